@@ -441,6 +441,27 @@ int main(void)
         printf(" }%s\n", (ini == NUM_CHANNELS) ? "" : ",");
     }
 
+    printf("};\n\n");
+
+    printf("/* The same coefficients as channel_converters, one row of [from] floats for each output channel. */\n");
+    printf("static const float channel_matrices[%d][%d][%d] = {   /* [from][to] */\n", NUM_CHANNELS, NUM_CHANNELS, NUM_CHANNELS * NUM_CHANNELS);
+    for (ini = 1; ini <= NUM_CHANNELS; ini++) {
+        printf("    {\n");
+        for (outi = 1; outi <= NUM_CHANNELS; outi++) {
+            const float *cvtmatrix = channel_conversion_matrix[ini-1][outi-1];
+            const char *comma = "";
+            int i;
+            printf("        /* %s -> %s */\n", lowercase(layout_names[ini-1]), lowercase(layout_names[outi-1]));
+            printf("        {");
+            for (i = 0; i < ini * outi; i++) {
+                printf("%s %.9ff", comma, cvtmatrix[i]);
+                comma = ",";
+            }
+            printf(" }%s\n", (outi == NUM_CHANNELS) ? "" : ",");
+        }
+        printf("    }%s\n", (ini == NUM_CHANNELS) ? "" : ",");
+    }
+
     printf("};\n\n");
     printf("/* vi: set ts=4 sw=4 expandtab: */\n\n");
 
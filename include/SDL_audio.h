@@ -1118,6 +1118,181 @@ extern DECLSPEC void SDLCALL SDL_AudioStreamClear(SDL_AudioStream *stream);
  */
 extern DECLSPEC void SDLCALL SDL_FreeAudioStream(SDL_AudioStream *stream);
 
+/**
+ * Set the mixing matrix an audio stream uses to change the channel count.
+ *
+ * `matrix` holds a row of `src_channels` floats for each of the stream's
+ * `dst_channels` output channels: output channel `j` is the sum of every
+ * input channel `i` multiplied by `matrix[j * src_channels + i]`. This
+ * replaces SDL's default mapping between channel layouts; for example, to
+ * fold 7.1 down to stereo with different weights for headphones. It also
+ * works when the stream doesn't change the channel count, to swap or mix
+ * channels.
+ *
+ * The matrix is copied. Audio already put into the stream has been converted
+ * with the previous matrix; only data put afterwards uses the new one.
+ *
+ * \param stream the audio stream to change
+ * \param matrix `dst_channels * src_channels` mixing weights, or NULL to go
+ *               back to the default mapping
+ * \returns 0 on success, or -1 on error; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_NewAudioStream
+ * \sa SDL_AudioStreamPut
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamSetChannelMatrix(SDL_AudioStream *stream, const float *matrix);
+
+/* SDL_WAVStream decodes a WAVE file a few sample frames at a time, instead
+   of all at once like SDL_LoadWAV_RW(). Use it for long music and ambience
+   tracks to start playing them right away without keeping all of the decoded
+   audio in memory.
+ */
+/* this is opaque to the outside world. */
+struct _SDL_WAVStream;
+typedef struct _SDL_WAVStream SDL_WAVStream;
+
+/**
+ * Open a WAVE file for decoding a few sample frames at a time.
+ *
+ * This reads the headers of the WAVE file and leaves its data to be decoded
+ * with SDL_WAVStreamRead() or SDL_WAVStreamPut(). It supports the same
+ * encodings as SDL_LoadWAV_RW(), decodes them to the same format, and obeys
+ * the same hints.
+ *
+ * The stream reads from `src` whenever data is decoded, so `src` must stay
+ * open until the stream is closed, and it must not be used for anything else
+ * in the meantime.
+ *
+ * \param src the data source for the WAVE data
+ * \param freesrc if non-zero, SDL_CloseWAVStream() will close `src`. It is
+ *                also closed if this function fails.
+ * \param spec an SDL_AudioSpec that will be filled in with the format of the
+ *             decoded audio
+ * \returns a new stream on success or NULL on failure; call SDL_GetError()
+ *          for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_CloseWAVStream
+ * \sa SDL_LoadWAV_RW
+ * \sa SDL_OpenWAVStream
+ * \sa SDL_WAVStreamPut
+ * \sa SDL_WAVStreamRead
+ * \sa SDL_WAVStreamSeek
+ */
+extern DECLSPEC SDL_WAVStream *SDLCALL SDL_OpenWAVStream_RW(SDL_RWops *src,
+                                                            int freesrc,
+                                                            SDL_AudioSpec *spec);
+
+/**
+ *  Opens a WAVE stream from a file.
+ *  \sa SDL_OpenWAVStream_RW
+ */
+#define SDL_OpenWAVStream(file, spec) \
+    SDL_OpenWAVStream_RW(SDL_RWFromFile(file, "rb"), 1, spec)
+
+/**
+ * Decode the next sample frames of a WAVE stream.
+ *
+ * A sample frame holds one sample for every channel, so `buf` must have room
+ * for `frames` times the channels times the sample size in bytes.
+ *
+ * \param stream the WAVE stream to decode from
+ * \param buf a buffer to fill with audio data
+ * \param frames the maximum number of sample frames to decode
+ * \returns the number of sample frames decoded, 0 at the end of the stream,
+ *          or -1 on error; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_OpenWAVStream_RW
+ * \sa SDL_WAVStreamPut
+ * \sa SDL_WAVStreamSeek
+ */
+extern DECLSPEC int SDLCALL SDL_WAVStreamRead(SDL_WAVStream *stream, void *buf, int frames);
+
+/**
+ * Decode the next sample frames of a WAVE stream into an audio stream.
+ *
+ * This is the same as calling SDL_WAVStreamRead() and passing the result to
+ * SDL_AudioStreamPut(), without a buffer of your own. Create `audiostream`
+ * with the format SDL_OpenWAVStream_RW() reported as its source format.
+ *
+ * \param stream the WAVE stream to decode from
+ * \param audiostream the audio stream to add the decoded audio to
+ * \param frames the maximum number of sample frames to decode
+ * \returns the number of sample frames added to `audiostream`, 0 at the end
+ *          of the stream, or -1 on error; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_AudioStreamPut
+ * \sa SDL_NewAudioStream
+ * \sa SDL_OpenWAVStream_RW
+ * \sa SDL_WAVStreamRead
+ */
+extern DECLSPEC int SDLCALL SDL_WAVStreamPut(SDL_WAVStream *stream, SDL_AudioStream *audiostream, int frames);
+
+/**
+ * Set the sample frame a WAVE stream decodes next.
+ *
+ * Compressed formats are decoded a block at a time, so seeking into the
+ * middle of a block decodes the whole block with the next read.
+ *
+ * \param stream the WAVE stream to seek in
+ * \param frame the sample frame to seek to, between 0 and the length of the
+ *              stream
+ * \returns 0 on success or -1 on error; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_WAVStreamLength
+ * \sa SDL_WAVStreamTell
+ */
+extern DECLSPEC int SDLCALL SDL_WAVStreamSeek(SDL_WAVStream *stream, Sint64 frame);
+
+/**
+ * Get the sample frame a WAVE stream decodes next.
+ *
+ * \param stream the WAVE stream to query
+ * \returns the position in sample frames, or -1 on error; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_WAVStreamSeek
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_WAVStreamTell(SDL_WAVStream *stream);
+
+/**
+ * Get the length of a WAVE stream.
+ *
+ * \param stream the WAVE stream to query
+ * \returns the number of sample frames in the stream, or -1 on error; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_WAVStreamSeek
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_WAVStreamLength(SDL_WAVStream *stream);
+
+/**
+ * Close a WAVE stream.
+ *
+ * \param stream the WAVE stream to close
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_OpenWAVStream_RW
+ */
+extern DECLSPEC void SDLCALL SDL_CloseWAVStream(SDL_WAVStream *stream);
+
 #define SDL_MIX_MAXVOLUME 128
 
 /**
@@ -337,6 +337,25 @@ extern "C" {
  */
 #define SDL_HINT_BMP_SAVE_LEGACY_FORMAT "SDL_BMP_SAVE_LEGACY_FORMAT"
 
+/**
+ *  \brief A variable that limits the CPU features SDL will use.
+ *
+ *  This is meant for testing and benchmarking the different code paths SDL
+ *  chooses based on the CPU, it can only hide features the CPU actually has.
+ *
+ *  The variable is a comma separated list of features, each prefixed with
+ *  '+' to keep it or '-' to hide it. The list is applied from left to right,
+ *  and "all" matches every feature. For example "-all,+sse2" limits SDL to
+ *  SSE2, while "-avx2,-avx512f" hides AVX2 and AVX-512.
+ *
+ *  Feature names are: altivec, mmx, 3dnow, sse, sse2, sse3, sse41, sse42,
+ *  avx, avx2, avx512f, armsimd, neon, lsx, lasx.
+ *
+ *  This hint affects SDL_HasSSE() and friends, and needs to be set before the
+ *  first call to any of them, which usually means before SDL_Init().
+ */
+#define SDL_HINT_CPU_FEATURE_MASK "SDL_CPU_FEATURE_MASK"
+
 /**
  *  \brief Override for SDL_GetDisplayUsableBounds()
  *
@@ -443,6 +462,23 @@ extern "C" {
  */
 #define SDL_HINT_FRAMEBUFFER_ACCELERATION   "SDL_FRAMEBUFFER_ACCELERATION"
 
+/**
+ *  \brief  A variable controlling whether SDL_UpdateWindowSurface() only pushes the parts of the window surface that changed.
+ *
+ *  When enabled, SDL keeps a hash of each tile of the window surface and
+ *  compares it to the previous frame, so that only the tiles that changed
+ *  are sent to the display. This helps mostly static content a lot, at the
+ *  cost of reading through the surface once per frame. The window is still
+ *  presented when nothing changed.
+ *
+ *  SDL_UpdateWindowSurfaceRects() is not affected by this hint.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Update the whole window surface (the default)
+ *    "1"       - Only update the parts of the window surface that changed
+ */
+#define SDL_HINT_FRAMEBUFFER_DAMAGE_TRACKING   "SDL_FRAMEBUFFER_DAMAGE_TRACKING"
+
 /**
  *  \brief  A variable that lets you manually hint extra gamecontroller db entries.
  *
@@ -1315,6 +1351,18 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_OPENGL_SHADERS      "SDL_RENDER_OPENGL_SHADERS"
 
+/**
+ *  \brief  A variable controlling whether the OpenGL render driver streams vertex data through vertex buffer objects.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Draw vertex data straight from client memory
+ *    "1"       - Upload vertex data into a vertex buffer object once per flush
+ *
+ *  By default vertex buffers are used if OpenGL supports them. A persistently
+ *  mapped buffer is used if GL_ARB_buffer_storage is available.
+ */
+#define SDL_HINT_RENDER_OPENGL_VERTEX_BUFFERS   "SDL_RENDER_OPENGL_VERTEX_BUFFERS"
+
 /**
  *  \brief  A variable controlling the scaling quality
  *
@@ -1327,6 +1375,23 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_SCALE_QUALITY       "SDL_RENDER_SCALE_QUALITY"
 
+/**
+ *  \brief  A variable controlling whether batched render commands are reordered to reduce state changes.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Render commands are sent to the GPU in the order they were issued
+ *    "1"       - Draws that don't overlap may be grouped by texture and blend mode
+ *
+ *  Draws that overlap are always rendered in the order they were issued, so
+ *  the result is the same either way. This only has an effect when batching
+ *  is enabled, see SDL_HINT_RENDER_BATCHING and SDL_RenderGetSortStats().
+ *
+ *  By default render commands are not reordered.
+ *
+ *  This variable should be set when the renderer is created.
+ */
+#define SDL_HINT_RENDER_SORT_COMMANDS       "SDL_RENDER_SORT_COMMANDS"
+
 /**
  *  \brief  A variable controlling whether updates to the SDL screen surface should be synchronized with the vertical refresh, to avoid tearing.
  *
@@ -1378,6 +1443,34 @@ extern "C" {
  */
 #define SDL_HINT_SCREENSAVER_INHIBIT_ACTIVITY_NAME "SDL_SCREENSAVER_INHIBIT_ACTIVITY_NAME"
 
+/**
+ *  \brief  A variable controlling how many threads convert large images.
+ *
+ *  SDL_ConvertSurface(), SDL_ConvertPixels() and the YUV conversions they use
+ *  can split images of a quarter megapixel or more into bands of rows that
+ *  are converted on several threads. Smaller images are always converted on
+ *  the calling thread.
+ *
+ *  This variable can be set to the following values:
+ *    "1"       - Convert on the calling thread (default)
+ *    "0"       - Use one thread per CPU core
+ *    "N"       - Use up to N threads
+ */
+#define SDL_HINT_SURFACE_CONVERT_THREADS "SDL_SURFACE_CONVERT_THREADS"
+
+/**
+ *  \brief  A variable controlling whether blits from RGB surfaces to palettized surfaces are dithered.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Each pixel is mapped to the nearest palette color (default)
+ *    "1"       - Floyd-Steinberg error diffusion is used to spread the error between pixels
+ *
+ *  The hint is checked when a blit mapping is calculated, which happens on
+ *  the first blit between two surfaces and whenever their formats or the
+ *  destination palette change.
+ */
+#define SDL_HINT_SURFACE_DITHER "SDL_SURFACE_DITHER"
+
 /**
  *  \brief Specifies whether SDL_THREAD_PRIORITY_TIME_CRITICAL should be treated as realtime.
  *
@@ -1732,6 +1825,20 @@ extern "C" {
  */
 #define SDL_HINT_VIDEO_X11_XVIDMODE         "SDL_VIDEO_X11_XVIDMODE"
 
+/**
+ *  \brief  A variable controlling how many threads decode compressed WAVE files.
+ *
+ *  MS ADPCM and IMA ADPCM data is made of blocks that can be decoded
+ *  independently of each other, so large files load faster when the blocks
+ *  are split between several threads.
+ *
+ *  This variable can be set to the following values:
+ *    "1"       - Decode on the thread calling SDL_LoadWAV_RW() (default)
+ *    "0"       - Use one thread per CPU core
+ *    "N"       - Use up to N threads
+ */
+#define SDL_HINT_WAVE_DECODE_THREADS   "SDL_WAVE_DECODE_THREADS"
+
 /**
  *  \brief  Controls how the fact chunk affects the loading of a WAVE file.
  *
@@ -2118,6 +2225,24 @@ extern "C" {
  */
 #define SDL_HINT_AUDIO_INCLUDE_MONITORS "SDL_AUDIO_INCLUDE_MONITORS"
 
+/**
+ *  \brief  A variable controlling whether ALSA playback uses mmap transfers.
+ *
+ *  This is currently only used for ALSA and ignored elsewhere.
+ *
+ *  When enabled, SDL asks ALSA for direct access to the device's ring buffer,
+ *  so the audio callback mixes straight into it, and the audio thread sleeps
+ *  in poll() until the device needs more data. Devices that don't support
+ *  mmap access fall back to regular writes.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Write audio with snd_pcm_writei()
+ *    "1"       - Use mmap transfers if the device supports them (default)
+ *
+ *  This hint must be set before opening an audio device.
+ */
+#define SDL_HINT_AUDIO_ALSA_MMAP "SDL_AUDIO_ALSA_MMAP"
+
 /**
  *  \brief  A variable that forces X11 windows to create as a custom type.
  *
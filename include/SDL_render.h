@@ -147,6 +147,18 @@ typedef struct SDL_Renderer SDL_Renderer;
 struct SDL_Texture;
 typedef struct SDL_Texture SDL_Texture;
 
+/**
+ * A set of large textures that many small textures are packed into
+ */
+struct SDL_TextureAtlas;
+typedef struct SDL_TextureAtlas SDL_TextureAtlas;
+
+/**
+ * A set of triangles kept by the renderer so it can be drawn many times
+ */
+struct SDL_Geometry;
+typedef struct SDL_Geometry SDL_Geometry;
+
 /* Function prototypes */
 
 /**
@@ -1804,6 +1816,28 @@ extern DECLSPEC void SDLCALL SDL_DestroyRenderer(SDL_Renderer * renderer);
  */
 extern DECLSPEC int SDLCALL SDL_RenderFlush(SDL_Renderer * renderer);
 
+/**
+ * Get statistics about the reordering of render commands.
+ *
+ * When SDL_HINT_RENDER_SORT_COMMANDS is enabled, batched draws that don't
+ * overlap are grouped by texture and blend mode before they are sent to the
+ * GPU. The counts are accumulated since the renderer was created.
+ *
+ * \param renderer the rendering context
+ * \param reordered a pointer filled in with the number of draws that were
+ *                  moved, may be NULL
+ * \param state_changes_saved a pointer filled in with the number of texture,
+ *                            blend mode or draw type changes between draws
+ *                            that were avoided, may be NULL
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_RenderFlush
+ */
+extern DECLSPEC int SDLCALL SDL_RenderGetSortStats(SDL_Renderer * renderer, Uint64 * reordered, Uint64 * state_changes_saved);
+
 
 /**
  * Bind an OpenGL/ES/ES2 texture to the current context.
@@ -1905,6 +1939,201 @@ extern DECLSPEC void *SDLCALL SDL_RenderGetMetalCommandEncoder(SDL_Renderer * re
  */
 extern DECLSPEC int SDLCALL SDL_RenderSetVSync(SDL_Renderer* renderer, int vsync);
 
+/**
+ * Create a texture atlas for a rendering context.
+ *
+ * A texture atlas packs many small textures into a few large "page"
+ * textures, so that drawing them doesn't require switching textures and can
+ * be batched into fewer draw calls. Pages are created on demand as textures
+ * are allocated from the atlas.
+ *
+ * Pages are created with SDL_TEXTUREACCESS_TARGET if the renderer supports
+ * render targets, which is required by SDL_DefragmentTextureAtlas().
+ *
+ * \param renderer the rendering context
+ * \param format the pixel format of the atlas pages, one of the
+ *               non-FOURCC formats supported by the renderer, or 0 for the
+ *               renderer's preferred format
+ * \param page_w the width of each atlas page in pixels
+ * \param page_h the height of each atlas page in pixels
+ * \returns a pointer to the created texture atlas or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_CreateAtlasTexture
+ * \sa SDL_DefragmentTextureAtlas
+ * \sa SDL_DestroyTextureAtlas
+ */
+extern DECLSPEC SDL_TextureAtlas * SDLCALL SDL_CreateTextureAtlas(SDL_Renderer * renderer, Uint32 format, int page_w, int page_h);
+
+/**
+ * Allocate a texture from a texture atlas.
+ *
+ * The returned texture can be used with SDL_UpdateTexture(),
+ * SDL_RenderCopy(), SDL_RenderCopyEx(), SDL_RenderGeometry() and the color,
+ * alpha and blend mode functions like any other static texture, and is
+ * freed with SDL_DestroyTexture(). Its contents are undefined until they are
+ * set with SDL_UpdateTexture(), which also copies its edge pixels into a one
+ * pixel border around it on the atlas page, so linear filtering at its edges
+ * doesn't pick up the neighbouring textures.
+ *
+ * Atlas textures can't be locked, used as a render target, bound with
+ * SDL_GL_BindTexture() or have their scale mode changed.
+ *
+ * \param atlas the texture atlas to allocate from
+ * \param w the width of the texture in pixels, at most the atlas page width
+ * \param h the height of the texture in pixels, at most the atlas page
+ *          height
+ * \returns a pointer to the created texture or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_CreateTextureAtlas
+ * \sa SDL_DestroyTexture
+ * \sa SDL_GetAtlasTextureRegion
+ */
+extern DECLSPEC SDL_Texture * SDLCALL SDL_CreateAtlasTexture(SDL_TextureAtlas * atlas, int w, int h);
+
+/**
+ * Get the atlas page and area of the page used by an atlas texture.
+ *
+ * This is useful to build vertex data that refers to the page texture
+ * directly. The returned values are only valid until the next call to
+ * SDL_DefragmentTextureAtlas() on the atlas, and the page texture must not
+ * be destroyed by the application.
+ *
+ * \param texture a texture created with SDL_CreateAtlasTexture()
+ * \param page a pointer filled in with the page texture, may be NULL
+ * \param rect a pointer filled in with the area of the page in pixels, may
+ *             be NULL
+ * \param uv a pointer filled in with the area of the page in normalized
+ *           texture coordinates, may be NULL
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_CreateAtlasTexture
+ */
+extern DECLSPEC int SDLCALL SDL_GetAtlasTextureRegion(SDL_Texture * texture, SDL_Texture ** page, SDL_Rect * rect, SDL_FRect * uv);
+
+/**
+ * Repack all the textures of a texture atlas into as few pages as possible.
+ *
+ * After many textures have been allocated and freed the atlas pages become
+ * fragmented. This function copies the contents of every texture in the
+ * atlas into freshly packed pages and releases the old ones. Textures
+ * allocated from the atlas remain valid, but the regions returned by
+ * SDL_GetAtlasTextureRegion() change.
+ *
+ * This function uses the atlas pages as render targets, and restores the
+ * current render target, draw color and draw blend mode when it's done.
+ *
+ * \param atlas the texture atlas to defragment
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_CreateTextureAtlas
+ */
+extern DECLSPEC int SDLCALL SDL_DefragmentTextureAtlas(SDL_TextureAtlas * atlas);
+
+/**
+ * Destroy a texture atlas and all the textures allocated from it.
+ *
+ * Texture atlases are also destroyed by SDL_DestroyRenderer().
+ *
+ * \param atlas the texture atlas to destroy
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_CreateTextureAtlas
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas);
+
+/**
+ * Create a geometry object that can be drawn many times.
+ *
+ * SDL_RenderGeometryRaw() copies and converts its vertices on every call.
+ * Meshes that don't change, like map tiles or user interface panels, can
+ * instead be created once as a geometry object and drawn with
+ * SDL_RenderRetainedGeometry(), which lets the renderer keep the vertices in
+ * whatever form it draws fastest.
+ *
+ * The vertex data is copied, so the arrays can be freed after this call.
+ * The parameters are the same as those of SDL_RenderGeometryRaw().
+ *
+ * \param renderer the rendering context
+ * \param xy vertex positions
+ * \param xy_stride byte size to move from one element to the next element
+ * \param color vertex colors (as SDL_Color)
+ * \param color_stride byte size to move from one element to the next
+ *                     element
+ * \param uv vertex normalized texture coordinates, or NULL if the geometry
+ *           is only drawn without a texture
+ * \param uv_stride byte size to move from one element to the next element
+ * \param num_vertices number of vertices
+ * \param indices (optional) An array of indices into the 'vertices' arrays,
+ *                if NULL all vertices will be rendered in sequential order.
+ * \param num_indices number of indices
+ * \param size_indices index size: 1 (byte), 2 (short), 4 (int)
+ * \returns a pointer to the created geometry or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_DestroyGeometry
+ * \sa SDL_RenderRetainedGeometry
+ */
+extern DECLSPEC SDL_Geometry * SDLCALL SDL_CreateGeometry(SDL_Renderer * renderer,
+                                               const float *xy, int xy_stride,
+                                               const SDL_Color *color, int color_stride,
+                                               const float *uv, int uv_stride,
+                                               int num_vertices,
+                                               const void *indices, int num_indices, int size_indices);
+
+/**
+ * Render a geometry object, optionally using a texture.
+ *
+ * The geometry is drawn as if its vertices were passed to
+ * SDL_RenderGeometryRaw() with the offset added to their positions.
+ *
+ * \param renderer the rendering context
+ * \param texture (optional) The SDL texture to use, the geometry must have
+ *                texture coordinates
+ * \param geometry a geometry created with SDL_CreateGeometry() for this
+ *                 renderer
+ * \param offset (optional) An amount to move the geometry by, in the same
+ *               coordinates as the vertex positions
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_CreateGeometry
+ * \sa SDL_RenderGeometryRaw
+ */
+extern DECLSPEC int SDLCALL SDL_RenderRetainedGeometry(SDL_Renderer * renderer,
+                                               SDL_Texture * texture,
+                                               SDL_Geometry * geometry,
+                                               const SDL_FPoint * offset);
+
+/**
+ * Destroy a geometry object.
+ *
+ * Geometry objects are also destroyed by SDL_DestroyRenderer().
+ *
+ * \param geometry the geometry to destroy
+ *
+ * \since This function is available since SDL 2.24.0.
+ *
+ * \sa SDL_CreateGeometry
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyGeometry(SDL_Geometry * geometry);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -46,6 +46,7 @@ extern "C" {
 /* ! Definitions for test case structures */
 #define TEST_ENABLED  1
 #define TEST_DISABLED 0
+#define TEST_BENCHMARK 2  /* Only run when benchmarks are enabled */
 
 /* ! Definition of all the possible test return values of the test case method */
 #define TEST_ABORTED        -1
@@ -69,6 +70,14 @@ typedef int (*SDLTest_TestCaseFp)(void *arg);
 /* !< Function pointer to a test case teardown function (run after every test) */
 typedef void  (*SDLTest_TestCaseTearDownFp)(void *arg);
 
+/* !< Function pointer to the body of a benchmark (run once per timed iteration) */
+typedef void (*SDLTest_BenchmarkFp)(void *arg);
+
+/* ! Definition of the possible machine-readable benchmark output formats */
+#define SDLTEST_BENCHMARK_OUTPUT_NONE   0
+#define SDLTEST_BENCHMARK_OUTPUT_CSV    1
+#define SDLTEST_BENCHMARK_OUTPUT_JSON   2  /* One JSON object per line */
+
 /**
  * Holds information about a single test case.
  */
@@ -79,7 +88,7 @@ typedef struct SDLTest_TestCaseReference {
     const char *name;
     /* !< Long name or full description "This test pushes func2() to the limit." */
     const char *description;
-    /* !< Set to TEST_ENABLED or TEST_DISABLED (test won't be run) */
+    /* !< Set to TEST_ENABLED, TEST_DISABLED (test won't be run) or TEST_BENCHMARK (only run with benchmarks enabled) */
     int enabled;
 } SDLTest_TestCaseReference;
 
@@ -122,6 +131,59 @@ char *SDLTest_GenerateRunSeed(const int length);
  */
 int SDLTest_RunSuites(SDLTest_TestSuiteReference *testSuites[], const char *userRunSeed, Uint64 userExecKey, const char *filter, int testIterations);
 
+/**
+ * \brief Execute each test suite in a separate worker process.
+ *
+ * Every worker is started with the given command line, followed by "--seed <runSeed> --filter <suite name>",
+ * so the command line must select a harness that accepts those options. Only suites are run in parallel,
+ * the test cases within each suite still run in order. Not supported on all platforms.
+ *
+ * \param testSuites Suites to run.
+ * \param userRunSeed Custom run seed provided by user, or NULL to autogenerate one.
+ * \param numWorkers Maximum number of worker processes running at the same time.
+ * \param workerArgv NULL-terminated command line used to start a worker, workerArgv[0] is the executable.
+ *
+ * \returns the test run result: 0 when all suites passed, 1 if any suite failed, -1 if parallel execution isn't supported.
+ */
+int SDLTest_RunSuitesParallel(SDLTest_TestSuiteReference *testSuites[], const char *userRunSeed, int numWorkers, char *workerArgv[]);
+
+/**
+ * \brief Enable or disable benchmark test cases and set how benchmarks are timed.
+ *
+ * \param enabled Non-zero to run test cases marked as TEST_BENCHMARK.
+ * \param warmupIterations Number of untimed iterations run before timing starts.
+ * \param timedIterations Number of timed iterations the statistics are computed from.
+ */
+void SDLTest_SetBenchmarkOptions(int enabled, int warmupIterations, int timedIterations);
+
+/**
+ * \brief Write benchmark results to a file in a machine-readable format.
+ *
+ * The file is truncated and a header is written, unless the harness is running as a parallel
+ * worker, in which case results are appended to the file the parent process created.
+ *
+ * \param file Path of the output file, or NULL to disable output.
+ * \param format One of the SDLTEST_BENCHMARK_OUTPUT_* values.
+ *
+ * \returns 0 on success, -1 if the file couldn't be created.
+ */
+int SDLTest_SetBenchmarkOutput(const char *file, int format);
+
+/**
+ * \brief Time a benchmark body and report min/median/p99 of the timed iterations.
+ *
+ * Meant to be called from a test case marked TEST_BENCHMARK; results are logged and
+ * written to the benchmark output file, tagged with the current suite and test name.
+ *
+ * \param name Name of the benchmark within the current test case.
+ * \param func Function to time.
+ * \param arg Argument passed to func.
+ * \param itemsPerIteration Units of work (pixels, samples, bytes, ...) done by one call to func, or 0.
+ *
+ * \returns 0 on success, -1 on failure.
+ */
+int SDLTest_Benchmark(const char *name, SDLTest_BenchmarkFp func, void *arg, Uint64 itemsPerIteration);
+
 
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
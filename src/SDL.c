@@ -48,6 +48,7 @@
 #include "SDL_revision.h"
 #include "SDL_assert_c.h"
 #include "SDL_log_c.h"
+#include "SDL_parallel_c.h"
 #include "events/SDL_events_c.h"
 #include "haptic/SDL_haptic_c.h"
 #include "joystick/SDL_joystick_c.h"
@@ -500,6 +501,9 @@ SDL_Quit(void)
 
     SDL_LogQuit();
 
+    SDL_QuitParallel();
+    SDL_QuitScratch();
+
     /* Now that every subsystem has been quit, we reset the subsystem refcount
      * and the list of initialized subsystems.
      */
@@ -0,0 +1,245 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "./SDL_internal.h"
+
+#include "SDL.h"
+#include "./SDL_parallel_c.h"
+#include "thread/SDL_systhread.h"
+
+#define SDL_PARALLEL_MAX_THREADS 32
+
+#if !SDL_THREADS_DISABLED
+
+struct SDL_ParallelPool;
+
+typedef struct SDL_ParallelWorker
+{
+    struct SDL_ParallelPool *pool;
+    SDL_Thread *thread;
+    int id;
+    Uint32 seen;            /* the last job this worker woke up for */
+} SDL_ParallelWorker;
+
+typedef struct SDL_ParallelPool
+{
+    SDL_atomic_t busy;      /* set while a job runs */
+
+    SDL_mutex *lock;        /* protects everything below */
+    SDL_cond *wake;         /* workers wait here for a job */
+    SDL_cond *done;         /* the caller waits here for the workers */
+    SDL_ParallelWorker workers[SDL_PARALLEL_MAX_THREADS - 1];
+    int numthreads;
+    SDL_bool quit;
+
+    /* The current job */
+    Uint32 generation;
+    int wanted;             /* workers taking part */
+    int running;            /* workers that haven't finished yet */
+    SDL_ParallelFunc func;
+    void *data;
+    int count;
+    SDL_atomic_t next;      /* next index to hand out */
+} SDL_ParallelPool;
+
+static SDL_SpinLock SDL_parallel_lock;
+static SDL_ParallelPool *SDL_parallel_pool;
+
+static void
+SDL_RunParallelJob(SDL_ParallelPool *pool)
+{
+    for (;;) {
+        const int index = SDL_AtomicAdd(&pool->next, 1);
+        if (index >= pool->count) {
+            break;
+        }
+        pool->func(pool->data, index);
+    }
+}
+
+static int SDLCALL
+SDL_ParallelWorkerThread(void *arg)
+{
+    SDL_ParallelWorker *worker = (SDL_ParallelWorker *)arg;
+    SDL_ParallelPool *pool = worker->pool;
+
+    SDL_LockMutex(pool->lock);
+    for (;;) {
+        while (!pool->quit && worker->seen == pool->generation) {
+            SDL_CondWait(pool->wake, pool->lock);
+        }
+        if (pool->quit) {
+            break;
+        }
+        worker->seen = pool->generation;
+        if (worker->id < pool->wanted) {
+            SDL_UnlockMutex(pool->lock);
+            SDL_RunParallelJob(pool);
+            SDL_LockMutex(pool->lock);
+            if (--pool->running == 0) {
+                SDL_CondSignal(pool->done);
+            }
+        }
+    }
+    SDL_UnlockMutex(pool->lock);
+    return 0;
+}
+
+static SDL_ParallelPool *
+SDL_GetParallelPool(void)
+{
+    SDL_ParallelPool *pool;
+
+    SDL_AtomicLock(&SDL_parallel_lock);
+    pool = SDL_parallel_pool;
+    if (pool == NULL) {
+        pool = (SDL_ParallelPool *)SDL_calloc(1, sizeof(*pool));
+        if (pool) {
+            pool->lock = SDL_CreateMutex();
+            pool->wake = SDL_CreateCond();
+            pool->done = SDL_CreateCond();
+            if (!pool->lock || !pool->wake || !pool->done) {
+                SDL_DestroyCond(pool->done);
+                SDL_DestroyCond(pool->wake);
+                SDL_DestroyMutex(pool->lock);
+                SDL_free(pool);
+                pool = NULL;
+            }
+        }
+        SDL_parallel_pool = pool;
+    }
+    SDL_AtomicUnlock(&SDL_parallel_lock);
+    return pool;
+}
+
+void
+SDL_ParallelFor(int count, int threads, SDL_ParallelFunc func, void *data)
+{
+    SDL_ParallelPool *pool = NULL;
+    int i;
+
+    threads = SDL_min(threads, SDL_min(count, SDL_PARALLEL_MAX_THREADS));
+    if (threads > 1) {
+        pool = SDL_GetParallelPool();
+    }
+    if (pool == NULL || !SDL_AtomicCAS(&pool->busy, 0, 1)) {
+        for (i = 0; i < count; ++i) {
+            func(data, i);
+        }
+        return;
+    }
+
+    SDL_LockMutex(pool->lock);
+    while (pool->numthreads < threads - 1) {
+        SDL_ParallelWorker *worker = &pool->workers[pool->numthreads];
+        worker->pool = pool;
+        worker->id = pool->numthreads;
+        worker->seen = pool->generation;
+        worker->thread = SDL_CreateThreadInternal(SDL_ParallelWorkerThread, "SDLParallel", 0, worker);
+        if (worker->thread == NULL) {
+            break;
+        }
+        ++pool->numthreads;
+    }
+    pool->func = func;
+    pool->data = data;
+    pool->count = count;
+    SDL_AtomicSet(&pool->next, 0);
+    pool->wanted = SDL_min(threads - 1, pool->numthreads);
+    pool->running = pool->wanted;
+    ++pool->generation;
+    SDL_CondBroadcast(pool->wake);
+    SDL_UnlockMutex(pool->lock);
+
+    SDL_RunParallelJob(pool);
+
+    SDL_LockMutex(pool->lock);
+    while (pool->running > 0) {
+        SDL_CondWait(pool->done, pool->lock);
+    }
+    SDL_UnlockMutex(pool->lock);
+
+    SDL_AtomicSet(&pool->busy, 0);
+}
+
+void
+SDL_QuitParallel(void)
+{
+    SDL_ParallelPool *pool;
+    int i;
+
+    SDL_AtomicLock(&SDL_parallel_lock);
+    pool = SDL_parallel_pool;
+    SDL_parallel_pool = NULL;
+    SDL_AtomicUnlock(&SDL_parallel_lock);
+
+    if (pool == NULL) {
+        return;
+    }
+
+    SDL_LockMutex(pool->lock);
+    pool->quit = SDL_TRUE;
+    SDL_CondBroadcast(pool->wake);
+    SDL_UnlockMutex(pool->lock);
+    for (i = 0; i < pool->numthreads; ++i) {
+        SDL_WaitThread(pool->workers[i].thread, NULL);
+    }
+    SDL_DestroyCond(pool->done);
+    SDL_DestroyCond(pool->wake);
+    SDL_DestroyMutex(pool->lock);
+    SDL_free(pool);
+}
+
+#else
+
+void
+SDL_ParallelFor(int count, int threads, SDL_ParallelFunc func, void *data)
+{
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        func(data, i);
+    }
+}
+
+void
+SDL_QuitParallel(void)
+{
+}
+
+#endif /* !SDL_THREADS_DISABLED */
+
+int
+SDL_GetParallelThreadsHint(const char *name)
+{
+    const char *hint = SDL_GetHint(name);
+    int threads;
+
+    if (hint == NULL || *hint == '\0') {
+        return 1;
+    }
+    threads = SDL_atoi(hint);
+    if (threads == 0 && *hint == '0') {
+        threads = SDL_GetCPUCount();
+    }
+    return SDL_max(threads, 1);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,51 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_parallel_c_h_
+#define SDL_parallel_c_h_
+
+/* A pool of worker threads for splitting large jobs across CPU cores.
+
+   SDL_ParallelFor() calls func(data, index) once for every index from 0
+   to count - 1, spread over at most 'threads' threads, the calling thread
+   included, and returns once all of them are done. Indices are handed
+   out in order but may finish in any order, so each one should write to
+   its own part of the output.
+
+   Workers are started the first time they are needed and are kept until
+   SDL_Quit(). Only one job runs at a time: a call made while another job
+   is running, including one from inside func, runs serially on the
+   calling thread instead. func must not fail in ways the caller can't
+   see afterwards, since SDL_SetError() on a worker thread is lost. */
+typedef void (*SDL_ParallelFunc)(void *data, int index);
+
+extern void SDL_ParallelFor(int count, int threads, SDL_ParallelFunc func, void *data);
+
+/* The number of threads a thread count hint asks for: "0" means one per
+   CPU core, and an unset or invalid hint means 1, so the work is serial. */
+extern int SDL_GetParallelThreadsHint(const char *name);
+
+/* Stop the worker threads. */
+extern void SDL_QuitParallel(void);
+
+#endif /* SDL_parallel_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,413 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "./SDL_internal.h"
+
+#include "SDL.h"
+#include "./SDL_scratch_c.h"
+
+#define SCRATCH_ALIGN       16
+#define SCRATCH_CHUNK_SIZE  (64 * 1024)
+#define SCRATCH_MAX_KEEP    (4 * SCRATCH_CHUNK_SIZE)    /* chunk bytes a thread keeps when they're idle */
+#define SCRATCH_NONE        ((size_t)-1)
+#define SCRATCH_ALIGN_UP(x) (((x) + (SCRATCH_ALIGN - 1)) & ~((size_t)(SCRATCH_ALIGN - 1)))
+
+#define SCRATCH_FLAG_FREED  0x1
+#define SCRATCH_FLAG_HEAP   0x2
+
+/* Sits right in front of every allocation, padded so the allocation stays aligned */
+typedef union SDL_ScratchHeader
+{
+    struct {
+        size_t prev;    /* offset of the allocation below this one in the chunk, or SCRATCH_NONE */
+        Uint32 flags;
+    } info;
+    Uint8 padding[SCRATCH_ALIGN];
+} SDL_ScratchHeader;
+
+typedef struct SDL_ScratchChunk
+{
+    struct SDL_ScratchChunk *prev;
+    struct SDL_ScratchChunk *next;
+    Uint8 *data;    /* aligned start of the usable space */
+    size_t size;    /* bytes of usable space */
+    size_t used;    /* bytes handed out, including headers */
+    size_t top;     /* offset of the most recent allocation, or SCRATCH_NONE */
+} SDL_ScratchChunk;
+
+typedef struct SDL_ScratchArena
+{
+    SDL_ScratchChunk *head;
+    SDL_ScratchChunk *current;  /* chunks after this one are empty spares */
+    SDL_malloc_func malloc_func;
+    SDL_free_func free_func;
+} SDL_ScratchArena;
+
+static void
+SDL_FreeScratchChunk(SDL_ScratchArena *arena, SDL_ScratchChunk *chunk)
+{
+    if (chunk->prev) {
+        chunk->prev->next = chunk->next;
+    } else {
+        arena->head = chunk->next;
+    }
+    if (chunk->next) {
+        chunk->next->prev = chunk->prev;
+    }
+    arena->free_func(chunk);
+}
+
+/* Free the spare chunks that aren't worth keeping: ones that were made for
+   a single oversize allocation, and any past SCRATCH_MAX_KEEP in total. */
+static void
+SDL_TrimScratchChunks(SDL_ScratchArena *arena)
+{
+    SDL_ScratchChunk *chunk;
+    SDL_bool spare;
+    size_t kept = 0;
+
+    /* An empty first chunk is as spare as the ones after it */
+    if (arena->current && arena->current->top == SCRATCH_NONE) {
+        arena->current = NULL;
+    }
+
+    spare = arena->current ? SDL_FALSE : SDL_TRUE;
+    chunk = arena->head;
+    while (chunk) {
+        SDL_ScratchChunk *next = chunk->next;
+        if (chunk == arena->current) {
+            spare = SDL_TRUE;
+            kept += chunk->size;
+        } else if (spare && (chunk->size > SCRATCH_CHUNK_SIZE || kept + chunk->size > SCRATCH_MAX_KEEP)) {
+            SDL_FreeScratchChunk(arena, chunk);
+        } else {
+            kept += chunk->size;
+        }
+        chunk = next;
+    }
+}
+
+static void
+SDL_FreeScratchChunks(SDL_ScratchArena *arena)
+{
+    SDL_ScratchChunk *chunk = arena->head;
+    while (chunk) {
+        SDL_ScratchChunk *next = chunk->next;
+        arena->free_func(chunk);
+        chunk = next;
+    }
+    arena->head = NULL;
+    arena->current = NULL;
+}
+
+static void
+SDL_FreeScratchArena(void *data)
+{
+    SDL_ScratchArena *arena = (SDL_ScratchArena *)data;
+
+    SDL_FreeScratchChunks(arena);
+    arena->free_func(arena);
+}
+
+/* Each thread's arena hangs off a slot: SDL_CreateScratchSlot() makes sure
+   there is one, and SDL_GetScratchSlot() returns NULL until there is. */
+#if SDL_THREADS_DISABLED
+static SDL_ScratchArena *scratch_arena;
+
+static SDL_bool SDL_CreateScratchSlot(void) { return SDL_TRUE; }
+static SDL_ScratchArena *SDL_GetScratchSlot(void) { return scratch_arena; }
+static int SDL_SetScratchSlot(SDL_ScratchArena *arena) { scratch_arena = arena; return 0; }
+static void SDL_QuitScratchSlot(void) { }
+
+#elif SDL_THREAD_PTHREAD
+#include <pthread.h>
+
+/* A key of our own rather than SDL_TLSSet(), so that the arenas of threads
+   SDL didn't create are freed when they exit too. It's deleted when SDL
+   quits, so its destructor isn't left pointing into SDL once it's unloaded. */
+static SDL_SpinLock scratch_lock;
+static SDL_bool scratch_key_valid;
+static pthread_key_t scratch_key;
+
+static SDL_bool
+SDL_CreateScratchSlot(void)
+{
+    if (!scratch_key_valid) {
+        SDL_AtomicLock(&scratch_lock);
+        if (!scratch_key_valid && pthread_key_create(&scratch_key, SDL_FreeScratchArena) == 0) {
+            SDL_MemoryBarrierRelease();
+            scratch_key_valid = SDL_TRUE;
+        }
+        SDL_AtomicUnlock(&scratch_lock);
+    }
+    return scratch_key_valid;
+}
+
+static SDL_ScratchArena *
+SDL_GetScratchSlot(void)
+{
+    if (!scratch_key_valid) {
+        return NULL;
+    }
+    SDL_MemoryBarrierAcquire();
+    return (SDL_ScratchArena *)pthread_getspecific(scratch_key);
+}
+
+static int
+SDL_SetScratchSlot(SDL_ScratchArena *arena)
+{
+    return (pthread_setspecific(scratch_key, arena) == 0) ? 0 : -1;
+}
+
+static void
+SDL_QuitScratchSlot(void)
+{
+    SDL_AtomicLock(&scratch_lock);
+    if (scratch_key_valid) {
+        scratch_key_valid = SDL_FALSE;
+        pthread_key_delete(scratch_key);
+    }
+    SDL_AtomicUnlock(&scratch_lock);
+}
+
+#else
+/* Threads SDL didn't create never clean up their SDL TLS, so their arenas
+   are only freed for threads that SDL created. */
+static SDL_SpinLock scratch_lock;
+static SDL_TLSID scratch_tls;
+
+static void SDLCALL
+SDL_DestroyScratchSlot(void *data)
+{
+    SDL_FreeScratchArena(data);
+}
+
+static SDL_bool
+SDL_CreateScratchSlot(void)
+{
+    if (!scratch_tls) {
+        SDL_AtomicLock(&scratch_lock);
+        if (!scratch_tls) {
+            SDL_TLSID slot = SDL_TLSCreate();
+            SDL_MemoryBarrierRelease();
+            scratch_tls = slot;
+        }
+        SDL_AtomicUnlock(&scratch_lock);
+    }
+    return scratch_tls ? SDL_TRUE : SDL_FALSE;
+}
+
+static SDL_ScratchArena *
+SDL_GetScratchSlot(void)
+{
+    if (!scratch_tls) {
+        return NULL;
+    }
+    SDL_MemoryBarrierAcquire();
+    return (SDL_ScratchArena *)SDL_TLSGet(scratch_tls);
+}
+
+static int
+SDL_SetScratchSlot(SDL_ScratchArena *arena)
+{
+    return SDL_TLSSet(scratch_tls, arena, arena ? SDL_DestroyScratchSlot : NULL);
+}
+
+static void SDL_QuitScratchSlot(void) { }
+#endif /* SDL_THREADS_DISABLED */
+
+static SDL_ScratchArena *
+SDL_GetScratchArena(SDL_bool create)
+{
+    SDL_ScratchArena *arena;
+
+    if (create && !SDL_CreateScratchSlot()) {
+        return NULL;
+    }
+
+    arena = SDL_GetScratchSlot();
+    if (!arena && create) {
+        /* The arena keeps the memory functions it was created with, so its
+         * chunks go back to the allocator they came from even if the app
+         * changes them later.
+         */
+        SDL_malloc_func malloc_func;
+        SDL_free_func free_func;
+        SDL_GetMemoryFunctions(&malloc_func, NULL, NULL, &free_func);
+
+        arena = (SDL_ScratchArena *)malloc_func(sizeof(*arena));
+        if (!arena) {
+            return NULL;
+        }
+        SDL_zerop(arena);
+        arena->malloc_func = malloc_func;
+        arena->free_func = free_func;
+        if (SDL_SetScratchSlot(arena) < 0) {
+            free_func(arena);
+            return NULL;
+        }
+    }
+    return arena;
+}
+
+static SDL_ScratchChunk *
+SDL_NextScratchChunk(SDL_ScratchArena *arena, size_t needed)
+{
+    SDL_ScratchChunk *chunk = arena->current;
+    SDL_ScratchChunk *next = chunk ? chunk->next : arena->head;
+    size_t size;
+
+    if (!next || next->size < needed) {
+        /* Don't keep spares around that are too small, they'd just get skipped again */
+        if (next) {
+            SDL_FreeScratchChunk(arena, next);
+        }
+
+        size = SDL_max(needed, SCRATCH_CHUNK_SIZE);
+        next = (SDL_ScratchChunk *)arena->malloc_func(sizeof(*next) + SCRATCH_ALIGN + size);
+        if (!next) {
+            return NULL;
+        }
+        next->data = (Uint8 *)SCRATCH_ALIGN_UP((size_t)(next + 1));
+        next->size = size;
+        next->prev = chunk;
+        if (chunk) {
+            next->next = chunk->next;
+            chunk->next = next;
+        } else {
+            next->next = arena->head;
+            arena->head = next;
+        }
+        if (next->next) {
+            next->next->prev = next;
+        }
+    }
+
+    next->used = 0;
+    next->top = SCRATCH_NONE;
+    arena->current = next;
+    return next;
+}
+
+void *
+SDL_AllocScratch(size_t len)
+{
+    SDL_ScratchArena *arena;
+    SDL_ScratchChunk *chunk;
+    SDL_ScratchHeader *header;
+    size_t needed;
+
+    if (len > (SDL_SIZE_MAX / 2)) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    needed = sizeof(*header) + SCRATCH_ALIGN_UP(len);
+
+    arena = SDL_GetScratchArena(SDL_TRUE);
+    if (!arena) {
+        /* No thread-local storage available, fall back to the heap */
+        header = (SDL_ScratchHeader *)SDL_malloc(needed);
+        if (!header) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        header->info.prev = SCRATCH_NONE;
+        header->info.flags = SCRATCH_FLAG_HEAP;
+        return header + 1;
+    }
+
+    chunk = arena->current;
+    if (!chunk || (chunk->size - chunk->used) < needed) {
+        chunk = SDL_NextScratchChunk(arena, needed);
+        if (!chunk) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+    }
+
+    header = (SDL_ScratchHeader *)(chunk->data + chunk->used);
+    header->info.prev = chunk->top;
+    header->info.flags = 0;
+    chunk->top = chunk->used;
+    chunk->used += needed;
+    return header + 1;
+}
+
+void
+SDL_FreeScratch(void *ptr)
+{
+    SDL_ScratchArena *arena;
+    SDL_ScratchChunk *chunk, *start;
+    SDL_ScratchHeader *header;
+
+    if (!ptr) {
+        return;
+    }
+
+    header = (SDL_ScratchHeader *)ptr - 1;
+    if (header->info.flags & SCRATCH_FLAG_HEAP) {
+        SDL_free(header);
+        return;
+    }
+    header->info.flags |= SCRATCH_FLAG_FREED;
+
+    arena = SDL_GetScratchArena(SDL_FALSE);
+    if (!arena) {
+        return;
+    }
+
+    /* Pop everything off the top that has been freed already */
+    chunk = start = arena->current;
+    while (chunk) {
+        if (chunk->top == SCRATCH_NONE) {
+            if (!chunk->prev) {
+                break;
+            }
+            chunk = chunk->prev;
+            continue;
+        }
+        header = (SDL_ScratchHeader *)(chunk->data + chunk->top);
+        if (!(header->info.flags & SCRATCH_FLAG_FREED)) {
+            break;
+        }
+        chunk->used = chunk->top;
+        chunk->top = header->info.prev;
+    }
+    arena->current = chunk;
+
+    /* Only chunks that were emptied just now can be new spares */
+    if (chunk != start || (chunk && chunk->top == SCRATCH_NONE)) {
+        SDL_TrimScratchChunks(arena);
+    }
+}
+
+void
+SDL_QuitScratch(void)
+{
+    SDL_ScratchArena *arena = SDL_GetScratchArena(SDL_FALSE);
+
+    if (arena) {
+        SDL_SetScratchSlot(NULL);
+        SDL_FreeScratchArena(arena);
+    }
+    SDL_QuitScratchSlot();
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,51 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_scratch_c_h_
+#define SDL_scratch_c_h_
+
+/* Per-thread scratch memory for short-lived internal buffers.
+
+   This is a bump allocator: allocations are carved out of large chunks
+   owned by the calling thread, and freeing the most recent allocation
+   hands its space straight back. Freeing out of order is allowed, the
+   space is reclaimed once everything allocated after it is freed too.
+   Chunks are kept around once allocated, so code that allocates and
+   frees the same amount every call stops touching the heap entirely
+   after the first call. Chunks made for a single large allocation are
+   given back as soon as it's freed, and each thread keeps at most a few
+   regular chunks around.
+
+   Scratch memory must be freed on the thread that allocated it, and it
+   must not outlive the function call that allocated it.
+
+   Returned memory is uninitialized and aligned to 16 bytes. */
+extern void *SDL_AllocScratch(size_t len);
+extern void SDL_FreeScratch(void *ptr);
+
+/* Release all scratch memory of the calling thread back to the heap. Where
+   other threads' scratch memory is freed as they exit, that stops here, and
+   whatever they still hold is leaked. */
+extern void SDL_QuitScratch(void);
+
+#endif /* SDL_scratch_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
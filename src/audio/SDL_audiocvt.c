@@ -171,6 +171,353 @@ SDL_ConvertMonoToStereo_SSE(SDL_AudioCVT * cvt, SDL_AudioFormat format)
 #include "SDL_audio_channel_converters.h"
 
 
+/* The generic channel mixer. Every output channel is a weighted sum of the
+   input channels; the default weights are the ones channel_converters uses,
+   and SDL_AudioStreamSetChannelMatrix() can replace them. */
+typedef struct SDL_AudioChannelMatrix
+{
+    int src_channels;
+    int dst_channels;
+    int num_columns;
+    Uint8 columns[8];  /* the input channels that feed any output, in summing order. */
+    float tiled[8][8];  /* tiled[in][i] is the weight of input channel (in) for output channel (i % dst_channels). */
+} SDL_AudioChannelMatrix;
+
+typedef void (*SDL_MixChannelsFunc)(const SDL_AudioChannelMatrix *matrix, const float *src, float *dst, int frames);
+
+static SDL_MixChannelsFunc SDL_MixChannels = NULL;
+static SDL_AudioChannelMatrix default_channel_matrices[8][8];
+
+/* !!! FIXME in 2.1: like the resampler below, this needs data the cvt structure doesn't
+   !!! FIXME in 2.1:   have room for, so it steals the eighth slot to point at the matrix. */
+#define SDL_AUDIOCVT_MATRIX_SLOT (SDL_AUDIOCVT_MAX_FILTERS - 2)
+
+/* SDL_ConvertAudio() runs the filter list over chunks of about this many
+   input bytes, so intermediate results stay in cache between filters. */
+#define SDL_AUDIOCVT_CHUNK_BYTES 4096
+
+static void
+SDL_InitAudioChannelMatrix(SDL_AudioChannelMatrix *matrix, const float *coefficients,
+                           const int src_channels, const int dst_channels)
+{
+    int i, j;
+
+    matrix->src_channels = src_channels;
+    matrix->dst_channels = dst_channels;
+    matrix->num_columns = 0;
+
+    for (i = 0; i < src_channels; i++) {
+        /* sum in the same order as the generated converters, so the results match them exactly. */
+        const int in = (dst_channels > src_channels) ? (src_channels - 1 - i) : i;
+        SDL_bool used = SDL_FALSE;
+        for (j = 0; j < 8; j++) {
+            matrix->tiled[in][j] = coefficients[((j % dst_channels) * src_channels) + in];
+            if (matrix->tiled[in][j] != 0.0f) {
+                used = SDL_TRUE;
+            }
+        }
+        if (used) {
+            matrix->columns[matrix->num_columns++] = (Uint8) in;
+        }
+    }
+}
+
+/* All of these work in place: the output grows backwards from the end of the
+   buffer when adding channels, and shrinks forwards from the start otherwise. */
+static void
+SDL_MixChannels_Scalar(const SDL_AudioChannelMatrix *matrix, const float *src, float *dst, int frames)
+{
+    const int srcchans = matrix->src_channels;
+    const int dstchans = matrix->dst_channels;
+    const int num_columns = matrix->num_columns;
+    const Uint8 *columns = matrix->columns;
+    int srcstep = srcchans;
+    int dststep = dstchans;
+    float in[8];
+    int i, j, k;
+
+    if (dstchans > srcchans) {
+        src += (frames - 1) * srcchans;
+        dst += (frames - 1) * dstchans;
+        srcstep = -srcchans;
+        dststep = -dstchans;
+    }
+
+    for (i = 0; i < frames; i++, src += srcstep, dst += dststep) {
+        for (k = 0; k < num_columns; k++) {
+            in[k] = src[columns[k]];
+        }
+        for (j = 0; j < dstchans; j++) {
+            float sample = 0.0f;
+            for (k = 0; k < num_columns; k++) {
+                sample += matrix->tiled[columns[k]][j] * in[k];
+            }
+            dst[j] = sample;
+        }
+    }
+}
+
+#if HAVE_SSE_INTRINSICS
+SDL_FORCE_INLINE void
+SDL_StoreChannels_SSE(float *dst, const __m128 samples, const int channels)
+{
+    switch (channels) {
+        case 4: _mm_storeu_ps(dst, samples); break;
+        case 3: _mm_storel_pi((__m64 *) dst, samples); _mm_store_ss(dst + 2, _mm_movehl_ps(samples, samples)); break;
+        case 2: _mm_storel_pi((__m64 *) dst, samples); break;
+        default: _mm_store_ss(dst, samples); break;
+    }
+}
+
+static void
+SDL_MixChannels_SSE(const SDL_AudioChannelMatrix *matrix, const float *src, float *dst, int frames)
+{
+    const int srcchans = matrix->src_channels;
+    const int dstchans = matrix->dst_channels;
+    const int num_columns = matrix->num_columns;
+    const Uint8 *columns = matrix->columns;
+    int srcstep = srcchans;
+    int dststep = dstchans;
+    int i, k;
+
+    if ((dstchans < srcchans) && ((dstchans == 1) || (dstchans == 2) || (dstchans == 4))) {
+        /* Several output frames fit in a vector, so mix 4 / dstchans frames at a time. */
+        const int vecframes = 4 / dstchans;
+        for (; frames >= vecframes; frames -= vecframes, src += vecframes * srcchans, dst += 4) {
+            __m128 acc = _mm_setzero_ps();
+            for (k = 0; k < num_columns; k++) {
+                const int c = columns[k];
+                __m128 in;
+                if (dstchans == 1) {
+                    in = _mm_set_ps(src[(3 * srcchans) + c], src[(2 * srcchans) + c], src[srcchans + c], src[c]);
+                } else if (dstchans == 2) {
+                    in = _mm_set_ps(src[srcchans + c], src[srcchans + c], src[c], src[c]);
+                } else {
+                    in = _mm_set1_ps(src[c]);
+                }
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(matrix->tiled[c]), in));
+            }
+            _mm_storeu_ps(dst, acc);
+        }
+    } else if (dstchans > srcchans) {
+        src += (frames - 1) * srcchans;
+        dst += (frames - 1) * dstchans;
+        srcstep = -srcchans;
+        dststep = -dstchans;
+    }
+
+    if (dstchans <= 4) {
+        for (i = 0; i < frames; i++, src += srcstep, dst += dststep) {
+            __m128 acc = _mm_setzero_ps();
+            for (k = 0; k < num_columns; k++) {
+                const int c = columns[k];
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(matrix->tiled[c]), _mm_set1_ps(src[c])));
+            }
+            SDL_StoreChannels_SSE(dst, acc, dstchans);
+        }
+    } else {
+        for (i = 0; i < frames; i++, src += srcstep, dst += dststep) {
+            __m128 lo = _mm_setzero_ps();
+            __m128 hi = _mm_setzero_ps();
+            for (k = 0; k < num_columns; k++) {
+                const int c = columns[k];
+                const __m128 in = _mm_set1_ps(src[c]);
+                lo = _mm_add_ps(lo, _mm_mul_ps(_mm_loadu_ps(matrix->tiled[c]), in));
+                hi = _mm_add_ps(hi, _mm_mul_ps(_mm_loadu_ps(matrix->tiled[c] + 4), in));
+            }
+            _mm_storeu_ps(dst, lo);
+            SDL_StoreChannels_SSE(dst + 4, hi, dstchans - 4);
+        }
+    }
+}
+#endif
+
+#if HAVE_AVX_INTRINSICS
+static void SDL_TARGETING("avx")
+SDL_MixChannels_AVX(const SDL_AudioChannelMatrix *matrix, const float *src, float *dst, int frames)
+{
+    static const int masks[16] = { -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0 };
+    const int srcchans = matrix->src_channels;
+    const int dstchans = matrix->dst_channels;
+    const int num_columns = matrix->num_columns;
+    const Uint8 *columns = matrix->columns;
+    const __m256i mask = _mm256_loadu_si256((const __m256i *) (masks + 8 - dstchans));
+    int srcstep = srcchans;
+    int dststep = dstchans;
+    int i, k;
+
+    if ((dstchans < srcchans) && ((dstchans == 1) || (dstchans == 2) || (dstchans == 4))) {
+        /* Several output frames fit in a vector, so mix 8 / dstchans frames at a time. */
+        const int vecframes = 8 / dstchans;
+        for (; frames >= vecframes; frames -= vecframes, src += vecframes * srcchans, dst += 8) {
+            __m256 acc = _mm256_setzero_ps();
+            for (k = 0; k < num_columns; k++) {
+                const int c = columns[k];
+                __m256 in;
+                if (dstchans == 1) {
+                    in = _mm256_set_ps(src[(7 * srcchans) + c], src[(6 * srcchans) + c], src[(5 * srcchans) + c], src[(4 * srcchans) + c],
+                                       src[(3 * srcchans) + c], src[(2 * srcchans) + c], src[srcchans + c], src[c]);
+                } else if (dstchans == 2) {
+                    in = _mm256_set_ps(src[(3 * srcchans) + c], src[(3 * srcchans) + c], src[(2 * srcchans) + c], src[(2 * srcchans) + c],
+                                       src[srcchans + c], src[srcchans + c], src[c], src[c]);
+                } else {
+                    in = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(src[c])), _mm_set1_ps(src[srcchans + c]), 1);
+                }
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(matrix->tiled[c]), in));
+            }
+            _mm256_storeu_ps(dst, acc);
+        }
+    } else if (dstchans > srcchans) {
+        src += (frames - 1) * srcchans;
+        dst += (frames - 1) * dstchans;
+        srcstep = -srcchans;
+        dststep = -dstchans;
+    }
+
+    for (i = 0; i < frames; i++, src += srcstep, dst += dststep) {
+        __m256 acc = _mm256_setzero_ps();
+        for (k = 0; k < num_columns; k++) {
+            const int c = columns[k];
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(matrix->tiled[c]), _mm256_broadcast_ss(src + c)));
+        }
+        _mm256_maskstore_ps(dst, mask, acc);
+    }
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+SDL_FORCE_INLINE void
+SDL_StoreChannels_NEON(float *dst, const float32x4_t samples, const int channels)
+{
+    switch (channels) {
+        case 4: vst1q_f32(dst, samples); break;
+        case 3: vst1_f32(dst, vget_low_f32(samples)); vst1q_lane_f32(dst + 2, samples, 2); break;
+        case 2: vst1_f32(dst, vget_low_f32(samples)); break;
+        default: vst1q_lane_f32(dst, samples, 0); break;
+    }
+}
+
+static void
+SDL_MixChannels_NEON(const SDL_AudioChannelMatrix *matrix, const float *src, float *dst, int frames)
+{
+    const int srcchans = matrix->src_channels;
+    const int dstchans = matrix->dst_channels;
+    const int num_columns = matrix->num_columns;
+    const Uint8 *columns = matrix->columns;
+    int srcstep = srcchans;
+    int dststep = dstchans;
+    int i, k;
+
+    if ((dstchans < srcchans) && ((dstchans == 1) || (dstchans == 2) || (dstchans == 4))) {
+        /* Several output frames fit in a vector, so mix 4 / dstchans frames at a time. */
+        const int vecframes = 4 / dstchans;
+        for (; frames >= vecframes; frames -= vecframes, src += vecframes * srcchans, dst += 4) {
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            for (k = 0; k < num_columns; k++) {
+                const int c = columns[k];
+                float32x4_t in;
+                if (dstchans == 1) {
+                    in = vdupq_n_f32(src[c]);
+                    in = vsetq_lane_f32(src[srcchans + c], in, 1);
+                    in = vsetq_lane_f32(src[(2 * srcchans) + c], in, 2);
+                    in = vsetq_lane_f32(src[(3 * srcchans) + c], in, 3);
+                } else if (dstchans == 2) {
+                    in = vcombine_f32(vdup_n_f32(src[c]), vdup_n_f32(src[srcchans + c]));
+                } else {
+                    in = vdupq_n_f32(src[c]);
+                }
+                acc = vaddq_f32(acc, vmulq_f32(vld1q_f32(matrix->tiled[c]), in));
+            }
+            vst1q_f32(dst, acc);
+        }
+    } else if (dstchans > srcchans) {
+        src += (frames - 1) * srcchans;
+        dst += (frames - 1) * dstchans;
+        srcstep = -srcchans;
+        dststep = -dstchans;
+    }
+
+    if (dstchans <= 4) {
+        for (i = 0; i < frames; i++, src += srcstep, dst += dststep) {
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            for (k = 0; k < num_columns; k++) {
+                const int c = columns[k];
+                acc = vaddq_f32(acc, vmulq_f32(vld1q_f32(matrix->tiled[c]), vdupq_n_f32(src[c])));
+            }
+            SDL_StoreChannels_NEON(dst, acc, dstchans);
+        }
+    } else {
+        for (i = 0; i < frames; i++, src += srcstep, dst += dststep) {
+            float32x4_t lo = vdupq_n_f32(0.0f);
+            float32x4_t hi = vdupq_n_f32(0.0f);
+            for (k = 0; k < num_columns; k++) {
+                const int c = columns[k];
+                const float32x4_t in = vdupq_n_f32(src[c]);
+                lo = vaddq_f32(lo, vmulq_f32(vld1q_f32(matrix->tiled[c]), in));
+                hi = vaddq_f32(hi, vmulq_f32(vld1q_f32(matrix->tiled[c] + 4), in));
+            }
+            vst1q_f32(dst, lo);
+            SDL_StoreChannels_NEON(dst + 4, hi, dstchans - 4);
+        }
+    }
+}
+#endif
+
+static void
+SDL_ChooseChannelMixer(void)
+{
+    SDL_MixChannelsFunc mixer = SDL_MixChannels_Scalar;
+    int i, j;
+
+    if (SDL_MixChannels) {
+        return;
+    }
+
+    for (i = 0; i < 8; i++) {
+        for (j = 0; j < 8; j++) {
+            SDL_InitAudioChannelMatrix(&default_channel_matrices[i][j], channel_matrices[i][j], i + 1, j + 1);
+        }
+    }
+
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        mixer = SDL_MixChannels_NEON;
+    }
+#endif
+#if HAVE_SSE_INTRINSICS
+    if (SDL_HasSSE()) {
+        mixer = SDL_MixChannels_SSE;
+    }
+#endif
+#if HAVE_AVX_INTRINSICS
+    if (SDL_HasAVX()) {
+        mixer = SDL_MixChannels_AVX;
+    }
+#endif
+
+    SDL_MixChannels = mixer;
+}
+
+static void SDLCALL
+SDL_ConvertChannels_Matrix(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const SDL_AudioChannelMatrix *matrix = (const SDL_AudioChannelMatrix *) (uintptr_t) cvt->filters[SDL_AUDIOCVT_MATRIX_SLOT];
+    const int frames = cvt->len_cvt / (int) (sizeof (float) * matrix->src_channels);
+
+    LOG_DEBUG_CONVERT("channels", "channels (using a mixing matrix)");
+    SDL_assert(format == AUDIO_F32SYS);
+
+    if (frames > 0) {
+        SDL_MixChannels(matrix, (const float *) cvt->buf, (float *) cvt->buf, frames);
+    }
+
+    cvt->len_cvt = frames * matrix->dst_channels * (int) sizeof (float);
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+
 
 /* SDL's resampler uses a "bandlimited interpolation" algorithm:
      https://ccrma.stanford.edu/~jos/resample/ */
@@ -253,6 +600,8 @@ SDL_ResampleAudio(const int chans, const int inrate, const int outrate,
     return outframes * chans * sizeof (float);
 }
 
+static int SDL_ConvertAudioInChunks(SDL_AudioCVT *cvt);
+
 int
 SDL_ConvertAudio(SDL_AudioCVT * cvt)
 {
@@ -271,8 +620,10 @@ SDL_ConvertAudio(SDL_AudioCVT * cvt)
     }
 
     /* Set up the conversion and go! */
-    cvt->filter_index = 0;
-    cvt->filters[0] (cvt, cvt->src_format);
+    if (SDL_ConvertAudioInChunks(cvt) < 0) {
+        cvt->filter_index = 0;
+        cvt->filters[0] (cvt, cvt->src_format);
+    }
     return 0;
 }
 
@@ -320,6 +671,10 @@ SDL_AddAudioCVTFilter(SDL_AudioCVT *cvt, const SDL_AudioFilter filter)
     if (cvt->filter_index >= SDL_AUDIOCVT_MAX_FILTERS) {
         return SDL_SetError("Too many filters needed for conversion, exceeded maximum of %d", SDL_AUDIOCVT_MAX_FILTERS);
     }
+    /* the NULL terminator can't land on a stashed mixing matrix. */
+    if ((cvt->filter_index >= (SDL_AUDIOCVT_MATRIX_SLOT - 1)) && (cvt->filters[SDL_AUDIOCVT_MATRIX_SLOT] != NULL)) {
+        return SDL_SetError("Too many filters needed for conversion, exceeded maximum of %d", SDL_AUDIOCVT_MATRIX_SLOT - 1);
+    }
     SDL_assert(filter != NULL);
     cvt->filters[cvt->filter_index++] = filter;
     cvt->filters[cvt->filter_index] = NULL; /* Moving terminator */
@@ -445,15 +800,15 @@ SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format
     SDL_assert(format == AUDIO_F32SYS);
 
     /* we keep no streaming state here, so pad with silence on both ends. */
-    padding = (float *) SDL_calloc(paddingsamples ? paddingsamples : 1, sizeof (float));
+    padding = (float *) SDL_AllocScratch((paddingsamples ? paddingsamples : 1) * sizeof (float));
     if (!padding) {
-        SDL_OutOfMemory();
         return;
     }
+    SDL_memset(padding, 0, (paddingsamples ? paddingsamples : 1) * sizeof (float));
 
     cvt->len_cvt = SDL_ResampleAudio(chans, inrate, outrate, padding, padding, src, srclen, dst, dstlen);
 
-    SDL_free(padding);
+    SDL_FreeScratch(padding);
 
     SDL_memmove(cvt->buf, dst, cvt->len_cvt);  /* !!! FIXME: remove this if we can get the resampler to work in-place again. */
 
@@ -493,6 +848,184 @@ ChooseCVTResampler(const int dst_channels)
     return NULL;
 }
 
+static SDL_bool
+SDL_IsResampleFilter(const SDL_AudioFilter filter)
+{
+    return ((filter == SDL_ResampleCVT_c1) || (filter == SDL_ResampleCVT_c2) ||
+            (filter == SDL_ResampleCVT_c4) || (filter == SDL_ResampleCVT_c6) ||
+            (filter == SDL_ResampleCVT_c8)) ? SDL_TRUE : SDL_FALSE;
+}
+
+/* Returns how many channels a frame has going into (filter), 1 if it works
+   sample by sample, or 0 if it isn't one of ours and might need to see the
+   whole buffer at once. */
+static int
+SDL_GetChunkableFilterChannels(const SDL_AudioCVT *cvt, const SDL_AudioFilter filter)
+{
+    size_t i, j;
+
+    if (filter == SDL_ConvertChannels_Matrix) {
+        return ((const SDL_AudioChannelMatrix *) (uintptr_t) cvt->filters[SDL_AUDIOCVT_MATRIX_SLOT])->src_channels;
+    }
+#if HAVE_SSE3_INTRINSICS
+    if (filter == SDL_ConvertStereoToMono_SSE3) {
+        return 2;
+    }
+#endif
+#if HAVE_SSE_INTRINSICS
+    if (filter == SDL_ConvertMonoToStereo_SSE) {
+        return 1;
+    }
+#endif
+    for (i = 0; i < SDL_arraysize(channel_converters); i++) {
+        for (j = 0; j < SDL_arraysize(channel_converters[i]); j++) {
+            if (filter == channel_converters[i][j]) {
+                return (int) i + 1;
+            }
+        }
+    }
+
+    if ((filter == SDL_Convert_Byteswap) ||
+        (filter == SDL_Convert_S8_to_F32) || (filter == SDL_Convert_U8_to_F32) ||
+        (filter == SDL_Convert_S16_to_F32) || (filter == SDL_Convert_U16_to_F32) ||
+        (filter == SDL_Convert_S32_to_F32) ||
+        (filter == SDL_Convert_F32_to_S8) || (filter == SDL_Convert_F32_to_U8) ||
+        (filter == SDL_Convert_F32_to_S16) || (filter == SDL_Convert_F32_to_U16) ||
+        (filter == SDL_Convert_F32_to_S32)) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/* Runs filters [first, last) of (cvt) over (len) bytes at (buf), returns how
+   many bytes they left there. */
+static int
+SDL_RunAudioCVTFilters(const SDL_AudioCVT *cvt, const int first, const int last,
+                       const SDL_AudioFormat format, Uint8 *buf, const int len)
+{
+    SDL_AudioCVT part;
+
+    SDL_memcpy(&part, cvt, sizeof (part));
+    part.buf = buf;
+    part.len_cvt = len;
+    part.filter_index = first;
+    if (last < SDL_AUDIOCVT_MAX_FILTERS) {
+        part.filters[last] = NULL;
+    }
+    part.filters[first](&part, format);
+    return part.len_cvt;
+}
+
+/* Runs filters [first, last) of (cvt) over the first (len) bytes of
+   cvt->buf, a few KB at a time so a chunk stays in cache while it goes
+   through every filter, instead of each filter sweeping the whole buffer.
+
+   Chunks are 16 sample frames of the widest layout they pass through, or a
+   multiple of that, so every filter sees the same runs of SIMD blocks and
+   scalar leftovers it would see converting the whole buffer (as long as
+   cvt->buf is 16 byte aligned): the output doesn't depend on the chunking.
+   Filters map whole frames to whole frames, so every full chunk grows or
+   shrinks by the same amount; growing output is written back to front so
+   it never lands on input that hasn't been read yet. */
+static int
+SDL_ConvertAudioFilterRange(const SDL_AudioCVT *cvt, const int first, const int last,
+                            const SDL_AudioFormat format, const int channels, const int len)
+{
+    const int unit = 16 * (SDL_AUDIO_BITSIZE(format) / 8) * channels;
+    const int chunk = (SDL_AUDIOCVT_CHUNK_BYTES / unit) * unit;
+    const int nchunks = (len + chunk - 1) / chunk;
+    const int scratchlen = chunk * cvt->len_mult;
+    Uint8 *scratch;
+    int chunkout, total, i;
+
+    if ((last - first) < 2 || len <= chunk) {
+        return SDL_RunAudioCVTFilters(cvt, first, last, format, cvt->buf, len);
+    }
+
+    scratch = (Uint8 *) SDL_AllocScratch(scratchlen * 2);
+    if (!scratch) {  /* fall back to sweeping the whole buffer in place. */
+        return SDL_RunAudioCVTFilters(cvt, first, last, format, cvt->buf, len);
+    }
+
+    /* the first chunk tells us which way to go. */
+    SDL_memcpy(scratch, cvt->buf, chunk);
+    chunkout = SDL_RunAudioCVTFilters(cvt, first, last, format, scratch, chunk);
+    total = chunkout;
+
+    if (chunkout <= chunk) {
+        SDL_memcpy(cvt->buf, scratch, chunkout);
+        for (i = 1; i < nchunks; i++) {
+            const int inlen = SDL_min(chunk, len - (i * chunk));
+            int outlen;
+            SDL_memcpy(scratch, cvt->buf + (i * chunk), inlen);
+            outlen = SDL_RunAudioCVTFilters(cvt, first, last, format, scratch, inlen);
+            SDL_memcpy(cvt->buf + total, scratch, outlen);
+            total += outlen;
+        }
+    } else {
+        /* keep the first chunk's output aside until its input is all that's left to overwrite. */
+        Uint8 *tail = scratch + scratchlen;
+        for (i = nchunks - 1; i > 0; i--) {
+            const int inlen = SDL_min(chunk, len - (i * chunk));
+            int outlen;
+            SDL_memcpy(tail, cvt->buf + (i * chunk), inlen);
+            outlen = SDL_RunAudioCVTFilters(cvt, first, last, format, tail, inlen);
+            SDL_memcpy(cvt->buf + (i * chunkout), tail, outlen);
+            total += outlen;
+        }
+        SDL_memcpy(cvt->buf, scratch, chunkout);
+    }
+
+    SDL_FreeScratch(scratch);
+    return total;
+}
+
+/* Runs the filter list of (cvt) chunk by chunk, splitting it around the
+   resampler, which needs to see the whole buffer. Returns -1 without
+   touching anything if there's a filter in there we don't know, so the
+   caller can run the list the classic way. */
+static int
+SDL_ConvertAudioInChunks(SDL_AudioCVT *cvt)
+{
+    int num_filters = 0;
+    int len = cvt->len;
+    int first, last;
+
+    while ((num_filters < SDL_AUDIOCVT_MAX_FILTERS) && cvt->filters[num_filters]) {
+        const SDL_AudioFilter filter = cvt->filters[num_filters];
+        if (!SDL_IsResampleFilter(filter) && !SDL_GetChunkableFilterChannels(cvt, filter)) {
+            return -1;
+        }
+        num_filters++;
+    }
+
+    if (num_filters < 2) {
+        return -1;  /* nothing to fuse. */
+    }
+
+    /* everything after the first filter gets handed float32 by the filter before it. */
+    for (first = 0; first < num_filters; first = last) {
+        const SDL_AudioFormat format = (first == 0) ? cvt->src_format : AUDIO_F32SYS;
+        int channels = 1;
+
+        if (SDL_IsResampleFilter(cvt->filters[first])) {
+            last = first + 1;
+            len = SDL_RunAudioCVTFilters(cvt, first, last, format, cvt->buf, len);
+            continue;
+        }
+
+        for (last = first; (last < num_filters) && !SDL_IsResampleFilter(cvt->filters[last]); last++) {
+            channels = SDL_max(channels, SDL_GetChunkableFilterChannels(cvt, cvt->filters[last]));
+        }
+        len = SDL_ConvertAudioFilterRange(cvt, first, last, format, channels, len);
+    }
+
+    cvt->len_cvt = len;
+    cvt->filter_index = num_filters;
+    return 0;
+}
+
 static int
 SDL_BuildAudioResampleCVT(SDL_AudioCVT * cvt, const int dst_channels,
                           const int src_rate, const int dst_rate)
@@ -571,12 +1104,14 @@ SDL_SupportedChannelCount(const int channels)
 /* Creates a set of audio filters to convert from one format to another.
    Returns 0 if no conversion is needed, 1 if the audio filter is set up,
    or -1 if an error like invalid parameter, unsupported format, etc. occurred.
+   A (matrix) replaces the default channel mapping, and must outlive (cvt).
 */
 
-int
-SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
-                  SDL_AudioFormat src_fmt, Uint8 src_channels, int src_rate,
-                  SDL_AudioFormat dst_fmt, Uint8 dst_channels, int dst_rate)
+static int
+SDL_BuildAudioCVTMatrix(SDL_AudioCVT * cvt,
+                        SDL_AudioFormat src_fmt, Uint8 src_channels, int src_rate,
+                        SDL_AudioFormat dst_fmt, Uint8 dst_channels, int dst_rate,
+                        const SDL_AudioChannelMatrix *matrix)
 {
     SDL_AudioFilter channel_converter = NULL;
 
@@ -630,6 +1165,9 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
 
     /* Make sure we've chosen audio conversion functions (SIMD, scalar, etc.) */
     SDL_ChooseAudioConverters();
+    SDL_ChooseChannelMixer();
+
+    SDL_assert(!matrix || ((matrix->src_channels == src_channels) && (matrix->dst_channels == dst_channels)));
 
     /* Type conversion goes like this now:
         - byteswap to CPU native format first if necessary.
@@ -646,7 +1184,7 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
        it was a bloat on SDL compile times and final library size. */
 
     /* see if we can skip float conversion entirely. */
-    if (src_rate == dst_rate && src_channels == dst_channels) {
+    if (src_rate == dst_rate && src_channels == dst_channels && !matrix) {
         if (src_fmt == dst_fmt) {
             return 0;
         }
@@ -680,26 +1218,38 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
     if ((channel_converter == NULL) != (src_channels == dst_channels)) {
         /* All combinations of supported channel counts should have been handled by now, but let's be defensive */
         return SDL_SetError("Invalid channel combination");
+    } else if (matrix != NULL) {
+        channel_converter = SDL_ConvertChannels_Matrix;
     } else if (channel_converter != NULL) {
         /* swap in some SIMD versions for a few of these. */
+        SDL_AudioFilter filter = NULL;
         if (channel_converter == SDL_ConvertStereoToMono) {
-            SDL_AudioFilter filter = NULL;
             #if HAVE_SSE3_INTRINSICS
             if (!filter && SDL_HasSSE3()) { filter = SDL_ConvertStereoToMono_SSE3; }
             #endif
-            if (filter) { channel_converter = filter; }
         } else if (channel_converter == SDL_ConvertMonoToStereo) {
-            SDL_AudioFilter filter = NULL;
             #if HAVE_SSE_INTRINSICS
             if (!filter && SDL_HasSSE()) { filter = SDL_ConvertMonoToStereo_SSE; }
             #endif
-            if (filter) { channel_converter = filter; }
         }
+        /* the rest go through the mixing matrix, if it has SIMD versions here. */
+        if (!filter && SDL_MixChannels != SDL_MixChannels_Scalar) {
+            matrix = &default_channel_matrices[src_channels-1][dst_channels-1];
+            filter = SDL_ConvertChannels_Matrix;
+        }
+        if (filter) { channel_converter = filter; }
+    }
 
+    if (channel_converter != NULL) {
         if (SDL_AddAudioCVTFilter(cvt, channel_converter) < 0) {
             return -1;
         }
 
+        if (channel_converter == SDL_ConvertChannels_Matrix) {
+            SDL_assert(cvt->filter_index < (SDL_AUDIOCVT_MATRIX_SLOT - 1));
+            cvt->filters[SDL_AUDIOCVT_MATRIX_SLOT] = (SDL_AudioFilter) (uintptr_t) matrix;
+        }
+
         if (src_channels < dst_channels) {
             cvt->len_mult = ((cvt->len_mult * dst_channels) + (src_channels-1)) / src_channels;
         }
@@ -722,6 +1272,14 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
     return (cvt->needed);
 }
 
+int
+SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
+                  SDL_AudioFormat src_fmt, Uint8 src_channels, int src_rate,
+                  SDL_AudioFormat dst_fmt, Uint8 dst_channels, int dst_rate)
+{
+    return SDL_BuildAudioCVTMatrix(cvt, src_fmt, src_channels, src_rate, dst_fmt, dst_channels, dst_rate, NULL);
+}
+
 typedef int (*SDL_ResampleAudioStreamFunc)(SDL_AudioStream *stream, const void *inbuf, const int inbuflen, void *outbuf, const int outbuflen);
 typedef void (*SDL_ResetAudioStreamResamplerFunc)(SDL_AudioStream *stream);
 typedef void (*SDL_CleanupAudioStreamResamplerFunc)(SDL_AudioStream *stream);
@@ -754,6 +1312,7 @@ struct _SDL_AudioStream
     SDL_ResampleAudioStreamFunc resampler_func;
     SDL_ResetAudioStreamResamplerFunc reset_resampler_func;
     SDL_CleanupAudioStreamResamplerFunc cleanup_resampler_func;
+    SDL_AudioChannelMatrix *channel_matrix;
 };
 
 static Uint8 *
@@ -901,6 +1460,33 @@ SDL_CleanupAudioStreamResampler(SDL_AudioStream *stream)
     SDL_free(stream->resampler_state);
 }
 
+static int
+SDL_BuildAudioStreamCVTs(SDL_AudioStream *stream)
+{
+    const SDL_AudioChannelMatrix *matrix = stream->channel_matrix;
+
+    /* Not resampling? It's an easy conversion (and maybe not even that!) */
+    if (stream->src_rate == stream->dst_rate) {
+        stream->cvt_before_resampling.needed = SDL_FALSE;
+        return SDL_BuildAudioCVTMatrix(&stream->cvt_after_resampling, stream->src_format, stream->src_channels, stream->dst_rate,
+                                       stream->dst_format, stream->dst_channels, stream->dst_rate, matrix);
+    }
+
+    /* Don't resample at first. Just get us to Float32 format. */
+    /* !!! FIXME: convert to int32 on devices without hardware float. */
+    /* A custom mixing matrix goes wherever the channel count changes. */
+    if (SDL_BuildAudioCVTMatrix(&stream->cvt_before_resampling, stream->src_format, stream->src_channels, stream->src_rate,
+                                AUDIO_F32SYS, stream->pre_resample_channels, stream->src_rate,
+                                (stream->pre_resample_channels == stream->dst_channels) ? matrix : NULL) < 0) {
+        return -1;
+    }
+
+    /* Convert us to the final format after resampling. */
+    return SDL_BuildAudioCVTMatrix(&stream->cvt_after_resampling, AUDIO_F32SYS, stream->pre_resample_channels, stream->dst_rate,
+                                   stream->dst_format, stream->dst_channels, stream->dst_rate,
+                                   (stream->pre_resample_channels != stream->dst_channels) ? matrix : NULL);
+}
+
 SDL_AudioStream *
 SDL_NewAudioStream(const SDL_AudioFormat src_format,
                    const Uint8 src_channels,
@@ -956,21 +1542,12 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
         }
     }
 
-    /* Not resampling? It's an easy conversion (and maybe not even that!) */
-    if (src_rate == dst_rate) {
-        retval->cvt_before_resampling.needed = SDL_FALSE;
-        if (SDL_BuildAudioCVT(&retval->cvt_after_resampling, src_format, src_channels, dst_rate, dst_format, dst_channels, dst_rate) < 0) {
-            SDL_FreeAudioStream(retval);
-            return NULL;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
-        }
-    } else {
-        /* Don't resample at first. Just get us to Float32 format. */
-        /* !!! FIXME: convert to int32 on devices without hardware float. */
-        if (SDL_BuildAudioCVT(&retval->cvt_before_resampling, src_format, src_channels, src_rate, AUDIO_F32SYS, pre_resample_channels, src_rate) < 0) {
-            SDL_FreeAudioStream(retval);
-            return NULL;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
-        }
+    if (SDL_BuildAudioStreamCVTs(retval) < 0) {
+        SDL_FreeAudioStream(retval);
+        return NULL;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
+    }
 
+    if (src_rate != dst_rate) {
 #ifdef HAVE_LIBSAMPLERATE_H
         SetupLibSampleRateResampling(retval);
 #endif
@@ -987,12 +1564,6 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
             retval->reset_resampler_func = SDL_ResetAudioStreamResampler;
             retval->cleanup_resampler_func = SDL_CleanupAudioStreamResampler;
         }
-
-        /* Convert us to the final format after resampling. */
-        if (SDL_BuildAudioCVT(&retval->cvt_after_resampling, AUDIO_F32SYS, pre_resample_channels, dst_rate, dst_format, dst_channels, dst_rate) < 0) {
-            SDL_FreeAudioStream(retval);
-            return NULL;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
-        }
     }
 
     retval->queue = SDL_NewDataQueue(packetlen, packetlen * 2);
@@ -1311,8 +1882,41 @@ SDL_FreeAudioStream(SDL_AudioStream *stream)
         SDL_free(stream->staging_buffer);
         SDL_free(stream->work_buffer_base);
         SDL_free(stream->resampler_padding);
+        SDL_free(stream->channel_matrix);
         SDL_free(stream);
     }
 }
 
+int
+SDL_AudioStreamSetChannelMatrix(SDL_AudioStream *stream, const float *matrix)
+{
+    SDL_AudioChannelMatrix *channel_matrix = NULL;
+    SDL_AudioChannelMatrix *prev;
+
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    }
+
+    if (matrix) {
+        channel_matrix = (SDL_AudioChannelMatrix *) SDL_malloc(sizeof (*channel_matrix));
+        if (!channel_matrix) {
+            return SDL_OutOfMemory();
+        }
+        SDL_InitAudioChannelMatrix(channel_matrix, matrix, stream->src_channels, stream->dst_channels);
+    }
+
+    /* data already put in the stream has been converted, so this only changes what comes next. */
+    prev = stream->channel_matrix;
+    stream->channel_matrix = channel_matrix;
+    if (SDL_BuildAudioStreamCVTs(stream) < 0) {
+        stream->channel_matrix = prev;
+        SDL_BuildAudioStreamCVTs(stream);
+        SDL_free(channel_matrix);
+        return -1;
+    }
+
+    SDL_free(prev);
+    return 0;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
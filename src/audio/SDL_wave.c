@@ -37,6 +37,7 @@
 #include "SDL_audio.h"
 #include "SDL_wave.h"
 #include "SDL_audio_c.h"
+#include "../SDL_parallel_c.h"
 
 /* Reads the value stored at the location of the f1 pointer, multiplies it
  * with the second argument and then stores the result to f1.
@@ -636,6 +637,104 @@ MS_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
     return 0;
 }
 
+/* Every ADPCM block starts from the state in its header, so whole blocks can
+ * be decoded independently. This decodes the complete blocks at the start of
+ * the data on the worker threads, each one straight to its place in the
+ * output, and leaves the rest (the last, possibly truncated block and any
+ * frames cut off by the fact chunk) to the serial loop of the decoder.
+ */
+#define ADPCM_PARALLEL_MIN_BLOCKS   64  /* Fewer blocks than this are decoded serially. */
+#define ADPCM_PARALLEL_TASK_BLOCKS  32  /* Blocks decoded at least by each task. */
+
+typedef int (*ADPCM_DecodeBlockFunc)(ADPCM_DecoderState *state);
+
+typedef struct ADPCM_ParallelDecoder
+{
+    const ADPCM_DecoderState *state;
+    ADPCM_DecodeBlockFunc decodeblock;
+    size_t cstatesize;
+    size_t blocks;
+    size_t taskblocks;
+    SDL_atomic_t failed;
+} ADPCM_ParallelDecoder;
+
+static void
+ADPCM_DecodeBlockRange(void *data, int task)
+{
+    ADPCM_ParallelDecoder *decoder = (ADPCM_ParallelDecoder *)data;
+    ADPCM_DecoderState state = *decoder->state;
+    size_t block = (size_t)task * decoder->taskblocks;
+    const size_t end = SDL_min(block + decoder->taskblocks, decoder->blocks);
+
+    state.cstate = SDL_AllocScratch(decoder->cstatesize);
+    if (state.cstate == NULL) {
+        SDL_AtomicSet(&decoder->failed, 1);
+        return;
+    }
+    SDL_memset(state.cstate, 0, decoder->cstatesize);
+
+    for (; block < end; block++) {
+        state.block.data = state.input.data + block * state.blocksize;
+        state.block.size = state.blocksize;
+        state.block.pos = 0;
+        state.output.pos = block * state.samplesperblock * state.channels;
+        state.framesleft = state.samplesperblock;
+        if (decoder->decodeblock(&state) == -1) {
+            SDL_AtomicSet(&decoder->failed, 1);
+            break;
+        }
+    }
+
+    SDL_FreeScratch(state.cstate);
+}
+
+/* Decodes the complete blocks in parallel if there are enough of them and
+ * more than one thread was asked for, and advances the state past them. If
+ * anything goes wrong, the state is left alone and the serial loop decodes
+ * everything again, reporting the error as it always has.
+ */
+static void
+ADPCM_DecodeBlocksParallel(WaveFile *file, ADPCM_DecoderState *state, ADPCM_DecodeBlockFunc decodeblock, size_t cstatesize)
+{
+    ADPCM_ParallelDecoder decoder;
+    size_t blocks = state->input.size / state->blocksize;
+    size_t tasks;
+
+    if ((Uint64)blocks * state->samplesperblock > (Uint64)state->framestotal) {
+        blocks = (size_t)(state->framestotal / state->samplesperblock);
+    }
+    if (file->decodethreads <= 1 || blocks < ADPCM_PARALLEL_MIN_BLOCKS) {
+        return;
+    }
+
+    SDL_zero(decoder);
+    decoder.state = state;
+    decoder.decodeblock = decodeblock;
+    decoder.cstatesize = cstatesize;
+    decoder.blocks = blocks;
+    /* A few tasks per thread to even out the load. */
+    decoder.taskblocks = SDL_max(blocks / ((size_t)file->decodethreads * 4), ADPCM_PARALLEL_TASK_BLOCKS);
+    tasks = (blocks + decoder.taskblocks - 1) / decoder.taskblocks;
+
+    SDL_ParallelFor((int)tasks, file->decodethreads, ADPCM_DecodeBlockRange, &decoder);
+    if (SDL_AtomicGet(&decoder.failed)) {
+        return;
+    }
+
+    state->input.pos = blocks * state->blocksize;
+    state->output.pos = blocks * state->samplesperblock * state->channels;
+    state->framesleft -= (Sint64)(blocks * state->samplesperblock);
+}
+
+static int
+MS_ADPCM_DecodeBlock(ADPCM_DecoderState *state)
+{
+    if (MS_ADPCM_DecodeBlockHeader(state) == -1) {
+        return -1;
+    }
+    return MS_ADPCM_DecodeBlockData(state);
+}
+
 static int
 MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 {
@@ -692,6 +791,8 @@ MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 
     state.cstate = cstate;
 
+    ADPCM_DecodeBlocksParallel(file, &state, MS_ADPCM_DecodeBlock, sizeof(cstate));
+
     /* Decode block by block. A truncated block will stop the decoding. */
     bytesleft = state.input.size - state.input.pos;
     while (state.framesleft > 0 && bytesleft >= state.blockheadersize) {
@@ -1032,6 +1133,15 @@ IMA_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
     return retval;
 }
 
+static int
+IMA_ADPCM_DecodeBlock(ADPCM_DecoderState *state)
+{
+    if (IMA_ADPCM_DecodeBlockHeader(state) == -1) {
+        return -1;
+    }
+    return IMA_ADPCM_DecodeBlockData(state);
+}
+
 static int
 IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 {
@@ -1090,6 +1200,8 @@ IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     }
     state.cstate = cstate;
 
+    ADPCM_DecodeBlocksParallel(file, &state, IMA_ADPCM_DecodeBlock, state.channels * sizeof(Sint8));
+
     /* Decode block by block. A truncated block will stop the decoding. */
     bytesleft = state.input.size - state.input.pos;
     while (state.framesleft > 0 && bytesleft >= state.blockheadersize) {
@@ -1165,95 +1277,62 @@ LAW_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
-static int
-LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
-{
-#ifdef SDL_WAVE_LAW_LUT
-    const Sint16 alaw_lut[256] = {
-        -5504, -5248, -6016, -5760, -4480, -4224, -4992, -4736, -7552, -7296, -8064, -7808, -6528, -6272, -7040, -6784, -2752,
-        -2624, -3008, -2880, -2240, -2112, -2496, -2368, -3776, -3648, -4032, -3904, -3264, -3136, -3520, -3392, -22016,
-        -20992, -24064, -23040, -17920, -16896, -19968, -18944, -30208, -29184, -32256, -31232, -26112, -25088, -28160, -27136, -11008,
-        -10496, -12032, -11520, -8960, -8448, -9984, -9472, -15104, -14592, -16128, -15616, -13056, -12544, -14080, -13568, -344,
-        -328, -376, -360, -280, -264, -312, -296, -472, -456, -504, -488, -408, -392, -440, -424, -88,
-        -72, -120, -104, -24, -8, -56, -40, -216, -200, -248, -232, -152, -136, -184, -168, -1376,
-        -1312, -1504, -1440, -1120, -1056, -1248, -1184, -1888, -1824, -2016, -1952, -1632, -1568, -1760, -1696, -688,
-        -656, -752, -720, -560, -528, -624, -592, -944, -912, -1008, -976, -816, -784, -880, -848, 5504,
-        5248, 6016, 5760, 4480, 4224, 4992, 4736, 7552, 7296, 8064, 7808, 6528, 6272, 7040, 6784, 2752,
-        2624, 3008, 2880, 2240, 2112, 2496, 2368, 3776, 3648, 4032, 3904, 3264, 3136, 3520, 3392, 22016,
-        20992, 24064, 23040, 17920, 16896, 19968, 18944, 30208, 29184, 32256, 31232, 26112, 25088, 28160, 27136, 11008,
-        10496, 12032, 11520, 8960, 8448, 9984, 9472, 15104, 14592, 16128, 15616, 13056, 12544, 14080, 13568, 344,
-        328, 376, 360, 280, 264, 312, 296, 472, 456, 504, 488, 408, 392, 440, 424, 88,
-        72, 120, 104, 24, 8, 56, 40, 216, 200, 248, 232, 152, 136, 184, 168, 1376,
-        1312, 1504, 1440, 1120, 1056, 1248, 1184, 1888, 1824, 2016, 1952, 1632, 1568, 1760, 1696, 688,
-        656, 752, 720, 560, 528, 624, 592, 944, 912, 1008, 976, 816, 784, 880, 848
-    };
-    const Sint16 mulaw_lut[256] = {
-        -32124, -31100, -30076, -29052, -28028, -27004, -25980, -24956, -23932, -22908, -21884, -20860, -19836, -18812, -17788, -16764, -15996,
-        -15484, -14972, -14460, -13948, -13436, -12924, -12412, -11900, -11388, -10876, -10364, -9852, -9340, -8828, -8316, -7932,
-        -7676, -7420, -7164, -6908, -6652, -6396, -6140, -5884, -5628, -5372, -5116, -4860, -4604, -4348, -4092, -3900,
-        -3772, -3644, -3516, -3388, -3260, -3132, -3004, -2876, -2748, -2620, -2492, -2364, -2236, -2108, -1980, -1884,
-        -1820, -1756, -1692, -1628, -1564, -1500, -1436, -1372, -1308, -1244, -1180, -1116, -1052, -988, -924, -876,
-        -844, -812, -780, -748, -716, -684, -652, -620, -588, -556, -524, -492, -460, -428, -396, -372,
-        -356, -340, -324, -308, -292, -276, -260, -244, -228, -212, -196, -180, -164, -148, -132, -120,
-        -112, -104, -96, -88, -80, -72, -64, -56, -48, -40, -32, -24, -16, -8, 0, 32124,
-        31100, 30076, 29052, 28028, 27004, 25980, 24956, 23932, 22908, 21884, 20860, 19836, 18812, 17788, 16764, 15996,
-        15484, 14972, 14460, 13948, 13436, 12924, 12412, 11900, 11388, 10876, 10364, 9852, 9340, 8828, 8316, 7932,
-        7676, 7420, 7164, 6908, 6652, 6396, 6140, 5884, 5628, 5372, 5116, 4860, 4604, 4348, 4092, 3900,
-        3772, 3644, 3516, 3388, 3260, 3132, 3004, 2876, 2748, 2620, 2492, 2364, 2236, 2108, 1980, 1884,
-        1820, 1756, 1692, 1628, 1564, 1500, 1436, 1372, 1308, 1244, 1180, 1116, 1052, 988, 924, 876,
-        844, 812, 780, 748, 716, 684, 652, 620, 588, 556, 524, 492, 460, 428, 396, 372,
-        356, 340, 324, 308, 292, 276, 260, 244, 228, 212, 196, 180, 164, 148, 132, 120,
-        112, 104, 96, 88, 80, 72, 64, 56, 48, 40, 32, 24, 16, 8, 0
-    };
+/* Expanding a companded sample through a table is faster than computing it,
+ * so that is the default. Define SDL_WAVE_LAW_NO_LUT to use the formulas.
+ */
+#if !defined(SDL_WAVE_LAW_LUT) && !defined(SDL_WAVE_LAW_NO_LUT)
+#define SDL_WAVE_LAW_LUT 1
 #endif
 
-    WaveFormat *format = &file->format;
-    WaveChunk *chunk = &file->chunk;
-    size_t i, sample_count, expanded_len;
-    Uint8 *src;
-    Sint16 *dst;
-
-    if (chunk->length != chunk->size) {
-        file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
-        if (file->sampleframes < 0) {
-            return -1;
-        }
-    }
-
-    /* Nothing to decode, nothing to return. */
-    if (file->sampleframes == 0) {
-        *audio_buf = NULL;
-        *audio_len = 0;
-        return 0;
-    }
-
-    sample_count = (size_t)file->sampleframes;
-    if (SafeMult(&sample_count, format->channels)) {
-        return SDL_OutOfMemory();
-    }
-
-    expanded_len = sample_count;
-    if (SafeMult(&expanded_len, sizeof(Sint16))) {
-        return SDL_OutOfMemory();
-    } else if (expanded_len > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
-        return SDL_SetError("WAVE file too big");
-    }
+#ifdef SDL_WAVE_LAW_LUT
+static const Sint16 alaw_lut[256] = {
+    -5504, -5248, -6016, -5760, -4480, -4224, -4992, -4736, -7552, -7296, -8064, -7808, -6528, -6272, -7040, -6784, -2752,
+    -2624, -3008, -2880, -2240, -2112, -2496, -2368, -3776, -3648, -4032, -3904, -3264, -3136, -3520, -3392, -22016,
+    -20992, -24064, -23040, -17920, -16896, -19968, -18944, -30208, -29184, -32256, -31232, -26112, -25088, -28160, -27136, -11008,
+    -10496, -12032, -11520, -8960, -8448, -9984, -9472, -15104, -14592, -16128, -15616, -13056, -12544, -14080, -13568, -344,
+    -328, -376, -360, -280, -264, -312, -296, -472, -456, -504, -488, -408, -392, -440, -424, -88,
+    -72, -120, -104, -24, -8, -56, -40, -216, -200, -248, -232, -152, -136, -184, -168, -1376,
+    -1312, -1504, -1440, -1120, -1056, -1248, -1184, -1888, -1824, -2016, -1952, -1632, -1568, -1760, -1696, -688,
+    -656, -752, -720, -560, -528, -624, -592, -944, -912, -1008, -976, -816, -784, -880, -848, 5504,
+    5248, 6016, 5760, 4480, 4224, 4992, 4736, 7552, 7296, 8064, 7808, 6528, 6272, 7040, 6784, 2752,
+    2624, 3008, 2880, 2240, 2112, 2496, 2368, 3776, 3648, 4032, 3904, 3264, 3136, 3520, 3392, 22016,
+    20992, 24064, 23040, 17920, 16896, 19968, 18944, 30208, 29184, 32256, 31232, 26112, 25088, 28160, 27136, 11008,
+    10496, 12032, 11520, 8960, 8448, 9984, 9472, 15104, 14592, 16128, 15616, 13056, 12544, 14080, 13568, 344,
+    328, 376, 360, 280, 264, 312, 296, 472, 456, 504, 488, 408, 392, 440, 424, 88,
+    72, 120, 104, 24, 8, 56, 40, 216, 200, 248, 232, 152, 136, 184, 168, 1376,
+    1312, 1504, 1440, 1120, 1056, 1248, 1184, 1888, 1824, 2016, 1952, 1632, 1568, 1760, 1696, 688,
+    656, 752, 720, 560, 528, 624, 592, 944, 912, 1008, 976, 816, 784, 880, 848
+};
 
-    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
-    src = (Uint8 *)SDL_realloc(chunk->data, expanded_len ? expanded_len : 1);
-    if (src == NULL) {
-        return SDL_OutOfMemory();
-    }
-    chunk->data = NULL;
-    chunk->size = 0;
+static const Sint16 mulaw_lut[256] = {
+    -32124, -31100, -30076, -29052, -28028, -27004, -25980, -24956, -23932, -22908, -21884, -20860, -19836, -18812, -17788, -16764, -15996,
+    -15484, -14972, -14460, -13948, -13436, -12924, -12412, -11900, -11388, -10876, -10364, -9852, -9340, -8828, -8316, -7932,
+    -7676, -7420, -7164, -6908, -6652, -6396, -6140, -5884, -5628, -5372, -5116, -4860, -4604, -4348, -4092, -3900,
+    -3772, -3644, -3516, -3388, -3260, -3132, -3004, -2876, -2748, -2620, -2492, -2364, -2236, -2108, -1980, -1884,
+    -1820, -1756, -1692, -1628, -1564, -1500, -1436, -1372, -1308, -1244, -1180, -1116, -1052, -988, -924, -876,
+    -844, -812, -780, -748, -716, -684, -652, -620, -588, -556, -524, -492, -460, -428, -396, -372,
+    -356, -340, -324, -308, -292, -276, -260, -244, -228, -212, -196, -180, -164, -148, -132, -120,
+    -112, -104, -96, -88, -80, -72, -64, -56, -48, -40, -32, -24, -16, -8, 0, 32124,
+    31100, 30076, 29052, 28028, 27004, 25980, 24956, 23932, 22908, 21884, 20860, 19836, 18812, 17788, 16764, 15996,
+    15484, 14972, 14460, 13948, 13436, 12924, 12412, 11900, 11388, 10876, 10364, 9852, 9340, 8828, 8316, 7932,
+    7676, 7420, 7164, 6908, 6652, 6396, 6140, 5884, 5628, 5372, 5116, 4860, 4604, 4348, 4092, 3900,
+    3772, 3644, 3516, 3388, 3260, 3132, 3004, 2876, 2748, 2620, 2492, 2364, 2236, 2108, 1980, 1884,
+    1820, 1756, 1692, 1628, 1564, 1500, 1436, 1372, 1308, 1244, 1180, 1116, 1052, 988, 924, 876,
+    844, 812, 780, 748, 716, 684, 652, 620, 588, 556, 524, 492, 460, 428, 396, 372,
+    356, 340, 324, 308, 292, 276, 260, 244, 228, 212, 196, 180, 164, 148, 132, 120,
+    112, 104, 96, 88, 80, 72, 64, 56, 48, 40, 32, 24, 16, 8, 0
+};
+#endif
 
-    dst = (Sint16 *)src;
+/* Expands count companded samples from src to dst. Works backwards, so dst
+ * may start at the same address as src.
+ */
+static int
+LAW_Expand(Uint16 encoding, Sint16 *dst, const Uint8 *src, size_t count)
+{
+    size_t i = count;
 
-    /* Work backwards, since we're expanding in-place. SDL_AudioSpec.format will
-     * inform the caller about the byte order.
-     */
-    i = sample_count;
-    switch (file->format.encoding) {
+    switch (encoding) {
 #ifdef SDL_WAVE_LAW_LUT
     case ALAW_CODE:
         while (i--) {
@@ -1298,10 +1377,63 @@ LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
         break;
 #endif
     default:
-        SDL_free(src);
         return SDL_SetError("Unknown companded encoding");
     }
 
+    return 0;
+}
+
+static int
+LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+    size_t sample_count, expanded_len;
+    Uint8 *src;
+    Sint16 *dst;
+
+    if (chunk->length != chunk->size) {
+        file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
+        if (file->sampleframes < 0) {
+            return -1;
+        }
+    }
+
+    /* Nothing to decode, nothing to return. */
+    if (file->sampleframes == 0) {
+        *audio_buf = NULL;
+        *audio_len = 0;
+        return 0;
+    }
+
+    sample_count = (size_t)file->sampleframes;
+    if (SafeMult(&sample_count, format->channels)) {
+        return SDL_OutOfMemory();
+    }
+
+    expanded_len = sample_count;
+    if (SafeMult(&expanded_len, sizeof(Sint16))) {
+        return SDL_OutOfMemory();
+    } else if (expanded_len > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
+        return SDL_SetError("WAVE file too big");
+    }
+
+    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
+    src = (Uint8 *)SDL_realloc(chunk->data, expanded_len ? expanded_len : 1);
+    if (src == NULL) {
+        return SDL_OutOfMemory();
+    }
+    chunk->data = NULL;
+    chunk->size = 0;
+
+    dst = (Sint16 *)src;
+
+    /* SDL_AudioSpec.format will inform the caller about the byte order. */
+    if (LAW_Expand(file->format.encoding, dst, src, sample_count) < 0) {
+        SDL_free(src);
+        return -1;
+    }
+
     *audio_buf = src;
     *audio_len = (Uint32)expanded_len;
 
@@ -1352,12 +1484,35 @@ PCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Shifts sample_count 24-bit samples to 32 bits in place. */
+static void
+PCM_ExpandSint24ToSint32(Uint8 *ptr, size_t sample_count)
+{
+    size_t i;
+
+    /* work from end to start, since we're expanding in-place. */
+    for (i = sample_count; i > 0; i--) {
+        const size_t o = i - 1;
+        uint8_t b[4];
+
+        b[0] = 0;
+        b[1] = ptr[o * 3];
+        b[2] = ptr[o * 3 + 1];
+        b[3] = ptr[o * 3 + 2];
+
+        ptr[o * 4 + 0] = b[0];
+        ptr[o * 4 + 1] = b[1];
+        ptr[o * 4 + 2] = b[2];
+        ptr[o * 4 + 3] = b[3];
+    }
+}
+
 static int
 PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 {
     WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
-    size_t i, expanded_len, sample_count;
+    size_t expanded_len, sample_count;
     Uint8 *ptr;
 
     sample_count = (size_t)file->sampleframes;
@@ -1385,21 +1540,7 @@ PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     *audio_buf = ptr;
     *audio_len = (Uint32)expanded_len;
 
-    /* work from end to start, since we're expanding in-place. */
-    for (i = sample_count; i > 0; i--) {
-        const size_t o = i - 1;
-        uint8_t b[4];
-
-        b[0] = 0;
-        b[1] = ptr[o * 3];
-        b[2] = ptr[o * 3 + 1];
-        b[3] = ptr[o * 3 + 2];
-
-        ptr[o * 4 + 0] = b[0];
-        ptr[o * 4 + 1] = b[1];
-        ptr[o * 4 + 2] = b[2];
-        ptr[o * 4 + 3] = b[3];
-    }
+    PCM_ExpandSint24ToSint32(ptr, sample_count);
 
     return 0;
 }
@@ -1783,8 +1924,12 @@ WaveCheckFormat(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Reads the RIFF structure and the format of the WAVE file, leaving the data
+ * chunk, unread, in file->chunk. endposition receives the position after the
+ * end of the file.
+ */
 static int
-WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+WaveReadHeaders(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Sint64 *endposition)
 {
     int result;
     Uint32 chunkcount = 0;
@@ -1997,9 +2142,71 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
 
     WaveFreeChunkData(chunk);
 
-    /* Process data chunk. */
+    /* The data chunk is read by the caller. */
     *chunk = datachunk;
 
+    /* Setting up the SDL_AudioSpec. All unsupported formats were filtered out
+     * by the format checks.
+     */
+    SDL_zerop(spec);
+    spec->freq = format->frequency;
+    spec->channels = (Uint8)format->channels;
+    spec->samples = 4096;       /* Good default buffer size */
+
+    switch (format->encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+    case ALAW_CODE:
+    case MULAW_CODE:
+        /* These can be easily stored in the byte order of the system. */
+        spec->format = AUDIO_S16SYS;
+        break;
+    case IEEE_FLOAT_CODE:
+        spec->format = AUDIO_F32LSB;
+        break;
+    case PCM_CODE:
+        switch (format->bitspersample) {
+        case 8:
+            spec->format = AUDIO_U8;
+            break;
+        case 16:
+            spec->format = AUDIO_S16LSB;
+            break;
+        case 24: /* Has been shifted to 32 bits. */
+        case 32:
+            spec->format = AUDIO_S32LSB;
+            break;
+        default:
+            /* Just in case something unexpected happened in the checks. */
+            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
+        }
+        break;
+    }
+
+    spec->silence = SDL_SilenceValueForFormat(spec->format);
+
+    if (RIFFlengthknown) {
+        *endposition = RIFFend;
+    } else {
+        *endposition = lastchunkpos;
+    }
+
+    return 0;
+}
+
+static int
+WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    int result;
+    Sint64 endposition;
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+
+    if (WaveReadHeaders(src, file, spec, &endposition) < 0) {
+        return -1;
+    }
+
+    /* Process data chunk. */
     if (chunk->length > 0) {
         result = WaveReadChunkData(src, chunk);
         if (result == -1) {
@@ -2043,52 +2250,8 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
         break;
     }
 
-    /* Setting up the SDL_AudioSpec. All unsupported formats were filtered out
-     * by checks earlier in this function.
-     */
-    SDL_zerop(spec);
-    spec->freq = format->frequency;
-    spec->channels = (Uint8)format->channels;
-    spec->samples = 4096;       /* Good default buffer size */
-
-    switch (format->encoding) {
-    case MS_ADPCM_CODE:
-    case IMA_ADPCM_CODE:
-    case ALAW_CODE:
-    case MULAW_CODE:
-        /* These can be easily stored in the byte order of the system. */
-        spec->format = AUDIO_S16SYS;
-        break;
-    case IEEE_FLOAT_CODE:
-        spec->format = AUDIO_F32LSB;
-        break;
-    case PCM_CODE:
-        switch (format->bitspersample) {
-        case 8:
-            spec->format = AUDIO_U8;
-            break;
-        case 16:
-            spec->format = AUDIO_S16LSB;
-            break;
-        case 24: /* Has been shifted to 32 bits. */
-        case 32:
-            spec->format = AUDIO_S32LSB;
-            break;
-        default:
-            /* Just in case something unexpected happened in the checks. */
-            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
-        }
-        break;
-    }
-
-    spec->silence = SDL_SilenceValueForFormat(spec->format);
-
     /* Report the end position back to the cleanup code. */
-    if (RIFFlengthknown) {
-        chunk->position = RIFFend;
-    } else {
-        chunk->position = lastchunkpos;
-    }
+    chunk->position = endposition;
 
     return 0;
 }
@@ -2122,6 +2285,7 @@ SDL_LoadWAV_RW(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec, Uint8 **audio_b
     file.riffhint = WaveGetRiffSizeHint();
     file.trunchint = WaveGetTruncationHint();
     file.facthint = WaveGetFactChunkHint();
+    file.decodethreads = SDL_GetParallelThreadsHint(SDL_HINT_WAVE_DECODE_THREADS);
 
     result = WaveLoad(src, &file, spec, audio_buf, audio_len);
     if (result < 0) {
@@ -2152,4 +2316,403 @@ SDL_FreeWAV(Uint8 *audio_buf)
     SDL_free(audio_buf);
 }
 
+/* A WAVE file that is decoded a few sample frames at a time. Uncompressed and
+ * companded data is read straight into the caller's buffer, ADPCM data is
+ * decoded one block at a time.
+ */
+struct _SDL_WAVStream
+{
+    SDL_RWops *src;
+    int freesrc;
+    WaveFile file;
+    size_t datasize;        /* Bytes of the data chunk that are in the file. */
+    size_t framesize;       /* Bytes per decoded sample frame. */
+    Sint64 frame;           /* The next sample frame to decode. */
+
+    /* For the ADPCM formats. The output of the decoder state holds the
+     * decoded frames of the current block.
+     */
+    ADPCM_DecoderState state;
+    ADPCM_DecodeBlockFunc decodeheader;
+    ADPCM_DecodeBlockFunc decodedata;
+    Uint8 *block;           /* The compressed data of the current block. */
+    Sint64 blockindex;      /* The decoded block, or -1. */
+    Uint32 blockframes;     /* Sample frames that could be decoded from it. */
+};
+
+/* Decoding this many sample frames at a time keeps the buffer of
+ * SDL_WAVStreamPut() small.
+ */
+#define WAVSTREAM_PUT_FRAMES 4096
+
+static int
+WaveStreamCalculateSampleFrames(WaveFile *file, size_t datalength)
+{
+    switch (file->format.encoding) {
+    case MS_ADPCM_CODE:
+        return MS_ADPCM_CalculateSampleFrames(file, datalength);
+    case IMA_ADPCM_CODE:
+        return IMA_ADPCM_CalculateSampleFrames(file, datalength);
+    default:
+        file->sampleframes = WaveAdjustToFactValue(file, datalength / file->format.blockalign);
+        return file->sampleframes < 0 ? -1 : 0;
+    }
+}
+
+static int
+WaveStreamInitDecoder(SDL_WAVStream *stream)
+{
+    WaveFormat *format = &stream->file.format;
+    ADPCM_DecoderState *state = &stream->state;
+
+    stream->blockindex = -1;
+
+    switch (format->encoding) {
+    case MS_ADPCM_CODE:
+        state->blockheadersize = (size_t)format->channels * 7;
+        state->ddata = stream->file.decoderdata;
+        stream->decodeheader = MS_ADPCM_DecodeBlockHeader;
+        stream->decodedata = MS_ADPCM_DecodeBlockData;
+        break;
+    case IMA_ADPCM_CODE:
+        state->blockheadersize = (size_t)format->channels * 4;
+        stream->decodeheader = IMA_ADPCM_DecodeBlockHeader;
+        stream->decodedata = IMA_ADPCM_DecodeBlockData;
+        break;
+    case ALAW_CODE:
+    case MULAW_CODE:
+        stream->framesize = (size_t)format->channels * sizeof(Sint16);
+        return 0;
+    default:
+        if (format->encoding == PCM_CODE && format->bitspersample == 24) {
+            /* 24-bit samples get shifted to 32 bits. */
+            stream->framesize = (size_t)format->channels * sizeof(Sint32);
+        } else {
+            stream->framesize = format->blockalign;
+        }
+        return 0;
+    }
+
+    state->channels = format->channels;
+    state->blocksize = format->blockalign;
+    state->samplesperblock = format->samplesperblock;
+    state->framesize = state->channels * sizeof(Sint16);
+    state->framestotal = stream->file.sampleframes;
+    state->output.size = (size_t)state->samplesperblock * state->channels;
+    stream->framesize = state->framesize;
+
+    stream->block = (Uint8 *)SDL_malloc(state->blocksize);
+    state->output.data = (Sint16 *)SDL_malloc(state->output.size * sizeof(Sint16));
+    state->cstate = SDL_calloc(state->channels, sizeof(MS_ADPCM_ChannelState));
+    if (stream->block == NULL || state->output.data == NULL || state->cstate == NULL) {
+        return SDL_OutOfMemory();
+    }
+
+    return 0;
+}
+
+/* Decodes a block of ADPCM data into the output of the decoder state. A
+ * truncated block leaves fewer sample frames there.
+ */
+static int
+WaveStreamDecodeBlock(SDL_WAVStream *stream, Sint64 blockindex)
+{
+    ADPCM_DecoderState *state = &stream->state;
+    const Sint64 offset = blockindex * state->blocksize;
+    const Sint64 position = stream->file.chunk.position + offset;
+    const Sint64 samplesperblock = (Sint64)state->samplesperblock;
+    const Sint64 frames = SDL_min(stream->file.sampleframes - blockindex * samplesperblock, samplesperblock);
+
+    stream->blockindex = -1;
+    stream->blockframes = 0;
+
+    if (SDL_RWseek(stream->src, position, RW_SEEK_SET) != position) {
+        return SDL_SetError("Could not seek data of WAVE data chunk");
+    }
+
+    state->block.data = stream->block;
+    state->block.size = SDL_RWread(stream->src, stream->block, 1, SDL_min(state->blocksize, stream->datasize - (size_t)offset));
+    state->block.pos = 0;
+    state->output.pos = 0;
+    state->framesleft = frames;
+
+    if (state->block.size >= state->blockheadersize) {
+        if (stream->decodeheader(state) == -1) {
+            return -1;
+        }
+        /* A truncated block stops with the sample frames that were complete. */
+        stream->decodedata(state);
+        stream->blockframes = (Uint32)SDL_min((Sint64)(state->output.pos / state->channels), frames);
+    }
+
+    stream->blockindex = blockindex;
+
+    return 0;
+}
+
+static int
+WaveStreamReadBlocks(SDL_WAVStream *stream, Uint8 *buf, int frames)
+{
+    ADPCM_DecoderState *state = &stream->state;
+    Sint64 frame = stream->frame;
+    int done = 0;
+
+    while (done < frames) {
+        const Sint64 blockindex = frame / state->samplesperblock;
+        const Uint32 blockframe = (Uint32)(frame % state->samplesperblock);
+        int count;
+
+        if (blockindex != stream->blockindex && WaveStreamDecodeBlock(stream, blockindex) < 0) {
+            return done > 0 ? done : -1;
+        } else if (blockframe >= stream->blockframes) {
+            /* The data ends in a truncated block. */
+            break;
+        }
+
+        count = (int)SDL_min((Uint32)(frames - done), stream->blockframes - blockframe);
+        SDL_memcpy(buf + done * stream->framesize, state->output.data + (size_t)blockframe * state->channels, count * stream->framesize);
+        done += count;
+        frame += count;
+    }
+
+    return done;
+}
+
+static int
+WaveStreamReadRaw(SDL_WAVStream *stream, Uint8 *buf, int frames)
+{
+    WaveFormat *format = &stream->file.format;
+    const Sint64 position = stream->file.chunk.position + stream->frame * format->blockalign;
+    size_t length, samples;
+
+    if (SDL_RWseek(stream->src, position, RW_SEEK_SET) != position) {
+        return SDL_SetError("Could not seek data of WAVE data chunk");
+    }
+
+    length = SDL_RWread(stream->src, buf, 1, (size_t)frames * format->blockalign);
+    frames = (int)(length / format->blockalign);
+    samples = (size_t)frames * format->channels;
+
+    if (format->encoding == ALAW_CODE || format->encoding == MULAW_CODE) {
+        if (LAW_Expand(format->encoding, (Sint16 *)buf, buf, samples) < 0) {
+            return -1;
+        }
+    } else if (format->encoding == PCM_CODE && format->bitspersample == 24) {
+        PCM_ExpandSint24ToSint32(buf, samples);
+    }
+
+    return frames;
+}
+
+SDL_WAVStream *
+SDL_OpenWAVStream_RW(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec)
+{
+    SDL_WAVStream *stream;
+    WaveFile *file;
+    Sint64 endposition, size;
+
+    /* Make sure we are passed a valid data source */
+    if (src == NULL) {
+        /* Error may come from RWops. */
+        return NULL;
+    } else if (spec == NULL) {
+        SDL_InvalidParamError("spec");
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return NULL;
+    }
+
+    stream = (SDL_WAVStream *)SDL_calloc(1, sizeof(*stream));
+    if (stream == NULL) {
+        SDL_OutOfMemory();
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return NULL;
+    }
+    stream->src = src;
+    stream->freesrc = freesrc;
+
+    file = &stream->file;
+    file->riffhint = WaveGetRiffSizeHint();
+    file->trunchint = WaveGetTruncationHint();
+    file->facthint = WaveGetFactChunkHint();
+
+    if (WaveReadHeaders(src, file, spec, &endposition) < 0) {
+        SDL_CloseWAVStream(stream);
+        return NULL;
+    }
+
+    /* Without reading the data chunk, the size of the stream tells if it's
+     * truncated. The sample frames are then counted like the decoders would.
+     */
+    stream->datasize = file->chunk.length;
+    size = SDL_RWsize(src);
+    if (size >= 0 && size - file->chunk.position < (Sint64)file->chunk.length) {
+        stream->datasize = size > file->chunk.position ? (size_t)(size - file->chunk.position) : 0;
+        if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
+            SDL_SetError("Could not read data of WAVE data chunk");
+            SDL_CloseWAVStream(stream);
+            return NULL;
+        } else if (WaveStreamCalculateSampleFrames(file, stream->datasize) < 0) {
+            SDL_CloseWAVStream(stream);
+            return NULL;
+        }
+    }
+
+    if (WaveStreamInitDecoder(stream) < 0) {
+        SDL_CloseWAVStream(stream);
+        return NULL;
+    }
+
+    return stream;
+}
+
+int
+SDL_WAVStreamRead(SDL_WAVStream *stream, void *buf, int frames)
+{
+    Sint64 framesleft;
+    int done;
+
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    } else if (buf == NULL) {
+        return SDL_InvalidParamError("buf");
+    } else if (frames < 0) {
+        return SDL_InvalidParamError("frames");
+    }
+
+    /* Don't read past the end or return more bytes than an int can count. */
+    framesleft = stream->file.sampleframes - stream->frame;
+    if ((Sint64)frames > framesleft) {
+        frames = (int)framesleft;
+    }
+    if ((size_t)frames > SDL_MAX_SINT32 / stream->framesize) {
+        frames = (int)(SDL_MAX_SINT32 / stream->framesize);
+    }
+    if (frames == 0) {
+        return 0;
+    }
+
+    switch (stream->file.format.encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+        done = WaveStreamReadBlocks(stream, (Uint8 *)buf, frames);
+        break;
+    default:
+        done = WaveStreamReadRaw(stream, (Uint8 *)buf, frames);
+        break;
+    }
+
+    if (done > 0) {
+        stream->frame += done;
+    }
+
+    return done;
+}
+
+int
+SDL_WAVStreamPut(SDL_WAVStream *stream, SDL_AudioStream *audiostream, int frames)
+{
+    Uint8 *buf;
+    int bufframes, done = 0;
+
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    } else if (audiostream == NULL) {
+        return SDL_InvalidParamError("audiostream");
+    } else if (frames < 0) {
+        return SDL_InvalidParamError("frames");
+    }
+
+    bufframes = SDL_min(frames, WAVSTREAM_PUT_FRAMES);
+    if (bufframes == 0) {
+        return 0;
+    }
+
+    buf = (Uint8 *)SDL_AllocScratch(bufframes * stream->framesize);
+    if (buf == NULL) {
+        return SDL_OutOfMemory();
+    }
+
+    while (done < frames) {
+        const int count = SDL_WAVStreamRead(stream, buf, SDL_min(frames - done, bufframes));
+        if (count < 0) {
+            if (done == 0) {
+                done = -1;
+            }
+            break;
+        } else if (count == 0) {
+            break;
+        }
+
+        if (SDL_AudioStreamPut(audiostream, buf, (int)(count * stream->framesize)) < 0) {
+            /* These frames didn't make it, decode them again next time. */
+            stream->frame -= count;
+            if (done == 0) {
+                done = -1;
+            }
+            break;
+        }
+        done += count;
+    }
+
+    SDL_FreeScratch(buf);
+
+    return done;
+}
+
+int
+SDL_WAVStreamSeek(SDL_WAVStream *stream, Sint64 frame)
+{
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    } else if (frame < 0 || frame > stream->file.sampleframes) {
+        return SDL_InvalidParamError("frame");
+    }
+
+    stream->frame = frame;
+
+    return 0;
+}
+
+Sint64
+SDL_WAVStreamTell(SDL_WAVStream *stream)
+{
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    }
+
+    return stream->frame;
+}
+
+Sint64
+SDL_WAVStreamLength(SDL_WAVStream *stream)
+{
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    }
+
+    return stream->file.sampleframes;
+}
+
+void
+SDL_CloseWAVStream(SDL_WAVStream *stream)
+{
+    if (stream == NULL) {
+        return;
+    }
+
+    if (stream->freesrc) {
+        SDL_RWclose(stream->src);
+    }
+    WaveFreeChunkData(&stream->file.chunk);
+    SDL_free(stream->file.decoderdata);
+    SDL_free(stream->block);
+    SDL_free(stream->state.output.data);
+    SDL_free(stream->state.cstate);
+    SDL_free(stream);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
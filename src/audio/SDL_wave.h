@@ -144,6 +144,8 @@ typedef struct WaveFile
     WaveRiffSizeHint riffhint;
     WaveTruncationHint trunchint;
     WaveFactChunkHint facthint;
+
+    int decodethreads;   /* Up to this many threads decode compressed data. */
 } WaveFile;
 
 /* vi: set ts=4 sw=4 expandtab: */
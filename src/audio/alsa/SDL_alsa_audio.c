@@ -36,11 +36,21 @@
 #include <sys/types.h>
 #include <signal.h>             /* For kill() */
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <unistd.h>
+#ifdef HAVE_INOTIFY
+#include <sys/inotify.h>
+#endif
 
 #include "SDL_timer.h"
+#include "SDL_hints.h"
 #include "SDL_audio.h"
 #include "../SDL_audio_c.h"
 #include "SDL_alsa_audio.h"
+#include "../../core/linux/SDL_udev.h"
 
 #ifdef SDL_AUDIO_DRIVER_ALSA_DYNAMIC
 #include "SDL_loadso.h"
@@ -101,6 +111,18 @@ static int (*ALSA_snd_device_name_hint) (int, const char *, void ***);
 static char* (*ALSA_snd_device_name_get_hint) (const void *, const char *);
 static int (*ALSA_snd_device_name_free_hint) (void **);
 static snd_pcm_sframes_t (*ALSA_snd_pcm_avail)(snd_pcm_t *);
+static snd_pcm_sframes_t (*ALSA_snd_pcm_avail_update)(snd_pcm_t *);
+static snd_pcm_state_t (*ALSA_snd_pcm_state)(snd_pcm_t *);
+static int (*ALSA_snd_pcm_start)(snd_pcm_t *);
+static int (*ALSA_snd_pcm_mmap_begin)
+  (snd_pcm_t *, const snd_pcm_channel_area_t **, snd_pcm_uframes_t *, snd_pcm_uframes_t *);
+static snd_pcm_sframes_t (*ALSA_snd_pcm_mmap_commit)
+  (snd_pcm_t *, snd_pcm_uframes_t, snd_pcm_uframes_t);
+static int (*ALSA_snd_pcm_poll_descriptors_count)(snd_pcm_t *);
+static int (*ALSA_snd_pcm_poll_descriptors)
+  (snd_pcm_t *, struct pollfd *, unsigned int);
+static int (*ALSA_snd_pcm_poll_descriptors_revents)
+  (snd_pcm_t *, struct pollfd *, unsigned int, unsigned short *);
 #ifdef SND_CHMAP_API_VERSION
 static snd_pcm_chmap_t* (*ALSA_snd_pcm_get_chmap) (snd_pcm_t *);
 static int (*ALSA_snd_pcm_chmap_print) (const snd_pcm_chmap_t *map, size_t maxlen, char *buf);
@@ -171,6 +193,14 @@ load_alsa_syms(void)
     SDL_ALSA_SYM(snd_device_name_get_hint);
     SDL_ALSA_SYM(snd_device_name_free_hint);
     SDL_ALSA_SYM(snd_pcm_avail);
+    SDL_ALSA_SYM(snd_pcm_avail_update);
+    SDL_ALSA_SYM(snd_pcm_state);
+    SDL_ALSA_SYM(snd_pcm_start);
+    SDL_ALSA_SYM(snd_pcm_mmap_begin);
+    SDL_ALSA_SYM(snd_pcm_mmap_commit);
+    SDL_ALSA_SYM(snd_pcm_poll_descriptors_count);
+    SDL_ALSA_SYM(snd_pcm_poll_descriptors);
+    SDL_ALSA_SYM(snd_pcm_poll_descriptors_revents);
 #ifdef SND_CHMAP_API_VERSION
     SDL_ALSA_SYM(snd_pcm_get_chmap);
     SDL_ALSA_SYM(snd_pcm_chmap_print);
@@ -252,28 +282,82 @@ get_audio_device(void *handle, const int channels)
 }
 
 
-/* This function waits until it is possible to write a full sound buffer */
-static void
-ALSA_WaitDevice(_THIS)
+/* Sleep in poll() until at least `frames` can be written to the device,
+   recovering from underruns along the way. Returns -1 if the device is gone. */
+static int
+ALSA_WaitForSpace(_THIS, const snd_pcm_sframes_t frames)
 {
-#if SDL_ALSA_NON_BLOCKING
-    const snd_pcm_sframes_t needed = (snd_pcm_sframes_t) this->spec.samples;
+    snd_pcm_t *pcm_handle = this->hidden->pcm_handle;
+    struct pollfd *fds = this->hidden->pollfds;
+    const int count = this->hidden->pollfd_count;
+    /* wake up now and then, so we notice when the device is being closed */
+    const int timeout = SDL_max((int) ((this->spec.samples * 2000) / this->spec.freq), 10);
+
     while (SDL_AtomicGet(&this->enabled)) {
-        const snd_pcm_sframes_t rc = ALSA_snd_pcm_avail(this->hidden->pcm_handle);
-        if ((rc < 0) && (rc != -EAGAIN)) {
-            /* Hmm, not much we can do - abort */
-            fprintf(stderr, "ALSA snd_pcm_avail failed (unrecoverable): %s\n",
-                        ALSA_snd_strerror(rc));
+        const snd_pcm_sframes_t avail = ALSA_snd_pcm_avail_update(pcm_handle);
+        unsigned short revents = 0;
+        int status;
+
+        if (avail < 0) {
+            status = ALSA_snd_pcm_recover(pcm_handle, (int) avail, 1);
+            if (status < 0) {
+                /* Hmm, not much we can do - abort */
+                fprintf(stderr, "ALSA snd_pcm_avail_update failed (unrecoverable): %s\n",
+                        ALSA_snd_strerror(status));
+                SDL_OpenedAudioDeviceDisconnected(this);
+                return -1;
+            }
+            continue;
+        } else if (avail >= frames) {
+            return 0;  /* ready to go! */
+        } else if (ALSA_snd_pcm_state(pcm_handle) == SND_PCM_STATE_PREPARED) {
+            /* The buffer filled up before the stream was started, so
+               nothing is going to drain it until we start it. */
+            status = ALSA_snd_pcm_start(pcm_handle);
+            if (status < 0) {
+                fprintf(stderr, "ALSA snd_pcm_start failed (unrecoverable): %s\n",
+                        ALSA_snd_strerror(status));
+                SDL_OpenedAudioDeviceDisconnected(this);
+                return -1;
+            }
+            continue;
+        }
+
+        if (count <= 0) {
+            /* No descriptors to wait on, guess how long it will take */
+            const Uint32 delay = (Uint32) (((frames - avail) * 1000) / this->spec.freq);
+            SDL_Delay(SDL_max(delay, 1));
+            continue;
+        }
+
+        ALSA_snd_pcm_poll_descriptors(pcm_handle, fds, (unsigned int) count);
+        status = poll(fds, (nfds_t) count, timeout);
+        if (status < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "ALSA poll failed (unrecoverable): %s\n", strerror(errno));
             SDL_OpenedAudioDeviceDisconnected(this);
-            return;
-        } else if (rc < needed) {
-            const Uint32 delay = ((needed - (SDL_max(rc, 0))) * 1000) / this->spec.freq;
-            SDL_Delay(SDL_max(delay, 10));
-        } else {
-            break;  /* ready to go! */
+            return -1;
+        } else if (status > 0) {
+            /* Errors are picked up by snd_pcm_avail_update() on the next pass,
+               but some plugins need to see their events to make progress. */
+            ALSA_snd_pcm_poll_descriptors_revents(pcm_handle, fds, (unsigned int) count, &revents);
         }
     }
+    return -1;
+}
+
+/* This function waits until it is possible to write a full sound buffer */
+static void
+ALSA_WaitDevice(_THIS)
+{
+#if !SDL_ALSA_NON_BLOCKING
+    if (!this->hidden->use_mmap) {
+        return;  /* snd_pcm_writei() blocks until everything is queued. */
+    }
 #endif
+    ALSA_WaitForSpace(this, (snd_pcm_sframes_t) this->spec.samples);
 }
 
 
@@ -371,6 +455,84 @@ no_swizzle(_THIS, void *buffer, Uint32 bufferlen)
 #endif /* SND_CHMAP_API_VERSION */
 
 
+static Uint8 *
+ALSA_MmapAddress(const snd_pcm_channel_area_t *areas, const snd_pcm_uframes_t offset)
+{
+    /* interleaved access, so the first channel's area covers whole frames */
+    return (Uint8 *) areas[0].addr + ((areas[0].first + offset * areas[0].step) / 8);
+}
+
+/* Commit a buffer to the ring buffer, copying it in first if the app
+   couldn't mix into the ring buffer directly. */
+static void
+ALSA_PlayDeviceMmap(_THIS)
+{
+    struct SDL_PrivateAudioData *hidden = this->hidden;
+    snd_pcm_t *pcm_handle = hidden->pcm_handle;
+    const Uint8 *sample_buf = (const Uint8 *) hidden->mixbuf;
+    const int frame_size = ((SDL_AUDIO_BITSIZE(this->spec.format)) / 8) *
+                                this->spec.channels;
+    snd_pcm_uframes_t frames_left = ((snd_pcm_uframes_t) this->spec.samples);
+    snd_pcm_sframes_t status;
+
+    if (hidden->mmap_buf) {
+        hidden->swizzle_func(this, hidden->mmap_buf, frames_left);
+        hidden->mmap_buf = NULL;
+
+        status = ALSA_snd_pcm_mmap_commit(pcm_handle, hidden->mmap_offset, frames_left);
+        if ((status >= 0) && ((snd_pcm_uframes_t) status != frames_left)) {
+            status = -EPIPE;
+        }
+        if (status < 0) {
+            status = ALSA_snd_pcm_recover(pcm_handle, (int) status, 0);
+            if (status < 0) {
+                /* Hmm, not much we can do - abort */
+                fprintf(stderr, "ALSA mmap commit failed (unrecoverable): %s\n",
+                        ALSA_snd_strerror((int) status));
+                SDL_OpenedAudioDeviceDisconnected(this);
+                return;
+            }
+        }
+        frames_left = 0;
+    } else {
+        hidden->swizzle_func(this, hidden->mixbuf, frames_left);
+    }
+
+    while ((frames_left > 0) && (ALSA_WaitForSpace(this, 1) == 0)) {
+        const snd_pcm_channel_area_t *areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t frames = frames_left;
+
+        status = ALSA_snd_pcm_mmap_begin(pcm_handle, &areas, &offset, &frames);
+        if (status >= 0) {
+            SDL_memcpy(ALSA_MmapAddress(areas, offset), sample_buf, frames * frame_size);
+            status = ALSA_snd_pcm_mmap_commit(pcm_handle, offset, frames);
+            if ((status >= 0) && ((snd_pcm_uframes_t) status != frames)) {
+                status = -EPIPE;
+            }
+        }
+        if (status < 0) {
+            status = ALSA_snd_pcm_recover(pcm_handle, (int) status, 0);
+            if (status < 0) {
+                /* Hmm, not much we can do - abort */
+                fprintf(stderr, "ALSA mmap write failed (unrecoverable): %s\n",
+                        ALSA_snd_strerror((int) status));
+                SDL_OpenedAudioDeviceDisconnected(this);
+                return;
+            }
+            continue;
+        }
+
+        sample_buf += frames * frame_size;
+        frames_left -= frames;
+    }
+
+    /* Committing to the ring buffer doesn't start the stream by itself */
+    if (ALSA_snd_pcm_state(pcm_handle) == SND_PCM_STATE_PREPARED) {
+        ALSA_snd_pcm_start(pcm_handle);
+    }
+}
+
 static void
 ALSA_PlayDevice(_THIS)
 {
@@ -379,6 +541,11 @@ ALSA_PlayDevice(_THIS)
                                 this->spec.channels;
     snd_pcm_uframes_t frames_left = ((snd_pcm_uframes_t) this->spec.samples);
 
+    if (this->hidden->use_mmap) {
+        ALSA_PlayDeviceMmap(this);
+        return;
+    }
+
     this->hidden->swizzle_func(this, this->hidden->mixbuf, frames_left);
 
     while ( frames_left > 0 && SDL_AtomicGet(&this->enabled) ) {
@@ -417,7 +584,24 @@ ALSA_PlayDevice(_THIS)
 static Uint8 *
 ALSA_GetDeviceBuf(_THIS)
 {
-    return (this->hidden->mixbuf);
+    struct SDL_PrivateAudioData *hidden = this->hidden;
+
+    hidden->mmap_buf = NULL;
+    if (hidden->use_mmap && (ALSA_WaitForSpace(this, (snd_pcm_sframes_t) this->spec.samples) == 0)) {
+        const snd_pcm_channel_area_t *areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t frames = this->spec.samples;
+
+        /* Mix straight into the ring buffer, unless the buffer wraps around
+           its end, in which case ALSA_PlayDevice() copies it in two pieces. */
+        if ((ALSA_snd_pcm_mmap_begin(hidden->pcm_handle, &areas, &offset, &frames) >= 0) &&
+            (frames == this->spec.samples)) {
+            hidden->mmap_offset = offset;
+            hidden->mmap_buf = ALSA_MmapAddress(areas, offset);
+            return hidden->mmap_buf;
+        }
+    }
+    return (hidden->mixbuf);
 }
 
 static int
@@ -482,6 +666,7 @@ ALSA_CloseDevice(_THIS)
 
         ALSA_snd_pcm_close(this->hidden->pcm_handle);
     }
+    SDL_free(this->hidden->pollfds);
     SDL_free(this->hidden->mixbuf);
     SDL_free(this->hidden);
 }
@@ -590,8 +775,16 @@ ALSA_OpenDevice(_THIS, const char *devname)
     }
 
     /* SDL only uses interleaved sample output */
-    status = ALSA_snd_pcm_hw_params_set_access(pcm_handle, hwparams,
-                                               SND_PCM_ACCESS_RW_INTERLEAVED);
+    status = -1;
+    if (!iscapture && SDL_GetHintBoolean(SDL_HINT_AUDIO_ALSA_MMAP, SDL_TRUE)) {
+        status = ALSA_snd_pcm_hw_params_set_access(pcm_handle, hwparams,
+                                                   SND_PCM_ACCESS_MMAP_INTERLEAVED);
+        this->hidden->use_mmap = (status >= 0) ? SDL_TRUE : SDL_FALSE;
+    }
+    if (status < 0) {
+        status = ALSA_snd_pcm_hw_params_set_access(pcm_handle, hwparams,
+                                                   SND_PCM_ACCESS_RW_INTERLEAVED);
+    }
     if (status < 0) {
         return SDL_SetError("ALSA: Couldn't set interleaved access: %s",
                      ALSA_snd_strerror(status));
@@ -722,10 +915,21 @@ ALSA_OpenDevice(_THIS, const char *devname)
             return SDL_OutOfMemory();
         }
         SDL_memset(this->hidden->mixbuf, this->spec.silence, this->hidden->mixlen);
+
+        /* Get the descriptors to wait on for more space in the device */
+        status = ALSA_snd_pcm_poll_descriptors_count(pcm_handle);
+        if (status > 0) {
+            this->hidden->pollfds = (struct pollfd *) SDL_calloc(status, sizeof (struct pollfd));
+            if (this->hidden->pollfds == NULL) {
+                return SDL_OutOfMemory();
+            }
+            this->hidden->pollfd_count = status;
+        }
     }
 
     #if !SDL_ALSA_NON_BLOCKING
-    if (!iscapture) {
+    /* mmap transfers never block, waiting is done in poll() instead */
+    if (!iscapture && !this->hidden->use_mmap) {
         ALSA_snd_pcm_nonblock(pcm_handle, 0);
     }
     #endif
@@ -933,11 +1137,231 @@ ALSA_HotplugIteration(void)
 static SDL_atomic_t ALSA_hotplug_shutdown;
 static SDL_Thread *ALSA_hotplug_thread;
 
+/* Readable when sound devices change, or -1 if we have to poll for changes */
+static int ALSA_hotplug_notify_fd = -1;
+
+/* ALSA_Deinitialize() writes to this to wake up the hotplug thread */
+static int ALSA_hotplug_wakeup[2] = { -1, -1 };
+
+#ifdef SDL_USE_LIBUDEV
+static const SDL_UDEV_Symbols *ALSA_udev_syms = NULL;
+static struct udev *ALSA_udev = NULL;
+static struct udev_monitor *ALSA_udev_mon = NULL;
+#endif
+
+#ifdef HAVE_INOTIFY
+static int ALSA_inotify_fd = -1;
+
+#ifdef HAVE_INOTIFY_INIT1
+static int SDL_inotify_init1(void) {
+    return inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+#else
+static int SDL_inotify_init1(void) {
+    int fd = inotify_init();
+    if (fd  < 0) return -1;
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+#endif
+#endif /* HAVE_INOTIFY */
+
+#ifdef SDL_USE_LIBUDEV
+static void
+ALSA_QuitUdevMonitor(void)
+{
+    if (ALSA_udev_syms) {
+        if (ALSA_udev_mon) {
+            ALSA_udev_syms->udev_monitor_unref(ALSA_udev_mon);
+            ALSA_udev_mon = NULL;
+        }
+        if (ALSA_udev) {
+            ALSA_udev_syms->udev_unref(ALSA_udev);
+            ALSA_udev = NULL;
+        }
+        SDL_UDEV_ReleaseUdevSyms();
+        ALSA_udev_syms = NULL;
+    }
+}
+#endif
+
+static void
+ALSA_StopHotplugNotifications(void)
+{
+#ifdef SDL_USE_LIBUDEV
+    ALSA_QuitUdevMonitor();
+#endif
+#ifdef HAVE_INOTIFY
+    if (ALSA_inotify_fd >= 0) {
+        close(ALSA_inotify_fd);
+        ALSA_inotify_fd = -1;
+    }
+#endif
+    if (ALSA_hotplug_wakeup[0] >= 0) {
+        close(ALSA_hotplug_wakeup[0]);
+        close(ALSA_hotplug_wakeup[1]);
+        ALSA_hotplug_wakeup[0] = ALSA_hotplug_wakeup[1] = -1;
+    }
+    ALSA_hotplug_notify_fd = -1;
+}
+
+/* Returns the descriptor that becomes readable when sound devices change,
+   or -1 if we have to fall back to polling. */
+static int
+ALSA_StartHotplugNotifications(void)
+{
+    if (pipe(ALSA_hotplug_wakeup) < 0) {
+        ALSA_hotplug_wakeup[0] = ALSA_hotplug_wakeup[1] = -1;
+        return -1;
+    }
+    fcntl(ALSA_hotplug_wakeup[0], F_SETFD, FD_CLOEXEC);
+    fcntl(ALSA_hotplug_wakeup[1], F_SETFD, FD_CLOEXEC);
+
+#ifdef SDL_USE_LIBUDEV
+    /* udev events don't make it into containers */
+    if (access("/.flatpak-info", F_OK) != 0 &&
+        access("/run/host/container-manager", F_OK) != 0) {
+        ALSA_udev_syms = SDL_UDEV_GetUdevSyms();
+        if (ALSA_udev_syms) {
+            ALSA_udev = ALSA_udev_syms->udev_new();
+        }
+        if (ALSA_udev) {
+            ALSA_udev_mon = ALSA_udev_syms->udev_monitor_new_from_netlink(ALSA_udev, "udev");
+        }
+        if (ALSA_udev_mon) {
+            ALSA_udev_syms->udev_monitor_filter_add_match_subsystem_devtype(ALSA_udev_mon, "sound", NULL);
+            if (ALSA_udev_syms->udev_monitor_enable_receiving(ALSA_udev_mon) >= 0) {
+                return ALSA_udev_syms->udev_monitor_get_fd(ALSA_udev_mon);
+            }
+        }
+        ALSA_QuitUdevMonitor();
+    }
+#endif /* SDL_USE_LIBUDEV */
+
+#ifdef HAVE_INOTIFY
+    ALSA_inotify_fd = SDL_inotify_init1();
+    if (ALSA_inotify_fd >= 0) {
+        /* We need to watch for attribute changes in addition to creation,
+           because udev only makes the device nodes accessible after
+           creating them. */
+        if (inotify_add_watch(ALSA_inotify_fd, "/dev/snd",
+                              IN_CREATE | IN_DELETE | IN_MOVE | IN_ATTRIB) >= 0) {
+            return ALSA_inotify_fd;
+        }
+        close(ALSA_inotify_fd);
+        ALSA_inotify_fd = -1;
+    }
+#endif /* HAVE_INOTIFY */
+
+    return -1;
+}
+
+/* Drains pending notifications, returns SDL_TRUE if a PCM device changed. */
+static SDL_bool
+ALSA_ReadHotplugNotifications(void)
+{
+    SDL_bool changed = SDL_FALSE;
+
+#ifdef SDL_USE_LIBUDEV
+    if (ALSA_udev_mon) {
+        struct pollfd pfd;
+        pfd.fd = ALSA_udev_syms->udev_monitor_get_fd(ALSA_udev_mon);
+        pfd.events = POLLIN;
+        while (poll(&pfd, 1, 0) == 1) {
+            struct udev_device *dev = ALSA_udev_syms->udev_monitor_receive_device(ALSA_udev_mon);
+            if (!dev) {
+                break;
+            }
+            changed = SDL_TRUE;
+            ALSA_udev_syms->udev_device_unref(dev);
+        }
+    }
+#endif /* SDL_USE_LIBUDEV */
+
+#ifdef HAVE_INOTIFY
+    if (ALSA_inotify_fd >= 0) {
+        union
+        {
+            struct inotify_event event;
+            char storage[4096];
+            char enough_for_inotify[sizeof (struct inotify_event) + NAME_MAX + 1];
+        } buf;
+        ssize_t bytes;
+
+        while ((bytes = read(ALSA_inotify_fd, &buf, sizeof (buf))) > 0) {
+            size_t remain = (size_t) bytes;
+            size_t len;
+
+            while (remain > 0) {
+                /* only the PCM nodes matter, not controls, timers, etc. */
+                if ((buf.event.len > 0) && (SDL_strncmp(buf.event.name, "pcmC", 4) == 0)) {
+                    changed = SDL_TRUE;
+                }
+
+                len = sizeof (struct inotify_event) + buf.event.len;
+                remain -= len;
+
+                if (remain != 0) {
+                    SDL_memmove(&buf.storage[0], &buf.storage[len], remain);
+                }
+            }
+        }
+    }
+#endif /* HAVE_INOTIFY */
+
+    return changed;
+}
+
+/* Sleeps until sound devices change and updates the device list.
+   Returns when we're told to stop, or if waiting fails. */
+static void
+ALSA_WaitForHotplugNotifications(void)
+{
+    struct pollfd fds[2];
+    int settle;
+
+    fds[0].fd = ALSA_hotplug_notify_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = ALSA_hotplug_wakeup[0];
+    fds[1].events = POLLIN;
+
+    while (!SDL_AtomicGet(&ALSA_hotplug_shutdown)) {
+        const int status = poll(fds, 2, -1);
+        if (status < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        } else if (fds[1].revents || (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL))) {
+            return;
+        }
+
+        if (ALSA_ReadHotplugNotifications()) {
+            /* Plugging in a card changes several nodes in quick succession,
+               so wait for things to settle before enumerating again. */
+            for (settle = 0; settle < 20 && !SDL_AtomicGet(&ALSA_hotplug_shutdown); settle++) {
+                if (poll(fds, 1, 50) <= 0) {
+                    break;
+                }
+                ALSA_ReadHotplugNotifications();
+            }
+
+            ALSA_HotplugIteration();  /* run the check. */
+        }
+    }
+}
+
 static int SDLCALL
 ALSA_HotplugThread(void *arg)
 {
     SDL_SetThreadPriority(SDL_THREAD_PRIORITY_LOW);
 
+    if (ALSA_hotplug_notify_fd >= 0) {
+        ALSA_WaitForHotplugNotifications();
+    }
+
+    /* No notifications available, check every now and then */
     while (!SDL_AtomicGet(&ALSA_hotplug_shutdown)) {
         /* Block awhile before checking again, unless we're told to stop. */
         const Uint32 ticks = SDL_GetTicks() + 5000;
@@ -959,8 +1383,12 @@ ALSA_DetectDevices(void)
 
 #if SDL_ALSA_HOTPLUG_THREAD
     SDL_AtomicSet(&ALSA_hotplug_shutdown, 0);
+    ALSA_hotplug_notify_fd = ALSA_StartHotplugNotifications();
     ALSA_hotplug_thread = SDL_CreateThread(ALSA_HotplugThread, "SDLHotplugALSA", NULL);
     /* if the thread doesn't spin, oh well, you just don't get further hotplug events. */
+    if (ALSA_hotplug_thread == NULL) {
+        ALSA_StopHotplugNotifications();
+    }
 #endif
 }
 
@@ -973,8 +1401,15 @@ ALSA_Deinitialize(void)
 #if SDL_ALSA_HOTPLUG_THREAD
     if (ALSA_hotplug_thread != NULL) {
         SDL_AtomicSet(&ALSA_hotplug_shutdown, 1);
+        if (ALSA_hotplug_wakeup[1] >= 0) {
+            const char wakeup = 1;
+            if (write(ALSA_hotplug_wakeup[1], &wakeup, 1) < 0) {
+                /* can't happen with an empty pipe, but keeps the compiler quiet */
+            }
+        }
         SDL_WaitThread(ALSA_hotplug_thread, NULL);
         ALSA_hotplug_thread = NULL;
+        ALSA_StopHotplugNotifications();
     }
 #endif
 
@@ -41,6 +41,15 @@ struct SDL_PrivateAudioData
 
     /* swizzle function */
     void (*swizzle_func)(_THIS, void *buffer, Uint32 bufferlen);
+
+    /* Descriptors to poll() while waiting for the device */
+    struct pollfd *pollfds;
+    int pollfd_count;
+
+    /* mmap transfer: the area of the ring buffer handed out by GetDeviceBuf */
+    SDL_bool use_mmap;
+    Uint8 *mmap_buf;
+    snd_pcm_uframes_t mmap_offset;
 };
 
 #endif /* SDL_ALSA_audio_h_ */
@@ -40,6 +40,7 @@
 
 #include "SDL_cpuinfo.h"
 #include "SDL_assert.h"
+#include "SDL_hints.h"
 
 #ifdef HAVE_SYSCONF
 #include <unistd.h>
@@ -850,6 +851,71 @@ SDL_GetCPUCacheLineSize(void)
 static Uint32 SDL_CPUFeatures = 0xFFFFFFFF;
 static Uint32 SDL_SIMDAlignment = 0xFFFFFFFF;
 
+static const struct
+{
+    const char *name;
+    Uint32 feature;
+} SDL_CPUFeatureNames[] = {
+    { "altivec", CPU_HAS_ALTIVEC },
+    { "mmx", CPU_HAS_MMX },
+    { "3dnow", CPU_HAS_3DNOW },
+    { "sse", CPU_HAS_SSE },
+    { "sse2", CPU_HAS_SSE2 },
+    { "sse3", CPU_HAS_SSE3 },
+    { "sse41", CPU_HAS_SSE41 },
+    { "sse42", CPU_HAS_SSE42 },
+    { "avx", CPU_HAS_AVX },
+    { "avx2", CPU_HAS_AVX2 },
+    { "avx512f", CPU_HAS_AVX512F },
+    { "armsimd", CPU_HAS_ARM_SIMD },
+    { "neon", CPU_HAS_NEON },
+    { "lsx", CPU_HAS_LSX },
+    { "lasx", CPU_HAS_LASX },
+};
+
+/* Parse SDL_HINT_CPU_FEATURE_MASK into the set of features SDL may use */
+static Uint32
+SDL_CPUFeatureMask(void)
+{
+    Uint32 mask = 0xFFFFFFFF;
+    const char *hint = SDL_GetHint(SDL_HINT_CPU_FEATURE_MASK);
+
+    while (hint && *hint) {
+        const char *end = SDL_strchr(hint, ',');
+        size_t len = end ? (size_t)(end - hint) : SDL_strlen(hint);
+        SDL_bool keep = SDL_TRUE;
+        Uint32 features = 0;
+        size_t i;
+
+        if (*hint == '+' || *hint == '-') {
+            keep = (*hint == '+') ? SDL_TRUE : SDL_FALSE;
+            ++hint;
+            --len;
+        }
+        if (len == 3 && SDL_strncasecmp(hint, "all", len) == 0) {
+            features = 0xFFFFFFFF;
+        } else {
+            for (i = 0; i < SDL_arraysize(SDL_CPUFeatureNames); ++i) {
+                if (SDL_strlen(SDL_CPUFeatureNames[i].name) == len &&
+                    SDL_strncasecmp(hint, SDL_CPUFeatureNames[i].name, len) == 0) {
+                    features = SDL_CPUFeatureNames[i].feature;
+                    break;
+                }
+            }
+        }
+        /* RDTSC isn't a code path, it's always left alone */
+        features &= ~CPU_HAS_RDTSC;
+
+        if (keep) {
+            mask |= features;
+        } else {
+            mask &= ~features;
+        }
+        hint = end ? end + 1 : NULL;
+    }
+    return mask;
+}
+
 static Uint32
 SDL_GetCPUFeatures(void)
 {
@@ -920,6 +986,7 @@ SDL_GetCPUFeatures(void)
             SDL_CPUFeatures |= CPU_HAS_LASX;
             SDL_SIMDAlignment = SDL_max(SDL_SIMDAlignment, 32);
         }
+        SDL_CPUFeatures &= SDL_CPUFeatureMask();
     }
     return SDL_CPUFeatures;
 }
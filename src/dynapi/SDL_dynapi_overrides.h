@@ -884,3 +884,20 @@
 #define SDL_GetRectDisplayIndex SDL_GetRectDisplayIndex_REAL
 #define SDL_ResetHint SDL_ResetHint_REAL
 #define SDL_crc16 SDL_crc16_REAL
+#define SDL_CreateTextureAtlas SDL_CreateTextureAtlas_REAL
+#define SDL_CreateAtlasTexture SDL_CreateAtlasTexture_REAL
+#define SDL_GetAtlasTextureRegion SDL_GetAtlasTextureRegion_REAL
+#define SDL_DefragmentTextureAtlas SDL_DefragmentTextureAtlas_REAL
+#define SDL_DestroyTextureAtlas SDL_DestroyTextureAtlas_REAL
+#define SDL_RenderGetSortStats SDL_RenderGetSortStats_REAL
+#define SDL_OpenWAVStream_RW SDL_OpenWAVStream_RW_REAL
+#define SDL_WAVStreamRead SDL_WAVStreamRead_REAL
+#define SDL_WAVStreamPut SDL_WAVStreamPut_REAL
+#define SDL_WAVStreamSeek SDL_WAVStreamSeek_REAL
+#define SDL_WAVStreamTell SDL_WAVStreamTell_REAL
+#define SDL_WAVStreamLength SDL_WAVStreamLength_REAL
+#define SDL_CloseWAVStream SDL_CloseWAVStream_REAL
+#define SDL_CreateGeometry SDL_CreateGeometry_REAL
+#define SDL_RenderRetainedGeometry SDL_RenderRetainedGeometry_REAL
+#define SDL_DestroyGeometry SDL_DestroyGeometry_REAL
+#define SDL_AudioStreamSetChannelMatrix SDL_AudioStreamSetChannelMatrix_REAL
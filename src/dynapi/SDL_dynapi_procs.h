@@ -967,3 +967,20 @@ SDL_DYNAPI_PROC(int,SDL_GetPointDisplayIndex,(const SDL_Point *a),(a),return)
 SDL_DYNAPI_PROC(int,SDL_GetRectDisplayIndex,(const SDL_Rect *a),(a),return)
 SDL_DYNAPI_PROC(SDL_bool,SDL_ResetHint,(const char *a),(a),return)
 SDL_DYNAPI_PROC(Uint16,SDL_crc16,(Uint16 a, const void *b, size_t c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_TextureAtlas*,SDL_CreateTextureAtlas,(SDL_Renderer *a, Uint32 b, int c, int d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(SDL_Texture*,SDL_CreateAtlasTexture,(SDL_TextureAtlas *a, int b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_GetAtlasTextureRegion,(SDL_Texture *a, SDL_Texture **b, SDL_Rect *c, SDL_FRect *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_DefragmentTextureAtlas,(SDL_TextureAtlas *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyTextureAtlas,(SDL_TextureAtlas *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_RenderGetSortStats,(SDL_Renderer *a, Uint64 *b, Uint64 *c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_WAVStream*,SDL_OpenWAVStream_RW,(SDL_RWops *a, int b, SDL_AudioSpec *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WAVStreamRead,(SDL_WAVStream *a, void *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WAVStreamPut,(SDL_WAVStream *a, SDL_AudioStream *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WAVStreamSeek,(SDL_WAVStream *a, Sint64 b),(a,b),return)
+SDL_DYNAPI_PROC(Sint64,SDL_WAVStreamTell,(SDL_WAVStream *a),(a),return)
+SDL_DYNAPI_PROC(Sint64,SDL_WAVStreamLength,(SDL_WAVStream *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_CloseWAVStream,(SDL_WAVStream *a),(a),)
+SDL_DYNAPI_PROC(SDL_Geometry*,SDL_CreateGeometry,(SDL_Renderer *a, const float *b, int c, const SDL_Color *d, int e, const float *f, int g, int h, const void *i, int j, int k),(a,b,c,d,e,f,g,h,i,j,k),return)
+SDL_DYNAPI_PROC(int,SDL_RenderRetainedGeometry,(SDL_Renderer *a, SDL_Texture *b, SDL_Geometry *c, const SDL_FPoint *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyGeometry,(SDL_Geometry *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_AudioStreamSetChannelMatrix,(SDL_AudioStream *a, const float *b),(a,b),return)
@@ -58,6 +58,18 @@ this should probably be removed at some point in the future.  --ryan. */
         return retval; \
     }
 
+#define CHECK_ATLAS_MAGIC(atlas, retval) \
+    if (!atlas || atlas->magic != &atlas_magic) { \
+        SDL_InvalidParamError("atlas"); \
+        return retval; \
+    }
+
+#define CHECK_GEOMETRY_MAGIC(geometry, retval) \
+    if (!geometry || geometry->magic != &geometry_magic) { \
+        SDL_InvalidParamError("geometry"); \
+        return retval; \
+    }
+
 /* Predefined blend modes */
 #define SDL_COMPOSE_BLENDMODE(srcColorFactor, dstColorFactor, colorOperation, \
                               srcAlphaFactor, dstAlphaFactor, alphaOperation) \
@@ -131,6 +143,45 @@ static const SDL_RenderDriver *render_drivers[] = {
 
 static char renderer_magic;
 static char texture_magic;
+static char atlas_magic;
+static char geometry_magic;
+
+/* Texture atlas state, see SDL_CreateTextureAtlas() */
+#define SDL_ATLAS_PADDING   2
+
+typedef struct
+{
+    int x;
+    int y;      /* top of the packed area from x up to the next node */
+    int w;
+} SDL_AtlasSkylineNode;
+
+struct SDL_AtlasPage
+{
+    SDL_Texture *texture;
+    SDL_AtlasSkylineNode *skyline;
+    int num_skyline;
+    SDL_Rect *free_rects;
+    int num_free_rects;
+    int max_free_rects;
+    int num_entries;
+    SDL_AtlasPage *next;
+};
+
+struct SDL_TextureAtlas
+{
+    const void *magic;
+    SDL_Renderer *renderer;
+    Uint32 format;
+    int access;
+    int page_w;
+    int page_h;
+    SDL_AtlasPage *pages;
+    SDL_Texture *entries;
+
+    SDL_TextureAtlas *prev;
+    SDL_TextureAtlas *next;
+};
 
 static SDL_INLINE void
 DebugLogRenderCommands(const SDL_RenderCommand *cmd)
@@ -233,6 +284,206 @@ DebugLogRenderCommands(const SDL_RenderCommand *cmd)
 #endif
 }
 
+/* How many draws back a draw may be moved to join others using the same state */
+#define SORT_MAX_DISTANCE   64
+
+static SDL_bool
+IsSortableRenderCommand(const SDL_RenderCommand *cmd)
+{
+    switch (cmd->command) {
+        case SDL_RENDERCMD_DRAW_POINTS:
+        case SDL_RENDERCMD_DRAW_LINES:
+        case SDL_RENDERCMD_FILL_RECTS:
+        case SDL_RENDERCMD_COPY:
+        case SDL_RENDERCMD_COPY_EX:
+        case SDL_RENDERCMD_GEOMETRY:
+            return SDL_TRUE;
+        default:
+            return SDL_FALSE;
+    }
+}
+
+static SDL_bool
+HasSameDrawState(const SDL_RenderCommand *a, const SDL_RenderCommand *b)
+{
+    /* The texture covers its scale mode too */
+    return a->command == b->command &&
+           a->data.draw.texture == b->data.draw.texture &&
+           a->data.draw.blend == b->data.draw.blend;
+}
+
+static SDL_bool
+HasOverlappingBounds(const SDL_RenderCommand *a, const SDL_RenderCommand *b)
+{
+    const SDL_FRect *A = &a->data.draw.bounds;
+    const SDL_FRect *B = &b->data.draw.bounds;
+    return A->x < B->x + B->w && B->x < A->x + A->w &&
+           A->y < B->y + B->h && B->y < A->y + A->h;
+}
+
+static Uint64
+CountDrawStateChanges(SDL_RenderCommand **cmds, size_t count)
+{
+    Uint64 changes = 0;
+    size_t i;
+    for (i = 1; i < count; ++i) {
+        if (!HasSameDrawState(cmds[i - 1], cmds[i])) {
+            ++changes;
+        }
+    }
+    return changes;
+}
+
+/* Reorder the queued draws to group those using the same state, without
+ * changing the result: draws only move within runs that aren't separated
+ * by viewport, clip rect, color or clear commands, and never past another
+ * draw they overlap. The vertex data is then laid out again in the new
+ * order, since backends expect consecutive draws they combine to have
+ * consecutive vertices. */
+static void
+SortRenderCommands(SDL_Renderer *renderer)
+{
+    SDL_RenderCommand *cmd;
+    SDL_RenderCommand **cmds;
+    Uint8 *vertices;
+    size_t count = 0;
+    size_t vertex_data_needed;
+    size_t reordered = 0;
+    size_t offset;
+    size_t i;
+
+    vertex_data_needed = renderer->vertex_data_used;
+    for (cmd = renderer->render_commands; cmd; cmd = cmd->next) {
+        vertex_data_needed += cmd->vertex_alignment;
+        ++count;
+    }
+    if (count < 3) {
+        return;  /* nothing can move. */
+    }
+
+    if (renderer->sort_array_allocation < count) {
+        cmds = (SDL_RenderCommand **) SDL_realloc(renderer->sort_array, count * sizeof(*cmds));
+        if (!cmds) {
+            return;  /* just render them in order. */
+        }
+        renderer->sort_array = cmds;
+        renderer->sort_array_allocation = count;
+    }
+    if (renderer->sort_vertex_data_allocation < vertex_data_needed) {
+        vertices = (Uint8 *) SDL_realloc(renderer->sort_vertex_data, vertex_data_needed);
+        if (!vertices) {
+            return;  /* just render them in order. */
+        }
+        renderer->sort_vertex_data = vertices;
+        renderer->sort_vertex_data_allocation = vertex_data_needed;
+    }
+
+    cmds = renderer->sort_array;
+    i = 0;
+    for (cmd = renderer->render_commands; cmd; cmd = cmd->next) {
+        cmds[i++] = cmd;
+    }
+
+    i = 0;
+    while (i < count) {
+        const size_t start = i;
+        size_t j;
+
+        while (i < count && IsSortableRenderCommand(cmds[i])) {
+            ++i;
+        }
+        if (i - start < 3) {
+            ++i;
+            continue;
+        }
+
+        renderer->sort_state_changes_saved += CountDrawStateChanges(&cmds[start], i - start);
+
+        for (j = start + 1; j < i; ++j) {
+            SDL_RenderCommand *draw = cmds[j];
+            const size_t limit = (j - start > SORT_MAX_DISTANCE) ? (j - SORT_MAX_DISTANCE) : start;
+            size_t k;
+
+            /* Move it right after the latest draw using the same state, if nothing in between overlaps it */
+            for (k = j; k > limit; --k) {
+                const SDL_RenderCommand *prev = cmds[k - 1];
+                if (HasSameDrawState(prev, draw)) {
+                    break;
+                }
+                if (HasOverlappingBounds(prev, draw)) {
+                    k = j;
+                    break;
+                }
+            }
+            if (k > limit && k < j) {
+                SDL_memmove(&cmds[k + 1], &cmds[k], (j - k) * sizeof(*cmds));
+                cmds[k] = draw;
+                ++reordered;
+            }
+        }
+
+        renderer->sort_state_changes_saved -= CountDrawStateChanges(&cmds[start], i - start);
+    }
+
+    if (!reordered) {
+        return;
+    }
+    renderer->sort_reordered += reordered;
+
+    for (i = 0; i < count - 1; ++i) {
+        cmds[i]->next = cmds[i + 1];
+    }
+    cmds[count - 1]->next = NULL;
+    renderer->render_commands = cmds[0];
+    renderer->render_commands_tail = cmds[count - 1];
+
+    /* Lay the vertex data out in the new command order */
+    vertices = (Uint8 *) renderer->sort_vertex_data;
+    offset = 0;
+    for (i = 0; i < count; ++i) {
+        size_t size;
+
+        cmd = cmds[i];
+        if (!cmd->vertex_end) {
+            continue;
+        }
+
+        if (cmd->vertex_alignment && (offset & (cmd->vertex_alignment - 1)) != 0) {
+            offset += cmd->vertex_alignment - (offset & (cmd->vertex_alignment - 1));
+        }
+        size = cmd->vertex_end - cmd->vertex_begin;
+        SDL_memcpy(vertices + offset, (const Uint8 *) renderer->vertex_data + cmd->vertex_begin, size);
+
+        switch (cmd->command) {
+            case SDL_RENDERCMD_SETVIEWPORT:
+                cmd->data.viewport.first = offset + (cmd->data.viewport.first - cmd->vertex_begin);
+                break;
+            case SDL_RENDERCMD_SETDRAWCOLOR:
+            case SDL_RENDERCMD_CLEAR:
+                cmd->data.color.first = offset + (cmd->data.color.first - cmd->vertex_begin);
+                break;
+            case SDL_RENDERCMD_SETCLIPRECT:
+            case SDL_RENDERCMD_NO_OP:
+                break;
+            default:
+                cmd->data.draw.first = offset + (cmd->data.draw.first - cmd->vertex_begin);
+                break;
+        }
+        cmd->vertex_begin = offset;
+        cmd->vertex_end = offset + size;
+        offset += size;
+    }
+
+    renderer->sort_vertex_data = renderer->vertex_data;
+    renderer->vertex_data = vertices;
+    renderer->vertex_data_used = offset;
+    {
+        const size_t allocation = renderer->sort_vertex_data_allocation;
+        renderer->sort_vertex_data_allocation = renderer->vertex_data_allocation;
+        renderer->vertex_data_allocation = allocation;
+    }
+}
+
 static int
 FlushRenderCommands(SDL_Renderer *renderer)
 {
@@ -245,6 +496,10 @@ FlushRenderCommands(SDL_Renderer *renderer)
         return 0;
     }
 
+    if (renderer->sort_commands) {
+        SortRenderCommands(renderer);
+    }
+
     DebugLogRenderCommands(renderer->render_commands);
 
     retval = renderer->RunCommandQueue(renderer, renderer->render_commands, renderer->vertex_data, renderer->vertex_data_used);
@@ -287,6 +542,20 @@ SDL_RenderFlush(SDL_Renderer * renderer)
     return FlushRenderCommands(renderer);
 }
 
+int
+SDL_RenderGetSortStats(SDL_Renderer * renderer, Uint64 * reordered, Uint64 * state_changes_saved)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (reordered) {
+        *reordered = renderer->sort_reordered;
+    }
+    if (state_changes_saved) {
+        *state_changes_saved = renderer->sort_state_changes_saved;
+    }
+    return 0;
+}
+
 void *
 SDL_AllocateRenderVertices(SDL_Renderer *renderer, const size_t numbytes, const size_t alignment, size_t *offset)
 {
@@ -318,6 +587,18 @@ SDL_AllocateRenderVertices(SDL_Renderer *renderer, const size_t numbytes, const
         *offset = aligned;
     }
 
+    /* Remember which vertex data belongs to the command being queued, so it can be moved around */
+    if (renderer->render_commands_tail) {
+        SDL_RenderCommand *cmd = renderer->render_commands_tail;
+        if (!cmd->vertex_end) {
+            cmd->vertex_begin = aligned;
+        }
+        cmd->vertex_end = aligned + numbytes;
+        if (alignment > cmd->vertex_alignment) {
+            cmd->vertex_alignment = alignment;
+        }
+    }
+
     renderer->vertex_data_used += aligner + numbytes;
 
     return ((Uint8 *) renderer->vertex_data) + aligned;
@@ -340,6 +621,9 @@ AllocateRenderCommand(SDL_Renderer *renderer)
             return NULL;
         }
     }
+    retval->vertex_begin = 0;
+    retval->vertex_end = 0;
+    retval->vertex_alignment = 0;
 
     SDL_assert((renderer->render_commands == NULL) == (renderer->render_commands_tail == NULL));
     if (renderer->render_commands_tail != NULL) {
@@ -462,6 +746,11 @@ PrepQueueCmdDraw(SDL_Renderer *renderer, const SDL_RenderCommandType cmdtype, SD
     if (texture) {
         color = &texture->color;
         blendMode = texture->blendMode;
+        if (texture->atlas_page) {
+            /* Atlas textures draw from their page with their own color and blend mode */
+            texture = texture->atlas_page->texture;
+            texture->last_command_generation = renderer->render_command_generation;
+        }
     } else {
         color = &renderer->color;
         blendMode = renderer->blendMode;
@@ -493,17 +782,66 @@ PrepQueueCmdDraw(SDL_Renderer *renderer, const SDL_RenderCommandType cmdtype, SD
             cmd->data.draw.a = color->a;
             cmd->data.draw.blend = blendMode;
             cmd->data.draw.texture = texture;
+            cmd->data.draw.geometry = NULL;
         }
     }
     return cmd;
 }
 
+static void
+SetDrawBounds(SDL_RenderCommand *cmd, float x0, float y0, float x1, float y1)
+{
+    /* Pad by a pixel to cover point and line rasterization and rounding in the backends */
+    cmd->data.draw.bounds.x = SDL_min(x0, x1) - 1.0f;
+    cmd->data.draw.bounds.y = SDL_min(y0, y1) - 1.0f;
+    cmd->data.draw.bounds.w = SDL_fabsf(x1 - x0) + 2.0f;
+    cmd->data.draw.bounds.h = SDL_fabsf(y1 - y0) + 2.0f;
+}
+
+static void
+SetDrawBoundsFromVertices(SDL_RenderCommand *cmd, const float *xy, int xy_stride, int count, float scale_x, float scale_y)
+{
+    float minx = xy[0], miny = xy[1];
+    float maxx = xy[0], maxy = xy[1];
+    int i;
+
+    for (i = 1; i < count; ++i) {
+        const float *xy_ = (const float *)((const char *)xy + i * xy_stride);
+        minx = SDL_min(minx, xy_[0]);
+        miny = SDL_min(miny, xy_[1]);
+        maxx = SDL_max(maxx, xy_[0]);
+        maxy = SDL_max(maxy, xy_[1]);
+    }
+    SetDrawBounds(cmd, minx * scale_x, miny * scale_y, maxx * scale_x, maxy * scale_y);
+}
+
+static void
+SetDrawBoundsFromRects(SDL_RenderCommand *cmd, const SDL_FRect *rects, int count)
+{
+    float minx = SDL_min(rects[0].x, rects[0].x + rects[0].w);
+    float miny = SDL_min(rects[0].y, rects[0].y + rects[0].h);
+    float maxx = SDL_max(rects[0].x, rects[0].x + rects[0].w);
+    float maxy = SDL_max(rects[0].y, rects[0].y + rects[0].h);
+    int i;
+
+    for (i = 1; i < count; ++i) {
+        minx = SDL_min(minx, SDL_min(rects[i].x, rects[i].x + rects[i].w));
+        miny = SDL_min(miny, SDL_min(rects[i].y, rects[i].y + rects[i].h));
+        maxx = SDL_max(maxx, SDL_max(rects[i].x, rects[i].x + rects[i].w));
+        maxy = SDL_max(maxy, SDL_max(rects[i].y, rects[i].y + rects[i].h));
+    }
+    SetDrawBounds(cmd, minx, miny, maxx, maxy);
+}
+
 static int
 QueueCmdDrawPoints(SDL_Renderer *renderer, const SDL_FPoint * points, const int count)
 {
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_DRAW_POINTS, NULL);
     int retval = -1;
     if (cmd != NULL) {
+        if (renderer->sort_commands) {
+            SetDrawBoundsFromVertices(cmd, &points->x, sizeof(*points), count, 1.0f, 1.0f);
+        }
         retval = renderer->QueueDrawPoints(renderer, cmd, points, count);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
@@ -518,6 +856,9 @@ QueueCmdDrawLines(SDL_Renderer *renderer, const SDL_FPoint * points, const int c
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_DRAW_LINES, NULL);
     int retval = -1;
     if (cmd != NULL) {
+        if (renderer->sort_commands) {
+            SetDrawBoundsFromVertices(cmd, &points->x, sizeof(*points), count, 1.0f, 1.0f);
+        }
         retval = renderer->QueueDrawLines(renderer, cmd, points, count);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
@@ -536,6 +877,9 @@ QueueCmdFillRects(SDL_Renderer *renderer, const SDL_FRect * rects, const int cou
     cmd = PrepQueueCmdDraw(renderer, (use_rendergeometry ? SDL_RENDERCMD_GEOMETRY : SDL_RENDERCMD_FILL_RECTS), NULL);
 
     if (cmd != NULL) {
+        if (renderer->sort_commands) {
+            SetDrawBoundsFromRects(cmd, rects, count);
+        }
         if (use_rendergeometry) {
             SDL_bool isstack1;
             SDL_bool isstack2;
@@ -600,13 +944,31 @@ QueueCmdFillRects(SDL_Renderer *renderer, const SDL_FRect * rects, const int cou
     return retval;
 }
 
+static const SDL_Rect *
+GetAtlasSourceRect(SDL_Texture * texture, const SDL_Rect * srcrect, SDL_Rect * atlas_srcrect)
+{
+    if (!texture->atlas_page) {
+        return srcrect;
+    }
+    atlas_srcrect->x = texture->atlas_rect.x + srcrect->x;
+    atlas_srcrect->y = texture->atlas_rect.y + srcrect->y;
+    atlas_srcrect->w = srcrect->w;
+    atlas_srcrect->h = srcrect->h;
+    return atlas_srcrect;
+}
+
 static int
 QueueCmdCopy(SDL_Renderer *renderer, SDL_Texture * texture, const SDL_Rect * srcrect, const SDL_FRect * dstrect)
 {
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_COPY, texture);
     int retval = -1;
     if (cmd != NULL) {
-        retval = renderer->QueueCopy(renderer, cmd, texture, srcrect, dstrect);
+        SDL_Rect atlas_srcrect;
+        srcrect = GetAtlasSourceRect(texture, srcrect, &atlas_srcrect);
+        if (renderer->sort_commands) {
+            SetDrawBoundsFromRects(cmd, dstrect, 1);
+        }
+        retval = renderer->QueueCopy(renderer, cmd, cmd->data.draw.texture, srcrect, dstrect);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
         }
@@ -622,7 +984,18 @@ QueueCmdCopyEx(SDL_Renderer *renderer, SDL_Texture * texture,
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_COPY_EX, texture);
     int retval = -1;
     if (cmd != NULL) {
-        retval = renderer->QueueCopyEx(renderer, cmd, texture, srcquad, dstrect, angle, center, flip, scale_x, scale_y);
+        SDL_Rect atlas_srcquad;
+        srcquad = GetAtlasSourceRect(texture, srcquad, &atlas_srcquad);
+        if (renderer->sort_commands) {
+            /* Any rotation stays within the circle around the center through the farthest corner */
+            const float cx = dstrect->x + center->x;
+            const float cy = dstrect->y + center->y;
+            const float dx = SDL_max(SDL_fabsf(center->x), SDL_fabsf(dstrect->w - center->x));
+            const float dy = SDL_max(SDL_fabsf(center->y), SDL_fabsf(dstrect->h - center->y));
+            const float radius = SDL_sqrtf(dx * dx + dy * dy);
+            SetDrawBounds(cmd, (cx - radius) * scale_x, (cy - radius) * scale_y, (cx + radius) * scale_x, (cy + radius) * scale_y);
+        }
+        retval = renderer->QueueCopyEx(renderer, cmd, cmd->data.draw.texture, srcquad, dstrect, angle, center, flip, scale_x, scale_y);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
         }
@@ -641,9 +1014,37 @@ QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
 {
     SDL_RenderCommand *cmd;
     int retval = -1;
+    float *atlas_uv = NULL;
+    SDL_bool isstack = SDL_FALSE;
+
+    if (texture && texture->atlas_page) {
+        /* Map the texture coordinates into the atlas page */
+        const SDL_Texture *page = texture->atlas_page->texture;
+        const float u0 = (float)texture->atlas_rect.x / page->w;
+        const float v0 = (float)texture->atlas_rect.y / page->h;
+        const float du = (float)texture->atlas_rect.w / page->w;
+        const float dv = (float)texture->atlas_rect.h / page->h;
+        int i;
+
+        atlas_uv = SDL_small_alloc(float, 2 * num_vertices, &isstack);
+        if (!atlas_uv) {
+            return SDL_OutOfMemory();
+        }
+        for (i = 0; i < num_vertices; ++i) {
+            const float *uv_ = (const float *)((const char *)uv + i * uv_stride);
+            atlas_uv[2 * i + 0] = u0 + uv_[0] * du;
+            atlas_uv[2 * i + 1] = v0 + uv_[1] * dv;
+        }
+        uv = atlas_uv;
+        uv_stride = 2 * sizeof (float);
+    }
+
     cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_GEOMETRY, texture);
     if (cmd != NULL) {
-        retval = renderer->QueueGeometry(renderer, cmd, texture,
+        if (renderer->sort_commands) {
+            SetDrawBoundsFromVertices(cmd, xy, xy_stride, num_vertices, scale_x, scale_y);
+        }
+        retval = renderer->QueueGeometry(renderer, cmd, cmd->data.draw.texture,
                 xy, xy_stride,
                 color, color_stride, uv, uv_stride,
                 num_vertices, indices, num_indices, size_indices,
@@ -652,6 +1053,10 @@ QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
             cmd->command = SDL_RENDERCMD_NO_OP;
         }
     }
+
+    if (atlas_uv) {
+        SDL_small_free(atlas_uv, isstack);
+    }
     return retval;
 }
 
@@ -1024,6 +1429,7 @@ SDL_CreateRenderer(SDL_Window * window, int index, Uint32 flags)
     }
 
     renderer->batching = batching;
+    renderer->sort_commands = SDL_GetHintBoolean(SDL_HINT_RENDER_SORT_COMMANDS, SDL_FALSE);
     renderer->magic = &renderer_magic;
     renderer->window = window;
     renderer->target_mutex = SDL_CreateMutex();
@@ -1430,66 +1836,770 @@ SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface)
         direct_update = SDL_FALSE;
     }
 
-    if (direct_update) {
-        if (SDL_MUSTLOCK(surface)) {
-            SDL_LockSurface(surface);
-            SDL_UpdateTexture(texture, NULL, surface->pixels, surface->pitch);
-            SDL_UnlockSurface(surface);
-        } else {
-            SDL_UpdateTexture(texture, NULL, surface->pixels, surface->pitch);
+    if (direct_update) {
+        if (SDL_MUSTLOCK(surface)) {
+            SDL_LockSurface(surface);
+            SDL_UpdateTexture(texture, NULL, surface->pixels, surface->pitch);
+            SDL_UnlockSurface(surface);
+        } else {
+            SDL_UpdateTexture(texture, NULL, surface->pixels, surface->pitch);
+        }
+
+#if SDL_VIDEO_RENDER_DIRECTFB
+        /* DirectFB allows palette format for textures.
+         * Copy SDL_Surface palette to the texture */
+        if (SDL_ISPIXELFORMAT_INDEXED(format)) {
+            if (SDL_strcasecmp(renderer->info.name, "directfb") == 0) {
+                extern void DirectFB_SetTexturePalette(SDL_Renderer *renderer, SDL_Texture *texture, SDL_Palette *pal);
+                DirectFB_SetTexturePalette(renderer, texture, surface->format->palette);
+            }
+        }
+#endif
+
+    } else {
+        SDL_PixelFormat *dst_fmt;
+        SDL_Surface *temp = NULL;
+
+        /* Set up a destination surface for the texture update */
+        dst_fmt = SDL_AllocFormat(format);
+        if (!dst_fmt) {
+           SDL_DestroyTexture(texture);
+           return NULL;
+        }
+        temp = SDL_ConvertSurface(surface, dst_fmt, 0);
+        SDL_FreeFormat(dst_fmt);
+        if (temp) {
+            SDL_UpdateTexture(texture, NULL, temp->pixels, temp->pitch);
+            SDL_FreeSurface(temp);
+        } else {
+            SDL_DestroyTexture(texture);
+            return NULL;
+        }
+    }
+
+    {
+        Uint8 r, g, b, a;
+        SDL_BlendMode blendMode;
+
+        SDL_GetSurfaceColorMod(surface, &r, &g, &b);
+        SDL_SetTextureColorMod(texture, r, g, b);
+
+        SDL_GetSurfaceAlphaMod(surface, &a);
+        SDL_SetTextureAlphaMod(texture, a);
+
+        if (SDL_HasColorKey(surface)) {
+            /* We converted to a texture with alpha format */
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        } else {
+            SDL_GetSurfaceBlendMode(surface, &blendMode);
+            SDL_SetTextureBlendMode(texture, blendMode);
+        }
+    }
+    return texture;
+}
+
+/* Texture atlases
+ *
+ * Each atlas page is packed with a skyline allocator, placing every new
+ * texture as low as possible. Textures freed from a page leave holes that are
+ * kept in a per-page free list and reused guillotine style, splitting off the
+ * unused part of the hole.
+ *
+ * Every texture has a one texel gutter all around it, holding copies of its
+ * edge texels, so linear filtering at its edges samples the texture itself
+ * rather than its neighbours. The allocator works in page coordinates offset
+ * by one with the gutter included in each allocation, so the place it picks
+ * is where the texture goes, and gutters along the page edges fall off the
+ * page, where the sampler clamps anyway.
+ */
+
+static void
+SDL_ResetAtlasPage(SDL_TextureAtlas *atlas, SDL_AtlasPage *page)
+{
+    page->skyline[0].x = 0;
+    page->skyline[0].y = 0;
+    page->skyline[0].w = atlas->page_w + SDL_ATLAS_PADDING;
+    page->num_skyline = 1;
+    page->num_free_rects = 0;
+}
+
+static SDL_AtlasPage *
+SDL_CreateAtlasPage(SDL_TextureAtlas *atlas)
+{
+    SDL_AtlasPage *page;
+    SDL_AtlasPage **tail;
+
+    page = (SDL_AtlasPage *) SDL_calloc(1, sizeof(*page));
+    if (!page) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* Skyline nodes are at least one pixel wide, plus one while inserting */
+    page->skyline = (SDL_AtlasSkylineNode *) SDL_malloc((atlas->page_w + SDL_ATLAS_PADDING + 1) * sizeof(*page->skyline));
+    if (!page->skyline) {
+        SDL_free(page);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    page->texture = SDL_CreateTexture(atlas->renderer, atlas->format, atlas->access, atlas->page_w, atlas->page_h);
+    if (!page->texture) {
+        SDL_free(page->skyline);
+        SDL_free(page);
+        return NULL;
+    }
+    /* Pages are only drawn directly when defragmenting the atlas */
+    SDL_SetTextureBlendMode(page->texture, SDL_BLENDMODE_NONE);
+
+    SDL_ResetAtlasPage(atlas, page);
+
+    /* Keep the pages in creation order so the first ones fill up first */
+    for (tail = &atlas->pages; *tail; tail = &(*tail)->next) {
+    }
+    *tail = page;
+
+    return page;
+}
+
+static void
+SDL_DestroyAtlasPages(SDL_AtlasPage *page)
+{
+    while (page) {
+        SDL_AtlasPage *next = page->next;
+        SDL_DestroyTexture(page->texture);
+        SDL_free(page->skyline);
+        SDL_free(page->free_rects);
+        SDL_free(page);
+        page = next;
+    }
+}
+
+/* Returns the lowest y a w x h area fits at the left edge of a skyline node, or -1 */
+static int
+SDL_FitAtlasSkyline(const SDL_AtlasPage *page, int index, int w, int h, int page_w, int page_h)
+{
+    const SDL_AtlasSkylineNode *node = &page->skyline[index];
+    int y = 0;
+
+    if (node->x + w > page_w) {
+        return -1;
+    }
+    while (w > 0) {
+        if (node->y > y) {
+            y = node->y;
+        }
+        if (y + h > page_h) {
+            return -1;
+        }
+        w -= node->w;
+        ++node;
+    }
+    return y;
+}
+
+static void
+SDL_AddAtlasSkylineLevel(SDL_AtlasPage *page, int index, const SDL_Rect *rect)
+{
+    SDL_AtlasSkylineNode *nodes = page->skyline;
+    const int right = rect->x + rect->w;
+    int i;
+
+    SDL_memmove(&nodes[index + 1], &nodes[index], (page->num_skyline - index) * sizeof(*nodes));
+    nodes[index].x = rect->x;
+    nodes[index].y = rect->y + rect->h;
+    nodes[index].w = rect->w;
+    ++page->num_skyline;
+
+    /* Shrink or remove the nodes covered by the new level */
+    i = index + 1;
+    while (i < page->num_skyline && nodes[i].x < right) {
+        const int overlap = right - nodes[i].x;
+        if (overlap < nodes[i].w) {
+            nodes[i].x += overlap;
+            nodes[i].w -= overlap;
+            break;
+        }
+        SDL_memmove(&nodes[i], &nodes[i + 1], (page->num_skyline - i - 1) * sizeof(*nodes));
+        --page->num_skyline;
+    }
+
+    /* Merge neighbouring nodes at the same height */
+    i = 0;
+    while (i < page->num_skyline - 1) {
+        if (nodes[i].y == nodes[i + 1].y) {
+            nodes[i].w += nodes[i + 1].w;
+            SDL_memmove(&nodes[i + 1], &nodes[i + 2], (page->num_skyline - i - 2) * sizeof(*nodes));
+            --page->num_skyline;
+        } else {
+            ++i;
+        }
+    }
+}
+
+static void
+SDL_AddAtlasFreeRect(SDL_AtlasPage *page, int x, int y, int w, int h)
+{
+    SDL_Rect *rect;
+
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+
+    if (page->num_free_rects == page->max_free_rects) {
+        const int max_free_rects = page->max_free_rects ? page->max_free_rects * 2 : 16;
+        SDL_Rect *free_rects = (SDL_Rect *) SDL_realloc(page->free_rects, max_free_rects * sizeof(*free_rects));
+        if (!free_rects) {
+            /* The space is lost until the page is empty or defragmented */
+            return;
+        }
+        page->free_rects = free_rects;
+        page->max_free_rects = max_free_rects;
+    }
+
+    rect = &page->free_rects[page->num_free_rects++];
+    rect->x = x;
+    rect->y = y;
+    rect->w = w;
+    rect->h = h;
+}
+
+static SDL_AtlasPage *
+SDL_AllocAtlasRect(SDL_TextureAtlas *atlas, int w, int h, SDL_Rect *rect)
+{
+    const int page_w = atlas->page_w + SDL_ATLAS_PADDING;
+    const int page_h = atlas->page_h + SDL_ATLAS_PADDING;
+    SDL_AtlasPage *page;
+    SDL_AtlasPage *best_page = NULL;
+    int best_index = 0;
+    int best_score = SDL_MAX_SINT32;
+    int i;
+
+    w += SDL_ATLAS_PADDING;
+    h += SDL_ATLAS_PADDING;
+
+    /* Reuse the smallest hole left by a freed texture that is big enough */
+    for (page = atlas->pages; page; page = page->next) {
+        for (i = 0; i < page->num_free_rects; ++i) {
+            const SDL_Rect *hole = &page->free_rects[i];
+            if (hole->w >= w && hole->h >= h && hole->w * hole->h < best_score) {
+                best_page = page;
+                best_index = i;
+                best_score = hole->w * hole->h;
+            }
+        }
+    }
+
+    if (best_page) {
+        const SDL_Rect hole = best_page->free_rects[best_index];
+
+        best_page->free_rects[best_index] = best_page->free_rects[--best_page->num_free_rects];
+
+        /* Split the rest of the hole along its shorter leftover side */
+        if (hole.w - w < hole.h - h) {
+            SDL_AddAtlasFreeRect(best_page, hole.x + w, hole.y, hole.w - w, h);
+            SDL_AddAtlasFreeRect(best_page, hole.x, hole.y + h, hole.w, hole.h - h);
+        } else {
+            SDL_AddAtlasFreeRect(best_page, hole.x + w, hole.y, hole.w - w, hole.h);
+            SDL_AddAtlasFreeRect(best_page, hole.x, hole.y + h, w, hole.h - h);
+        }
+        rect->x = hole.x;
+        rect->y = hole.y;
+    } else {
+        /* Place it as low as possible on the skyline of the first page it fits in */
+        int best_y = 0;
+        int best_width = 0;
+
+        for (page = atlas->pages; page && !best_page; page = page->next) {
+            for (i = 0; i < page->num_skyline; ++i) {
+                const int y = SDL_FitAtlasSkyline(page, i, w, h, page_w, page_h);
+                if (y >= 0 &&
+                    (y + h < best_score || (y + h == best_score && page->skyline[i].w < best_width))) {
+                    best_page = page;
+                    best_index = i;
+                    best_score = y + h;
+                    best_y = y;
+                    best_width = page->skyline[i].w;
+                }
+            }
+        }
+
+        if (!best_page) {
+            best_page = SDL_CreateAtlasPage(atlas);
+            if (!best_page) {
+                return NULL;
+            }
+            best_index = 0;
+            best_y = 0;
+        }
+
+        rect->x = best_page->skyline[best_index].x;
+        rect->y = best_y;
+        rect->w = w;
+        rect->h = h;
+        SDL_AddAtlasSkylineLevel(best_page, best_index, rect);
+    }
+
+    rect->w = w - SDL_ATLAS_PADDING;
+    rect->h = h - SDL_ATLAS_PADDING;
+    ++best_page->num_entries;
+    return best_page;
+}
+
+static void
+SDL_FreeAtlasRect(SDL_TextureAtlas *atlas, SDL_AtlasPage *page, const SDL_Rect *rect)
+{
+    if (--page->num_entries == 0) {
+        SDL_ResetAtlasPage(atlas, page);
+    } else {
+        SDL_AddAtlasFreeRect(page, rect->x, rect->y, rect->w + SDL_ATLAS_PADDING, rect->h + SDL_ATLAS_PADDING);
+    }
+}
+
+/* Calls back for each part of the gutter around an atlas texture next to
+   the given area of the texture, with the edge texels of the area it copies
+   and where they go on the page. Parts off the page are skipped. */
+typedef int (*SDL_AtlasGutterCallback)(void *userdata, const SDL_Rect *edge, const SDL_Rect *gutter);
+
+static int
+SDL_ForEachAtlasGutter(const SDL_Texture *texture, const SDL_Rect *area, SDL_AtlasGutterCallback callback, void *userdata)
+{
+    const SDL_Texture *page = texture->atlas_page->texture;
+    const SDL_Rect *place = &texture->atlas_rect;
+    SDL_Rect edge, gutter;
+    int i, dx, dy;
+
+    for (i = 0; i < 9; ++i) {
+        dx = (i % 3) - 1;
+        dy = (i / 3) - 1;
+        if ((dx == 0 && dy == 0) ||
+            (dx < 0 && area->x != 0) || (dx > 0 && area->x + area->w != texture->w) ||
+            (dy < 0 && area->y != 0) || (dy > 0 && area->y + area->h != texture->h)) {
+            continue;
+        }
+
+        edge.x = (dx > 0) ? (area->x + area->w - 1) : area->x;
+        edge.y = (dy > 0) ? (area->y + area->h - 1) : area->y;
+        edge.w = dx ? 1 : area->w;
+        edge.h = dy ? 1 : area->h;
+
+        gutter.x = place->x + edge.x + dx;
+        gutter.y = place->y + edge.y + dy;
+        gutter.w = edge.w;
+        gutter.h = edge.h;
+        if (gutter.x < 0 || gutter.y < 0 ||
+            gutter.x + gutter.w > page->w || gutter.y + gutter.h > page->h) {
+            continue;
+        }
+
+        if (callback(userdata, &edge, &gutter) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+typedef struct
+{
+    SDL_Texture *page;
+    const SDL_Rect *area;
+    const Uint8 *pixels;
+    int pitch;
+    int bpp;
+} SDL_AtlasUpdate;
+
+static int
+SDL_UpdateAtlasGutter(void *userdata, const SDL_Rect *edge, const SDL_Rect *gutter)
+{
+    const SDL_AtlasUpdate *update = (const SDL_AtlasUpdate *) userdata;
+    const Uint8 *pixels = update->pixels +
+                          (edge->y - update->area->y) * update->pitch +
+                          (edge->x - update->area->x) * update->bpp;
+
+    return SDL_UpdateTexture(update->page, gutter, pixels, update->pitch);
+}
+
+/* Updates an area of an atlas texture, and the gutter next to it */
+static int
+SDL_UpdateAtlasTexture(SDL_Texture *texture, const SDL_Rect *rect, const void *pixels, int pitch)
+{
+    SDL_AtlasUpdate update;
+    SDL_Rect real_rect;
+
+    real_rect.x = texture->atlas_rect.x + rect->x;
+    real_rect.y = texture->atlas_rect.y + rect->y;
+    real_rect.w = rect->w;
+    real_rect.h = rect->h;
+    if (SDL_UpdateTexture(texture->atlas_page->texture, &real_rect, pixels, pitch) < 0) {
+        return -1;
+    }
+
+    update.page = texture->atlas_page->texture;
+    update.area = rect;
+    update.pixels = (const Uint8 *) pixels;
+    update.pitch = pitch;
+    update.bpp = SDL_BYTESPERPIXEL(texture->format);
+    return SDL_ForEachAtlasGutter(texture, rect, SDL_UpdateAtlasGutter, &update);
+}
+
+typedef struct
+{
+    SDL_Renderer *renderer;
+    SDL_Texture *old_page;
+    const SDL_Rect *old_rect;
+} SDL_AtlasMove;
+
+static int
+SDL_CopyAtlasGutter(void *userdata, const SDL_Rect *edge, const SDL_Rect *gutter)
+{
+    const SDL_AtlasMove *move = (const SDL_AtlasMove *) userdata;
+    SDL_Rect src;
+
+    src.x = move->old_rect->x + edge->x;
+    src.y = move->old_rect->y + edge->y;
+    src.w = edge->w;
+    src.h = edge->h;
+    return SDL_RenderCopy(move->renderer, move->old_page, &src, gutter);
+}
+
+/* Copies an atlas texture from its old place to the current render target, its new page */
+static int
+SDL_MoveAtlasTexture(SDL_Renderer *renderer, SDL_Texture *texture, SDL_Texture *old_page, const SDL_Rect *old_rect)
+{
+    SDL_AtlasMove move;
+    SDL_Rect area;
+
+    if (SDL_RenderCopy(renderer, old_page, old_rect, &texture->atlas_rect) < 0) {
+        return -1;
+    }
+
+    /* The old gutter may have been off its page, so fill the new one from the edges */
+    area.x = 0;
+    area.y = 0;
+    area.w = texture->w;
+    area.h = texture->h;
+    move.renderer = renderer;
+    move.old_page = old_page;
+    move.old_rect = old_rect;
+    return SDL_ForEachAtlasGutter(texture, &area, SDL_CopyAtlasGutter, &move);
+}
+
+SDL_TextureAtlas *
+SDL_CreateTextureAtlas(SDL_Renderer * renderer, Uint32 format, int page_w, int page_h)
+{
+    SDL_TextureAtlas *atlas;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+
+    if (!format) {
+        format = renderer->info.texture_formats[0];
+    }
+    if (SDL_ISPIXELFORMAT_FOURCC(format) || SDL_BYTESPERPIXEL(format) == 0 ||
+        !IsSupportedFormat(renderer, format)) {
+        SDL_SetError("Texture atlas format not supported by the renderer");
+        return NULL;
+    }
+    if (page_w <= 0 || page_h <= 0) {
+        SDL_SetError("Texture dimensions can't be 0");
+        return NULL;
+    }
+    if ((renderer->info.max_texture_width && page_w > renderer->info.max_texture_width) ||
+        (renderer->info.max_texture_height && page_h > renderer->info.max_texture_height)) {
+        SDL_SetError("Texture dimensions are limited to %dx%d", renderer->info.max_texture_width, renderer->info.max_texture_height);
+        return NULL;
+    }
+
+    atlas = (SDL_TextureAtlas *) SDL_calloc(1, sizeof(*atlas));
+    if (!atlas) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    atlas->magic = &atlas_magic;
+    atlas->renderer = renderer;
+    atlas->format = format;
+    atlas->access = SDL_RenderTargetSupported(renderer) ? SDL_TEXTUREACCESS_TARGET : SDL_TEXTUREACCESS_STATIC;
+    atlas->page_w = page_w;
+    atlas->page_h = page_h;
+    atlas->next = renderer->atlases;
+    if (renderer->atlases) {
+        renderer->atlases->prev = atlas;
+    }
+    renderer->atlases = atlas;
+
+    return atlas;
+}
+
+SDL_Texture *
+SDL_CreateAtlasTexture(SDL_TextureAtlas * atlas, int w, int h)
+{
+    SDL_Texture *texture;
+    SDL_AtlasPage *page;
+    SDL_Rect rect;
+
+    CHECK_ATLAS_MAGIC(atlas, NULL);
+
+    if (w <= 0 || h <= 0) {
+        SDL_SetError("Texture dimensions can't be 0");
+        return NULL;
+    }
+    if (w > atlas->page_w || h > atlas->page_h) {
+        SDL_SetError("Texture dimensions are limited to %dx%d in this atlas", atlas->page_w, atlas->page_h);
+        return NULL;
+    }
+
+    texture = (SDL_Texture *) SDL_calloc(1, sizeof(*texture));
+    if (!texture) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    page = SDL_AllocAtlasRect(atlas, w, h, &rect);
+    if (!page) {
+        SDL_free(texture);
+        return NULL;
+    }
+    texture->magic = &texture_magic;
+    texture->format = atlas->format;
+    texture->access = SDL_TEXTUREACCESS_STATIC;
+    texture->w = w;
+    texture->h = h;
+    texture->color.r = 255;
+    texture->color.g = 255;
+    texture->color.b = 255;
+    texture->color.a = 255;
+    texture->scaleMode = page->texture->scaleMode;
+    texture->renderer = atlas->renderer;
+    texture->atlas = atlas;
+    texture->atlas_page = page;
+    texture->atlas_rect = rect;
+
+    /* Atlas textures are kept out of the renderer texture list, they go away with their atlas */
+    texture->next = atlas->entries;
+    if (atlas->entries) {
+        atlas->entries->prev = texture;
+    }
+    atlas->entries = texture;
+
+    return texture;
+}
+
+static void
+SDL_DestroyAtlasTexture(SDL_Texture * texture)
+{
+    SDL_TextureAtlas *atlas = texture->atlas;
+
+    SDL_FreeAtlasRect(atlas, texture->atlas_page, &texture->atlas_rect);
+
+    texture->magic = NULL;
+
+    if (texture->next) {
+        texture->next->prev = texture->prev;
+    }
+    if (texture->prev) {
+        texture->prev->next = texture->next;
+    } else {
+        atlas->entries = texture->next;
+    }
+
+    SDL_free(texture);
+}
+
+int
+SDL_GetAtlasTextureRegion(SDL_Texture * texture, SDL_Texture ** page, SDL_Rect * rect, SDL_FRect * uv)
+{
+    SDL_Texture *page_texture;
+
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (!texture->atlas) {
+        return SDL_SetError("Texture was not created with SDL_CreateAtlasTexture()");
+    }
+
+    page_texture = texture->atlas_page->texture;
+    if (page) {
+        *page = page_texture;
+    }
+    if (rect) {
+        *rect = texture->atlas_rect;
+    }
+    if (uv) {
+        uv->x = (float)texture->atlas_rect.x / page_texture->w;
+        uv->y = (float)texture->atlas_rect.y / page_texture->h;
+        uv->w = (float)texture->atlas_rect.w / page_texture->w;
+        uv->h = (float)texture->atlas_rect.h / page_texture->h;
+    }
+    return 0;
+}
+
+static int SDLCALL
+SDL_CompareAtlasTextures(const void *a, const void *b)
+{
+    const SDL_Texture *A = *(const SDL_Texture * const *)a;
+    const SDL_Texture *B = *(const SDL_Texture * const *)b;
+
+    /* Tallest first, which keeps the skyline flat */
+    if (A->h != B->h) {
+        return B->h - A->h;
+    }
+    return B->w - A->w;
+}
+
+int
+SDL_DefragmentTextureAtlas(SDL_TextureAtlas * atlas)
+{
+    SDL_Renderer *renderer;
+    SDL_AtlasPage *old_pages;
+    SDL_AtlasPage *page;
+    SDL_Texture **entries;
+    SDL_AtlasPage **old_entry_pages;
+    SDL_Rect *old_entry_rects;
+    SDL_Texture *texture;
+    SDL_Texture *target;
+    SDL_DRect viewport;
+    SDL_DRect clip_rect;
+    SDL_bool clipping_enabled;
+    SDL_FPoint scale;
+    int logical_w, logical_h;
+    Uint8 r, g, b, a;
+    int num_entries = 0;
+    int num_placed = 0;
+    int retval = 0;
+    int i;
+
+    CHECK_ATLAS_MAGIC(atlas, -1);
+
+    renderer = atlas->renderer;
+
+    if (atlas->access != SDL_TEXTUREACCESS_TARGET) {
+        return SDL_Unsupported();
+    }
+
+    for (texture = atlas->entries; texture; texture = texture->next) {
+        ++num_entries;
+    }
+    if (num_entries == 0) {
+        SDL_DestroyAtlasPages(atlas->pages);
+        atlas->pages = NULL;
+        return 0;
+    }
+
+    entries = (SDL_Texture **) SDL_malloc(num_entries * (sizeof(*entries) + sizeof(*old_entry_pages) + sizeof(*old_entry_rects)));
+    if (!entries) {
+        return SDL_OutOfMemory();
+    }
+    old_entry_rects = (SDL_Rect *) &entries[num_entries];
+    old_entry_pages = (SDL_AtlasPage **) &old_entry_rects[num_entries];
+
+    i = 0;
+    for (texture = atlas->entries; texture; texture = texture->next) {
+        entries[i++] = texture;
+    }
+    SDL_qsort(entries, num_entries, sizeof(*entries), SDL_CompareAtlasTextures);
+
+    /* Pack everything into new pages */
+    old_pages = atlas->pages;
+    atlas->pages = NULL;
+    for (num_placed = 0; num_placed < num_entries; ++num_placed) {
+        SDL_Rect rect;
+
+        texture = entries[num_placed];
+        page = SDL_AllocAtlasRect(atlas, texture->w, texture->h, &rect);
+        if (!page) {
+            retval = -1;
+            break;
         }
+        old_entry_pages[num_placed] = texture->atlas_page;
+        old_entry_rects[num_placed] = texture->atlas_rect;
+        texture->atlas_page = page;
+        texture->atlas_rect = rect;
+    }
 
-#if SDL_VIDEO_RENDER_DIRECTFB
-        /* DirectFB allows palette format for textures.
-         * Copy SDL_Surface palette to the texture */
-        if (SDL_ISPIXELFORMAT_INDEXED(format)) {
-            if (SDL_strcasecmp(renderer->info.name, "directfb") == 0) {
-                extern void DirectFB_SetTexturePalette(SDL_Renderer *renderer, SDL_Texture *texture, SDL_Palette *pal);
-                DirectFB_SetTexturePalette(renderer, texture, surface->format->palette);
+    /* Copy the textures over to the cleared new pages */
+    target = renderer->target;
+    SDL_LockMutex(renderer->target_mutex);
+    viewport = renderer->viewport;
+    clip_rect = renderer->clip_rect;
+    clipping_enabled = renderer->clipping_enabled;
+    scale = renderer->scale;
+    logical_w = renderer->logical_w;
+    logical_h = renderer->logical_h;
+    SDL_UnlockMutex(renderer->target_mutex);
+    r = renderer->color.r;
+    g = renderer->color.g;
+    b = renderer->color.b;
+    a = renderer->color.a;
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    for (page = atlas->pages; page && retval == 0; page = page->next) {
+        retval = SDL_SetRenderTarget(renderer, page->texture);
+        if (retval == 0) {
+            retval = SDL_RenderClear(renderer);
+        }
+        for (i = 0; i < num_entries && retval == 0; ++i) {
+            if (entries[i]->atlas_page == page) {
+                retval = SDL_MoveAtlasTexture(renderer, entries[i], old_entry_pages[i]->texture, &old_entry_rects[i]);
             }
         }
-#endif
+    }
 
-    } else {
-        SDL_PixelFormat *dst_fmt;
-        SDL_Surface *temp = NULL;
+    SDL_SetRenderTarget(renderer, target);
+    if (target) {
+        /* Changing the target reset the state of the texture target, put it back */
+        SDL_LockMutex(renderer->target_mutex);
+        renderer->viewport = viewport;
+        renderer->clip_rect = clip_rect;
+        renderer->clipping_enabled = clipping_enabled;
+        renderer->scale = scale;
+        renderer->logical_w = logical_w;
+        renderer->logical_h = logical_h;
+        SDL_UnlockMutex(renderer->target_mutex);
+        QueueCmdSetViewport(renderer);
+        QueueCmdSetClipRect(renderer);
+    }
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
 
-        /* Set up a destination surface for the texture update */
-        dst_fmt = SDL_AllocFormat(format);
-        if (!dst_fmt) {
-           SDL_DestroyTexture(texture);
-           return NULL;
-        }
-        temp = SDL_ConvertSurface(surface, dst_fmt, 0);
-        SDL_FreeFormat(dst_fmt);
-        if (temp) {
-            SDL_UpdateTexture(texture, NULL, temp->pixels, temp->pitch);
-            SDL_FreeSurface(temp);
-        } else {
-            SDL_DestroyTexture(texture);
-            return NULL;
+    if (retval < 0) {
+        /* Put everything back the way it was */
+        for (i = 0; i < num_placed; ++i) {
+            entries[i]->atlas_page = old_entry_pages[i];
+            entries[i]->atlas_rect = old_entry_rects[i];
         }
+        SDL_DestroyAtlasPages(atlas->pages);
+        atlas->pages = old_pages;
+    } else {
+        SDL_DestroyAtlasPages(old_pages);
     }
 
-    {
-        Uint8 r, g, b, a;
-        SDL_BlendMode blendMode;
+    SDL_free(entries);
+    return retval;
+}
 
-        SDL_GetSurfaceColorMod(surface, &r, &g, &b);
-        SDL_SetTextureColorMod(texture, r, g, b);
+void
+SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas)
+{
+    SDL_Renderer *renderer;
 
-        SDL_GetSurfaceAlphaMod(surface, &a);
-        SDL_SetTextureAlphaMod(texture, a);
+    CHECK_ATLAS_MAGIC(atlas, );
 
-        if (SDL_HasColorKey(surface)) {
-            /* We converted to a texture with alpha format */
-            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-        } else {
-            SDL_GetSurfaceBlendMode(surface, &blendMode);
-            SDL_SetTextureBlendMode(texture, blendMode);
-        }
+    renderer = atlas->renderer;
+
+    while (atlas->entries) {
+        SDL_DestroyAtlasTexture(atlas->entries);
     }
-    return texture;
+    SDL_DestroyAtlasPages(atlas->pages);
+
+    atlas->magic = NULL;
+
+    if (atlas->next) {
+        atlas->next->prev = atlas->prev;
+    }
+    if (atlas->prev) {
+        atlas->prev->next = atlas->next;
+    } else {
+        renderer->atlases = atlas->next;
+    }
+
+    SDL_free(atlas);
 }
 
 int
@@ -1614,6 +2724,10 @@ SDL_SetTextureScaleMode(SDL_Texture * texture, SDL_ScaleMode scaleMode)
 
     CHECK_TEXTURE_MAGIC(texture, -1);
 
+    if (texture->atlas) {
+        return SDL_SetError("Can't change the scale mode of an atlas texture");
+    }
+
     renderer = texture->renderer;
     texture->scaleMode = scaleMode;
     if (texture->native) {
@@ -1686,14 +2800,14 @@ SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
         const int temp_pitch = (((rect->w * SDL_BYTESPERPIXEL(native->format)) + 3) & ~3);
         const size_t alloclen = rect->h * temp_pitch;
         if (alloclen > 0) {
-            void *temp_pixels = SDL_malloc(alloclen);
+            void *temp_pixels = SDL_AllocScratch(alloclen);
             if (!temp_pixels) {
                 return SDL_OutOfMemory();
             }
             SDL_SW_CopyYUVToRGB(texture->yuv, rect, native->format,
                                 rect->w, rect->h, temp_pixels, temp_pitch);
             SDL_UpdateTexture(native, rect, temp_pixels, temp_pitch);
-            SDL_free(temp_pixels);
+            SDL_FreeScratch(temp_pixels);
         }
     }
     return 0;
@@ -1727,7 +2841,7 @@ SDL_UpdateTextureNative(SDL_Texture * texture, const SDL_Rect * rect,
         const int temp_pitch = (((rect->w * SDL_BYTESPERPIXEL(native->format)) + 3) & ~3);
         const size_t alloclen = rect->h * temp_pitch;
         if (alloclen > 0) {
-            void *temp_pixels = SDL_malloc(alloclen);
+            void *temp_pixels = SDL_AllocScratch(alloclen);
             if (!temp_pixels) {
                 return SDL_OutOfMemory();
             }
@@ -1735,7 +2849,7 @@ SDL_UpdateTextureNative(SDL_Texture * texture, const SDL_Rect * rect,
                               texture->format, pixels, pitch,
                               native->format, temp_pixels, temp_pitch);
             SDL_UpdateTexture(native, rect, temp_pixels, temp_pitch);
-            SDL_free(temp_pixels);
+            SDL_FreeScratch(temp_pixels);
         }
     }
     return 0;
@@ -1768,6 +2882,8 @@ SDL_UpdateTexture(SDL_Texture * texture, const SDL_Rect * rect,
 
     if (real_rect.w == 0 || real_rect.h == 0) {
         return 0;  /* nothing to do. */
+    } else if (texture->atlas_page) {
+        return SDL_UpdateAtlasTexture(texture, &real_rect, pixels, pitch);
 #if SDL_HAVE_YUV
     } else if (texture->yuv) {
         return SDL_UpdateTextureYUV(texture, &real_rect, pixels, pitch);
@@ -1823,14 +2939,14 @@ SDL_UpdateTextureYUVPlanar(SDL_Texture * texture, const SDL_Rect * rect,
         const int temp_pitch = (((rect->w * SDL_BYTESPERPIXEL(native->format)) + 3) & ~3);
         const size_t alloclen = rect->h * temp_pitch;
         if (alloclen > 0) {
-            void *temp_pixels = SDL_malloc(alloclen);
+            void *temp_pixels = SDL_AllocScratch(alloclen);
             if (!temp_pixels) {
                 return SDL_OutOfMemory();
             }
             SDL_SW_CopyYUVToRGB(texture->yuv, rect, native->format,
                                 rect->w, rect->h, temp_pixels, temp_pitch);
             SDL_UpdateTexture(native, rect, temp_pixels, temp_pitch);
-            SDL_free(temp_pixels);
+            SDL_FreeScratch(temp_pixels);
         }
     }
     return 0;
@@ -1874,14 +2990,14 @@ SDL_UpdateTextureNVPlanar(SDL_Texture * texture, const SDL_Rect * rect,
         const int temp_pitch = (((rect->w * SDL_BYTESPERPIXEL(native->format)) + 3) & ~3);
         const size_t alloclen = rect->h * temp_pitch;
         if (alloclen > 0) {
-            void *temp_pixels = SDL_malloc(alloclen);
+            void *temp_pixels = SDL_AllocScratch(alloclen);
             if (!temp_pixels) {
                 return SDL_OutOfMemory();
             }
             SDL_SW_CopyYUVToRGB(texture->yuv, rect, native->format,
                                 rect->w, rect->h, temp_pixels, temp_pitch);
             SDL_UpdateTexture(native, rect, temp_pixels, temp_pitch);
-            SDL_free(temp_pixels);
+            SDL_FreeScratch(temp_pixels);
         }
     }
     return 0;
@@ -4103,6 +5219,43 @@ end:
     return retval;
 }
 
+static int
+CheckGeometryUV(const float *uv, int uv_stride, int num_vertices)
+{
+    int i;
+
+    for (i = 0; i < num_vertices; ++i) {
+        const float *uv_ = (const float *)((const char*)uv + i * uv_stride);
+        float u = uv_[0];
+        float v = uv_[1];
+        if (u < 0.0f || v < 0.0f || u > 1.0f || v > 1.0f) {
+            return SDL_SetError("Values of 'uv' out of bounds %f %f at %d/%d", u, v, i, num_vertices);
+        }
+    }
+    return 0;
+}
+
+static int
+CheckGeometryIndices(const void *indices, int num_indices, int size_indices, int num_vertices)
+{
+    int i;
+
+    for (i = 0; i < num_indices; ++i) {
+        int j;
+        if (size_indices == 4) {
+            j = ((const Uint32 *)indices)[i];
+        } else if (size_indices == 2) {
+            j = ((const Uint16 *)indices)[i];
+        } else {
+            j = ((const Uint8 *)indices)[i];
+        }
+        if (j < 0 || j >= num_vertices) {
+            return SDL_SetError("Values of 'indices' out of bounds");
+        }
+    }
+    return 0;
+}
+
 int
 SDL_RenderGeometryRaw(SDL_Renderer *renderer,
                                   SDL_Texture *texture,
@@ -4112,7 +5265,6 @@ SDL_RenderGeometryRaw(SDL_Renderer *renderer,
                                   int num_vertices,
                                   const void *indices, int num_indices, int size_indices)
 {
-    int i;
     int retval = 0;
     int count = indices ? num_indices : num_vertices;
 
@@ -4169,31 +5321,12 @@ SDL_RenderGeometryRaw(SDL_Renderer *renderer,
         texture = texture->native;
     }
 
-    if (texture) {
-        for (i = 0; i < num_vertices; ++i) {
-            const float *uv_ = (const float *)((const char*)uv + i * uv_stride);
-            float u = uv_[0];
-            float v = uv_[1];
-            if (u < 0.0f || v < 0.0f || u > 1.0f || v > 1.0f) {
-                return SDL_SetError("Values of 'uv' out of bounds %f %f at %d/%d", u, v, i, num_vertices);
-            }
-        }
+    if (texture && CheckGeometryUV(uv, uv_stride, num_vertices) < 0) {
+        return -1;
     }
 
-    if (indices) {
-        for (i = 0; i < num_indices; ++i) {
-            int j;
-            if (size_indices == 4) {
-                j = ((const Uint32 *)indices)[i];
-            } else if (size_indices == 2) {
-                j = ((const Uint16 *)indices)[i];
-            } else {
-                j = ((const Uint8 *)indices)[i];
-            }
-            if (j < 0 || j >= num_vertices) {
-                return SDL_SetError("Values of 'indices' out of bounds");
-            }
-        }
+    if (indices && CheckGeometryIndices(indices, num_indices, size_indices, num_vertices) < 0) {
+        return -1;
     }
 
     if (texture) {
@@ -4217,6 +5350,274 @@ SDL_RenderGeometryRaw(SDL_Renderer *renderer,
 }
 
 
+SDL_Geometry *
+SDL_CreateGeometry(SDL_Renderer *renderer,
+                   const float *xy, int xy_stride,
+                   const SDL_Color *color, int color_stride,
+                   const float *uv, int uv_stride,
+                   int num_vertices,
+                   const void *indices, int num_indices, int size_indices)
+{
+    SDL_Geometry *geometry;
+    size_t xy_size, color_size, uv_size, indices_size;
+    Uint8 *data;
+    int i;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+
+    if (!renderer->QueueGeometry) {
+        SDL_Unsupported();
+        return NULL;
+    }
+
+    if (!xy) {
+        SDL_InvalidParamError("xy");
+        return NULL;
+    }
+
+    if (!color) {
+        SDL_InvalidParamError("color");
+        return NULL;
+    }
+
+    if (num_vertices < 0) {
+        SDL_InvalidParamError("num_vertices");
+        return NULL;
+    }
+
+    if (indices) {
+        if (num_indices < 0 || num_indices % 3 != 0) {
+            SDL_InvalidParamError("num_indices");
+            return NULL;
+        }
+        if (size_indices != 1 && size_indices != 2 && size_indices != 4) {
+            SDL_InvalidParamError("size_indices");
+            return NULL;
+        }
+        if (CheckGeometryIndices(indices, num_indices, size_indices, num_vertices) < 0) {
+            return NULL;
+        }
+    } else {
+        if (num_vertices % 3 != 0) {
+            SDL_InvalidParamError("num_vertices");
+            return NULL;
+        }
+        num_indices = 0;
+        size_indices = 0;
+    }
+
+    if (uv && CheckGeometryUV(uv, uv_stride, num_vertices) < 0) {
+        return NULL;
+    }
+
+    /* Keep the arrays in a single allocation, floats first for alignment */
+    xy_size = (size_t) num_vertices * 2 * sizeof (float);
+    uv_size = uv ? xy_size : 0;
+    color_size = (size_t) num_vertices * sizeof (SDL_Color);
+    indices_size = (size_t) num_indices * size_indices;
+
+    geometry = (SDL_Geometry *) SDL_calloc(1, sizeof(*geometry));
+    data = (Uint8 *) SDL_malloc(SDL_max(xy_size + uv_size + color_size + indices_size, 1));
+    if (!geometry || !data) {
+        SDL_free(geometry);
+        SDL_free(data);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    geometry->xy = (float *) data;
+    geometry->uv = uv ? (float *) (data + xy_size) : NULL;
+    geometry->color = (SDL_Color *) (data + xy_size + uv_size);
+    geometry->indices = indices ? (data + xy_size + uv_size + color_size) : NULL;
+    geometry->num_vertices = num_vertices;
+    geometry->num_indices = num_indices;
+    geometry->size_indices = size_indices;
+
+    for (i = 0; i < num_vertices; ++i) {
+        const float *xy_ = (const float *)((const char *)xy + i * xy_stride);
+        geometry->xy[2 * i + 0] = xy_[0];
+        geometry->xy[2 * i + 1] = xy_[1];
+        geometry->color[i] = *(const SDL_Color *)((const char *)color + i * color_stride);
+        if (uv) {
+            const float *uv_ = (const float *)((const char *)uv + i * uv_stride);
+            geometry->uv[2 * i + 0] = uv_[0];
+            geometry->uv[2 * i + 1] = uv_[1];
+        }
+    }
+    if (indices) {
+        SDL_memcpy(geometry->indices, indices, indices_size);
+    }
+
+    if (num_vertices > 0) {
+        float minx = geometry->xy[0], miny = geometry->xy[1];
+        float maxx = minx, maxy = miny;
+        for (i = 1; i < num_vertices; ++i) {
+            minx = SDL_min(minx, geometry->xy[2 * i + 0]);
+            miny = SDL_min(miny, geometry->xy[2 * i + 1]);
+            maxx = SDL_max(maxx, geometry->xy[2 * i + 0]);
+            maxy = SDL_max(maxy, geometry->xy[2 * i + 1]);
+        }
+        geometry->bounds.x = minx;
+        geometry->bounds.y = miny;
+        geometry->bounds.w = maxx - minx;
+        geometry->bounds.h = maxy - miny;
+    }
+
+    geometry->magic = &geometry_magic;
+    geometry->renderer = renderer;
+    geometry->last_command_generation = renderer->render_command_generation - 1;
+
+    if (renderer->CreateGeometry && renderer->CreateGeometry(renderer, geometry) < 0) {
+        SDL_free(geometry->xy);
+        SDL_free(geometry);
+        return NULL;
+    }
+
+    geometry->next = renderer->geometries;
+    if (renderer->geometries) {
+        renderer->geometries->prev = geometry;
+    }
+    renderer->geometries = geometry;
+
+    return geometry;
+}
+
+int
+SDL_RenderRetainedGeometry(SDL_Renderer *renderer,
+                           SDL_Texture *texture,
+                           SDL_Geometry *geometry,
+                           const SDL_FPoint *offset)
+{
+    const float offset_x = offset ? offset->x : 0.0f;
+    const float offset_y = offset ? offset->y : 0.0f;
+    int retval;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+    CHECK_GEOMETRY_MAGIC(geometry, -1);
+
+    if (renderer != geometry->renderer) {
+        return SDL_SetError("Geometry was not created with this renderer");
+    }
+
+    if (texture) {
+        CHECK_TEXTURE_MAGIC(texture, -1);
+
+        if (renderer != texture->renderer) {
+            return SDL_SetError("Texture was not created with this renderer");
+        }
+        if (!geometry->uv) {
+            return SDL_SetError("Geometry has no texture coordinates");
+        }
+    }
+
+#if DONT_DRAW_WHILE_HIDDEN
+    /* Don't draw while we're hidden */
+    if (renderer->hidden) {
+        return 0;
+    }
+#endif
+
+    if (geometry->num_vertices < 3) {
+        return 0;
+    }
+
+    if (texture && texture->native) {
+        texture = texture->native;
+    }
+
+    if (texture) {
+        texture->last_command_generation = renderer->render_command_generation;
+    }
+
+    if (renderer->QueueRetainedGeometry && !(texture && texture->atlas_page)) {
+        SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_GEOMETRY, texture);
+        if (cmd != NULL) {
+            if (renderer->sort_commands) {
+                const SDL_FRect *bounds = &geometry->bounds;
+                SetDrawBounds(cmd,
+                              (bounds->x + offset_x) * renderer->scale.x,
+                              (bounds->y + offset_y) * renderer->scale.y,
+                              (bounds->x + bounds->w + offset_x) * renderer->scale.x,
+                              (bounds->y + bounds->h + offset_y) * renderer->scale.y);
+            }
+            retval = renderer->QueueRetainedGeometry(renderer, cmd, cmd->data.draw.texture,
+                                                     geometry, offset_x, offset_y,
+                                                     renderer->scale.x, renderer->scale.y);
+            if (retval < 0) {
+                cmd->command = SDL_RENDERCMD_NO_OP;
+            }
+        } else {
+            retval = -1;
+        }
+    } else {
+        /* Draw it like any other geometry, moved by the offset */
+        const float *xy = geometry->xy;
+        float *moved = NULL;
+        SDL_bool isstack = SDL_FALSE;
+        int i;
+
+        if (offset_x != 0.0f || offset_y != 0.0f) {
+            moved = SDL_small_alloc(float, 2 * geometry->num_vertices, &isstack);
+            if (!moved) {
+                return SDL_OutOfMemory();
+            }
+            for (i = 0; i < geometry->num_vertices; ++i) {
+                moved[2 * i + 0] = xy[2 * i + 0] + offset_x;
+                moved[2 * i + 1] = xy[2 * i + 1] + offset_y;
+            }
+            xy = moved;
+        }
+
+        retval = QueueCmdGeometry(renderer, texture,
+                xy, 2 * sizeof (float),
+                geometry->color, sizeof (SDL_Color),
+                geometry->uv, 2 * sizeof (float),
+                geometry->num_vertices,
+                geometry->indices, geometry->num_indices, geometry->size_indices,
+                renderer->scale.x, renderer->scale.y);
+
+        if (moved) {
+            SDL_small_free(moved, isstack);
+        }
+    }
+
+    geometry->last_command_generation = renderer->render_command_generation;
+
+    return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
+}
+
+void
+SDL_DestroyGeometry(SDL_Geometry *geometry)
+{
+    SDL_Renderer *renderer;
+
+    CHECK_GEOMETRY_MAGIC(geometry, );
+
+    renderer = geometry->renderer;
+    if (geometry->last_command_generation == renderer->render_command_generation) {
+        /* the current command queue depends on this geometry, flush the queue now */
+        FlushRenderCommands(renderer);
+    }
+
+    geometry->magic = NULL;
+
+    if (geometry->next) {
+        geometry->next->prev = geometry->prev;
+    }
+    if (geometry->prev) {
+        geometry->prev->next = geometry->next;
+    } else {
+        renderer->geometries = geometry->next;
+    }
+
+    if (renderer->DestroyGeometry) {
+        renderer->DestroyGeometry(renderer, geometry);
+    }
+
+    SDL_free(geometry->xy);
+    SDL_free(geometry);
+}
+
 int
 SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                      Uint32 format, void * pixels, int pitch)
@@ -4284,6 +5685,11 @@ SDL_DestroyTexture(SDL_Texture * texture)
 
     CHECK_TEXTURE_MAGIC(texture, );
 
+    if (texture->atlas) {
+        SDL_DestroyAtlasTexture(texture);
+        return;
+    }
+
     renderer = texture->renderer;
     if (texture == renderer->target) {
         SDL_SetRenderTarget(renderer, NULL);  /* implies command queue flush */
@@ -4347,6 +5753,18 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
     }
 
     SDL_free(renderer->vertex_data);
+    SDL_free(renderer->sort_array);
+    SDL_free(renderer->sort_vertex_data);
+
+    /* Free texture atlases, with the textures allocated from them */
+    while (renderer->atlases) {
+        SDL_DestroyTextureAtlas(renderer->atlases);
+    }
+
+    /* Free retained geometry */
+    while (renderer->geometries) {
+        SDL_DestroyGeometry(renderer->geometries);
+    }
 
     /* Free existing textures for this renderer */
     while (renderer->textures) {
@@ -4376,7 +5794,9 @@ int SDL_GL_BindTexture(SDL_Texture *texture, float *texw, float *texh)
 
     CHECK_TEXTURE_MAGIC(texture, -1);
     renderer = texture->renderer;
-    if (texture->native) {
+    if (texture->atlas) {
+        return SDL_Unsupported();
+    } else if (texture->native) {
         return SDL_GL_BindTexture(texture->native, texw, texh);
     } else if (renderer && renderer->GL_BindTexture) {
         FlushRenderCommandsIfTextureNeeded(texture);  /* in case the app is going to mess with it. */
@@ -4392,7 +5812,9 @@ int SDL_GL_UnbindTexture(SDL_Texture *texture)
 
     CHECK_TEXTURE_MAGIC(texture, -1);
     renderer = texture->renderer;
-    if (texture->native) {
+    if (texture->atlas) {
+        return SDL_Unsupported();
+    } else if (texture->native) {
         return SDL_GL_UnbindTexture(texture->native);
     } else if (renderer && renderer->GL_UnbindTexture) {
         FlushRenderCommandsIfTextureNeeded(texture);  /* in case the app messed with it. */
@@ -48,6 +48,7 @@ typedef struct SDL_DRect
 /* The SDL 2D rendering system */
 
 typedef struct SDL_RenderDriver SDL_RenderDriver;
+typedef struct SDL_AtlasPage SDL_AtlasPage;
 
 /* Define the SDL texture structure */
 struct SDL_Texture
@@ -72,6 +73,11 @@ struct SDL_Texture
     SDL_Rect locked_rect;
     SDL_Surface *locked_surface;  /**< Locked region exposed as a SDL surface */
 
+    /* Support for textures allocated from a texture atlas */
+    SDL_TextureAtlas *atlas;
+    SDL_AtlasPage *atlas_page;
+    SDL_Rect atlas_rect;        /**< The area of the atlas page used by this texture */
+
     Uint32 last_command_generation; /* last command queue generation this texture was in. */
 
     void *driverdata;           /**< Driver specific texture representation */
@@ -81,6 +87,30 @@ struct SDL_Texture
     SDL_Texture *next;
 };
 
+/* Define the SDL geometry structure */
+struct SDL_Geometry
+{
+    const void *magic;
+    SDL_Renderer *renderer;
+
+    /* The vertex data, copied into tightly packed arrays */
+    float *xy;
+    SDL_Color *color;
+    float *uv;                  /**< NULL if the geometry has no texture coordinates */
+    int num_vertices;
+    void *indices;              /**< NULL if the vertices are drawn in order */
+    int num_indices;
+    int size_indices;
+    SDL_FRect bounds;           /**< The area covered by the vertex positions */
+
+    Uint32 last_command_generation; /* last command queue generation this geometry was in. */
+
+    void *driverdata;           /**< Driver specific geometry representation */
+
+    SDL_Geometry *prev;
+    SDL_Geometry *next;
+};
+
 typedef enum
 {
     SDL_RENDERCMD_NO_OP,
@@ -114,12 +144,17 @@ typedef struct SDL_RenderCommand
             Uint8 r, g, b, a;
             SDL_BlendMode blend;
             SDL_Texture *texture;
+            SDL_Geometry *geometry;  /* set by backends that draw retained geometry from their own copy */
+            SDL_FRect bounds;   /* area touched by the draw, only set when sorting commands */
         } draw;
         struct {
             size_t first;
             Uint8 r, g, b, a;
         } color;
     } data;
+    size_t vertex_begin;        /* the range of vertex data allocated for this command */
+    size_t vertex_end;
+    size_t vertex_alignment;
     struct SDL_RenderCommand *next;
 } SDL_RenderCommand;
 
@@ -165,6 +200,11 @@ struct SDL_Renderer
                           const float *xy, int xy_stride, const SDL_Color *color, int color_stride, const float *uv, int uv_stride,
                           int num_vertices, const void *indices, int num_indices, int size_indices,
                           float scale_x, float scale_y);
+    int (*CreateGeometry) (SDL_Renderer * renderer, SDL_Geometry * geometry);
+    int (*QueueRetainedGeometry) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                                  SDL_Geometry * geometry, float offset_x, float offset_y,
+                                  float scale_x, float scale_y);
+    void (*DestroyGeometry) (SDL_Renderer * renderer, SDL_Geometry * geometry);
 
     int (*RunCommandQueue) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize);
     int (*UpdateTexture) (SDL_Renderer * renderer, SDL_Texture * texture,
@@ -251,6 +291,12 @@ struct SDL_Renderer
     SDL_Texture *target;
     SDL_mutex *target_mutex;
 
+    /* The list of texture atlases */
+    SDL_TextureAtlas *atlases;
+
+    /* The list of retained geometry */
+    SDL_Geometry *geometries;
+
     SDL_Color color;                    /**< Color for drawing operations values */
     SDL_BlendMode blendMode;            /**< The drawing blend mode */
 
@@ -272,6 +318,15 @@ struct SDL_Renderer
     size_t vertex_data_used;
     size_t vertex_data_allocation;
 
+    /* Reordering of the command queue before it's flushed */
+    SDL_bool sort_commands;
+    SDL_RenderCommand **sort_array;
+    size_t sort_array_allocation;
+    void *sort_vertex_data;
+    size_t sort_vertex_data_allocation;
+    Uint64 sort_reordered;
+    Uint64 sort_state_changes_saved;
+
     void *driverdata;
 };
 
@@ -54,6 +54,9 @@ extern int SDL_RecreateWindow(SDL_Window * window, Uint32 flags);
 
 static const float inv255f = 1.0f / 255.0f;
 
+#define GL_VERTEX_BUFFER_SECTIONS   4
+#define GL_PIXEL_BUFFER_COUNT       3
+
 typedef struct GL_FBOList GL_FBOList;
 
 struct GL_FBOList
@@ -119,6 +122,40 @@ typedef struct
     PFNGLBINDFRAMEBUFFEREXTPROC glBindFramebufferEXT;
     PFNGLCHECKFRAMEBUFFERSTATUSEXTPROC glCheckFramebufferStatusEXT;
 
+    /* Buffer object support */
+    SDL_bool GL_ARB_vertex_buffer_object_supported;
+    SDL_bool GL_ARB_pixel_buffer_object_supported;
+    SDL_bool GL_ARB_buffer_storage_supported;
+    SDL_bool vertex_buffers_enabled;
+    PFNGLGENBUFFERSARBPROC glGenBuffersARB;
+    PFNGLDELETEBUFFERSARBPROC glDeleteBuffersARB;
+    PFNGLBINDBUFFERARBPROC glBindBufferARB;
+    PFNGLBUFFERDATAARBPROC glBufferDataARB;
+    PFNGLBUFFERSUBDATAARBPROC glBufferSubDataARB;
+    PFNGLMAPBUFFERARBPROC glMapBufferARB;
+    PFNGLUNMAPBUFFERARBPROC glUnmapBufferARB;
+    PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+    PFNGLBUFFERSTORAGEPROC glBufferStorage;
+    PFNGLFENCESYNCPROC glFenceSync;
+    PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+    PFNGLDELETESYNCPROC glDeleteSync;
+
+    /* The vertex data of each RunCommandQueue call is copied into this
+       buffer once, at a rising offset, wrapping around when it runs out of
+       space. With ARB_buffer_storage the buffer stays mapped and each
+       quarter of it gets a fence when the writer moves on to the next one,
+       which is waited on before the writer comes back to it on the next
+       lap. Otherwise the buffer is orphaned on wraparound so the driver
+       never has to wait for pending draws. */
+    GLuint vertex_buffer;
+    size_t vertex_buffer_size;
+    size_t vertex_buffer_offset;
+    Uint8 *vertex_buffer_mapping;
+    GLsync vertex_buffer_fences[GL_VERTEX_BUFFER_SECTIONS];
+    int vertex_buffer_section;          /* the section the writer is in */
+    int vertex_buffer_fence_first;      /* sections the current flush left, */
+    int vertex_buffer_fence_count;      /*  to be fenced once it's drawn */
+
     /* Shader support */
     GL_ShaderContext *shaders;
 
@@ -137,6 +174,12 @@ typedef struct
     int pitch;
     SDL_Rect locked_rect;
 
+    /* Streaming textures are locked and updated through a ring of pixel
+       buffers, so glTexSubImage2D() can return before the upload is done */
+    GLuint pbos[GL_PIXEL_BUFFER_COUNT];
+    int current_pbo;
+    SDL_bool pbo_locked;
+
 #if SDL_HAVE_YUV
     /* YUV texture support */
     SDL_bool yuv;
@@ -450,6 +493,76 @@ convert_format(GL_RenderData *renderdata, Uint32 pixel_format,
     return SDL_TRUE;
 }
 
+/* Size of the tightly packed pixel data of a w x h area, including the chroma planes */
+static size_t
+GL_GetPixelDataSize(Uint32 format, int w, int h)
+{
+    size_t size = (size_t)h * w * SDL_BYTESPERPIXEL(format);
+
+    if (format == SDL_PIXELFORMAT_YV12 ||
+        format == SDL_PIXELFORMAT_IYUV) {
+        /* Need to add size for the U and V planes */
+        size += 2 * (size_t)((h + 1) / 2) * ((w + 1) / 2);
+    }
+    if (format == SDL_PIXELFORMAT_NV12 ||
+        format == SDL_PIXELFORMAT_NV21) {
+        /* Need to add size for the U/V plane */
+        size += 2 * (size_t)((h + 1) / 2) * ((w + 1) / 2);
+    }
+    return size;
+}
+
+/* Maps the next pixel buffer of a streaming texture for writing and leaves
+   it bound, so glTexSubImage2D() takes offsets into it instead of pointers.
+   The buffer is orphaned first, so this never waits for an upload that is
+   still reading from it. */
+static Uint8 *
+GL_MapPixelBuffer(GL_RenderData *renderdata, GL_TextureData *data, size_t size)
+{
+    Uint8 *mapping;
+
+    data->current_pbo = (data->current_pbo + 1) % GL_PIXEL_BUFFER_COUNT;
+    renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->pbos[data->current_pbo]);
+    renderdata->glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, (GLsizeiptrARB)size, NULL, GL_STREAM_DRAW_ARB);
+    if (renderdata->glMapBufferRange) {
+        mapping = (Uint8 *)renderdata->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER_ARB, 0, (GLsizeiptr)size,
+                                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    } else {
+        mapping = (Uint8 *)renderdata->glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+    }
+    if (!mapping) {
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+    }
+    return mapping;
+}
+
+/* Unmaps the bound pixel buffer. If the contents got lost while it was
+   mapped, the buffer is unbound and SDL_FALSE is returned. */
+static SDL_bool
+GL_UnmapPixelBuffer(GL_RenderData *renderdata)
+{
+    if (!renderdata->glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB)) {
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static Uint8 *
+GL_CopyPlane(Uint8 *dst, const Uint8 *src, int src_pitch, int length, int rows)
+{
+    if (src_pitch == length) {
+        SDL_memcpy(dst, src, (size_t)length * rows);
+        return dst + (size_t)length * rows;
+    }
+    while (rows--) {
+        SDL_memcpy(dst, src, length);
+        src += src_pitch;
+        dst += length;
+    }
+    return dst;
+}
+
 static int
 GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
@@ -482,23 +595,23 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     }
 
     if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
-        size_t size;
+        SDL_bool use_pbo = renderdata->GL_ARB_pixel_buffer_object_supported;
+#ifdef __MACOSX__
+        /* These use client storage below, which reads straight from data->pixels */
+        if (texture->format == SDL_PIXELFORMAT_ARGB8888 && (texture->w % 8) == 0) {
+            use_pbo = SDL_FALSE;
+        }
+#endif
         data->pitch = texture->w * SDL_BYTESPERPIXEL(texture->format);
-        size = texture->h * data->pitch;
-        if (texture->format == SDL_PIXELFORMAT_YV12 ||
-            texture->format == SDL_PIXELFORMAT_IYUV) {
-            /* Need to add size for the U and V planes */
-            size += 2 * ((texture->h + 1) / 2) * ((data->pitch + 1) / 2);
-        }
-        if (texture->format == SDL_PIXELFORMAT_NV12 ||
-            texture->format == SDL_PIXELFORMAT_NV21) {
-            /* Need to add size for the U/V plane */
-            size += 2 * ((texture->h + 1) / 2) * ((data->pitch + 1) / 2);
-        }
-        data->pixels = SDL_calloc(1, size);
-        if (!data->pixels) {
-            SDL_free(data);
-            return SDL_OutOfMemory();
+        if (use_pbo) {
+            /* The pixel buffers replace the shadow copy, it's only allocated if mapping fails */
+            renderdata->glGenBuffersARB(GL_PIXEL_BUFFER_COUNT, data->pbos);
+        } else {
+            data->pixels = SDL_calloc(1, GL_GetPixelDataSize(texture->format, texture->w, texture->h));
+            if (!data->pixels) {
+                SDL_free(data);
+                return SDL_OutOfMemory();
+            }
         }
     }
 
@@ -511,6 +624,9 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     GL_CheckError("", renderer);
     renderdata->glGenTextures(1, &data->texture);
     if (GL_CheckError("glGenTextures()", renderer) < 0) {
+        if (data->pbos[0]) {
+            renderdata->glDeleteBuffersARB(GL_PIXEL_BUFFER_COUNT, data->pbos);
+        }
         if (data->pixels) {
             SDL_free(data->pixels);
         }
@@ -697,8 +813,9 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     return GL_CheckError("", renderer);
 }
 
+/* Uploads from client memory, or from the bound pixel buffer */
 static int
-GL_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
+GL_UploadTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                  const SDL_Rect * rect, const void *pixels, int pitch)
 {
     GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
@@ -759,9 +876,48 @@ GL_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
     return GL_CheckError("glTexSubImage2D()", renderer);
 }
 
+static int
+GL_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
+                 const SDL_Rect * rect, const void *pixels, int pitch)
+{
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
+    GL_TextureData *data = (GL_TextureData *) texture->driverdata;
+
+    if (data->pbos[0] && rect->w > 0 && rect->h > 0) {
+        const int packed_pitch = rect->w * SDL_BYTESPERPIXEL(texture->format);
+        Uint8 *dst;
+
+        GL_ActivateRenderer(renderer);
+
+        dst = GL_MapPixelBuffer(renderdata, data, GL_GetPixelDataSize(texture->format, rect->w, rect->h));
+        if (dst) {
+            const Uint8 *src = (const Uint8 *) pixels;
+
+            dst = GL_CopyPlane(dst, src, pitch, packed_pitch, rect->h);
+#if SDL_HAVE_YUV
+            if (data->yuv) {
+                src += rect->h * pitch;
+                dst = GL_CopyPlane(dst, src, (pitch + 1) / 2, (rect->w + 1) / 2, (rect->h + 1) / 2);
+                src += ((rect->h + 1) / 2) * ((pitch + 1) / 2);
+                GL_CopyPlane(dst, src, (pitch + 1) / 2, (rect->w + 1) / 2, (rect->h + 1) / 2);
+            } else if (data->nv12) {
+                src += rect->h * pitch;
+                GL_CopyPlane(dst, src, 2 * ((pitch + 1) / 2), 2 * ((rect->w + 1) / 2), (rect->h + 1) / 2);
+            }
+#endif
+            if (GL_UnmapPixelBuffer(renderdata)) {
+                int retval = GL_UploadTexture(renderer, texture, rect, NULL, packed_pitch);
+                renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+                return retval;
+            }
+        }
+    }
+    return GL_UploadTexture(renderer, texture, rect, pixels, pitch);
+}
+
 #if SDL_HAVE_YUV
 static int
-GL_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
+GL_UploadTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
                     const SDL_Rect * rect,
                     const Uint8 *Yplane, int Ypitch,
                     const Uint8 *Uplane, int Upitch,
@@ -798,7 +954,45 @@ GL_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
 }
 
 static int
-GL_UpdateTextureNV(SDL_Renderer * renderer, SDL_Texture * texture,
+GL_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
+                    const SDL_Rect * rect,
+                    const Uint8 *Yplane, int Ypitch,
+                    const Uint8 *Uplane, int Upitch,
+                    const Uint8 *Vplane, int Vpitch)
+{
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
+    GL_TextureData *data = (GL_TextureData *) texture->driverdata;
+
+    if (data->pbos[0] && rect->w > 0 && rect->h > 0) {
+        const int uvw = (rect->w + 1) / 2;
+        const int uvh = (rect->h + 1) / 2;
+        const size_t ysize = (size_t)rect->w * rect->h;
+        const size_t uvsize = (size_t)uvw * uvh;
+        Uint8 *dst;
+
+        GL_ActivateRenderer(renderer);
+
+        dst = GL_MapPixelBuffer(renderdata, data, ysize + 2 * uvsize);
+        if (dst) {
+            dst = GL_CopyPlane(dst, Yplane, Ypitch, rect->w, rect->h);
+            dst = GL_CopyPlane(dst, Uplane, Upitch, uvw, uvh);
+            GL_CopyPlane(dst, Vplane, Vpitch, uvw, uvh);
+            if (GL_UnmapPixelBuffer(renderdata)) {
+                const Uint8 *base = NULL;
+                int retval = GL_UploadTextureYUV(renderer, texture, rect,
+                                                 base, rect->w,
+                                                 base + ysize, uvw,
+                                                 base + ysize + uvsize, uvw);
+                renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+                return retval;
+            }
+        }
+    }
+    return GL_UploadTextureYUV(renderer, texture, rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch);
+}
+
+static int
+GL_UploadTextureNV(SDL_Renderer * renderer, SDL_Texture * texture,
                     const SDL_Rect * rect,
                     const Uint8 *Yplane, int Ypitch,
                     const Uint8 *UVplane, int UVpitch)
@@ -827,15 +1021,74 @@ GL_UpdateTextureNV(SDL_Renderer * renderer, SDL_Texture * texture,
 
     return GL_CheckError("glTexSubImage2D()", renderer);
 }
+
+static int
+GL_UpdateTextureNV(SDL_Renderer * renderer, SDL_Texture * texture,
+                    const SDL_Rect * rect,
+                    const Uint8 *Yplane, int Ypitch,
+                    const Uint8 *UVplane, int UVpitch)
+{
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
+    GL_TextureData *data = (GL_TextureData *) texture->driverdata;
+
+    if (data->pbos[0] && rect->w > 0 && rect->h > 0) {
+        const int uvpitch = 2 * ((rect->w + 1) / 2);
+        const size_t ysize = (size_t)rect->w * rect->h;
+        Uint8 *dst;
+
+        GL_ActivateRenderer(renderer);
+
+        dst = GL_MapPixelBuffer(renderdata, data, ysize + (size_t)uvpitch * ((rect->h + 1) / 2));
+        if (dst) {
+            dst = GL_CopyPlane(dst, Yplane, Ypitch, rect->w, rect->h);
+            GL_CopyPlane(dst, UVplane, UVpitch, uvpitch, (rect->h + 1) / 2);
+            if (GL_UnmapPixelBuffer(renderdata)) {
+                const Uint8 *base = NULL;
+                int retval = GL_UploadTextureNV(renderer, texture, rect,
+                                                base, rect->w,
+                                                base + ysize, uvpitch);
+                renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+                return retval;
+            }
+        }
+    }
+    return GL_UploadTextureNV(renderer, texture, rect, Yplane, Ypitch, UVplane, UVpitch);
+}
 #endif
 
 static int
 GL_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                const SDL_Rect * rect, void **pixels, int *pitch)
 {
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
     GL_TextureData *data = (GL_TextureData *) texture->driverdata;
 
     data->locked_rect = *rect;
+
+    if (data->pbos[0]) {
+        Uint8 *mapping;
+
+        GL_ActivateRenderer(renderer);
+
+        /* Hand out the locked area tightly packed, that's how it gets uploaded */
+        mapping = GL_MapPixelBuffer(renderdata, data, GL_GetPixelDataSize(texture->format, rect->w, rect->h));
+        if (mapping) {
+            /* It stays mapped until unlocked, but must not be bound meanwhile */
+            renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+            data->pbo_locked = SDL_TRUE;
+            *pixels = mapping;
+            *pitch = rect->w * SDL_BYTESPERPIXEL(texture->format);
+            return 0;
+        }
+
+        if (!data->pixels) {
+            data->pixels = SDL_calloc(1, GL_GetPixelDataSize(texture->format, texture->w, texture->h));
+            if (!data->pixels) {
+                return SDL_OutOfMemory();
+            }
+        }
+    }
+
     *pixels =
         (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
                   rect->x * SDL_BYTESPERPIXEL(texture->format));
@@ -846,15 +1099,30 @@ GL_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
 static void
 GL_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
     GL_TextureData *data = (GL_TextureData *) texture->driverdata;
     const SDL_Rect *rect;
     void *pixels;
 
     rect = &data->locked_rect;
+
+    if (data->pbo_locked) {
+        data->pbo_locked = SDL_FALSE;
+
+        GL_ActivateRenderer(renderer);
+
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->pbos[data->current_pbo]);
+        if (GL_UnmapPixelBuffer(renderdata)) {
+            GL_UploadTexture(renderer, texture, rect, NULL, rect->w * SDL_BYTESPERPIXEL(texture->format));
+            renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+        }
+        return;
+    }
+
     pixels =
         (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
                   rect->x * SDL_BYTESPERPIXEL(texture->format));
-    GL_UpdateTexture(renderer, texture, rect, pixels, data->pitch);
+    GL_UploadTexture(renderer, texture, rect, pixels, data->pitch);
 }
 
 static void
@@ -1198,16 +1466,199 @@ SetCopyState(GL_RenderData *data, const SDL_RenderCommand *cmd)
     return 0;
 }
 
+#define GL_VERTEX_BUFFER_MIN_SIZE   (1024 * 1024)
+
+static void
+GL_DestroyVertexBuffer(GL_RenderData *data)
+{
+    int i;
+
+    for (i = 0; i < GL_VERTEX_BUFFER_SECTIONS; ++i) {
+        if (data->vertex_buffer_fences[i]) {
+            data->glDeleteSync(data->vertex_buffer_fences[i]);
+            data->vertex_buffer_fences[i] = NULL;
+        }
+    }
+    if (data->vertex_buffer) {
+        /* This unmaps the buffer too, if it's persistently mapped */
+        data->glDeleteBuffersARB(1, &data->vertex_buffer);
+        data->vertex_buffer = 0;
+    }
+    data->vertex_buffer_mapping = NULL;
+    data->vertex_buffer_size = 0;
+    data->vertex_buffer_offset = 0;
+    data->vertex_buffer_section = 0;
+    data->vertex_buffer_fence_count = 0;
+}
+
+static int
+GL_CreatePersistentVertexBuffer(GL_RenderData *data, size_t size)
+{
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    GL_DestroyVertexBuffer(data);
+
+    data->glGenBuffersARB(1, &data->vertex_buffer);
+    data->glBindBufferARB(GL_ARRAY_BUFFER_ARB, data->vertex_buffer);
+    data->glBufferStorage(GL_ARRAY_BUFFER_ARB, (GLsizeiptr)size, NULL, flags);
+    data->vertex_buffer_mapping = (Uint8 *)data->glMapBufferRange(GL_ARRAY_BUFFER_ARB, 0, (GLsizeiptr)size, flags);
+    if (!data->vertex_buffer_mapping) {
+        GL_DestroyVertexBuffer(data);
+        return -1;
+    }
+    data->vertex_buffer_size = size;
+    return 0;
+}
+
+static void
+GL_FenceVertexBufferSection(GL_RenderData *data, int section)
+{
+    if (data->vertex_buffer_fences[section]) {
+        data->glDeleteSync(data->vertex_buffer_fences[section]);
+    }
+    data->vertex_buffer_fences[section] = data->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+static void
+GL_WaitVertexBufferFence(GL_RenderData *data, int section)
+{
+    GLsync fence = data->vertex_buffer_fences[section];
+
+    if (fence) {
+        for (;;) {
+            GLenum result = data->glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            if (result != GL_TIMEOUT_EXPIRED) {
+                break;  /* signaled, or the wait failed and we can't do any better */
+            }
+        }
+        data->glDeleteSync(fence);
+        data->vertex_buffer_fences[section] = NULL;
+    }
+}
+
+/* Copies the vertex data for this flush into the vertex buffer and leaves it
+   bound. Returns the offset of the data in the buffer, or -1 if the data
+   should be drawn from client memory instead. */
+static Sint64
+GL_UploadVertices(GL_RenderData *data, const void *vertices, size_t vertsize)
+{
+    size_t offset = data->vertex_buffer_offset;
+
+    if (!data->vertex_buffers_enabled || vertsize == 0) {
+        return -1;
+    }
+
+    if (data->GL_ARB_buffer_storage_supported) {
+        size_t section_size;
+        int first, last, i;
+        SDL_bool wrapped = SDL_FALSE;
+
+        /* Keep at least two flushes worth of data in flight */
+        if (vertsize > data->vertex_buffer_size / 2) {
+            size_t size = GL_VERTEX_BUFFER_MIN_SIZE;
+            while (size / 2 < vertsize) {
+                size *= 2;
+            }
+            if (GL_CreatePersistentVertexBuffer(data, size) < 0) {
+                /* Don't bother anymore, stick to client arrays */
+                data->GL_ARB_buffer_storage_supported = SDL_FALSE;
+                data->vertex_buffers_enabled = SDL_FALSE;
+                return -1;
+            }
+            offset = 0;
+        } else {
+            data->glBindBufferARB(GL_ARRAY_BUFFER_ARB, data->vertex_buffer);
+        }
+
+        if (offset + vertsize > data->vertex_buffer_size) {
+            offset = 0;
+            wrapped = SDL_TRUE;
+        }
+
+        section_size = data->vertex_buffer_size / GL_VERTEX_BUFFER_SECTIONS;
+        first = (int)(offset / section_size);
+        last = (int)((offset + vertsize - 1) / section_size);
+
+        /* Leaving the section we were writing: the draws in it have all
+           been issued by now, so fence it for the next lap. */
+        if (wrapped || first != data->vertex_buffer_section) {
+            GL_FenceVertexBufferSection(data, data->vertex_buffer_section);
+        }
+
+        /* Entering sections on a new lap: wait until the GPU is done with
+           what we wrote there last time. */
+        for (i = first; i <= last; ++i) {
+            if (wrapped || i != data->vertex_buffer_section) {
+                GL_WaitVertexBufferFence(data, i);
+            }
+        }
+
+        /* Sections this flush passes through get fenced after its draws */
+        data->vertex_buffer_fence_first = first;
+        data->vertex_buffer_fence_count = last - first;
+        data->vertex_buffer_section = last;
+
+        SDL_memcpy(data->vertex_buffer_mapping + offset, vertices, vertsize);
+    } else {
+        if (!data->vertex_buffer) {
+            data->glGenBuffersARB(1, &data->vertex_buffer);
+        }
+        data->glBindBufferARB(GL_ARRAY_BUFFER_ARB, data->vertex_buffer);
+
+        if (offset + vertsize > data->vertex_buffer_size) {
+            /* Orphan the old storage, the driver hands us fresh memory and
+               frees the old one once the draws using it are done */
+            size_t size = SDL_max(data->vertex_buffer_size, GL_VERTEX_BUFFER_MIN_SIZE);
+            while (size < vertsize) {
+                size *= 2;
+            }
+            data->glBufferDataARB(GL_ARRAY_BUFFER_ARB, (GLsizeiptrARB)size, NULL, GL_STREAM_DRAW_ARB);
+            data->vertex_buffer_size = size;
+            offset = 0;
+        }
+        data->glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, (GLintptrARB)offset, (GLsizeiptrARB)vertsize, vertices);
+    }
+
+    /* Keep the next flush nicely aligned */
+    data->vertex_buffer_offset = (offset + vertsize + 63) & ~((size_t)63);
+    return (Sint64)offset;
+}
+
+/* Called after the draws of a flush have been issued */
+static void
+GL_FinishVertices(GL_RenderData *data)
+{
+    if (data->vertex_buffer_mapping) {
+        int i;
+
+        /* The section the flush ends in is fenced when a later flush leaves it */
+        for (i = 0; i < data->vertex_buffer_fence_count; ++i) {
+            GL_FenceVertexBufferSection(data, data->vertex_buffer_fence_first + i);
+        }
+        data->vertex_buffer_fence_count = 0;
+    }
+
+    /* External code may use client arrays, which don't work with a buffer bound */
+    data->glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+}
+
 static int
 GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
 {
-    /* !!! FIXME: it'd be nice to use a vertex buffer instead of immediate mode... */
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    const Uint8 *vertbase = (const Uint8 *) vertices;
+    Sint64 vertoffset;
 
     if (GL_ActivateRenderer(renderer) < 0) {
         return -1;
     }
 
+    vertoffset = GL_UploadVertices(data, vertices, vertsize);
+    if (vertoffset >= 0) {
+        /* The gl*Pointer calls take offsets into the bound buffer now */
+        vertbase = (const Uint8 *) NULL + (size_t) vertoffset;
+    }
+
     data->drawstate.target = renderer->target;
     if (!data->drawstate.target) {
         int w, h;
@@ -1301,7 +1752,7 @@ GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
             case SDL_RENDERCMD_DRAW_LINES: {
                 if (SetDrawState(data, cmd, SHADER_SOLID) == 0) {
                     size_t count = cmd->data.draw.count;
-                    const GLfloat *verts = (GLfloat *) (((Uint8 *) vertices) + cmd->data.draw.first);
+                    const GLfloat *verts = (const GLfloat *) (vertbase + cmd->data.draw.first);
 
                     /* SetDrawState handles glEnableClientState. */
                     data->glVertexPointer(2, GL_FLOAT, sizeof(float) * 2, verts);
@@ -1368,7 +1819,7 @@ GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                 }
 
                 if (ret == 0) {
-                    const GLfloat *verts = (GLfloat *) (((Uint8 *) vertices) + cmd->data.draw.first);
+                    const GLfloat *verts = (const GLfloat *) (vertbase + cmd->data.draw.first);
                     int op = GL_TRIANGLES; /* SDL_RENDERCMD_GEOMETRY */
                     if (thiscmdtype == SDL_RENDERCMD_DRAW_POINTS) {
                         op = GL_POINTS;
@@ -1428,6 +1879,10 @@ GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
         data->drawstate.texture_array = SDL_FALSE;
     }
 
+    if (vertoffset >= 0) {
+        GL_FinishVertices(data);
+    }
+
     return GL_CheckError("", renderer);
 }
 
@@ -1537,6 +1992,9 @@ GL_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
         renderdata->glDeleteTextures(1, &data->vtexture);
     }
 #endif
+    if (data->pbos[0]) {
+        renderdata->glDeleteBuffersARB(GL_PIXEL_BUFFER_COUNT, data->pbos);
+    }
     SDL_free(data->pixels);
     SDL_free(data);
     texture->driverdata = NULL;
@@ -1565,6 +2023,9 @@ GL_DestroyRenderer(SDL_Renderer * renderer)
             GL_DestroyShaderContext(data->shaders);
         }
         if (data->context) {
+            if (data->vertex_buffers_enabled) {
+                GL_DestroyVertexBuffer(data);
+            }
             while (data->framebuffers) {
                 GL_FBOList *nextnode = data->framebuffers->next;
                 /* delete the framebuffer object */
@@ -1947,6 +2408,52 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     }
     data->framebuffers = NULL;
 
+    /* Check for buffer object support */
+    if (SDL_GL_ExtensionSupported("GL_ARB_vertex_buffer_object")) {
+        data->glGenBuffersARB = (PFNGLGENBUFFERSARBPROC) SDL_GL_GetProcAddress("glGenBuffersARB");
+        data->glDeleteBuffersARB = (PFNGLDELETEBUFFERSARBPROC) SDL_GL_GetProcAddress("glDeleteBuffersARB");
+        data->glBindBufferARB = (PFNGLBINDBUFFERARBPROC) SDL_GL_GetProcAddress("glBindBufferARB");
+        data->glBufferDataARB = (PFNGLBUFFERDATAARBPROC) SDL_GL_GetProcAddress("glBufferDataARB");
+        data->glBufferSubDataARB = (PFNGLBUFFERSUBDATAARBPROC) SDL_GL_GetProcAddress("glBufferSubDataARB");
+        data->glMapBufferARB = (PFNGLMAPBUFFERARBPROC) SDL_GL_GetProcAddress("glMapBufferARB");
+        data->glUnmapBufferARB = (PFNGLUNMAPBUFFERARBPROC) SDL_GL_GetProcAddress("glUnmapBufferARB");
+        if (data->glGenBuffersARB && data->glDeleteBuffersARB && data->glBindBufferARB &&
+            data->glBufferDataARB && data->glBufferSubDataARB &&
+            data->glMapBufferARB && data->glUnmapBufferARB) {
+            data->GL_ARB_vertex_buffer_object_supported = SDL_TRUE;
+        }
+    }
+    if (data->GL_ARB_vertex_buffer_object_supported &&
+        SDL_GL_ExtensionSupported("GL_ARB_map_buffer_range")) {
+        data->glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC) SDL_GL_GetProcAddress("glMapBufferRange");
+    }
+    if (data->GL_ARB_vertex_buffer_object_supported &&
+        (SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object") ||
+         SDL_GL_ExtensionSupported("GL_EXT_pixel_buffer_object"))) {
+        data->GL_ARB_pixel_buffer_object_supported = SDL_TRUE;
+    }
+    if (data->GL_ARB_vertex_buffer_object_supported &&
+        SDL_GetHintBoolean(SDL_HINT_RENDER_OPENGL_VERTEX_BUFFERS, SDL_TRUE)) {
+        data->vertex_buffers_enabled = SDL_TRUE;
+    }
+    if (data->vertex_buffers_enabled && data->glMapBufferRange &&
+        SDL_GL_ExtensionSupported("GL_ARB_buffer_storage") &&
+        SDL_GL_ExtensionSupported("GL_ARB_sync")) {
+        data->glBufferStorage = (PFNGLBUFFERSTORAGEPROC) SDL_GL_GetProcAddress("glBufferStorage");
+        data->glFenceSync = (PFNGLFENCESYNCPROC) SDL_GL_GetProcAddress("glFenceSync");
+        data->glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC) SDL_GL_GetProcAddress("glClientWaitSync");
+        data->glDeleteSync = (PFNGLDELETESYNCPROC) SDL_GL_GetProcAddress("glDeleteSync");
+        if (data->glBufferStorage && data->glFenceSync &&
+            data->glClientWaitSync && data->glDeleteSync) {
+            data->GL_ARB_buffer_storage_supported = SDL_TRUE;
+        }
+    }
+    SDL_LogInfo(SDL_LOG_CATEGORY_RENDER, "OpenGL vertex buffers: %s",
+                data->GL_ARB_buffer_storage_supported ? "PERSISTENT" :
+                data->vertex_buffers_enabled ? "ENABLED" : "DISABLED");
+    SDL_LogInfo(SDL_LOG_CATEGORY_RENDER, "OpenGL pixel buffers: %s",
+                data->GL_ARB_pixel_buffer_object_supported ? "ENABLED" : "DISABLED");
+
     /* Set up parameters for rendering */
     data->glMatrixMode(GL_MODELVIEW);
     data->glLoadIdentity();
@@ -45,6 +45,19 @@
 #define RENDERER_CONTEXT_MAJOR 2
 #define RENDERER_CONTEXT_MINOR 0
 
+/* Pixel buffer objects are core in OpenGL ES 3.0, which the ES 2.0 headers don't cover */
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_BUFFER_BIT
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#endif
+
+#define GLES2_PIXEL_BUFFER_COUNT 3
+
 /* Used to re-create the window with OpenGL ES capability */
 extern int SDL_RecreateWindow(SDL_Window * window, Uint32 flags);
 
@@ -69,6 +82,12 @@ typedef struct GLES2_TextureData
     GLenum pixel_type;
     void *pixel_data;
     int pitch;
+    SDL_Rect locked_rect;
+    /* Streaming textures are locked and updated through a ring of pixel
+       buffers, so glTexSubImage2D() can return before the upload is done */
+    GLuint pbos[GLES2_PIXEL_BUFFER_COUNT];
+    int current_pbo;
+    SDL_bool pbo_locked;
 #if SDL_HAVE_YUV
     /* YUV texture support */
     SDL_bool yuv;
@@ -154,6 +173,11 @@ typedef struct GLES2_RenderData
 #define SDL_PROC(ret,func,params) ret (APIENTRY *func) params;
 #include "SDL_gles2funcs.h"
 #undef SDL_PROC
+    /* OpenGL ES 3.0 functions, only used if available */
+    void *(APIENTRY *glMapBufferRange)(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+    GLboolean (APIENTRY *glUnmapBuffer)(GLenum);
+    SDL_bool pixel_buffers_supported;
+
     GLES2_FBOList *framebuffers;
     GLuint window_framebuffer;
 
@@ -1347,6 +1371,71 @@ GLES2_DestroyRenderer(SDL_Renderer *renderer)
     SDL_free(renderer);
 }
 
+/* Size of the tightly packed pixel data of a w x h area, including the chroma planes */
+static size_t
+GLES2_GetPixelDataSize(Uint32 format, int w, int h)
+{
+    size_t size = (size_t)h * w * SDL_BYTESPERPIXEL(format);
+
+#if SDL_HAVE_YUV
+    if (format == SDL_PIXELFORMAT_YV12 || format == SDL_PIXELFORMAT_IYUV) {
+        /* Need to add size for the U and V planes */
+        size += 2 * (size_t)((h + 1) / 2) * ((w + 1) / 2);
+    } else if (format == SDL_PIXELFORMAT_NV12 || format == SDL_PIXELFORMAT_NV21) {
+        /* Need to add size for the U/V plane */
+        size += 2 * (size_t)((h + 1) / 2) * ((w + 1) / 2);
+    }
+#endif
+    return size;
+}
+
+/* Maps the next pixel buffer of a streaming texture for writing and leaves
+   it bound, so glTexSubImage2D() takes offsets into it instead of pointers.
+   The whole buffer is invalidated, so this never waits for an upload that
+   is still reading from it. */
+static Uint8 *
+GLES2_MapPixelBuffer(GLES2_RenderData *data, GLES2_TextureData *tdata, size_t size)
+{
+    Uint8 *mapping;
+
+    tdata->current_pbo = (tdata->current_pbo + 1) % GLES2_PIXEL_BUFFER_COUNT;
+    data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, tdata->pbos[tdata->current_pbo]);
+    data->glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_DRAW);
+    mapping = (Uint8 *)data->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size,
+                                              GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!mapping) {
+        data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    return mapping;
+}
+
+/* Unmaps the bound pixel buffer. If the contents got lost while it was
+   mapped, the buffer is unbound and SDL_FALSE is returned. */
+static SDL_bool
+GLES2_UnmapPixelBuffer(GLES2_RenderData *data)
+{
+    if (!data->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+        data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static Uint8 *
+GLES2_CopyPlane(Uint8 *dst, const Uint8 *src, int src_pitch, int length, int rows)
+{
+    if (src_pitch == length) {
+        SDL_memcpy(dst, src, (size_t)length * rows);
+        return dst + (size_t)length * rows;
+    }
+    while (rows--) {
+        SDL_memcpy(dst, src, length);
+        src += src_pitch;
+        dst += length;
+    }
+    return dst;
+}
+
 static int
 GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
@@ -1417,22 +1506,16 @@ GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 
     /* Allocate a blob for image renderdata */
     if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
-        size_t size;
         data->pitch = texture->w * SDL_BYTESPERPIXEL(texture->format);
-        size = texture->h * data->pitch;
-#if SDL_HAVE_YUV
-        if (data->yuv) {
-            /* Need to add size for the U and V planes */
-            size += 2 * ((texture->h + 1) / 2) * ((data->pitch + 1) / 2);
-        } else if (data->nv12) {
-            /* Need to add size for the U/V plane */
-            size += 2 * ((texture->h + 1) / 2) * ((data->pitch + 1) / 2);
-        }
-#endif
-        data->pixel_data = SDL_calloc(1, size);
-        if (!data->pixel_data) {
-            SDL_free(data);
-            return SDL_OutOfMemory();
+        if (renderdata->pixel_buffers_supported) {
+            /* The pixel buffers replace the blob, it's only allocated if mapping fails */
+            renderdata->glGenBuffers(GLES2_PIXEL_BUFFER_COUNT, data->pbos);
+        } else {
+            data->pixel_data = SDL_calloc(1, GLES2_GetPixelDataSize(texture->format, texture->w, texture->h));
+            if (!data->pixel_data) {
+                SDL_free(data);
+                return SDL_OutOfMemory();
+            }
         }
     }
 
@@ -1575,8 +1658,9 @@ GLES2_TexSubImage2D(GLES2_RenderData *data, GLenum target, GLint xoffset, GLint
     return 0;
 }
 
+/* Uploads from client memory, or from the bound pixel buffer if pitch is tightly packed */
 static int
-GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *rect,
+GLES2_UploadTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *rect,
                     const void *pixels, int pitch)
 {
     GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
@@ -1654,9 +1738,48 @@ GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
     return GL_CheckError("glTexSubImage2D()", renderer);
 }
 
+static int
+GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *rect,
+                    const void *pixels, int pitch)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
+
+    if (tdata->pbos[0] && rect->w > 0 && rect->h > 0) {
+        const int packed_pitch = rect->w * SDL_BYTESPERPIXEL(texture->format);
+        Uint8 *dst;
+
+        GLES2_ActivateRenderer(renderer);
+
+        dst = GLES2_MapPixelBuffer(data, tdata, GLES2_GetPixelDataSize(texture->format, rect->w, rect->h));
+        if (dst) {
+            const Uint8 *src = (const Uint8 *)pixels;
+
+            dst = GLES2_CopyPlane(dst, src, pitch, packed_pitch, rect->h);
+#if SDL_HAVE_YUV
+            if (tdata->yuv) {
+                src += rect->h * pitch;
+                dst = GLES2_CopyPlane(dst, src, (pitch + 1) / 2, (rect->w + 1) / 2, (rect->h + 1) / 2);
+                src += ((rect->h + 1) / 2) * ((pitch + 1) / 2);
+                GLES2_CopyPlane(dst, src, (pitch + 1) / 2, (rect->w + 1) / 2, (rect->h + 1) / 2);
+            } else if (tdata->nv12) {
+                src += rect->h * pitch;
+                GLES2_CopyPlane(dst, src, 2 * ((pitch + 1) / 2), 2 * ((rect->w + 1) / 2), (rect->h + 1) / 2);
+            }
+#endif
+            if (GLES2_UnmapPixelBuffer(data)) {
+                int retval = GLES2_UploadTexture(renderer, texture, rect, NULL, packed_pitch);
+                data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                return retval;
+            }
+        }
+    }
+    return GLES2_UploadTexture(renderer, texture, rect, pixels, pitch);
+}
+
 #if SDL_HAVE_YUV
 static int
-GLES2_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
+GLES2_UploadTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
                     const SDL_Rect * rect,
                     const Uint8 *Yplane, int Ypitch,
                     const Uint8 *Uplane, int Upitch,
@@ -1708,7 +1831,45 @@ GLES2_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
 }
 
 static int
-GLES2_UpdateTextureNV(SDL_Renderer * renderer, SDL_Texture * texture,
+GLES2_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
+                    const SDL_Rect * rect,
+                    const Uint8 *Yplane, int Ypitch,
+                    const Uint8 *Uplane, int Upitch,
+                    const Uint8 *Vplane, int Vpitch)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
+
+    if (tdata->pbos[0] && rect->w > 0 && rect->h > 0) {
+        const int uvw = (rect->w + 1) / 2;
+        const int uvh = (rect->h + 1) / 2;
+        const size_t ysize = (size_t)rect->w * rect->h;
+        const size_t uvsize = (size_t)uvw * uvh;
+        Uint8 *dst;
+
+        GLES2_ActivateRenderer(renderer);
+
+        dst = GLES2_MapPixelBuffer(data, tdata, ysize + 2 * uvsize);
+        if (dst) {
+            dst = GLES2_CopyPlane(dst, Yplane, Ypitch, rect->w, rect->h);
+            dst = GLES2_CopyPlane(dst, Uplane, Upitch, uvw, uvh);
+            GLES2_CopyPlane(dst, Vplane, Vpitch, uvw, uvh);
+            if (GLES2_UnmapPixelBuffer(data)) {
+                const Uint8 *base = NULL;
+                int retval = GLES2_UploadTextureYUV(renderer, texture, rect,
+                                                    base, rect->w,
+                                                    base + ysize, uvw,
+                                                    base + ysize + uvsize, uvw);
+                data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                return retval;
+            }
+        }
+    }
+    return GLES2_UploadTextureYUV(renderer, texture, rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch);
+}
+
+static int
+GLES2_UploadTextureNV(SDL_Renderer * renderer, SDL_Texture * texture,
                     const SDL_Rect * rect,
                     const Uint8 *Yplane, int Ypitch,
                     const Uint8 *UVplane, int UVpitch)
@@ -1747,14 +1908,73 @@ GLES2_UpdateTextureNV(SDL_Renderer * renderer, SDL_Texture * texture,
 
     return GL_CheckError("glTexSubImage2D()", renderer);
 }
+
+static int
+GLES2_UpdateTextureNV(SDL_Renderer * renderer, SDL_Texture * texture,
+                    const SDL_Rect * rect,
+                    const Uint8 *Yplane, int Ypitch,
+                    const Uint8 *UVplane, int UVpitch)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
+
+    if (tdata->pbos[0] && rect->w > 0 && rect->h > 0) {
+        const int uvpitch = 2 * ((rect->w + 1) / 2);
+        const size_t ysize = (size_t)rect->w * rect->h;
+        Uint8 *dst;
+
+        GLES2_ActivateRenderer(renderer);
+
+        dst = GLES2_MapPixelBuffer(data, tdata, ysize + (size_t)uvpitch * ((rect->h + 1) / 2));
+        if (dst) {
+            dst = GLES2_CopyPlane(dst, Yplane, Ypitch, rect->w, rect->h);
+            GLES2_CopyPlane(dst, UVplane, UVpitch, uvpitch, (rect->h + 1) / 2);
+            if (GLES2_UnmapPixelBuffer(data)) {
+                const Uint8 *base = NULL;
+                int retval = GLES2_UploadTextureNV(renderer, texture, rect,
+                                                   base, rect->w,
+                                                   base + ysize, uvpitch);
+                data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                return retval;
+            }
+        }
+    }
+    return GLES2_UploadTextureNV(renderer, texture, rect, Yplane, Ypitch, UVplane, UVpitch);
+}
 #endif
 
 static int
 GLES2_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *rect,
                   void **pixels, int *pitch)
 {
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
     GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
 
+    if (tdata->pbos[0]) {
+        Uint8 *mapping;
+
+        GLES2_ActivateRenderer(renderer);
+
+        /* Hand out the locked area tightly packed, that's how it gets uploaded */
+        mapping = GLES2_MapPixelBuffer(data, tdata, GLES2_GetPixelDataSize(texture->format, rect->w, rect->h));
+        if (mapping) {
+            /* It stays mapped until unlocked, but must not be bound meanwhile */
+            data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            tdata->locked_rect = *rect;
+            tdata->pbo_locked = SDL_TRUE;
+            *pixels = mapping;
+            *pitch = rect->w * SDL_BYTESPERPIXEL(texture->format);
+            return 0;
+        }
+
+        if (!tdata->pixel_data) {
+            tdata->pixel_data = SDL_calloc(1, GLES2_GetPixelDataSize(texture->format, texture->w, texture->h));
+            if (!tdata->pixel_data) {
+                return SDL_OutOfMemory();
+            }
+        }
+    }
+
     /* Retrieve the buffer/pitch for the specified region */
     *pixels = (Uint8 *)tdata->pixel_data +
               (tdata->pitch * rect->y) +
@@ -1767,15 +1987,30 @@ GLES2_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *
 static void
 GLES2_UnlockTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
     GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
     SDL_Rect rect;
 
+    if (tdata->pbo_locked) {
+        tdata->pbo_locked = SDL_FALSE;
+
+        GLES2_ActivateRenderer(renderer);
+
+        data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, tdata->pbos[tdata->current_pbo]);
+        if (GLES2_UnmapPixelBuffer(data)) {
+            rect = tdata->locked_rect;
+            GLES2_UploadTexture(renderer, texture, &rect, NULL, rect.w * SDL_BYTESPERPIXEL(texture->format));
+            data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        return;
+    }
+
     /* We do whole texture updates, at least for now */
     rect.x = 0;
     rect.y = 0;
     rect.w = texture->w;
     rect.h = texture->h;
-    GLES2_UpdateTexture(renderer, texture, &rect, tdata->pixel_data, tdata->pitch);
+    GLES2_UploadTexture(renderer, texture, &rect, tdata->pixel_data, tdata->pitch);
 }
 
 static void
@@ -1861,6 +2096,9 @@ GLES2_DestroyTexture(SDL_Renderer *renderer, SDL_Texture *texture)
             data->glDeleteTextures(1, &tdata->texture_u);
         }
 #endif
+        if (tdata->pbos[0]) {
+            data->glDeleteBuffers(GLES2_PIXEL_BUFFER_COUNT, tdata->pbos);
+        }
         SDL_free(tdata->pixel_data);
         SDL_free(tdata);
         texture->driverdata = NULL;
@@ -2106,6 +2344,22 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     data->glGenBuffers(SDL_arraysize(data->vertex_buffers), data->vertex_buffers);
 #endif
 
+    /* Check for pixel buffer support, the uploads from them can't byteswap */
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    {
+        const char *verstr = (const char *)data->glGetString(GL_VERSION);
+        int es_major = 0;
+
+        if (verstr && SDL_sscanf(verstr, "OpenGL ES %d.", &es_major) == 1 && es_major >= 3) {
+            data->glMapBufferRange = SDL_GL_GetProcAddress("glMapBufferRange");
+            data->glUnmapBuffer = SDL_GL_GetProcAddress("glUnmapBuffer");
+            if (data->glMapBufferRange && data->glUnmapBuffer) {
+                data->pixel_buffers_supported = SDL_TRUE;
+            }
+        }
+    }
+#endif
+
     data->framebuffers = NULL;
     data->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &window_framebuffer);
     data->window_framebuffer = (GLuint)window_framebuffer;
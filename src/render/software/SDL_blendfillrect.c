@@ -130,6 +130,487 @@ SDL_BlendFillRect_ARGB8888(SDL_Surface * dst, const SDL_Rect * rect,
     return 0;
 }
 
+#if defined(__SSE2__)
+#  define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#if defined(__ARM_NEON)
+#  define HAVE_NEON_INTRINSICS 1
+#endif
+
+#if defined(HAVE_AVX2_INTRINSICS) && defined(HAVE_SSE2_INTRINSICS)
+#  define HAVE_AVX2_BLENDFILL 1
+#endif
+
+/*
+ * SIMD versions of the blend, add, mod and mul operators for RGB565, RGB888
+ * and ARGB8888, giving exactly the same results as the DRAW_SETPIXEL_* macros.
+ *
+ * Each channel is widened to 16 bits. DRAW_MUL() is computed as
+ * (x + 1 + (x >> 8)) >> 8, which equals x / 255 for every x <= 255 * 255.
+ * In the 8888 formats the color vector holds the source value for each
+ * channel, with alpha set so that the same operator leaves the destination
+ * alpha as the scalar code does: 0 for add, 0xFF for mod and 'a' otherwise.
+ * RGB888 always stores 0 in its unused byte. RGB565 channels are expanded as
+ * SDL_expand_byte does, v * 255 / 31 (or / 63) rounded down, using a
+ * multiply-high.
+ */
+#define BLENDFILL_EXPAND5_MUL   8457    /* (x * 8457) >> 18 == x / 31 for x = v * 255, v < 32 */
+#define BLENDFILL_EXPAND6_MUL   8323    /* (x * 8323) >> 19 == x / 63 for x = v * 255, v < 64 */
+
+#if defined(HAVE_SSE2_INTRINSICS) || defined(HAVE_NEON_INTRINSICS)
+#define HAVE_SIMD_BLENDFILL 1
+
+typedef struct
+{
+    Uint32 color[8];    /* 8888 source color, repeated to fill a vector */
+    Uint32 mask[8];     /* 8888 bits to keep */
+    Uint8 r, g, b;      /* 565 source color */
+    unsigned inva;
+} BlendFillColor;
+
+/* Calls 'kernel' with a constant blend mode, so each mode gets its own loop */
+#define DEFINE_BLENDFILL_MODES(decl, name, kernel) \
+decl \
+name(SDL_Surface * dst, const SDL_Rect * rect, SDL_BlendMode blendMode, const BlendFillColor *color) \
+{ \
+    switch (blendMode) { \
+    case SDL_BLENDMODE_BLEND: \
+        kernel(dst, rect, SDL_BLENDMODE_BLEND, color); \
+        break; \
+    case SDL_BLENDMODE_ADD: \
+        kernel(dst, rect, SDL_BLENDMODE_ADD, color); \
+        break; \
+    case SDL_BLENDMODE_MOD: \
+        kernel(dst, rect, SDL_BLENDMODE_MOD, color); \
+        break; \
+    default: \
+        kernel(dst, rect, SDL_BLENDMODE_MUL, color); \
+        break; \
+    } \
+}
+#endif
+
+#if defined(HAVE_SSE2_INTRINSICS)
+
+SDL_FORCE_INLINE __m128i
+BlendFillMul_SSE2(__m128i x, __m128i y)
+{
+    const __m128i t = _mm_mullo_epi16(x, y);
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(t, _mm_set1_epi16(1)), _mm_srli_epi16(t, 8)), 8);
+}
+
+SDL_FORCE_INLINE __m128i
+BlendFillOp_SSE2(__m128i d, __m128i c, __m128i inva, SDL_BlendMode blendMode)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        return _mm_add_epi16(BlendFillMul_SSE2(d, inva), c);
+    case SDL_BLENDMODE_ADD:
+        return _mm_min_epi16(_mm_add_epi16(d, c), _mm_set1_epi16(0xFF));
+    case SDL_BLENDMODE_MOD:
+        return BlendFillMul_SSE2(d, c);
+    default:
+        return _mm_min_epi16(_mm_add_epi16(BlendFillMul_SSE2(d, c), BlendFillMul_SSE2(d, inva)), _mm_set1_epi16(0xFF));
+    }
+}
+
+/* 4 pixels */
+SDL_FORCE_INLINE __m128i
+BlendFill8888_SSE2(__m128i pixels, __m128i c, __m128i inva, __m128i mask, SDL_BlendMode blendMode)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = BlendFillOp_SSE2(_mm_unpacklo_epi8(pixels, zero), c, inva, blendMode);
+    const __m128i hi = BlendFillOp_SSE2(_mm_unpackhi_epi8(pixels, zero), c, inva, blendMode);
+    return _mm_and_si128(_mm_packus_epi16(lo, hi), mask);
+}
+
+/* 8 pixels */
+SDL_FORCE_INLINE __m128i
+BlendFill565_SSE2(__m128i pixels, const __m128i *c, __m128i inva, SDL_BlendMode blendMode)
+{
+    const __m128i x255 = _mm_set1_epi16(0xFF);
+    __m128i r = _mm_srli_epi16(pixels, 11);
+    __m128i g = _mm_and_si128(_mm_srli_epi16(pixels, 5), _mm_set1_epi16(0x3F));
+    __m128i b = _mm_and_si128(pixels, _mm_set1_epi16(0x1F));
+
+    r = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(r, x255), _mm_set1_epi16(BLENDFILL_EXPAND5_MUL)), 2);
+    g = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(g, x255), _mm_set1_epi16(BLENDFILL_EXPAND6_MUL)), 3);
+    b = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(b, x255), _mm_set1_epi16(BLENDFILL_EXPAND5_MUL)), 2);
+    r = BlendFillOp_SSE2(r, c[0], inva, blendMode);
+    g = BlendFillOp_SSE2(g, c[1], inva, blendMode);
+    b = BlendFillOp_SSE2(b, c[2], inva, blendMode);
+    return _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi16(r, 8), _mm_set1_epi16((short)0xF800)),
+                                     _mm_and_si128(_mm_slli_epi16(g, 3), _mm_set1_epi16(0x07E0))),
+                        _mm_srli_epi16(b, 3));
+}
+
+SDL_FORCE_INLINE void
+BlendFillRect8888_SSE2(SDL_Surface * dst, const SDL_Rect * rect, SDL_BlendMode blendMode,
+                       const BlendFillColor *color)
+{
+    const __m128i c = _mm_unpacklo_epi8(_mm_loadu_si128((const __m128i *)color->color), _mm_setzero_si128());
+    const __m128i m = _mm_loadu_si128((const __m128i *)color->mask);
+    const __m128i a = _mm_set1_epi16((short)color->inva);
+    Uint8 *row = (Uint8 *)dst->pixels + rect->y * dst->pitch + rect->x * 4;
+    int height = rect->h;
+
+    while (height--) {
+        Uint32 *pixel = (Uint32 *)row;
+        int n = rect->w;
+        for (; n >= 4; n -= 4, pixel += 4) {
+            _mm_storeu_si128((__m128i *)pixel, BlendFill8888_SSE2(_mm_loadu_si128((const __m128i *)pixel), c, a, m, blendMode));
+        }
+        if (n) {
+            Uint32 tail[4];
+            SDL_zeroa(tail);
+            SDL_memcpy(tail, pixel, n * 4);
+            _mm_storeu_si128((__m128i *)tail, BlendFill8888_SSE2(_mm_loadu_si128((const __m128i *)tail), c, a, m, blendMode));
+            SDL_memcpy(pixel, tail, n * 4);
+        }
+        row += dst->pitch;
+    }
+}
+
+SDL_FORCE_INLINE void
+BlendFillRect565_SSE2(SDL_Surface * dst, const SDL_Rect * rect, SDL_BlendMode blendMode,
+                      const BlendFillColor *color)
+{
+    __m128i c[3];
+    const __m128i a = _mm_set1_epi16((short)color->inva);
+    Uint8 *row = (Uint8 *)dst->pixels + rect->y * dst->pitch + rect->x * 2;
+    int height = rect->h;
+
+    c[0] = _mm_set1_epi16(color->r);
+    c[1] = _mm_set1_epi16(color->g);
+    c[2] = _mm_set1_epi16(color->b);
+    while (height--) {
+        Uint16 *pixel = (Uint16 *)row;
+        int n = rect->w;
+        for (; n >= 8; n -= 8, pixel += 8) {
+            _mm_storeu_si128((__m128i *)pixel, BlendFill565_SSE2(_mm_loadu_si128((const __m128i *)pixel), c, a, blendMode));
+        }
+        if (n) {
+            Uint16 tail[8];
+            SDL_zeroa(tail);
+            SDL_memcpy(tail, pixel, n * 2);
+            _mm_storeu_si128((__m128i *)tail, BlendFill565_SSE2(_mm_loadu_si128((const __m128i *)tail), c, a, blendMode));
+            SDL_memcpy(pixel, tail, n * 2);
+        }
+        row += dst->pitch;
+    }
+}
+
+DEFINE_BLENDFILL_MODES(static void, BlendFillRect8888_SSE2_Modes, BlendFillRect8888_SSE2)
+DEFINE_BLENDFILL_MODES(static void, BlendFillRect565_SSE2_Modes, BlendFillRect565_SSE2)
+
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if defined(HAVE_AVX2_BLENDFILL)
+
+static int
+hasAVX2()
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
+    }
+    val = SDL_HasAVX2();
+    return val;
+}
+
+SDL_FORCE_INLINE __m256i SDL_TARGETING("avx2")
+BlendFillMul_AVX2(__m256i x, __m256i y)
+{
+    const __m256i t = _mm256_mullo_epi16(x, y);
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(t, _mm256_set1_epi16(1)), _mm256_srli_epi16(t, 8)), 8);
+}
+
+SDL_FORCE_INLINE __m256i SDL_TARGETING("avx2")
+BlendFillOp_AVX2(__m256i d, __m256i c, __m256i inva, SDL_BlendMode blendMode)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        return _mm256_add_epi16(BlendFillMul_AVX2(d, inva), c);
+    case SDL_BLENDMODE_ADD:
+        return _mm256_min_epi16(_mm256_add_epi16(d, c), _mm256_set1_epi16(0xFF));
+    case SDL_BLENDMODE_MOD:
+        return BlendFillMul_AVX2(d, c);
+    default:
+        return _mm256_min_epi16(_mm256_add_epi16(BlendFillMul_AVX2(d, c), BlendFillMul_AVX2(d, inva)), _mm256_set1_epi16(0xFF));
+    }
+}
+
+/* 8 pixels; unpacking and packing within each 128-bit lane keeps them in order */
+SDL_FORCE_INLINE __m256i SDL_TARGETING("avx2")
+BlendFill8888_AVX2(__m256i pixels, __m256i c, __m256i inva, __m256i mask, SDL_BlendMode blendMode)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lo = BlendFillOp_AVX2(_mm256_unpacklo_epi8(pixels, zero), c, inva, blendMode);
+    const __m256i hi = BlendFillOp_AVX2(_mm256_unpackhi_epi8(pixels, zero), c, inva, blendMode);
+    return _mm256_and_si256(_mm256_packus_epi16(lo, hi), mask);
+}
+
+/* 16 pixels */
+SDL_FORCE_INLINE __m256i SDL_TARGETING("avx2")
+BlendFill565_AVX2(__m256i pixels, const __m256i *c, __m256i inva, SDL_BlendMode blendMode)
+{
+    const __m256i x255 = _mm256_set1_epi16(0xFF);
+    __m256i r = _mm256_srli_epi16(pixels, 11);
+    __m256i g = _mm256_and_si256(_mm256_srli_epi16(pixels, 5), _mm256_set1_epi16(0x3F));
+    __m256i b = _mm256_and_si256(pixels, _mm256_set1_epi16(0x1F));
+
+    r = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(r, x255), _mm256_set1_epi16(BLENDFILL_EXPAND5_MUL)), 2);
+    g = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(g, x255), _mm256_set1_epi16(BLENDFILL_EXPAND6_MUL)), 3);
+    b = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(b, x255), _mm256_set1_epi16(BLENDFILL_EXPAND5_MUL)), 2);
+    r = BlendFillOp_AVX2(r, c[0], inva, blendMode);
+    g = BlendFillOp_AVX2(g, c[1], inva, blendMode);
+    b = BlendFillOp_AVX2(b, c[2], inva, blendMode);
+    return _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_slli_epi16(r, 8), _mm256_set1_epi16((short)0xF800)),
+                                           _mm256_and_si256(_mm256_slli_epi16(g, 3), _mm256_set1_epi16(0x07E0))),
+                           _mm256_srli_epi16(b, 3));
+}
+
+SDL_FORCE_INLINE void SDL_TARGETING("avx2")
+BlendFillRect8888_AVX2(SDL_Surface * dst, const SDL_Rect * rect, SDL_BlendMode blendMode,
+                       const BlendFillColor *color)
+{
+    const __m256i c = _mm256_unpacklo_epi8(_mm256_loadu_si256((const __m256i *)color->color), _mm256_setzero_si256());
+    const __m256i m = _mm256_loadu_si256((const __m256i *)color->mask);
+    const __m256i a = _mm256_set1_epi16((short)color->inva);
+    Uint8 *row = (Uint8 *)dst->pixels + rect->y * dst->pitch + rect->x * 4;
+    int height = rect->h;
+
+    while (height--) {
+        Uint32 *pixel = (Uint32 *)row;
+        int n = rect->w;
+        for (; n >= 8; n -= 8, pixel += 8) {
+            _mm256_storeu_si256((__m256i *)pixel, BlendFill8888_AVX2(_mm256_loadu_si256((const __m256i *)pixel), c, a, m, blendMode));
+        }
+        if (n) {
+            Uint32 tail[8];
+            SDL_zeroa(tail);
+            SDL_memcpy(tail, pixel, n * 4);
+            _mm256_storeu_si256((__m256i *)tail, BlendFill8888_AVX2(_mm256_loadu_si256((const __m256i *)tail), c, a, m, blendMode));
+            SDL_memcpy(pixel, tail, n * 4);
+        }
+        row += dst->pitch;
+    }
+}
+
+SDL_FORCE_INLINE void SDL_TARGETING("avx2")
+BlendFillRect565_AVX2(SDL_Surface * dst, const SDL_Rect * rect, SDL_BlendMode blendMode,
+                      const BlendFillColor *color)
+{
+    __m256i c[3];
+    const __m256i a = _mm256_set1_epi16((short)color->inva);
+    Uint8 *row = (Uint8 *)dst->pixels + rect->y * dst->pitch + rect->x * 2;
+    int height = rect->h;
+
+    c[0] = _mm256_set1_epi16(color->r);
+    c[1] = _mm256_set1_epi16(color->g);
+    c[2] = _mm256_set1_epi16(color->b);
+    while (height--) {
+        Uint16 *pixel = (Uint16 *)row;
+        int n = rect->w;
+        for (; n >= 16; n -= 16, pixel += 16) {
+            _mm256_storeu_si256((__m256i *)pixel, BlendFill565_AVX2(_mm256_loadu_si256((const __m256i *)pixel), c, a, blendMode));
+        }
+        if (n) {
+            Uint16 tail[16];
+            SDL_zeroa(tail);
+            SDL_memcpy(tail, pixel, n * 2);
+            _mm256_storeu_si256((__m256i *)tail, BlendFill565_AVX2(_mm256_loadu_si256((const __m256i *)tail), c, a, blendMode));
+            SDL_memcpy(pixel, tail, n * 2);
+        }
+        row += dst->pitch;
+    }
+}
+
+DEFINE_BLENDFILL_MODES(static void SDL_TARGETING("avx2"), BlendFillRect8888_AVX2_Modes, BlendFillRect8888_AVX2)
+DEFINE_BLENDFILL_MODES(static void SDL_TARGETING("avx2"), BlendFillRect565_AVX2_Modes, BlendFillRect565_AVX2)
+
+#endif /* HAVE_AVX2_BLENDFILL */
+
+#if defined(HAVE_NEON_INTRINSICS)
+
+SDL_FORCE_INLINE uint16x8_t
+BlendFillMul_NEON(uint16x8_t x, uint16x8_t y)
+{
+    const uint16x8_t t = vmulq_u16(x, y);
+    return vshrq_n_u16(vaddq_u16(vaddq_u16(t, vdupq_n_u16(1)), vshrq_n_u16(t, 8)), 8);
+}
+
+SDL_FORCE_INLINE uint16x8_t
+BlendFillOp_NEON(uint16x8_t d, uint16x8_t c, uint16x8_t inva, SDL_BlendMode blendMode)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        return vaddq_u16(BlendFillMul_NEON(d, inva), c);
+    case SDL_BLENDMODE_ADD:
+        return vminq_u16(vaddq_u16(d, c), vdupq_n_u16(0xFF));
+    case SDL_BLENDMODE_MOD:
+        return BlendFillMul_NEON(d, c);
+    default:
+        return vminq_u16(vaddq_u16(BlendFillMul_NEON(d, c), BlendFillMul_NEON(d, inva)), vdupq_n_u16(0xFF));
+    }
+}
+
+/* 4 pixels */
+SDL_FORCE_INLINE uint8x16_t
+BlendFill8888_NEON(uint8x16_t pixels, uint16x8_t c, uint16x8_t inva, uint8x16_t mask, SDL_BlendMode blendMode)
+{
+    const uint16x8_t lo = BlendFillOp_NEON(vmovl_u8(vget_low_u8(pixels)), c, inva, blendMode);
+    const uint16x8_t hi = BlendFillOp_NEON(vmovl_u8(vget_high_u8(pixels)), c, inva, blendMode);
+    return vandq_u8(vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi)), mask);
+}
+
+SDL_FORCE_INLINE uint16x8_t
+BlendFillExpand_NEON(uint16x8_t v, uint16_t mul, int shift)
+{
+    const uint16x8_t x = vmulq_n_u16(v, 0xFF);
+    const uint16x8_t hi = vcombine_u16(vshrn_n_u32(vmull_n_u16(vget_low_u16(x), mul), 16),
+                                       vshrn_n_u32(vmull_n_u16(vget_high_u16(x), mul), 16));
+    return vshlq_u16(hi, vdupq_n_s16(-shift));
+}
+
+/* 8 pixels */
+SDL_FORCE_INLINE uint16x8_t
+BlendFill565_NEON(uint16x8_t pixels, const uint16x8_t *c, uint16x8_t inva, SDL_BlendMode blendMode)
+{
+    uint16x8_t r = vshrq_n_u16(pixels, 11);
+    uint16x8_t g = vandq_u16(vshrq_n_u16(pixels, 5), vdupq_n_u16(0x3F));
+    uint16x8_t b = vandq_u16(pixels, vdupq_n_u16(0x1F));
+
+    r = BlendFillOp_NEON(BlendFillExpand_NEON(r, BLENDFILL_EXPAND5_MUL, 2), c[0], inva, blendMode);
+    g = BlendFillOp_NEON(BlendFillExpand_NEON(g, BLENDFILL_EXPAND6_MUL, 3), c[1], inva, blendMode);
+    b = BlendFillOp_NEON(BlendFillExpand_NEON(b, BLENDFILL_EXPAND5_MUL, 2), c[2], inva, blendMode);
+    return vorrq_u16(vorrq_u16(vandq_u16(vshlq_n_u16(r, 8), vdupq_n_u16(0xF800)),
+                               vandq_u16(vshlq_n_u16(g, 3), vdupq_n_u16(0x07E0))),
+                     vshrq_n_u16(b, 3));
+}
+
+SDL_FORCE_INLINE void
+BlendFillRect8888_NEON(SDL_Surface * dst, const SDL_Rect * rect, SDL_BlendMode blendMode,
+                       const BlendFillColor *color)
+{
+    const uint16x8_t c = vmovl_u8(vld1_u8((const Uint8 *)color->color));
+    const uint8x16_t m = vld1q_u8((const Uint8 *)color->mask);
+    const uint16x8_t a = vdupq_n_u16((uint16_t)color->inva);
+    Uint8 *row = (Uint8 *)dst->pixels + rect->y * dst->pitch + rect->x * 4;
+    int height = rect->h;
+
+    while (height--) {
+        Uint8 *pixel = row;
+        int n = rect->w;
+        for (; n >= 4; n -= 4, pixel += 16) {
+            vst1q_u8(pixel, BlendFill8888_NEON(vld1q_u8(pixel), c, a, m, blendMode));
+        }
+        if (n) {
+            Uint8 tail[16];
+            SDL_zeroa(tail);
+            SDL_memcpy(tail, pixel, n * 4);
+            vst1q_u8(tail, BlendFill8888_NEON(vld1q_u8(tail), c, a, m, blendMode));
+            SDL_memcpy(pixel, tail, n * 4);
+        }
+        row += dst->pitch;
+    }
+}
+
+SDL_FORCE_INLINE void
+BlendFillRect565_NEON(SDL_Surface * dst, const SDL_Rect * rect, SDL_BlendMode blendMode,
+                      const BlendFillColor *color)
+{
+    uint16x8_t c[3];
+    const uint16x8_t a = vdupq_n_u16((uint16_t)color->inva);
+    Uint8 *row = (Uint8 *)dst->pixels + rect->y * dst->pitch + rect->x * 2;
+    int height = rect->h;
+
+    c[0] = vdupq_n_u16(color->r);
+    c[1] = vdupq_n_u16(color->g);
+    c[2] = vdupq_n_u16(color->b);
+    while (height--) {
+        Uint16 *pixel = (Uint16 *)row;
+        int n = rect->w;
+        for (; n >= 8; n -= 8, pixel += 8) {
+            vst1q_u16(pixel, BlendFill565_NEON(vld1q_u16(pixel), c, a, blendMode));
+        }
+        if (n) {
+            Uint16 tail[8];
+            SDL_zeroa(tail);
+            SDL_memcpy(tail, pixel, n * 2);
+            vst1q_u16(tail, BlendFill565_NEON(vld1q_u16(tail), c, a, blendMode));
+            SDL_memcpy(pixel, tail, n * 2);
+        }
+        row += dst->pitch;
+    }
+}
+
+DEFINE_BLENDFILL_MODES(static void, BlendFillRect8888_NEON_Modes, BlendFillRect8888_NEON)
+DEFINE_BLENDFILL_MODES(static void, BlendFillRect565_NEON_Modes, BlendFillRect565_NEON)
+
+#endif /* HAVE_NEON_INTRINSICS */
+
+#if defined(HAVE_SIMD_BLENDFILL)
+
+/* RGB565, RGB888 and ARGB8888 with the blend, add, mod or mul operator */
+static int
+SDL_BlendFillRect_SIMD(SDL_Surface * dst, const SDL_Rect * rect,
+                       SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    const SDL_bool is565 = (dst->format->BytesPerPixel == 2);
+    BlendFillColor color;
+    Uint32 alpha;
+    size_t i;
+
+    switch (blendMode) {
+    case SDL_BLENDMODE_ADD:
+        alpha = 0;
+        break;
+    case SDL_BLENDMODE_MOD:
+        alpha = 0xFF;
+        break;
+    default:
+        alpha = a;
+        break;
+    }
+    for (i = 0; i < SDL_arraysize(color.color); ++i) {
+        color.color[i] = (alpha << 24) | ((Uint32)r << 16) | ((Uint32)g << 8) | b;
+        color.mask[i] = dst->format->Amask ? 0xFFFFFFFF : 0x00FFFFFF;
+    }
+    color.r = r;
+    color.g = g;
+    color.b = b;
+    color.inva = 0xff - a;
+
+#if defined(HAVE_AVX2_BLENDFILL)
+    if (hasAVX2()) {
+        if (is565) {
+            BlendFillRect565_AVX2_Modes(dst, rect, blendMode, &color);
+        } else {
+            BlendFillRect8888_AVX2_Modes(dst, rect, blendMode, &color);
+        }
+        return 0;
+    }
+#endif
+#if defined(HAVE_SSE2_INTRINSICS)
+    if (is565) {
+        BlendFillRect565_SSE2_Modes(dst, rect, blendMode, &color);
+    } else {
+        BlendFillRect8888_SSE2_Modes(dst, rect, blendMode, &color);
+    }
+#elif defined(HAVE_NEON_INTRINSICS)
+    if (is565) {
+        BlendFillRect565_NEON_Modes(dst, rect, blendMode, &color);
+    } else {
+        BlendFillRect8888_NEON_Modes(dst, rect, blendMode, &color);
+    }
+#endif
+    return 0;
+}
+
+#endif /* HAVE_SIMD_BLENDFILL */
+
 static int
 SDL_BlendFillRect_RGB(SDL_Surface * dst, const SDL_Rect * rect,
                       SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
@@ -213,6 +694,67 @@ SDL_BlendFillRect_RGBA(SDL_Surface * dst, const SDL_Rect * rect,
     }
 }
 
+typedef int (*SDL_BlendFillRectFunc)(SDL_Surface * dst, const SDL_Rect * rect,
+                                     SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+static SDL_BlendFillRectFunc
+SDL_ChooseBlendFillRect(const SDL_PixelFormat * fmt, SDL_BlendMode blendMode)
+{
+    SDL_BlendFillRectFunc func = NULL;
+
+    switch (fmt->BitsPerPixel) {
+    case 15:
+        switch (fmt->Rmask) {
+        case 0x7C00:
+            func = SDL_BlendFillRect_RGB555;
+        }
+        break;
+    case 16:
+        switch (fmt->Rmask) {
+        case 0xF800:
+            func = SDL_BlendFillRect_RGB565;
+        }
+        break;
+    case 32:
+        switch (fmt->Rmask) {
+        case 0x00FF0000:
+            if (!fmt->Amask) {
+                func = SDL_BlendFillRect_RGB888;
+            } else {
+                func = SDL_BlendFillRect_ARGB8888;
+            }
+            break;
+        }
+        break;
+    default:
+        break;
+    }
+
+#if defined(HAVE_SIMD_BLENDFILL)
+    if (func == SDL_BlendFillRect_RGB565 || func == SDL_BlendFillRect_RGB888 || func == SDL_BlendFillRect_ARGB8888) {
+        switch (blendMode) {
+        case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_ADD:
+        case SDL_BLENDMODE_MOD:
+        case SDL_BLENDMODE_MUL:
+            func = SDL_BlendFillRect_SIMD;
+            break;
+        default:
+            break;
+        }
+    }
+#endif
+
+    if (!func) {
+        if (!fmt->Amask) {
+            func = SDL_BlendFillRect_RGB;
+        } else {
+            func = SDL_BlendFillRect_RGBA;
+        }
+    }
+    return func;
+}
+
 int
 SDL_BlendFillRect(SDL_Surface * dst, const SDL_Rect * rect,
                   SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
@@ -245,39 +787,7 @@ SDL_BlendFillRect(SDL_Surface * dst, const SDL_Rect * rect,
         b = DRAW_MUL(b, a);
     }
 
-    switch (dst->format->BitsPerPixel) {
-    case 15:
-        switch (dst->format->Rmask) {
-        case 0x7C00:
-            return SDL_BlendFillRect_RGB555(dst, rect, blendMode, r, g, b, a);
-        }
-        break;
-    case 16:
-        switch (dst->format->Rmask) {
-        case 0xF800:
-            return SDL_BlendFillRect_RGB565(dst, rect, blendMode, r, g, b, a);
-        }
-        break;
-    case 32:
-        switch (dst->format->Rmask) {
-        case 0x00FF0000:
-            if (!dst->format->Amask) {
-                return SDL_BlendFillRect_RGB888(dst, rect, blendMode, r, g, b, a);
-            } else {
-                return SDL_BlendFillRect_ARGB8888(dst, rect, blendMode, r, g, b, a);
-            }
-            /* break; -Wunreachable-code-break */
-        }
-        break;
-    default:
-        break;
-    }
-
-    if (!dst->format->Amask) {
-        return SDL_BlendFillRect_RGB(dst, rect, blendMode, r, g, b, a);
-    } else {
-        return SDL_BlendFillRect_RGBA(dst, rect, blendMode, r, g, b, a);
-    }
+    return SDL_ChooseBlendFillRect(dst->format, blendMode)(dst, rect, blendMode, r, g, b, a);
 }
 
 int
@@ -286,8 +796,7 @@ SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
 {
     SDL_Rect rect;
     int i;
-    int (*func)(SDL_Surface * dst, const SDL_Rect * rect,
-                SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) = NULL;
+    SDL_BlendFillRectFunc func;
     int status = 0;
 
     if (!dst) {
@@ -305,42 +814,7 @@ SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
         b = DRAW_MUL(b, a);
     }
 
-    /* FIXME: Does this function pointer slow things down significantly? */
-    switch (dst->format->BitsPerPixel) {
-    case 15:
-        switch (dst->format->Rmask) {
-        case 0x7C00:
-            func = SDL_BlendFillRect_RGB555;
-        }
-        break;
-    case 16:
-        switch (dst->format->Rmask) {
-        case 0xF800:
-            func = SDL_BlendFillRect_RGB565;
-        }
-        break;
-    case 32:
-        switch (dst->format->Rmask) {
-        case 0x00FF0000:
-            if (!dst->format->Amask) {
-                func = SDL_BlendFillRect_RGB888;
-            } else {
-                func = SDL_BlendFillRect_ARGB8888;
-            }
-            break;
-        }
-        break;
-    default:
-        break;
-    }
-
-    if (!func) {
-        if (!dst->format->Amask) {
-            func = SDL_BlendFillRect_RGB;
-        } else {
-            func = SDL_BlendFillRect_RGBA;
-        }
-    }
+    func = SDL_ChooseBlendFillRect(dst->format, blendMode);
 
     for (i = 0; i < count; ++i) {
         /* Perform clipping */
@@ -631,6 +631,155 @@ SW_QueueGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *te
     return 0;
 }
 
+/* Retained geometry is kept as triangles, one vertex per index. Positions
+   stay in floats: each draw adds the offset and scales them before going
+   to fixed point, exactly like SDL_RenderGeometryRaw() would. Texture
+   coordinates are converted for the texture size they were last drawn with. */
+typedef struct
+{
+    GeometryCopyData *verts;    /* src and color of each vertex, dst is unused */
+    float *xy;                  /* position of each vertex */
+    float *uv;                  /* texture coordinate of each vertex, NULL without uv */
+    int count;
+    int texw;                   /* the texture size of the source points, 0 until drawn with a texture */
+    int texh;
+} SW_GeometryData;
+
+/* What a retained geometry draw puts in the vertex data */
+typedef struct
+{
+    float offset_x;
+    float offset_y;
+    float scale_x;
+    float scale_y;
+} SW_RetainedDrawData;
+
+static int
+SW_CreateGeometry(SDL_Renderer * renderer, SDL_Geometry * geometry)
+{
+    SW_GeometryData *data;
+    int i;
+
+    data = (SW_GeometryData *) SDL_calloc(1, sizeof(*data));
+    if (!data) {
+        return SDL_OutOfMemory();
+    }
+    data->count = geometry->indices ? geometry->num_indices : geometry->num_vertices;
+    data->verts = (GeometryCopyData *) SDL_malloc(SDL_max(data->count, 1) * sizeof(*data->verts));
+    data->xy = (float *) SDL_malloc(SDL_max(data->count, 1) * 2 * sizeof(float));
+    if (geometry->uv) {
+        data->uv = (float *) SDL_malloc(SDL_max(data->count, 1) * 2 * sizeof(float));
+    }
+    if (!data->verts || !data->xy || (geometry->uv && !data->uv)) {
+        SDL_free(data->verts);
+        SDL_free(data->xy);
+        SDL_free(data->uv);
+        SDL_free(data);
+        return SDL_OutOfMemory();
+    }
+
+    for (i = 0; i < data->count; i++) {
+        int j;
+        if (geometry->size_indices == 4) {
+            j = ((const Uint32 *)geometry->indices)[i];
+        } else if (geometry->size_indices == 2) {
+            j = ((const Uint16 *)geometry->indices)[i];
+        } else if (geometry->size_indices == 1) {
+            j = ((const Uint8 *)geometry->indices)[i];
+        } else {
+            j = i;
+        }
+        data->xy[2 * i + 0] = geometry->xy[2 * j + 0];
+        data->xy[2 * i + 1] = geometry->xy[2 * j + 1];
+        data->verts[i].color = geometry->color[j];
+        if (data->uv) {
+            data->uv[2 * i + 0] = geometry->uv[2 * j + 0];
+            data->uv[2 * i + 1] = geometry->uv[2 * j + 1];
+        }
+    }
+
+    geometry->driverdata = data;
+    return 0;
+}
+
+static void
+SW_ConvertGeometry(SW_GeometryData *data, SDL_Texture *texture)
+{
+    GeometryCopyData *ptr = data->verts;
+    int i;
+
+    for (i = 0; i < data->count; i++, ptr++) {
+        ptr->src.x = (int)(data->uv[2 * i + 0] * texture->w);
+        ptr->src.y = (int)(data->uv[2 * i + 1] * texture->h);
+    }
+
+    data->texw = texture->w;
+    data->texh = texture->h;
+}
+
+static int
+SW_QueueRetainedGeometry(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                         SDL_Geometry * geometry, float offset_x, float offset_y,
+                         float scale_x, float scale_y)
+{
+    SW_GeometryData *data = (SW_GeometryData *) geometry->driverdata;
+    SW_RetainedDrawData *draw;
+
+    if (texture && (data->texw != texture->w || data->texh != texture->h)) {
+        if (geometry->last_command_generation == renderer->render_command_generation) {
+            /* An earlier draw in the queue uses the converted texture
+               coordinates, so copy the vertices like any other geometry. */
+            float *moved;
+            SDL_bool isstack;
+            int i, retval;
+
+            moved = SDL_small_alloc(float, SDL_max(geometry->num_vertices, 1) * 2, &isstack);
+            if (!moved) {
+                return SDL_OutOfMemory();
+            }
+            for (i = 0; i < geometry->num_vertices; i++) {
+                moved[2 * i + 0] = geometry->xy[2 * i + 0] + offset_x;
+                moved[2 * i + 1] = geometry->xy[2 * i + 1] + offset_y;
+            }
+            retval = SW_QueueGeometry(renderer, cmd, texture,
+                                      moved, 2 * sizeof (float),
+                                      geometry->color, sizeof (SDL_Color),
+                                      geometry->uv, 2 * sizeof (float),
+                                      geometry->num_vertices,
+                                      geometry->indices, geometry->num_indices, geometry->size_indices,
+                                      scale_x, scale_y);
+            SDL_small_free(moved, isstack);
+            return retval;
+        }
+        SW_ConvertGeometry(data, texture);
+    }
+
+    draw = (SW_RetainedDrawData *) SDL_AllocateRenderVertices(renderer, sizeof (*draw), 0, &cmd->data.draw.first);
+    if (!draw) {
+        return -1;
+    }
+    draw->offset_x = offset_x;
+    draw->offset_y = offset_y;
+    draw->scale_x = scale_x;
+    draw->scale_y = scale_y;
+    cmd->data.draw.count = data->count;
+    cmd->data.draw.geometry = geometry;
+    return 0;
+}
+
+static void
+SW_DestroyGeometry(SDL_Renderer * renderer, SDL_Geometry * geometry)
+{
+    SW_GeometryData *data = (SW_GeometryData *) geometry->driverdata;
+
+    if (data) {
+        SDL_free(data->verts);
+        SDL_free(data->xy);
+        SDL_free(data->uv);
+        SDL_free(data);
+    }
+}
+
 static void
 PrepTextureForCopy(const SDL_RenderCommand *cmd)
 {
@@ -678,6 +827,57 @@ SetDrawState(SDL_Surface *surface, SW_DrawStateCache *drawstate)
     }
 }
 
+static void
+SW_MoveRetainedTriangle(const float *xy, const SW_RetainedDrawData *draw, const SDL_Point *viewport, SDL_Point d[3])
+{
+    int k;
+
+    for (k = 0; k < 3; k++) {
+        d[k].x = (int)((xy[2 * k + 0] + draw->offset_x) * draw->scale_x);
+        d[k].y = (int)((xy[2 * k + 1] + draw->offset_y) * draw->scale_y);
+        trianglepoint_2_fixedpoint(&d[k]);
+        d[k].x += viewport->x;
+        d[k].y += viewport->y;
+    }
+}
+
+static void
+SW_RenderRetainedGeometry(SDL_Surface *surface, const SDL_RenderCommand *cmd,
+                          const SW_RetainedDrawData *draw, const SDL_Rect *viewport)
+{
+    const SW_GeometryData *data = (const SW_GeometryData *) cmd->data.draw.geometry->driverdata;
+    SDL_Texture *texture = cmd->data.draw.texture;
+    const GeometryCopyData *ptr = data->verts;
+    const float *xy = data->xy;
+    SDL_Point vp, s[3], d[3];
+    int i, k;
+
+    vp.x = viewport->x;
+    vp.y = viewport->y;
+    trianglepoint_2_fixedpoint(&vp);
+
+    if (texture) {
+        SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+
+        PrepTextureForCopy(cmd);
+
+        for (i = 0; i < data->count; i += 3, ptr += 3, xy += 6) {
+            for (k = 0; k < 3; k++) {
+                s[k] = ptr[k].src;
+            }
+            SW_MoveRetainedTriangle(xy, draw, &vp, d);
+            SDL_SW_BlitTriangle(src, &s[0], &s[1], &s[2], surface, &d[0], &d[1], &d[2],
+                                ptr[0].color, ptr[1].color, ptr[2].color);
+        }
+    } else {
+        for (i = 0; i < data->count; i += 3, ptr += 3, xy += 6) {
+            SW_MoveRetainedTriangle(xy, draw, &vp, d);
+            SDL_SW_FillTriangle(surface, &d[0], &d[1], &d[2], cmd->data.draw.blend,
+                                ptr[0].color, ptr[1].color, ptr[2].color);
+        }
+    }
+}
+
 static int
 SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
 {
@@ -893,7 +1093,9 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
 
                 SetDrawState(surface, &drawstate);
 
-                if (texture) {
+                if (cmd->data.draw.geometry) {
+                    SW_RenderRetainedGeometry(surface, cmd, (const SW_RetainedDrawData *) verts, drawstate.viewport);
+                } else if (texture) {
                     SDL_Surface *src = (SDL_Surface *) texture->driverdata;
 
                     GeometryCopyData *ptr = (GeometryCopyData *) verts;
@@ -1052,6 +1254,9 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     renderer->QueueCopy = SW_QueueCopy;
     renderer->QueueCopyEx = SW_QueueCopyEx;
     renderer->QueueGeometry = SW_QueueGeometry;
+    renderer->CreateGeometry = SW_CreateGeometry;
+    renderer->QueueRetainedGeometry = SW_QueueRetainedGeometry;
+    renderer->DestroyGeometry = SW_DestroyGeometry;
     renderer->RunCommandQueue = SW_RunCommandQueue;
     renderer->RenderReadPixels = SW_RenderReadPixels;
     renderer->RenderPresent = SW_RenderPresent;
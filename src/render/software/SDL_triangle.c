@@ -180,13 +180,6 @@ static void bounding_rect(const SDL_Point *a, const SDL_Point *b, const SDL_Poin
                     int a = (int)(((Sint64)w0 * c0.a + (Sint64)w1 * c1.a + (Sint64)w2 * c2.a) / area);  \
                     int color = SDL_MapRGBA(format, r, g, b, a);                                        \
 
-#define TRIANGLE_GET_COLOR                                                                              \
-                    int r = (int)(((Sint64)w0 * c0.r + (Sint64)w1 * c1.r + (Sint64)w2 * c2.r) / area);  \
-                    int g = (int)(((Sint64)w0 * c0.g + (Sint64)w1 * c1.g + (Sint64)w2 * c2.g) / area);  \
-                    int b = (int)(((Sint64)w0 * c0.b + (Sint64)w1 * c1.b + (Sint64)w2 * c2.b) / area);  \
-                    int a = (int)(((Sint64)w0 * c0.a + (Sint64)w1 * c1.a + (Sint64)w2 * c2.a) / area);  \
-
-
 #define TRIANGLE_END_LOOP                                                                               \
                 }                                                                                       \
                 /* x += 1 */                                                                            \
@@ -202,6 +195,357 @@ static void bounding_rect(const SDL_Point *a, const SDL_Point *b, const SDL_Poin
         }                                                                                               \
     }                                                                                                   \
 
+/* Block based rasterization, for 32-bit destinations and the generic blitter
+ *
+ * The destination rect is walked in TRIANGLE_BLOCK x TRIANGLE_BLOCK tiles.
+ * A tile lying completely outside one of the edges is skipped, and a tile
+ * lying completely inside all three edges is drawn without testing its
+ * pixels. For the other tiles, the coverage of a row is computed for all
+ * its pixels at once.
+ *
+ * Colors and texture coordinates are then interpolated for the whole row
+ * of the tile. The numerators of TRIANGLE_GET_MAPPED_COLOR / TRIANGLE_GET_TEXTCOORD
+ * are exact in double precision, and the quotient is far enough from the
+ * next integer for the truncation to be exact as well, so the results are
+ * the same as computing them pixel by pixel.
+ */
+#define TRIANGLE_BLOCK 8
+
+#define TRIANGLE_OUTSIDE    0
+#define TRIANGLE_PARTIAL    1
+#define TRIANGLE_INSIDE     2
+
+#if defined(__SSE2__)
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#if defined(HAVE_AVX2_INTRINSICS) && defined(HAVE_SSE2_INTRINSICS)
+#define HAVE_AVX2_TRIANGLE 1
+#endif
+
+typedef struct TriangleEdges TriangleEdges;
+
+/* Computes (n + i * dn) / area for the TRIANGLE_BLOCK pixels of a row */
+typedef void (*TriangleInterpolateFunc)(Sint64 n, Sint64 dn, const TriangleEdges *edges, int *out);
+
+struct TriangleEdges
+{
+    int dx[3];              /* increment of each edge function for x += 1 */
+    int dy[3];              /* increment of each edge function for y += 1 */
+    int limit[3];           /* a pixel is inside an edge if w > limit */
+    Sint64 area;
+    double area_f;
+    TriangleInterpolateFunc interpolate;
+#if defined(HAVE_SSE2_INTRINSICS)
+    __m128i steps_lo[3];    /* 0..3 times dx */
+    __m128i steps_hi[3];    /* 4..7 times dx */
+    __m128i limits[3];
+#endif
+};
+
+/* A value interpolated over the triangle: (w0 * v0 + w1 * v1 + w2 * v2 + bias) / area */
+typedef struct
+{
+    Sint64 v0, v1, v2, bias;
+    Sint64 dn;              /* increment of the numerator for x += 1 */
+    TriangleInterpolateFunc interpolate;
+} TriangleValue;
+
+static void
+TriangleInterpolate_Scalar(Sint64 n, Sint64 dn, const TriangleEdges *edges, int *out)
+{
+    int i;
+    for (i = 0; i < TRIANGLE_BLOCK; i++) {
+        out[i] = (int)(n / edges->area);
+        n += dn;
+    }
+}
+
+#if defined(HAVE_SSE2_INTRINSICS)
+static void
+TriangleInterpolate_SSE2(Sint64 n, Sint64 dn, const TriangleEdges *edges, int *out)
+{
+    const __m128d area = _mm_set1_pd(edges->area_f);
+    const __m128d step = _mm_set1_pd((double)dn);
+    const __m128d step2 = _mm_add_pd(step, step);
+    __m128d num = _mm_add_pd(_mm_set1_pd((double)n), _mm_mul_pd(step, _mm_set_pd(1.0, 0.0)));
+    int i;
+
+    for (i = 0; i < TRIANGLE_BLOCK; i += 2) {
+        _mm_storel_epi64((__m128i *)(out + i), _mm_cvttpd_epi32(_mm_div_pd(num, area)));
+        num = _mm_add_pd(num, step2);
+    }
+}
+#endif
+
+#if defined(HAVE_AVX2_TRIANGLE)
+static SDL_INLINE int
+hasAVX2()
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
+    }
+    val = SDL_HasAVX2();
+    return val;
+}
+
+static void SDL_TARGETING("avx2")
+TriangleInterpolate_AVX2(Sint64 n, Sint64 dn, const TriangleEdges *edges, int *out)
+{
+    const __m256d area = _mm256_set1_pd(edges->area_f);
+    const __m256d step = _mm256_set1_pd((double)dn);
+    const __m256d step4 = _mm256_mul_pd(step, _mm256_set1_pd(4.0));
+    __m256d num = _mm256_add_pd(_mm256_set1_pd((double)n), _mm256_mul_pd(step, _mm256_setr_pd(0.0, 1.0, 2.0, 3.0)));
+
+    _mm_storeu_si128((__m128i *)out, _mm256_cvttpd_epi32(_mm256_div_pd(num, area)));
+    num = _mm256_add_pd(num, step4);
+    _mm_storeu_si128((__m128i *)(out + 4), _mm256_cvttpd_epi32(_mm256_div_pd(num, area)));
+}
+#endif
+
+static void
+TriangleEdgesInit(TriangleEdges *edges, int area, int bias_w0, int bias_w1, int bias_w2,
+    int d2d1_y, int d1d2_x, int d0d2_y, int d2d0_x, int d1d0_y, int d0d1_x)
+{
+    int i;
+
+    edges->dx[0] = d2d1_y;
+    edges->dx[1] = d0d2_y;
+    edges->dx[2] = d1d0_y;
+    edges->dy[0] = d1d2_x;
+    edges->dy[1] = d2d0_x;
+    edges->dy[2] = d0d1_x;
+    /* w + bias >= 0 */
+    edges->limit[0] = -1 - bias_w0;
+    edges->limit[1] = -1 - bias_w1;
+    edges->limit[2] = -1 - bias_w2;
+    edges->area = area;
+    edges->area_f = (double)area;
+
+    edges->interpolate = TriangleInterpolate_Scalar;
+#if defined(HAVE_AVX2_TRIANGLE)
+    if (hasAVX2()) {
+        edges->interpolate = TriangleInterpolate_AVX2;
+    } else
+#endif
+    {
+#if defined(HAVE_SSE2_INTRINSICS)
+        edges->interpolate = TriangleInterpolate_SSE2;
+#endif
+    }
+
+#if defined(HAVE_SSE2_INTRINSICS)
+    for (i = 0; i < 3; i++) {
+        const int dx = edges->dx[i];
+        edges->steps_lo[i] = _mm_setr_epi32(0, dx, 2 * dx, 3 * dx);
+        edges->steps_hi[i] = _mm_setr_epi32(4 * dx, 5 * dx, 6 * dx, 7 * dx);
+        edges->limits[i] = _mm_set1_epi32(edges->limit[i]);
+    }
+#else
+    (void)i;
+#endif
+}
+
+static void
+TriangleValueInit(TriangleValue *value, const TriangleEdges *edges, Sint64 v0, Sint64 v1, Sint64 v2, Sint64 bias)
+{
+    value->v0 = v0;
+    value->v1 = v1;
+    value->v2 = v2;
+    value->bias = bias;
+    value->dn = edges->dx[0] * v0 + edges->dx[1] * v1 + edges->dx[2] * v2;
+
+    /* With weights below 2^31 and values below 2^20, the numerators stay
+       below 2^53 and the quotients below 2^21, so the double precision
+       quotient can't be rounded across an integer as long as 1/area is
+       larger than its precision */
+#define OUT_OF_RANGE(v, limit)  ((v) <= -(limit) || (v) >= (limit))
+    value->interpolate = edges->interpolate;
+    if (edges->area >= (1 << 30) ||
+        OUT_OF_RANGE(v0, 1 << 20) || OUT_OF_RANGE(v1, 1 << 20) || OUT_OF_RANGE(v2, 1 << 20) ||
+        OUT_OF_RANGE(bias, edges->area << 20)) {
+        value->interpolate = TriangleInterpolate_Scalar;
+    }
+#undef OUT_OF_RANGE
+}
+
+/* Interpolate a value for the TRIANGLE_BLOCK pixels of a row, starting with weights w0, w1, w2 */
+static SDL_INLINE void
+TriangleInterpolate(const TriangleEdges *edges, const TriangleValue *value, int w0, int w1, int w2, int *out)
+{
+    const Sint64 n = w0 * value->v0 + w1 * value->v1 + w2 * value->v2 + value->bias;
+    value->interpolate(n, value->dn, edges, out);
+}
+
+/* Whether a tile is completely outside, completely inside or partially covered by the triangle */
+static SDL_INLINE int
+TriangleBlockCoverage(const TriangleEdges *edges, int w0, int w1, int w2, int block_w, int block_h)
+{
+    int w[3];
+    int i, inside = 1;
+
+    w[0] = w0;
+    w[1] = w1;
+    w[2] = w2;
+    for (i = 0; i < 3; i++) {
+        /* the edge functions are linear, so the extremes are at the corners */
+        const int ex = (block_w - 1) * edges->dx[i];
+        const int ey = (block_h - 1) * edges->dy[i];
+        const int w_min = w[i] + SDL_min(ex, 0) + SDL_min(ey, 0);
+        const int w_max = w[i] + SDL_max(ex, 0) + SDL_max(ey, 0);
+        if (w_max <= edges->limit[i]) {
+            return TRIANGLE_OUTSIDE;
+        }
+        if (w_min <= edges->limit[i]) {
+            inside = 0;
+        }
+    }
+    return inside ? TRIANGLE_INSIDE : TRIANGLE_PARTIAL;
+}
+
+/* Bit mask of the pixels inside the triangle, for the TRIANGLE_BLOCK pixels of a row */
+static SDL_INLINE int
+TriangleRowMask(const TriangleEdges *edges, int w0, int w1, int w2)
+{
+#if defined(HAVE_SSE2_INTRINSICS)
+    const __m128i v0 = _mm_set1_epi32(w0);
+    const __m128i v1 = _mm_set1_epi32(w1);
+    const __m128i v2 = _mm_set1_epi32(w2);
+    __m128i lo, hi;
+
+    lo = _mm_cmpgt_epi32(_mm_add_epi32(v0, edges->steps_lo[0]), edges->limits[0]);
+    lo = _mm_and_si128(lo, _mm_cmpgt_epi32(_mm_add_epi32(v1, edges->steps_lo[1]), edges->limits[1]));
+    lo = _mm_and_si128(lo, _mm_cmpgt_epi32(_mm_add_epi32(v2, edges->steps_lo[2]), edges->limits[2]));
+    hi = _mm_cmpgt_epi32(_mm_add_epi32(v0, edges->steps_hi[0]), edges->limits[0]);
+    hi = _mm_and_si128(hi, _mm_cmpgt_epi32(_mm_add_epi32(v1, edges->steps_hi[1]), edges->limits[1]));
+    hi = _mm_and_si128(hi, _mm_cmpgt_epi32(_mm_add_epi32(v2, edges->steps_hi[2]), edges->limits[2]));
+    return _mm_movemask_ps(_mm_castsi128_ps(lo)) | (_mm_movemask_ps(_mm_castsi128_ps(hi)) << 4);
+#else
+    int i, mask = 0;
+    for (i = 0; i < TRIANGLE_BLOCK; i++) {
+        if (w0 > edges->limit[0] && w1 > edges->limit[1] && w2 > edges->limit[2]) {
+            mask |= 1 << i;
+        }
+        w0 += edges->dx[0];
+        w1 += edges->dx[1];
+        w2 += edges->dx[2];
+    }
+    return mask;
+#endif
+}
+
+/* Write the TRIANGLE_BLOCK pixels of a row that are set in mask, count pixels at most */
+static SDL_INLINE void
+TriangleStoreRow32(Uint32 *dptr, const Uint32 *pixels, int mask, int count)
+{
+    int i;
+    if (mask == (1 << TRIANGLE_BLOCK) - 1) {
+#if defined(HAVE_SSE2_INTRINSICS)
+        _mm_storeu_si128((__m128i *)dptr, _mm_loadu_si128((const __m128i *)pixels));
+        _mm_storeu_si128((__m128i *)(dptr + 4), _mm_loadu_si128((const __m128i *)(pixels + 4)));
+#else
+        SDL_memcpy(dptr, pixels, TRIANGLE_BLOCK * sizeof(Uint32));
+#endif
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        if (mask & (1 << i)) {
+            dptr[i] = pixels[i];
+        }
+    }
+}
+
+/* Whether SDL_MapRGBA() is a plain shift of each 8-bit component for this format */
+static SDL_bool
+TriangleIsPacked8888(const SDL_PixelFormat *format)
+{
+    return format->BytesPerPixel == 4 && !format->palette &&
+           format->Rloss == 0 && format->Gloss == 0 && format->Bloss == 0 &&
+           (format->Aloss == 0 || format->Aloss == 8);
+}
+
+/* Same as SDL_MapRGBA() for TRIANGLE_BLOCK pixels, in a format where TriangleIsPacked8888() */
+static SDL_INLINE void
+TrianglePackRow8888(const SDL_PixelFormat *format, const int *r, const int *g, const int *b, const int *a, Uint32 *pixels)
+{
+#if defined(HAVE_SSE2_INTRINSICS)
+    const __m128i rshift = _mm_cvtsi32_si128(format->Rshift);
+    const __m128i gshift = _mm_cvtsi32_si128(format->Gshift);
+    const __m128i bshift = _mm_cvtsi32_si128(format->Bshift);
+    const __m128i ashift = _mm_cvtsi32_si128(format->Ashift);
+    const __m128i aloss = _mm_cvtsi32_si128(format->Aloss);
+    const __m128i amask = _mm_set1_epi32((int)format->Amask);
+    int i;
+
+    for (i = 0; i < TRIANGLE_BLOCK; i += 4) {
+        __m128i pixel;
+        pixel = _mm_sll_epi32(_mm_loadu_si128((const __m128i *)(r + i)), rshift);
+        pixel = _mm_or_si128(pixel, _mm_sll_epi32(_mm_loadu_si128((const __m128i *)(g + i)), gshift));
+        pixel = _mm_or_si128(pixel, _mm_sll_epi32(_mm_loadu_si128((const __m128i *)(b + i)), bshift));
+        pixel = _mm_or_si128(pixel, _mm_and_si128(_mm_sll_epi32(_mm_srl_epi32(_mm_loadu_si128((const __m128i *)(a + i)), aloss), ashift), amask));
+        _mm_storeu_si128((__m128i *)(pixels + i), pixel);
+    }
+#else
+    int i;
+    for (i = 0; i < TRIANGLE_BLOCK; i++) {
+        pixels[i] = ((Uint32)r[i] << format->Rshift) |
+                    ((Uint32)g[i] << format->Gshift) |
+                    ((Uint32)b[i] << format->Bshift) |
+                    (((Uint32)a[i] >> format->Aloss) << format->Ashift & format->Amask);
+    }
+#endif
+}
+
+/* Walk the destination rect in blocks. For each row of a block which has
+ * pixels inside the triangle, the body gets 'dptr' pointing to the first
+ * pixel of the row, 'mask' with a bit set for each pixel inside, 'count'
+ * pixels in the row, and the weights 'w0', 'w1', 'w2' of the first pixel.
+ */
+#define TRIANGLE_BEGIN_BLOCK_LOOP                                                                       \
+    {                                                                                                   \
+        int bx, by, y;                                                                                  \
+        for (by = 0; by < dstrect.h; by += TRIANGLE_BLOCK) {                                            \
+            const int block_h = SDL_min(TRIANGLE_BLOCK, dstrect.h - by);                                \
+            int w0_block = w0_row;                                                                      \
+            int w1_block = w1_row;                                                                      \
+            int w2_block = w2_row;                                                                      \
+            for (bx = 0; bx < dstrect.w; bx += TRIANGLE_BLOCK) {                                        \
+                const int count = SDL_min(TRIANGLE_BLOCK, dstrect.w - bx);                              \
+                const int full = (1 << count) - 1;                                                      \
+                const int coverage = TriangleBlockCoverage(&edges, w0_block, w1_block, w2_block,        \
+                                                           count, block_h);                             \
+                if (coverage != TRIANGLE_OUTSIDE) {                                                     \
+                    Uint8 *dptr = (Uint8 *) dst_ptr + by * dst_pitch + bx * dstbpp;                     \
+                    int w0 = w0_block;                                                                  \
+                    int w1 = w1_block;                                                                  \
+                    int w2 = w2_block;                                                                  \
+                    for (y = 0; y < block_h; y++) {                                                     \
+                        const int mask = (coverage == TRIANGLE_INSIDE) ? full :                         \
+                                         (TriangleRowMask(&edges, w0, w1, w2) & full);                  \
+                        if (mask) {                                                                     \
+
+#define TRIANGLE_END_BLOCK_LOOP                                                                         \
+                        }                                                                               \
+                        /* y += 1 */                                                                    \
+                        w0 += d1d2_x;                                                                   \
+                        w1 += d2d0_x;                                                                   \
+                        w2 += d0d1_x;                                                                   \
+                        dptr += dst_pitch;                                                              \
+                    }                                                                                   \
+                }                                                                                       \
+                /* x += TRIANGLE_BLOCK */                                                               \
+                w0_block += TRIANGLE_BLOCK * d2d1_y;                                                    \
+                w1_block += TRIANGLE_BLOCK * d0d2_y;                                                    \
+                w2_block += TRIANGLE_BLOCK * d1d0_y;                                                    \
+            }                                                                                           \
+            /* y += TRIANGLE_BLOCK */                                                                   \
+            w0_row += TRIANGLE_BLOCK * d1d2_x;                                                          \
+            w1_row += TRIANGLE_BLOCK * d2d0_x;                                                          \
+            w2_row += TRIANGLE_BLOCK * d0d1_x;                                                          \
+        }                                                                                               \
+    }                                                                                                   \
+
 int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Point *d2, SDL_BlendMode blend, SDL_Color c0, SDL_Color c1, SDL_Color c2)
 {
     int ret = 0;
@@ -219,6 +563,8 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
     int w0_row, w1_row, w2_row;
     int bias_w0, bias_w1, bias_w2;
 
+    TriangleEdges edges;
+
     int is_uniform;
 
     SDL_Surface *tmp = NULL;
@@ -340,6 +686,9 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
     bias_w1 = (is_top_left(d2, d0, is_clockwise) ? 0 : -1);
     bias_w2 = (is_top_left(d0, d1, is_clockwise) ? 0 : -1);
 
+    TriangleEdgesInit(&edges, area, bias_w0, bias_w1, bias_w2,
+            d2d1_y, d1d2_x, d0d2_y, d2d0_x, d1d0_y, d0d1_x);
+
     if (is_uniform) {
         Uint32 color;
         if (tmp) {
@@ -354,11 +703,16 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
         }
 
         if (dstbpp == 4) {
-            TRIANGLE_BEGIN_LOOP
+            Uint32 pixels[TRIANGLE_BLOCK];
+            int i;
+            for (i = 0; i < TRIANGLE_BLOCK; i++) {
+                pixels[i] = color;
+            }
+            TRIANGLE_BEGIN_BLOCK_LOOP
             {
-                *(Uint32 *)dptr = color;
+                TriangleStoreRow32((Uint32 *)dptr, pixels, mask, count);
             }
-            TRIANGLE_END_LOOP
+            TRIANGLE_END_BLOCK_LOOP
         } else if (dstbpp == 3) {
             TRIANGLE_BEGIN_LOOP
             {
@@ -387,12 +741,31 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
             format = tmp->format;
         }
         if (dstbpp == 4) {
-            TRIANGLE_BEGIN_LOOP
+            const SDL_bool packed = TriangleIsPacked8888(format);
+            TriangleValue value_r, value_g, value_b, value_a;
+            TriangleValueInit(&value_r, &edges, c0.r, c1.r, c2.r, 0);
+            TriangleValueInit(&value_g, &edges, c0.g, c1.g, c2.g, 0);
+            TriangleValueInit(&value_b, &edges, c0.b, c1.b, c2.b, 0);
+            TriangleValueInit(&value_a, &edges, c0.a, c1.a, c2.a, 0);
+            TRIANGLE_BEGIN_BLOCK_LOOP
             {
-                TRIANGLE_GET_MAPPED_COLOR
-                *(Uint32 *)dptr = color;
+                int r[TRIANGLE_BLOCK], g[TRIANGLE_BLOCK], b[TRIANGLE_BLOCK], a[TRIANGLE_BLOCK];
+                Uint32 pixels[TRIANGLE_BLOCK];
+                TriangleInterpolate(&edges, &value_r, w0, w1, w2, r);
+                TriangleInterpolate(&edges, &value_g, w0, w1, w2, g);
+                TriangleInterpolate(&edges, &value_b, w0, w1, w2, b);
+                TriangleInterpolate(&edges, &value_a, w0, w1, w2, a);
+                if (packed) {
+                    TrianglePackRow8888(format, r, g, b, a, pixels);
+                } else {
+                    int i;
+                    for (i = 0; i < count; i++) {
+                        pixels[i] = SDL_MapRGBA(format, r[i], g[i], b[i], a[i]);
+                    }
+                }
+                TriangleStoreRow32((Uint32 *)dptr, pixels, mask, count);
             }
-            TRIANGLE_END_LOOP
+            TRIANGLE_END_BLOCK_LOOP
         } else if (dstbpp == 3) {
             TRIANGLE_BEGIN_LOOP
             {
@@ -471,6 +844,8 @@ int SDL_SW_BlitTriangle(
     int w0_row, w1_row, w2_row;
     int bias_w0, bias_w1, bias_w2;
 
+    TriangleEdges edges;
+
     int is_uniform;
 
     int has_modulation;
@@ -671,13 +1046,26 @@ int SDL_SW_BlitTriangle(
     }
 
     if (dstbpp == 4) {
-        TRIANGLE_BEGIN_LOOP
+        TriangleValue value_x, value_y;
+        TriangleEdgesInit(&edges, area, bias_w0, bias_w1, bias_w2,
+                d2d1_y, d1d2_x, d0d2_y, d2d0_x, d1d0_y, d0d1_x);
+        TriangleValueInit(&value_x, &edges, s2s0_x, s2s1_x, 0, s2_x_area.x);
+        TriangleValueInit(&value_y, &edges, s2s0_y, s2s1_y, 0, s2_x_area.y);
+        TRIANGLE_BEGIN_BLOCK_LOOP
         {
-            TRIANGLE_GET_TEXTCOORD
-            Uint32 *sptr = (Uint32 *)((Uint8 *) src_ptr + srcy * src_pitch);
-            *(Uint32 *)dptr = sptr[srcx];
+            int srcx[TRIANGLE_BLOCK], srcy[TRIANGLE_BLOCK];
+            Uint32 pixels[TRIANGLE_BLOCK];
+            int i;
+            TriangleInterpolate(&edges, &value_x, w0, w1, w2, srcx);
+            TriangleInterpolate(&edges, &value_y, w0, w1, w2, srcy);
+            for (i = 0; i < count; i++) {
+                if (mask & (1 << i)) {
+                    pixels[i] = ((Uint32 *)((Uint8 *) src_ptr + srcy[i] * src_pitch))[srcx[i]];
+                }
+            }
+            TriangleStoreRow32((Uint32 *)dptr, pixels, mask, count);
         }
-        TRIANGLE_END_LOOP
+        TRIANGLE_END_BLOCK_LOOP
     } else if (dstbpp == 3) {
         TRIANGLE_BEGIN_LOOP
         {
@@ -759,128 +1147,158 @@ SDL_BlitTriangle_Slow(SDL_BlitInfo *info,
     Uint32 ckey = info->colorkey & rgbmask;
 
     Uint8 *dst_ptr = info->dst;
-    int dst_pitch = info->dst_pitch;;
+    int dst_pitch = info->dst_pitch;
+
+    TriangleEdges edges;
+    TriangleValue value_x, value_y, value_r, value_g, value_b, value_a;
 
     srcfmt_val = detect_format(src_fmt);
     dstfmt_val = detect_format(dst_fmt);
 
-    TRIANGLE_BEGIN_LOOP
+    TriangleEdgesInit(&edges, area, bias_w0, bias_w1, bias_w2,
+            d2d1_y, d1d2_x, d0d2_y, d2d0_x, d1d0_y, d0d1_x);
+    TriangleValueInit(&value_x, &edges, s2s0_x, s2s1_x, 0, s2_x_area.x);
+    TriangleValueInit(&value_y, &edges, s2s0_y, s2s1_y, 0, s2_x_area.y);
+    if (! is_uniform) {
+        TriangleValueInit(&value_r, &edges, c0.r, c1.r, c2.r, 0);
+        TriangleValueInit(&value_g, &edges, c0.g, c1.g, c2.g, 0);
+        TriangleValueInit(&value_b, &edges, c0.b, c1.b, c2.b, 0);
+        TriangleValueInit(&value_a, &edges, c0.a, c1.a, c2.a, 0);
+    }
+
+    TRIANGLE_BEGIN_BLOCK_LOOP
     {
-        Uint8 *src;
-        Uint8 *dst = dptr;
-        TRIANGLE_GET_TEXTCOORD
-        src = (info->src + (srcy * info->src_pitch) + (srcx * srcbpp));
-        if (FORMAT_HAS_ALPHA(srcfmt_val)) {
-            DISEMBLE_RGBA(src, srcbpp, src_fmt, srcpixel, srcR, srcG, srcB, srcA);
-        } else if (FORMAT_HAS_NO_ALPHA(srcfmt_val)) {
-            DISEMBLE_RGB(src, srcbpp, src_fmt, srcpixel, srcR, srcG, srcB);
-            srcA = 0xFF;
-        } else {
-            /* SDL_PIXELFORMAT_ARGB2101010 */
-            srcpixel = *((Uint32 *)(src));
-            RGBA_FROM_ARGB2101010(srcpixel, srcR, srcG, srcB, srcA);
+        int srcx[TRIANGLE_BLOCK], srcy[TRIANGLE_BLOCK];
+        int r[TRIANGLE_BLOCK], g[TRIANGLE_BLOCK], b[TRIANGLE_BLOCK], a[TRIANGLE_BLOCK];
+        int i;
+
+        TriangleInterpolate(&edges, &value_x, w0, w1, w2, srcx);
+        TriangleInterpolate(&edges, &value_y, w0, w1, w2, srcy);
+        if (! is_uniform) {
+            TriangleInterpolate(&edges, &value_r, w0, w1, w2, r);
+            TriangleInterpolate(&edges, &value_g, w0, w1, w2, g);
+            TriangleInterpolate(&edges, &value_b, w0, w1, w2, b);
+            TriangleInterpolate(&edges, &value_a, w0, w1, w2, a);
         }
-        if (flags & SDL_COPY_COLORKEY) {
-            /* srcpixel isn't set for 24 bpp */
-            if (srcbpp == 3) {
-                srcpixel = (srcR << src_fmt->Rshift) |
-                    (srcG << src_fmt->Gshift) | (srcB << src_fmt->Bshift);
-            }
-            if ((srcpixel & rgbmask) == ckey) {
+
+        for (i = 0; i < count; i++) {
+            Uint8 *src;
+            Uint8 *dst = dptr + i * dstbpp;
+            if (!(mask & (1 << i))) {
                 continue;
             }
-        }
-        if (FORMAT_HAS_ALPHA(dstfmt_val)) {
-            DISEMBLE_RGBA(dst, dstbpp, dst_fmt, dstpixel, dstR, dstG, dstB, dstA);
-        } else if (FORMAT_HAS_NO_ALPHA(dstfmt_val)) {
-            DISEMBLE_RGB(dst, dstbpp, dst_fmt, dstpixel, dstR, dstG, dstB);
-            dstA = 0xFF;
-        } else {
-            /* SDL_PIXELFORMAT_ARGB2101010 */
-            dstpixel = *((Uint32 *)(dst));
-            RGBA_FROM_ARGB2101010(dstpixel, dstR, dstG, dstB, dstA);
-        }
+            src = (info->src + (srcy[i] * info->src_pitch) + (srcx[i] * srcbpp));
+            if (FORMAT_HAS_ALPHA(srcfmt_val)) {
+                DISEMBLE_RGBA(src, srcbpp, src_fmt, srcpixel, srcR, srcG, srcB, srcA);
+            } else if (FORMAT_HAS_NO_ALPHA(srcfmt_val)) {
+                DISEMBLE_RGB(src, srcbpp, src_fmt, srcpixel, srcR, srcG, srcB);
+                srcA = 0xFF;
+            } else {
+                /* SDL_PIXELFORMAT_ARGB2101010 */
+                srcpixel = *((Uint32 *)(src));
+                RGBA_FROM_ARGB2101010(srcpixel, srcR, srcG, srcB, srcA);
+            }
+            if (flags & SDL_COPY_COLORKEY) {
+                /* srcpixel isn't set for 24 bpp */
+                if (srcbpp == 3) {
+                    srcpixel = (srcR << src_fmt->Rshift) |
+                        (srcG << src_fmt->Gshift) | (srcB << src_fmt->Bshift);
+                }
+                if ((srcpixel & rgbmask) == ckey) {
+                    continue;
+                }
+            }
+            if (FORMAT_HAS_ALPHA(dstfmt_val)) {
+                DISEMBLE_RGBA(dst, dstbpp, dst_fmt, dstpixel, dstR, dstG, dstB, dstA);
+            } else if (FORMAT_HAS_NO_ALPHA(dstfmt_val)) {
+                DISEMBLE_RGB(dst, dstbpp, dst_fmt, dstpixel, dstR, dstG, dstB);
+                dstA = 0xFF;
+            } else {
+                /* SDL_PIXELFORMAT_ARGB2101010 */
+                dstpixel = *((Uint32 *)(dst));
+                RGBA_FROM_ARGB2101010(dstpixel, dstR, dstG, dstB, dstA);
+            }
 
-        if (! is_uniform) {
-            TRIANGLE_GET_COLOR
-            modulateR = r;
-            modulateG = g;
-            modulateB = b;
-            modulateA = a;
-        }
+            if (! is_uniform) {
+                modulateR = r[i];
+                modulateG = g[i];
+                modulateB = b[i];
+                modulateA = a[i];
+            }
 
-        if (flags & SDL_COPY_MODULATE_COLOR) {
-            srcR = (srcR * modulateR) / 255;
-            srcG = (srcG * modulateG) / 255;
-            srcB = (srcB * modulateB) / 255;
-        }
-        if (flags & SDL_COPY_MODULATE_ALPHA) {
-            srcA = (srcA * modulateA) / 255;
-        }
-        if (flags & (SDL_COPY_BLEND | SDL_COPY_ADD)) {
-            /* This goes away if we ever use premultiplied alpha */
-            if (srcA < 255) {
-                srcR = (srcR * srcA) / 255;
-                srcG = (srcG * srcA) / 255;
-                srcB = (srcB * srcA) / 255;
+            if (flags & SDL_COPY_MODULATE_COLOR) {
+                srcR = (srcR * modulateR) / 255;
+                srcG = (srcG * modulateG) / 255;
+                srcB = (srcB * modulateB) / 255;
+            }
+            if (flags & SDL_COPY_MODULATE_ALPHA) {
+                srcA = (srcA * modulateA) / 255;
+            }
+            if (flags & (SDL_COPY_BLEND | SDL_COPY_ADD)) {
+                /* This goes away if we ever use premultiplied alpha */
+                if (srcA < 255) {
+                    srcR = (srcR * srcA) / 255;
+                    srcG = (srcG * srcA) / 255;
+                    srcB = (srcB * srcA) / 255;
+                }
+            }
+            switch (flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL)) {
+            case 0:
+                dstR = srcR;
+                dstG = srcG;
+                dstB = srcB;
+                dstA = srcA;
+                break;
+            case SDL_COPY_BLEND:
+                dstR = srcR + ((255 - srcA) * dstR) / 255;
+                dstG = srcG + ((255 - srcA) * dstG) / 255;
+                dstB = srcB + ((255 - srcA) * dstB) / 255;
+                dstA = srcA + ((255 - srcA) * dstA) / 255;
+                break;
+            case SDL_COPY_ADD:
+                dstR = srcR + dstR;
+                if (dstR > 255)
+                    dstR = 255;
+                dstG = srcG + dstG;
+                if (dstG > 255)
+                    dstG = 255;
+                dstB = srcB + dstB;
+                if (dstB > 255)
+                    dstB = 255;
+                break;
+            case SDL_COPY_MOD:
+                dstR = (srcR * dstR) / 255;
+                dstG = (srcG * dstG) / 255;
+                dstB = (srcB * dstB) / 255;
+                break;
+            case SDL_COPY_MUL:
+                dstR = ((srcR * dstR) + (dstR * (255 - srcA))) / 255;
+                if (dstR > 255)
+                    dstR = 255;
+                dstG = ((srcG * dstG) + (dstG * (255 - srcA))) / 255;
+                if (dstG > 255)
+                    dstG = 255;
+                dstB = ((srcB * dstB) + (dstB * (255 - srcA))) / 255;
+                if (dstB > 255)
+                    dstB = 255;
+                dstA = ((srcA * dstA) + (dstA * (255 - srcA))) / 255;
+                if (dstA > 255)
+                    dstA = 255;
+                break;
+            }
+            if (FORMAT_HAS_ALPHA(dstfmt_val)) {
+                ASSEMBLE_RGBA(dst, dstbpp, dst_fmt, dstR, dstG, dstB, dstA);
+            } else if (FORMAT_HAS_NO_ALPHA(dstfmt_val)) {
+                ASSEMBLE_RGB(dst, dstbpp, dst_fmt, dstR, dstG, dstB);
+            } else {
+                /* SDL_PIXELFORMAT_ARGB2101010 */
+                Uint32 pixel;
+                ARGB2101010_FROM_RGBA(pixel, dstR, dstG, dstB, dstA);
+                *(Uint32 *)dst = pixel;
             }
-        }
-        switch (flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL)) {
-        case 0:
-            dstR = srcR;
-            dstG = srcG;
-            dstB = srcB;
-            dstA = srcA;
-            break;
-        case SDL_COPY_BLEND:
-            dstR = srcR + ((255 - srcA) * dstR) / 255;
-            dstG = srcG + ((255 - srcA) * dstG) / 255;
-            dstB = srcB + ((255 - srcA) * dstB) / 255;
-            dstA = srcA + ((255 - srcA) * dstA) / 255;
-            break;
-        case SDL_COPY_ADD:
-            dstR = srcR + dstR;
-            if (dstR > 255)
-                dstR = 255;
-            dstG = srcG + dstG;
-            if (dstG > 255)
-                dstG = 255;
-            dstB = srcB + dstB;
-            if (dstB > 255)
-                dstB = 255;
-            break;
-        case SDL_COPY_MOD:
-            dstR = (srcR * dstR) / 255;
-            dstG = (srcG * dstG) / 255;
-            dstB = (srcB * dstB) / 255;
-            break;
-        case SDL_COPY_MUL:
-            dstR = ((srcR * dstR) + (dstR * (255 - srcA))) / 255;
-            if (dstR > 255)
-                dstR = 255;
-            dstG = ((srcG * dstG) + (dstG * (255 - srcA))) / 255;
-            if (dstG > 255)
-                dstG = 255;
-            dstB = ((srcB * dstB) + (dstB * (255 - srcA))) / 255;
-            if (dstB > 255)
-                dstB = 255;
-            dstA = ((srcA * dstA) + (dstA * (255 - srcA))) / 255;
-            if (dstA > 255)
-                dstA = 255;
-            break;
-        }
-        if (FORMAT_HAS_ALPHA(dstfmt_val)) {
-            ASSEMBLE_RGBA(dst, dstbpp, dst_fmt, dstR, dstG, dstB, dstA);
-        } else if (FORMAT_HAS_NO_ALPHA(dstfmt_val)) {
-            ASSEMBLE_RGB(dst, dstbpp, dst_fmt, dstR, dstG, dstB);
-        } else {
-            /* SDL_PIXELFORMAT_ARGB2101010 */
-            Uint32 pixel;
-            ARGB2101010_FROM_RGBA(pixel, dstR, dstG, dstB, dstA);
-            *(Uint32 *)dst = pixel;
         }
     }
-    TRIANGLE_END_LOOP
+    TRIANGLE_END_BLOCK_LOOP
 }
 
 #endif /* SDL_VIDEO_RENDER_SW && !SDL_RENDER_DISABLED */
@@ -30,6 +30,8 @@
 #include "SDL_stdinc.h"
 #include "SDL_endian.h"
 
+#include "SDL_cpuinfo.h"
+
 #if defined(HAVE_ICONV) && defined(HAVE_ICONV_H)
 #ifdef __FreeBSD__
 /* Define LIBICONV_PLUG to use iconv from the base instead of ports and avoid linker errors. */
@@ -37,45 +39,15 @@
 #endif
 #include <iconv.h>
 #include <errno.h>
+#endif
 
-SDL_COMPILE_TIME_ASSERT(iconv_t, sizeof (iconv_t) <= sizeof (SDL_iconv_t));
-
-SDL_iconv_t
-SDL_iconv_open(const char *tocode, const char *fromcode)
-{
-    return (SDL_iconv_t) ((uintptr_t) iconv_open(tocode, fromcode));
-}
-
-int
-SDL_iconv_close(SDL_iconv_t cd)
-{
-    return iconv_close((iconv_t) ((uintptr_t) cd));
-}
-
-size_t
-SDL_iconv(SDL_iconv_t cd,
-          const char **inbuf, size_t * inbytesleft,
-          char **outbuf, size_t * outbytesleft)
-{
-    /* iconv's second parameter may or may not be `const char const *` depending on the
-       C runtime's whims. Casting to void * seems to make everyone happy, though. */
-    const size_t retCode = iconv((iconv_t) ((uintptr_t) cd), (void *) inbuf, inbytesleft, outbuf, outbytesleft);
-    if (retCode == (size_t) - 1) {
-        switch (errno) {
-        case E2BIG:
-            return SDL_ICONV_E2BIG;
-        case EILSEQ:
-            return SDL_ICONV_EILSEQ;
-        case EINVAL:
-            return SDL_ICONV_EINVAL;
-        default:
-            return SDL_ICONV_ERROR;
-        }
-    }
-    return retCode;
-}
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
 
-#else
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
 
 /* Lots of useful information on Unicode at:
     http://www.cl.cam.ac.uk/~mgk25/unicode.html
@@ -115,12 +87,6 @@ enum
 #define ENCODING_UCS4NATIVE     ENCODING_UCS4LE
 #endif
 
-struct _SDL_iconv_t
-{
-    int src_fmt;
-    int dst_fmt;
-};
-
 static struct
 {
     const char *name;
@@ -163,6 +129,533 @@ static struct
 /* *INDENT-ON* */ /* clang-format on */
 };
 
+/* How code units are laid out in memory, for the ASCII fast path */
+enum
+{
+    LAYOUT_NONE,
+    LAYOUT_8,
+    LAYOUT_16LE,
+    LAYOUT_16BE,
+    LAYOUT_32LE,
+    LAYOUT_32BE
+};
+
+static int
+getlayout(int format)
+{
+    switch (format) {
+    case ENCODING_ASCII:
+    case ENCODING_LATIN1:
+    case ENCODING_UTF8:
+        return LAYOUT_8;
+    case ENCODING_UTF16LE:
+    case ENCODING_UCS2LE:
+        return LAYOUT_16LE;
+    case ENCODING_UTF16BE:
+    case ENCODING_UCS2BE:
+        return LAYOUT_16BE;
+    case ENCODING_UTF32LE:
+    case ENCODING_UCS4LE:
+        return LAYOUT_32LE;
+    case ENCODING_UTF32BE:
+    case ENCODING_UCS4BE:
+        return LAYOUT_32BE;
+    default:
+        return LAYOUT_NONE;
+    }
+}
+
+static int
+getunitsize(int layout)
+{
+    switch (layout) {
+    case LAYOUT_8:
+        return 1;
+    case LAYOUT_16LE:
+    case LAYOUT_16BE:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+/* The SIMD versions handle any byte sized source, and 16 or 32-bit little
+   endian sources going to bytes or to the same layout. They work on blocks
+   of 16 code units and stop at the first block that isn't all ASCII.
+ */
+static SDL_bool
+SDL_iconv_ascii_simd_supported(int src_layout, int dst_layout)
+{
+    if (src_layout == LAYOUT_8) {
+        return SDL_TRUE;
+    }
+    if (src_layout == LAYOUT_16LE || src_layout == LAYOUT_32LE) {
+        return (dst_layout == LAYOUT_8 || dst_layout == src_layout);
+    }
+    return SDL_FALSE;
+}
+
+#if HAVE_SSE2_INTRINSICS
+static size_t
+SDL_iconv_ascii_SSE2(const Uint8 *src, int src_layout, Uint8 *dst, int dst_layout, size_t count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const int dst_block = 16 * getunitsize(dst_layout);
+    size_t i;
+
+    for (i = 0; i + 16 <= count; i += 16) {
+        if (src_layout == LAYOUT_8) {
+            const __m128i v = _mm_loadu_si128((const __m128i *)src);
+            if (_mm_movemask_epi8(v) != 0) {
+                break;
+            }
+            switch (dst_layout) {
+            case LAYOUT_8:
+                _mm_storeu_si128((__m128i *)dst, v);
+                break;
+            case LAYOUT_16LE:
+                _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi8(v, zero));
+                _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi8(v, zero));
+                break;
+            case LAYOUT_16BE:
+                _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi8(zero, v));
+                _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi8(zero, v));
+                break;
+            case LAYOUT_32LE:
+            {
+                const __m128i lo = _mm_unpacklo_epi8(v, zero);
+                const __m128i hi = _mm_unpackhi_epi8(v, zero);
+                _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128((__m128i *)(dst + 32), _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128((__m128i *)(dst + 48), _mm_unpackhi_epi16(hi, zero));
+                break;
+            }
+            case LAYOUT_32BE:
+            {
+                const __m128i lo = _mm_unpacklo_epi8(zero, v);
+                const __m128i hi = _mm_unpackhi_epi8(zero, v);
+                _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(zero, lo));
+                _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(zero, lo));
+                _mm_storeu_si128((__m128i *)(dst + 32), _mm_unpacklo_epi16(zero, hi));
+                _mm_storeu_si128((__m128i *)(dst + 48), _mm_unpackhi_epi16(zero, hi));
+                break;
+            }
+            }
+            src += 16;
+        } else if (src_layout == LAYOUT_16LE) {
+            const __m128i a = _mm_loadu_si128((const __m128i *)src);
+            const __m128i b = _mm_loadu_si128((const __m128i *)(src + 16));
+            const __m128i high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16((short)0xFF80));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) {
+                break;
+            }
+            if (dst_layout == LAYOUT_8) {
+                _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(a, b));
+            } else {
+                _mm_storeu_si128((__m128i *)dst, a);
+                _mm_storeu_si128((__m128i *)(dst + 16), b);
+            }
+            src += 32;
+        } else {
+            const __m128i a = _mm_loadu_si128((const __m128i *)src);
+            const __m128i b = _mm_loadu_si128((const __m128i *)(src + 16));
+            const __m128i c = _mm_loadu_si128((const __m128i *)(src + 32));
+            const __m128i d = _mm_loadu_si128((const __m128i *)(src + 48));
+            const __m128i high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), _mm_set1_epi32((int)0xFFFFFF80));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xFFFF) {
+                break;
+            }
+            if (dst_layout == LAYOUT_8) {
+                _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+            } else {
+                _mm_storeu_si128((__m128i *)dst, a);
+                _mm_storeu_si128((__m128i *)(dst + 16), b);
+                _mm_storeu_si128((__m128i *)(dst + 32), c);
+                _mm_storeu_si128((__m128i *)(dst + 48), d);
+            }
+            src += 64;
+        }
+        dst += dst_block;
+    }
+    return i;
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS && (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+#define HAVE_NEON_ASCII 1
+
+static SDL_bool
+SDL_iconv_any_set_NEON(uint8x16_t v)
+{
+    const uint64x2_t v64 = vreinterpretq_u64_u8(v);
+    return (vgetq_lane_u64(v64, 0) | vgetq_lane_u64(v64, 1)) ? SDL_TRUE : SDL_FALSE;
+}
+
+static size_t
+SDL_iconv_ascii_NEON(const Uint8 *src, int src_layout, Uint8 *dst, int dst_layout, size_t count)
+{
+    const uint8x16_t zero = vdupq_n_u8(0);
+    const int dst_block = 16 * getunitsize(dst_layout);
+    size_t i;
+
+    for (i = 0; i + 16 <= count; i += 16) {
+        if (src_layout == LAYOUT_8) {
+            const uint8x16_t v = vld1q_u8(src);
+            if (SDL_iconv_any_set_NEON(vandq_u8(v, vdupq_n_u8(0x80)))) {
+                break;
+            }
+            switch (dst_layout) {
+            case LAYOUT_8:
+                vst1q_u8(dst, v);
+                break;
+            case LAYOUT_16LE:
+            case LAYOUT_16BE:
+            {
+                const uint8x16x2_t w = (dst_layout == LAYOUT_16LE) ? vzipq_u8(v, zero) : vzipq_u8(zero, v);
+                vst1q_u8(dst, w.val[0]);
+                vst1q_u8(dst + 16, w.val[1]);
+                break;
+            }
+            case LAYOUT_32LE:
+            case LAYOUT_32BE:
+            {
+                const uint16x8_t zero16 = vdupq_n_u16(0);
+                uint8x16x2_t w;
+                uint16x8x2_t lo, hi;
+                if (dst_layout == LAYOUT_32LE) {
+                    w = vzipq_u8(v, zero);
+                    lo = vzipq_u16(vreinterpretq_u16_u8(w.val[0]), zero16);
+                    hi = vzipq_u16(vreinterpretq_u16_u8(w.val[1]), zero16);
+                } else {
+                    w = vzipq_u8(zero, v);
+                    lo = vzipq_u16(zero16, vreinterpretq_u16_u8(w.val[0]));
+                    hi = vzipq_u16(zero16, vreinterpretq_u16_u8(w.val[1]));
+                }
+                vst1q_u16((uint16_t *)dst, lo.val[0]);
+                vst1q_u16((uint16_t *)(dst + 16), lo.val[1]);
+                vst1q_u16((uint16_t *)(dst + 32), hi.val[0]);
+                vst1q_u16((uint16_t *)(dst + 48), hi.val[1]);
+                break;
+            }
+            }
+            src += 16;
+        } else if (src_layout == LAYOUT_16LE) {
+            const uint16x8_t a = vld1q_u16((const uint16_t *)src);
+            const uint16x8_t b = vld1q_u16((const uint16_t *)(src + 16));
+            if (SDL_iconv_any_set_NEON(vreinterpretq_u8_u16(vandq_u16(vorrq_u16(a, b), vdupq_n_u16(0xFF80))))) {
+                break;
+            }
+            if (dst_layout == LAYOUT_8) {
+                vst1q_u8(dst, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+            } else {
+                vst1q_u16((uint16_t *)dst, a);
+                vst1q_u16((uint16_t *)(dst + 16), b);
+            }
+            src += 32;
+        } else {
+            const uint32x4_t a = vld1q_u32((const uint32_t *)src);
+            const uint32x4_t b = vld1q_u32((const uint32_t *)(src + 16));
+            const uint32x4_t c = vld1q_u32((const uint32_t *)(src + 32));
+            const uint32x4_t d = vld1q_u32((const uint32_t *)(src + 48));
+            const uint32x4_t all = vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d));
+            if (SDL_iconv_any_set_NEON(vreinterpretq_u8_u32(vandq_u32(all, vdupq_n_u32(0xFFFFFF80))))) {
+                break;
+            }
+            if (dst_layout == LAYOUT_8) {
+                const uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+                const uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+                vst1q_u8(dst, vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+            } else {
+                vst1q_u32((uint32_t *)dst, a);
+                vst1q_u32((uint32_t *)(dst + 16), b);
+                vst1q_u32((uint32_t *)(dst + 32), c);
+                vst1q_u32((uint32_t *)(dst + 48), d);
+            }
+            src += 64;
+        }
+        dst += dst_block;
+    }
+    return i;
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+/* Converts the run of ASCII characters at the start of src, stopping at the
+   first other character or when the output is full. Returns the number of
+   characters converted.
+ */
+static size_t
+SDL_iconv_ascii(const Uint8 *src, size_t srclen, int src_layout,
+                Uint8 *dst, size_t dstlen, int dst_layout)
+{
+    const int src_size = getunitsize(src_layout);
+    const int dst_size = getunitsize(dst_layout);
+    const size_t count = SDL_min(srclen / src_size, dstlen / dst_size);
+    size_t i = 0;
+
+    if (count >= 16 && SDL_iconv_ascii_simd_supported(src_layout, dst_layout)) {
+#if HAVE_SSE2_INTRINSICS
+        if (SDL_HasSSE2()) {
+            i = SDL_iconv_ascii_SSE2(src, src_layout, dst, dst_layout, count);
+        }
+#endif
+#if HAVE_NEON_ASCII
+        if (SDL_HasNEON()) {
+            i = SDL_iconv_ascii_NEON(src, src_layout, dst, dst_layout, count);
+        }
+#endif
+        src += i * src_size;
+        dst += i * dst_size;
+    }
+
+    for (; i < count; ++i) {
+        Uint8 ch;
+
+        switch (src_layout) {
+        case LAYOUT_8:
+            if (src[0] & 0x80) {
+                return i;
+            }
+            ch = src[0];
+            break;
+        case LAYOUT_16LE:
+            if ((src[0] & 0x80) || src[1]) {
+                return i;
+            }
+            ch = src[0];
+            break;
+        case LAYOUT_16BE:
+            if (src[0] || (src[1] & 0x80)) {
+                return i;
+            }
+            ch = src[1];
+            break;
+        case LAYOUT_32LE:
+            if ((src[0] & 0x80) || src[1] || src[2] || src[3]) {
+                return i;
+            }
+            ch = src[0];
+            break;
+        default:
+            if (src[0] || src[1] || src[2] || (src[3] & 0x80)) {
+                return i;
+            }
+            ch = src[3];
+            break;
+        }
+        src += src_size;
+
+        SDL_memset(dst, 0, dst_size);
+        switch (dst_layout) {
+        case LAYOUT_16BE:
+            dst[1] = ch;
+            break;
+        case LAYOUT_32BE:
+            dst[3] = ch;
+            break;
+        default:
+            dst[0] = ch;
+            break;
+        }
+        dst += dst_size;
+    }
+    return i;
+}
+
+#if defined(HAVE_ICONV) && defined(HAVE_ICONV_H)
+
+struct _SDL_iconv_t
+{
+    iconv_t cd;
+    int src_layout;
+    int dst_layout;
+};
+
+/* Returns the layout of an encoding name, if the system iconv is sure to
+   treat it the way we do. Names without an explicit byte order may add a
+   byte order marker or use a different default order, so those are left
+   entirely to iconv.
+ */
+static int
+getsystemlayout(const char *code)
+{
+    size_t len;
+    int i;
+
+    if (!code) {
+        return LAYOUT_NONE;
+    }
+    len = SDL_strlen(code);
+    for (i = 0; i < (int)SDL_arraysize(encodings); ++i) {
+        if (SDL_strcasecmp(code, encodings[i].name) == 0) {
+            const int layout = getlayout(encodings[i].format);
+            if (layout == LAYOUT_8) {
+                return layout;
+            }
+            if (len > 2 && (SDL_strcasecmp(code + len - 2, "LE") == 0 ||
+                            SDL_strcasecmp(code + len - 2, "BE") == 0)) {
+                return layout;
+            }
+            return LAYOUT_NONE;
+        }
+    }
+    return LAYOUT_NONE;
+}
+
+/* Returns the number of bytes before the next ASCII character in src, which
+   is never part of a longer character in any of the layouts.
+ */
+static size_t
+SDL_iconv_nonascii_length(const Uint8 *src, size_t srclen, int layout)
+{
+    const int size = getunitsize(layout);
+    size_t i;
+
+    for (i = 0; i + size <= srclen; i += size) {
+        const Uint8 *p = src + i;
+        SDL_bool ascii;
+
+        switch (layout) {
+        case LAYOUT_8:
+            ascii = !(p[0] & 0x80);
+            break;
+        case LAYOUT_16LE:
+            ascii = !((p[0] & 0x80) || p[1]);
+            break;
+        case LAYOUT_16BE:
+            ascii = !(p[0] || (p[1] & 0x80));
+            break;
+        case LAYOUT_32LE:
+            ascii = !((p[0] & 0x80) || p[1] || p[2] || p[3]);
+            break;
+        default:
+            ascii = !(p[0] || p[1] || p[2] || (p[3] & 0x80));
+            break;
+        }
+        if (ascii) {
+            return i;
+        }
+    }
+    return srclen;
+}
+
+SDL_iconv_t
+SDL_iconv_open(const char *tocode, const char *fromcode)
+{
+    SDL_iconv_t cd;
+    iconv_t handle;
+
+    handle = iconv_open(tocode, fromcode);
+    if (handle == (iconv_t) - 1) {
+        return (SDL_iconv_t) - 1;
+    }
+    cd = (SDL_iconv_t) SDL_malloc(sizeof(*cd));
+    if (!cd) {
+        iconv_close(handle);
+        return (SDL_iconv_t) - 1;
+    }
+    cd->cd = handle;
+    cd->src_layout = getsystemlayout(fromcode);
+    cd->dst_layout = getsystemlayout(tocode);
+    return cd;
+}
+
+int
+SDL_iconv_close(SDL_iconv_t cd)
+{
+    int retval;
+
+    if (cd == (SDL_iconv_t) - 1) {
+        return -1;
+    }
+    retval = iconv_close(cd->cd);
+    SDL_free(cd);
+    return retval;
+}
+
+static size_t
+SDL_iconv_system(iconv_t cd,
+                 const char **inbuf, size_t * inbytesleft,
+                 char **outbuf, size_t * outbytesleft)
+{
+    /* iconv's second parameter may or may not be `const char const *` depending on the
+       C runtime's whims. Casting to void * seems to make everyone happy, though. */
+    const size_t retCode = iconv(cd, (void *) inbuf, inbytesleft, outbuf, outbytesleft);
+    if (retCode == (size_t) - 1) {
+        switch (errno) {
+        case E2BIG:
+            return SDL_ICONV_E2BIG;
+        case EILSEQ:
+            return SDL_ICONV_EILSEQ;
+        case EINVAL:
+            return SDL_ICONV_EINVAL;
+        default:
+            return SDL_ICONV_ERROR;
+        }
+    }
+    return retCode;
+}
+
+size_t
+SDL_iconv(SDL_iconv_t cd,
+          const char **inbuf, size_t * inbytesleft,
+          char **outbuf, size_t * outbytesleft)
+{
+    size_t total = 0;
+
+    if (cd->src_layout == LAYOUT_NONE || cd->dst_layout == LAYOUT_NONE ||
+        !inbuf || !*inbuf || !inbytesleft || !outbuf || !*outbuf || !outbytesleft) {
+        return SDL_iconv_system(cd->cd, inbuf, inbytesleft, outbuf, outbytesleft);
+    }
+
+    while (*inbytesleft > 0) {
+        const size_t src_size = getunitsize(cd->src_layout);
+        const size_t dst_size = getunitsize(cd->dst_layout);
+        size_t count, remaining, run, left, retCode;
+
+        /* Most text is largely ASCII, so convert runs of it in bulk */
+        count = SDL_iconv_ascii((const Uint8 *)*inbuf, *inbytesleft, cd->src_layout,
+                                (Uint8 *)*outbuf, *outbytesleft, cd->dst_layout);
+        *inbuf += count * src_size;
+        *inbytesleft -= count * src_size;
+        *outbuf += count * dst_size;
+        *outbytesleft -= count * dst_size;
+
+        remaining = *inbytesleft;
+        if (remaining == 0) {
+            break;
+        }
+
+        /* Hand iconv everything up to the next ASCII character */
+        run = SDL_iconv_nonascii_length((const Uint8 *)*inbuf, remaining, cd->src_layout);
+        if (run == 0) {
+            /* The next character is ASCII and didn't fit */
+            return SDL_ICONV_E2BIG;
+        }
+        left = run;
+        retCode = SDL_iconv_system(cd->cd, inbuf, &left, outbuf, outbytesleft);
+        *inbytesleft = remaining - (run - left);
+        if (retCode == SDL_ICONV_EINVAL && run < remaining) {
+            /* The sequence was only cut short by us, and an ASCII character
+               can't continue it, so it's really an illegal one */
+            return SDL_ICONV_EILSEQ;
+        }
+        if (retCode >= SDL_ICONV_EINVAL) {
+            return retCode;
+        }
+        total += retCode;
+    }
+    return total;
+}
+
+#else
+
+struct _SDL_iconv_t
+{
+    int src_fmt;
+    int dst_fmt;
+};
+
 static const char *
 getlocale(char *buffer, size_t bufsize)
 {
@@ -238,31 +731,11 @@ SDL_iconv_open(const char *tocode, const char *fromcode)
     return (SDL_iconv_t) - 1;
 }
 
-size_t
-SDL_iconv(SDL_iconv_t cd,
-          const char **inbuf, size_t * inbytesleft,
-          char **outbuf, size_t * outbytesleft)
+/* Picks the byte order for source formats that need a byte order marker */
+static int
+getsourceformat(int src_fmt, const char *src, size_t srclen)
 {
-    /* For simplicity, we'll convert everything to and from UCS-4 */
-    const char *src;
-    char *dst;
-    size_t srclen, dstlen;
-    Uint32 ch = 0;
-    size_t total;
-
-    if (!inbuf || !*inbuf) {
-        /* Reset the context */
-        return 0;
-    }
-    if (!outbuf || !*outbuf || !outbytesleft || !*outbytesleft) {
-        return SDL_ICONV_E2BIG;
-    }
-    src = *inbuf;
-    srclen = (inbytesleft ? *inbytesleft : 0);
-    dst = *outbuf;
-    dstlen = *outbytesleft;
-
-    switch (cd->src_fmt) {
+    switch (src_fmt) {
     case ENCODING_UTF16:
         /* Scan for a byte order marker */
         {
@@ -270,21 +743,16 @@ SDL_iconv(SDL_iconv_t cd,
             size_t n = srclen / 2;
             while (n) {
                 if (p[0] == 0xFF && p[1] == 0xFE) {
-                    cd->src_fmt = ENCODING_UTF16BE;
-                    break;
+                    return ENCODING_UTF16BE;
                 } else if (p[0] == 0xFE && p[1] == 0xFF) {
-                    cd->src_fmt = ENCODING_UTF16LE;
-                    break;
+                    return ENCODING_UTF16LE;
                 }
                 p += 2;
                 --n;
             }
-            if (n == 0) {
-                /* We can't tell, default to host order */
-                cd->src_fmt = ENCODING_UTF16NATIVE;
-            }
+            /* We can't tell, default to host order */
+            return ENCODING_UTF16NATIVE;
         }
-        break;
     case ENCODING_UTF32:
         /* Scan for a byte order marker */
         {
@@ -293,283 +761,350 @@ SDL_iconv(SDL_iconv_t cd,
             while (n) {
                 if (p[0] == 0xFF && p[1] == 0xFE &&
                     p[2] == 0x00 && p[3] == 0x00) {
-                    cd->src_fmt = ENCODING_UTF32BE;
-                    break;
+                    return ENCODING_UTF32BE;
                 } else if (p[0] == 0x00 && p[1] == 0x00 &&
                            p[2] == 0xFE && p[3] == 0xFF) {
-                    cd->src_fmt = ENCODING_UTF32LE;
-                    break;
+                    return ENCODING_UTF32LE;
                 }
                 p += 4;
                 --n;
             }
-            if (n == 0) {
-                /* We can't tell, default to host order */
-                cd->src_fmt = ENCODING_UTF32NATIVE;
-            }
+            /* We can't tell, default to host order */
+            return ENCODING_UTF32NATIVE;
         }
-        break;
+    default:
+        return src_fmt;
     }
+}
 
-    switch (cd->dst_fmt) {
-    case ENCODING_UTF16:
-        /* Default to host order, need to add byte order marker */
-        if (dstlen < 2) {
-            return SDL_ICONV_E2BIG;
+/* Decodes the character at the start of the input and steps past it, or
+   returns SDL_ICONV_EINVAL without moving if the input ends part way through.
+ */
+static size_t
+SDL_iconv_decode(int src_fmt, const char **inbuf, size_t *inbytesleft, Uint32 *character)
+{
+    const char *src = *inbuf;
+    size_t srclen = *inbytesleft;
+    Uint32 ch = 0;
+
+    switch (src_fmt) {
+    case ENCODING_ASCII:
+        {
+            Uint8 *p = (Uint8 *) src;
+            ch = (Uint32) (p[0] & 0x7F);
+            ++src;
+            --srclen;
         }
-        *(Uint16 *) dst = UNICODE_BOM;
-        dst += 2;
-        dstlen -= 2;
-        cd->dst_fmt = ENCODING_UTF16NATIVE;
         break;
-    case ENCODING_UTF32:
-        /* Default to host order, need to add byte order marker */
-        if (dstlen < 4) {
-            return SDL_ICONV_E2BIG;
+    case ENCODING_LATIN1:
+        {
+            Uint8 *p = (Uint8 *) src;
+            ch = (Uint32) p[0];
+            ++src;
+            --srclen;
         }
-        *(Uint32 *) dst = UNICODE_BOM;
-        dst += 4;
-        dstlen -= 4;
-        cd->dst_fmt = ENCODING_UTF32NATIVE;
         break;
-    }
-
-    total = 0;
-    while (srclen > 0) {
-        /* Decode a character */
-        switch (cd->src_fmt) {
-        case ENCODING_ASCII:
-            {
-                Uint8 *p = (Uint8 *) src;
-                ch = (Uint32) (p[0] & 0x7F);
-                ++src;
-                --srclen;
-            }
-            break;
-        case ENCODING_LATIN1:
-            {
-                Uint8 *p = (Uint8 *) src;
-                ch = (Uint32) p[0];
-                ++src;
-                --srclen;
-            }
-            break;
-        case ENCODING_UTF8:    /* RFC 3629 */
-            {
-                Uint8 *p = (Uint8 *) src;
-                size_t left = 0;
-                SDL_bool overlong = SDL_FALSE;
-                if (p[0] >= 0xF0) {
-                    if ((p[0] & 0xF8) != 0xF0) {
-                        /* Skip illegal sequences
-                           return SDL_ICONV_EILSEQ;
-                         */
-                        ch = UNKNOWN_UNICODE;
-                    } else {
-                        if (p[0] == 0xF0 && srclen > 1 && (p[1] & 0xF0) == 0x80) {
-                            overlong = SDL_TRUE;
-                        }
-                        ch = (Uint32) (p[0] & 0x07);
-                        left = 3;
-                    }
-                } else if (p[0] >= 0xE0) {
-                    if ((p[0] & 0xF0) != 0xE0) {
-                        /* Skip illegal sequences
-                           return SDL_ICONV_EILSEQ;
-                         */
-                        ch = UNKNOWN_UNICODE;
-                    } else {
-                        if (p[0] == 0xE0 && srclen > 1 && (p[1] & 0xE0) == 0x80) {
-                            overlong = SDL_TRUE;
-                        }
-                        ch = (Uint32) (p[0] & 0x0F);
-                        left = 2;
-                    }
-                } else if (p[0] >= 0xC0) {
-                    if ((p[0] & 0xE0) != 0xC0) {
-                        /* Skip illegal sequences
-                           return SDL_ICONV_EILSEQ;
-                         */
-                        ch = UNKNOWN_UNICODE;
-                    } else {
-                        if ((p[0] & 0xDE) == 0xC0) {
-                            overlong = SDL_TRUE;
-                        }
-                        ch = (Uint32) (p[0] & 0x1F);
-                        left = 1;
-                    }
-                } else {
-                    if ((p[0] & 0x80) != 0x00) {
-                        /* Skip illegal sequences
-                           return SDL_ICONV_EILSEQ;
-                         */
-                        ch = UNKNOWN_UNICODE;
-                    } else {
-                        ch = (Uint32) p[0];
-                    }
-                }
-                ++src;
-                --srclen;
-                if (srclen < left) {
-                    return SDL_ICONV_EINVAL;
-                }
-                while (left--) {
-                    ++p;
-                    if ((p[0] & 0xC0) != 0x80) {
-                        /* Skip illegal sequences
-                           return SDL_ICONV_EILSEQ;
-                         */
-                        ch = UNKNOWN_UNICODE;
-                        break;
-                    }
-                    ch <<= 6;
-                    ch |= (p[0] & 0x3F);
-                    ++src;
-                    --srclen;
-                }
-                if (overlong) {
-                    /* Potential security risk
-                       return SDL_ICONV_EILSEQ;
-                     */
-                    ch = UNKNOWN_UNICODE;
-                }
-                if ((ch >= 0xD800 && ch <= 0xDFFF) ||
-                    (ch == 0xFFFE || ch == 0xFFFF) || ch > 0x10FFFF) {
+    case ENCODING_UTF8:    /* RFC 3629 */
+        {
+            Uint8 *p = (Uint8 *) src;
+            size_t left = 0;
+            SDL_bool overlong = SDL_FALSE;
+            if (p[0] >= 0xF0) {
+                if ((p[0] & 0xF8) != 0xF0) {
                     /* Skip illegal sequences
                        return SDL_ICONV_EILSEQ;
                      */
                     ch = UNKNOWN_UNICODE;
+                } else {
+                    if (p[0] == 0xF0 && srclen > 1 && (p[1] & 0xF0) == 0x80) {
+                        overlong = SDL_TRUE;
+                    }
+                    ch = (Uint32) (p[0] & 0x07);
+                    left = 3;
                 }
-            }
-            break;
-        case ENCODING_UTF16BE: /* RFC 2781 */
-            {
-                Uint8 *p = (Uint8 *) src;
-                Uint16 W1, W2;
-                if (srclen < 2) {
-                    return SDL_ICONV_EINVAL;
-                }
-                W1 = ((Uint16) p[0] << 8) | (Uint16) p[1];
-                src += 2;
-                srclen -= 2;
-                if (W1 < 0xD800 || W1 > 0xDFFF) {
-                    ch = (Uint32) W1;
-                    break;
-                }
-                if (W1 > 0xDBFF) {
+            } else if (p[0] >= 0xE0) {
+                if ((p[0] & 0xF0) != 0xE0) {
                     /* Skip illegal sequences
                        return SDL_ICONV_EILSEQ;
                      */
                     ch = UNKNOWN_UNICODE;
-                    break;
-                }
-                if (srclen < 2) {
-                    return SDL_ICONV_EINVAL;
+                } else {
+                    if (p[0] == 0xE0 && srclen > 1 && (p[1] & 0xE0) == 0x80) {
+                        overlong = SDL_TRUE;
+                    }
+                    ch = (Uint32) (p[0] & 0x0F);
+                    left = 2;
                 }
-                p = (Uint8 *) src;
-                W2 = ((Uint16) p[0] << 8) | (Uint16) p[1];
-                src += 2;
-                srclen -= 2;
-                if (W2 < 0xDC00 || W2 > 0xDFFF) {
+            } else if (p[0] >= 0xC0) {
+                if ((p[0] & 0xE0) != 0xC0) {
                     /* Skip illegal sequences
                        return SDL_ICONV_EILSEQ;
                      */
                     ch = UNKNOWN_UNICODE;
-                    break;
-                }
-                ch = (((Uint32) (W1 & 0x3FF) << 10) |
-                      (Uint32) (W2 & 0x3FF)) + 0x10000;
-            }
-            break;
-        case ENCODING_UTF16LE: /* RFC 2781 */
-            {
-                Uint8 *p = (Uint8 *) src;
-                Uint16 W1, W2;
-                if (srclen < 2) {
-                    return SDL_ICONV_EINVAL;
-                }
-                W1 = ((Uint16) p[1] << 8) | (Uint16) p[0];
-                src += 2;
-                srclen -= 2;
-                if (W1 < 0xD800 || W1 > 0xDFFF) {
-                    ch = (Uint32) W1;
-                    break;
+                } else {
+                    if ((p[0] & 0xDE) == 0xC0) {
+                        overlong = SDL_TRUE;
+                    }
+                    ch = (Uint32) (p[0] & 0x1F);
+                    left = 1;
                 }
-                if (W1 > 0xDBFF) {
+            } else {
+                if ((p[0] & 0x80) != 0x00) {
                     /* Skip illegal sequences
                        return SDL_ICONV_EILSEQ;
                      */
                     ch = UNKNOWN_UNICODE;
-                    break;
-                }
-                if (srclen < 2) {
-                    return SDL_ICONV_EINVAL;
+                } else {
+                    ch = (Uint32) p[0];
                 }
-                p = (Uint8 *) src;
-                W2 = ((Uint16) p[1] << 8) | (Uint16) p[0];
-                src += 2;
-                srclen -= 2;
-                if (W2 < 0xDC00 || W2 > 0xDFFF) {
+            }
+            ++src;
+            --srclen;
+            if (srclen < left) {
+                return SDL_ICONV_EINVAL;
+            }
+            while (left--) {
+                ++p;
+                if ((p[0] & 0xC0) != 0x80) {
                     /* Skip illegal sequences
                        return SDL_ICONV_EILSEQ;
                      */
                     ch = UNKNOWN_UNICODE;
                     break;
                 }
-                ch = (((Uint32) (W1 & 0x3FF) << 10) |
-                      (Uint32) (W2 & 0x3FF)) + 0x10000;
+                ch <<= 6;
+                ch |= (p[0] & 0x3F);
+                ++src;
+                --srclen;
             }
-            break;
-        case ENCODING_UCS2LE:
-            {
-                Uint8 *p = (Uint8 *) src;
-                if (srclen < 2) {
-                    return SDL_ICONV_EINVAL;
-                }
-                ch = ((Uint32) p[1] << 8) | (Uint32) p[0];
-                src += 2;
-                srclen -= 2;
+            if (overlong) {
+                /* Potential security risk
+                   return SDL_ICONV_EILSEQ;
+                 */
+                ch = UNKNOWN_UNICODE;
             }
-            break;
-        case ENCODING_UCS2BE:
-            {
-                Uint8 *p = (Uint8 *) src;
-                if (srclen < 2) {
-                    return SDL_ICONV_EINVAL;
-                }
-                ch = ((Uint32) p[0] << 8) | (Uint32) p[1];
-                src += 2;
-                srclen -= 2;
+            if ((ch >= 0xD800 && ch <= 0xDFFF) ||
+                (ch == 0xFFFE || ch == 0xFFFF) || ch > 0x10FFFF) {
+                /* Skip illegal sequences
+                   return SDL_ICONV_EILSEQ;
+                 */
+                ch = UNKNOWN_UNICODE;
             }
-            break;
-        case ENCODING_UCS4BE:
-        case ENCODING_UTF32BE:
-            {
-                Uint8 *p = (Uint8 *) src;
-                if (srclen < 4) {
-                    return SDL_ICONV_EINVAL;
-                }
-                ch = ((Uint32) p[0] << 24) |
-                    ((Uint32) p[1] << 16) |
-                    ((Uint32) p[2] << 8) | (Uint32) p[3];
-                src += 4;
-                srclen -= 4;
+        }
+        break;
+    case ENCODING_UTF16BE: /* RFC 2781 */
+        {
+            Uint8 *p = (Uint8 *) src;
+            Uint16 W1, W2;
+            if (srclen < 2) {
+                return SDL_ICONV_EINVAL;
             }
-            break;
-        case ENCODING_UCS4LE:
-        case ENCODING_UTF32LE:
-            {
-                Uint8 *p = (Uint8 *) src;
-                if (srclen < 4) {
-                    return SDL_ICONV_EINVAL;
-                }
-                ch = ((Uint32) p[3] << 24) |
-                    ((Uint32) p[2] << 16) |
-                    ((Uint32) p[1] << 8) | (Uint32) p[0];
-                src += 4;
-                srclen -= 4;
+            W1 = ((Uint16) p[0] << 8) | (Uint16) p[1];
+            src += 2;
+            srclen -= 2;
+            if (W1 < 0xD800 || W1 > 0xDFFF) {
+                ch = (Uint32) W1;
+                break;
             }
-            break;
+            if (W1 > 0xDBFF) {
+                /* Skip illegal sequences
+                   return SDL_ICONV_EILSEQ;
+                 */
+                ch = UNKNOWN_UNICODE;
+                break;
+            }
+            if (srclen < 2) {
+                return SDL_ICONV_EINVAL;
+            }
+            p = (Uint8 *) src;
+            W2 = ((Uint16) p[0] << 8) | (Uint16) p[1];
+            src += 2;
+            srclen -= 2;
+            if (W2 < 0xDC00 || W2 > 0xDFFF) {
+                /* Skip illegal sequences
+                   return SDL_ICONV_EILSEQ;
+                 */
+                ch = UNKNOWN_UNICODE;
+                break;
+            }
+            ch = (((Uint32) (W1 & 0x3FF) << 10) |
+                  (Uint32) (W2 & 0x3FF)) + 0x10000;
+        }
+        break;
+    case ENCODING_UTF16LE: /* RFC 2781 */
+        {
+            Uint8 *p = (Uint8 *) src;
+            Uint16 W1, W2;
+            if (srclen < 2) {
+                return SDL_ICONV_EINVAL;
+            }
+            W1 = ((Uint16) p[1] << 8) | (Uint16) p[0];
+            src += 2;
+            srclen -= 2;
+            if (W1 < 0xD800 || W1 > 0xDFFF) {
+                ch = (Uint32) W1;
+                break;
+            }
+            if (W1 > 0xDBFF) {
+                /* Skip illegal sequences
+                   return SDL_ICONV_EILSEQ;
+                 */
+                ch = UNKNOWN_UNICODE;
+                break;
+            }
+            if (srclen < 2) {
+                return SDL_ICONV_EINVAL;
+            }
+            p = (Uint8 *) src;
+            W2 = ((Uint16) p[1] << 8) | (Uint16) p[0];
+            src += 2;
+            srclen -= 2;
+            if (W2 < 0xDC00 || W2 > 0xDFFF) {
+                /* Skip illegal sequences
+                   return SDL_ICONV_EILSEQ;
+                 */
+                ch = UNKNOWN_UNICODE;
+                break;
+            }
+            ch = (((Uint32) (W1 & 0x3FF) << 10) |
+                  (Uint32) (W2 & 0x3FF)) + 0x10000;
+        }
+        break;
+    case ENCODING_UCS2LE:
+        {
+            Uint8 *p = (Uint8 *) src;
+            if (srclen < 2) {
+                return SDL_ICONV_EINVAL;
+            }
+            ch = ((Uint32) p[1] << 8) | (Uint32) p[0];
+            src += 2;
+            srclen -= 2;
+        }
+        break;
+    case ENCODING_UCS2BE:
+        {
+            Uint8 *p = (Uint8 *) src;
+            if (srclen < 2) {
+                return SDL_ICONV_EINVAL;
+            }
+            ch = ((Uint32) p[0] << 8) | (Uint32) p[1];
+            src += 2;
+            srclen -= 2;
+        }
+        break;
+    case ENCODING_UCS4BE:
+    case ENCODING_UTF32BE:
+        {
+            Uint8 *p = (Uint8 *) src;
+            if (srclen < 4) {
+                return SDL_ICONV_EINVAL;
+            }
+            ch = ((Uint32) p[0] << 24) |
+                ((Uint32) p[1] << 16) |
+                ((Uint32) p[2] << 8) | (Uint32) p[3];
+            src += 4;
+            srclen -= 4;
+        }
+        break;
+    case ENCODING_UCS4LE:
+    case ENCODING_UTF32LE:
+        {
+            Uint8 *p = (Uint8 *) src;
+            if (srclen < 4) {
+                return SDL_ICONV_EINVAL;
+            }
+            ch = ((Uint32) p[3] << 24) |
+                ((Uint32) p[2] << 16) |
+                ((Uint32) p[1] << 8) | (Uint32) p[0];
+            src += 4;
+            srclen -= 4;
+        }
+        break;
+    }
+
+    *inbuf = src;
+    *inbytesleft = srclen;
+    *character = ch;
+    return 0;
+}
+
+size_t
+SDL_iconv(SDL_iconv_t cd,
+          const char **inbuf, size_t * inbytesleft,
+          char **outbuf, size_t * outbytesleft)
+{
+    /* For simplicity, we'll convert everything to and from UCS-4 */
+    const char *src;
+    char *dst;
+    size_t srclen, dstlen;
+    Uint32 ch = 0;
+    size_t total, retCode;
+    int src_layout, dst_layout;
+
+    if (!inbuf || !*inbuf) {
+        /* Reset the context */
+        return 0;
+    }
+    if (!outbuf || !*outbuf || !outbytesleft || !*outbytesleft) {
+        return SDL_ICONV_E2BIG;
+    }
+    src = *inbuf;
+    srclen = (inbytesleft ? *inbytesleft : 0);
+    dst = *outbuf;
+    dstlen = *outbytesleft;
+
+    cd->src_fmt = getsourceformat(cd->src_fmt, src, srclen);
+
+    switch (cd->dst_fmt) {
+    case ENCODING_UTF16:
+        /* Default to host order, need to add byte order marker */
+        if (dstlen < 2) {
+            return SDL_ICONV_E2BIG;
+        }
+        *(Uint16 *) dst = UNICODE_BOM;
+        dst += 2;
+        dstlen -= 2;
+        cd->dst_fmt = ENCODING_UTF16NATIVE;
+        break;
+    case ENCODING_UTF32:
+        /* Default to host order, need to add byte order marker */
+        if (dstlen < 4) {
+            return SDL_ICONV_E2BIG;
+        }
+        *(Uint32 *) dst = UNICODE_BOM;
+        dst += 4;
+        dstlen -= 4;
+        cd->dst_fmt = ENCODING_UTF32NATIVE;
+        break;
+    }
+
+    src_layout = getlayout(cd->src_fmt);
+    dst_layout = getlayout(cd->dst_fmt);
+
+    total = 0;
+    while (srclen > 0) {
+        /* Most text is largely ASCII, so convert runs of it in bulk */
+        if (src_layout != LAYOUT_NONE && dst_layout != LAYOUT_NONE) {
+            const size_t count = SDL_iconv_ascii((const Uint8 *)src, srclen, src_layout,
+                                                 (Uint8 *)dst, dstlen, dst_layout);
+            if (count > 0) {
+                src += count * getunitsize(src_layout);
+                srclen -= count * getunitsize(src_layout);
+                dst += count * getunitsize(dst_layout);
+                dstlen -= count * getunitsize(dst_layout);
+                *inbuf = src;
+                *inbytesleft = srclen;
+                *outbuf = dst;
+                *outbytesleft = dstlen;
+                total += count;
+                continue;
+            }
+        }
+
+        /* Decode a character */
+        retCode = SDL_iconv_decode(cd->src_fmt, &src, &srclen, &ch);
+        if (retCode != 0) {
+            return retCode;
         }
 
         /* Encode a character */
@@ -804,6 +1339,65 @@ SDL_iconv_close(SDL_iconv_t cd)
     return 0;
 }
 
+/* Returns the number of bytes a character takes up in the output */
+static size_t
+getencodedsize(int dst_fmt, Uint32 ch)
+{
+    switch (dst_fmt) {
+    case ENCODING_ASCII:
+    case ENCODING_LATIN1:
+        return 1;
+    case ENCODING_UTF8:
+        if (ch <= 0x7F) {
+            return 1;
+        } else if (ch <= 0x7FF) {
+            return 2;
+        } else if (ch <= 0xFFFF || ch > 0x10FFFF) {
+            return 3;
+        }
+        return 4;
+    case ENCODING_UTF16BE:
+    case ENCODING_UTF16LE:
+        return (ch >= 0x10000 && ch <= 0x10FFFF) ? 4 : 2;
+    case ENCODING_UCS2BE:
+    case ENCODING_UCS2LE:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+/* Returns the exact number of bytes SDL_iconv_string() will produce, so it
+   can allocate once. This only decodes the input, nothing is written.
+ */
+static size_t
+SDL_iconv_size(SDL_iconv_t cd, const char *inbuf, size_t inbytesleft)
+{
+    const int src_fmt = getsourceformat(cd->src_fmt, inbuf, inbytesleft);
+    int dst_fmt = cd->dst_fmt;
+    size_t size = 0;
+    Uint32 ch;
+
+    switch (dst_fmt) {
+    case ENCODING_UTF16:
+        size += 2;
+        dst_fmt = ENCODING_UTF16NATIVE;
+        break;
+    case ENCODING_UTF32:
+        size += 4;
+        dst_fmt = ENCODING_UTF32NATIVE;
+        break;
+    }
+
+    while (inbytesleft > 0) {
+        if (SDL_iconv_decode(src_fmt, &inbuf, &inbytesleft, &ch) != 0) {
+            break;
+        }
+        size += getencodedsize(dst_fmt, ch);
+    }
+    return size;
+}
+
 #endif /* !HAVE_ICONV */
 
 char *
@@ -832,7 +1426,16 @@ SDL_iconv_string(const char *tocode, const char *fromcode, const char *inbuf,
         return NULL;
     }
 
+#if defined(HAVE_ICONV) && defined(HAVE_ICONV_H)
     stringsize = inbytesleft > 4 ? inbytesleft : 4;
+#else
+    /* Leave room for a terminator, in case the input doesn't include one.
+       Never go below the input size, some callers count on the output being
+       at least that big, which was always the case before.
+     */
+    stringsize = SDL_iconv_size(cd, inbuf, inbytesleft) + 4;
+    stringsize = SDL_max(stringsize, inbytesleft);
+#endif
     string = (char *) SDL_malloc(stringsize);
     if (!string) {
         SDL_iconv_close(cd);
@@ -877,6 +1480,7 @@ SDL_iconv_string(const char *tocode, const char *fromcode, const char *inbuf,
             break;
         }
     }
+    SDL_memset(outbuf, 0, SDL_min(outbytesleft, 4));
     SDL_iconv_close(cd);
 
     return string;
@@ -28,6 +28,14 @@
 #include <string.h>
 #include <time.h>
 
+#if defined(__LINUX__) || defined(__MACOSX__) || defined(__FREEBSD__) || defined(__NETBSD__) || defined(__OPENBSD__)
+#define SDLTEST_HAVE_WORKER_PROCESSES 1
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+
 /* Invalid test name/description message format */
 #define SDLTEST_INVALID_NAME_FORMAT "(Invalid)"
 
@@ -40,6 +48,20 @@
 /* ! \brief Timeout for single test case execution */
 static Uint32 SDLTest_TestCaseTimeout = 3600;
 
+/* Environment variable set for worker processes started by SDLTest_RunSuitesParallel() */
+#define SDLTEST_WORKER_ENV "SDLTEST_HARNESS_WORKER"
+
+/* Benchmark settings */
+static int SDLTest_BenchmarksEnabled = 0;
+static int SDLTest_BenchmarkWarmupIterations = 3;
+static int SDLTest_BenchmarkTimedIterations = 25;
+static char *SDLTest_BenchmarkFile = NULL;
+static int SDLTest_BenchmarkFormat = SDLTEST_BENCHMARK_OUTPUT_NONE;
+
+/* Names of the suite and test that are currently running, used to tag benchmark results */
+static const char *SDLTest_CurrentSuiteName = NULL;
+static const char *SDLTest_CurrentTestName = NULL;
+
 /**
 * Generates a random run seed string for the harness. The generated seed
 * will contain alphanumeric characters (0-9A-Z).
@@ -246,6 +268,15 @@ SDLTest_RunTest(SDLTest_TestSuiteReference *testSuite, const SDLTest_TestCaseRef
         return TEST_RESULT_SKIPPED;
     }
 
+    if (testCase->enabled == TEST_BENCHMARK && !SDLTest_BenchmarksEnabled && forceTestRun == SDL_FALSE)
+    {
+        SDLTest_Log(SDLTEST_FINAL_RESULT_FORMAT, "Test", testCase->name, "Skipped (Benchmark)");
+        return TEST_RESULT_SKIPPED;
+    }
+
+    SDLTest_CurrentSuiteName = testSuite->name;
+    SDLTest_CurrentTestName = testCase->name;
+
     /* Initialize fuzzer */
     SDLTest_FuzzerInit(execKey);
 
@@ -287,6 +318,9 @@ SDLTest_RunTest(SDLTest_TestSuiteReference *testSuite, const SDLTest_TestCaseRef
         testSuite->testTearDown(0x0);
     }
 
+    SDLTest_CurrentSuiteName = NULL;
+    SDLTest_CurrentTestName = NULL;
+
     /* Cancel timeout timer */
     if (timer) {
         SDL_RemoveTimer(timer);
@@ -353,6 +387,218 @@ static float GetClock()
     return currentClock;
 }
 
+/**
+* \brief Enable or disable benchmark test cases and set how benchmarks are timed.
+*
+* \param enabled Non-zero to run test cases marked as TEST_BENCHMARK.
+* \param warmupIterations Number of untimed iterations run before timing starts.
+* \param timedIterations Number of timed iterations the statistics are computed from.
+*/
+void
+SDLTest_SetBenchmarkOptions(int enabled, int warmupIterations, int timedIterations)
+{
+    SDLTest_BenchmarksEnabled = enabled;
+    if (warmupIterations >= 0) {
+        SDLTest_BenchmarkWarmupIterations = warmupIterations;
+    }
+    if (timedIterations > 0) {
+        SDLTest_BenchmarkTimedIterations = timedIterations;
+    }
+}
+
+/**
+* \brief Write benchmark results to a file in a machine-readable format.
+*
+* \param file Path of the output file, or NULL to disable output.
+* \param format One of the SDLTEST_BENCHMARK_OUTPUT_* values.
+*
+* \returns 0 on success, -1 if the file couldn't be created.
+*/
+int
+SDLTest_SetBenchmarkOutput(const char *file, int format)
+{
+    SDL_free(SDLTest_BenchmarkFile);
+    SDLTest_BenchmarkFile = NULL;
+    SDLTest_BenchmarkFormat = SDLTEST_BENCHMARK_OUTPUT_NONE;
+
+    if (file == NULL || file[0] == '\0' ||
+        (format != SDLTEST_BENCHMARK_OUTPUT_CSV && format != SDLTEST_BENCHMARK_OUTPUT_JSON)) {
+        return 0;
+    }
+
+    /* Workers append to the file their parent process created */
+    if (SDL_getenv(SDLTEST_WORKER_ENV) == NULL) {
+        SDL_RWops *rw = SDL_RWFromFile(file, "wb");
+        if (rw == NULL) {
+            SDLTest_LogError("Unable to create benchmark output file '%s': %s", file, SDL_GetError());
+            return -1;
+        }
+        if (format == SDLTEST_BENCHMARK_OUTPUT_CSV) {
+            static const char header[] = "suite,test,benchmark,iterations,min_ns,median_ns,p99_ns,mean_ns,items_per_sec\n";
+            SDL_RWwrite(rw, header, 1, sizeof(header) - 1);
+        }
+        SDL_RWclose(rw);
+    }
+
+    SDLTest_BenchmarkFile = SDL_strdup(file);
+    if (SDLTest_BenchmarkFile == NULL) {
+        SDL_Error(SDL_ENOMEM);
+        return -1;
+    }
+    SDLTest_BenchmarkFormat = format;
+    return 0;
+}
+
+/* Appends a string to a CSV or JSON record, quoted as required by the format, or verbatim for SDLTEST_BENCHMARK_OUTPUT_NONE */
+static size_t
+SDLTest_AppendToRecord(char *buffer, size_t length, size_t pos, const char *str, int format)
+{
+    const char *escape = (format == SDLTEST_BENCHMARK_OUTPUT_JSON) ? "\\\"" : "\"";
+    const SDL_bool quoted = (format != SDLTEST_BENCHMARK_OUTPUT_NONE);
+
+    if (pos >= length) {
+        return length - 1;
+    }
+    if (str == NULL) {
+        str = SDLTEST_INVALID_NAME_FORMAT;
+    }
+
+    /* Always leave room for the closing quote and the terminator */
+    if (quoted && pos + 2 < length) {
+        buffer[pos++] = '"';
+    }
+    for (; *str && pos + 3 < length; ++str) {
+        if (quoted && SDL_strchr(escape, *str)) {
+            buffer[pos++] = (format == SDLTEST_BENCHMARK_OUTPUT_JSON) ? '\\' : '"';
+        }
+        buffer[pos++] = *str;
+    }
+    if (quoted && pos + 1 < length) {
+        buffer[pos++] = '"';
+    }
+    buffer[pos] = '\0';
+    return pos;
+}
+
+static void
+SDLTest_WriteBenchmarkRecord(const char *name, int iterations, double minNs, double medianNs, double p99Ns, double meanNs, double itemsPerSecond)
+{
+    const int format = SDLTest_BenchmarkFormat;
+    char record[1024];
+    size_t pos = 0;
+    SDL_RWops *rw;
+
+    if (SDLTest_BenchmarkFile == NULL) {
+        return;
+    }
+
+    if (format == SDLTEST_BENCHMARK_OUTPUT_JSON) {
+        pos = SDLTest_AppendToRecord(record, sizeof(record), pos, "{\"suite\":", SDLTEST_BENCHMARK_OUTPUT_NONE);
+        pos = SDLTest_AppendToRecord(record, sizeof(record), pos, SDLTest_CurrentSuiteName, format);
+        pos = SDLTest_AppendToRecord(record, sizeof(record), pos, ",\"test\":", SDLTEST_BENCHMARK_OUTPUT_NONE);
+        pos = SDLTest_AppendToRecord(record, sizeof(record), pos, SDLTest_CurrentTestName, format);
+        pos = SDLTest_AppendToRecord(record, sizeof(record), pos, ",\"benchmark\":", SDLTEST_BENCHMARK_OUTPUT_NONE);
+        pos = SDLTest_AppendToRecord(record, sizeof(record), pos, name, format);
+        SDL_snprintf(record + pos, sizeof(record) - pos,
+                     ",\"iterations\":%d,\"min_ns\":%.1f,\"median_ns\":%.1f,\"p99_ns\":%.1f,\"mean_ns\":%.1f,\"items_per_sec\":%.1f}\n",
+                     iterations, minNs, medianNs, p99Ns, meanNs, itemsPerSecond);
+    } else {
+        pos = SDLTest_AppendToRecord(record, sizeof(record), pos, SDLTest_CurrentSuiteName, format);
+        pos = SDLTest_AppendToRecord(record, sizeof(record), pos, ",", SDLTEST_BENCHMARK_OUTPUT_NONE);
+        pos = SDLTest_AppendToRecord(record, sizeof(record), pos, SDLTest_CurrentTestName, format);
+        pos = SDLTest_AppendToRecord(record, sizeof(record), pos, ",", SDLTEST_BENCHMARK_OUTPUT_NONE);
+        pos = SDLTest_AppendToRecord(record, sizeof(record), pos, name, format);
+        SDL_snprintf(record + pos, sizeof(record) - pos, ",%d,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+                     iterations, minNs, medianNs, p99Ns, meanNs, itemsPerSecond);
+    }
+
+    /* Open and close the file for every record, so parallel workers never interleave partial lines */
+    rw = SDL_RWFromFile(SDLTest_BenchmarkFile, "ab");
+    if (rw == NULL) {
+        SDLTest_LogError("Unable to open benchmark output file '%s': %s", SDLTest_BenchmarkFile, SDL_GetError());
+        return;
+    }
+    SDL_RWwrite(rw, record, 1, SDL_strlen(record));
+    SDL_RWclose(rw);
+}
+
+static int SDLCALL
+SDLTest_CompareTicks(const void *a, const void *b)
+{
+    const Uint64 lhs = *(const Uint64 *)a;
+    const Uint64 rhs = *(const Uint64 *)b;
+    return (lhs < rhs) ? -1 : (lhs > rhs) ? 1 : 0;
+}
+
+/**
+* \brief Time a benchmark body and report min/median/p99 of the timed iterations.
+*
+* \param name Name of the benchmark within the current test case.
+* \param func Function to time.
+* \param arg Argument passed to func.
+* \param itemsPerIteration Units of work done by one call to func, or 0.
+*
+* \returns 0 on success, -1 on failure.
+*/
+int
+SDLTest_Benchmark(const char *name, SDLTest_BenchmarkFp func, void *arg, Uint64 itemsPerIteration)
+{
+    const int iterations = SDLTest_BenchmarkTimedIterations;
+    const double nsPerTick = 1000000000.0 / (double)SDL_GetPerformanceFrequency();
+    Uint64 *ticks;
+    Uint64 totalTicks = 0;
+    double minNs, medianNs, p99Ns, meanNs;
+    double itemsPerSecond = 0.0;
+    int i;
+
+    if (name == NULL || func == NULL) {
+        SDLTest_LogError("Benchmark name and function can't be NULL");
+        return -1;
+    }
+
+    ticks = (Uint64 *)SDL_malloc(iterations * sizeof(*ticks));
+    if (ticks == NULL) {
+        SDLTest_LogError("Unable to allocate benchmark timings");
+        SDL_Error(SDL_ENOMEM);
+        return -1;
+    }
+
+    for (i = 0; i < SDLTest_BenchmarkWarmupIterations; ++i) {
+        func(arg);
+    }
+
+    for (i = 0; i < iterations; ++i) {
+        const Uint64 start = SDL_GetPerformanceCounter();
+        func(arg);
+        ticks[i] = SDL_GetPerformanceCounter() - start;
+        totalTicks += ticks[i];
+    }
+
+    SDL_qsort(ticks, iterations, sizeof(*ticks), SDLTest_CompareTicks);
+    minNs = ticks[0] * nsPerTick;
+    if (iterations % 2) {
+        medianNs = ticks[iterations / 2] * nsPerTick;
+    } else {
+        medianNs = ((ticks[iterations / 2 - 1] + ticks[iterations / 2]) / 2.0) * nsPerTick;
+    }
+    /* Nearest-rank percentile */
+    p99Ns = ticks[((iterations * 99) + 99) / 100 - 1] * nsPerTick;
+    meanNs = ((double)totalTicks / iterations) * nsPerTick;
+    SDL_free(ticks);
+
+    if (itemsPerIteration > 0 && medianNs > 0.0) {
+        itemsPerSecond = (double)itemsPerIteration * 1000000000.0 / medianNs;
+        SDLTest_Log("Benchmark '%s': %d iterations, min %.3f us, median %.3f us, p99 %.3f us, %.2f M items/sec",
+                    name, iterations, minNs / 1000.0, medianNs / 1000.0, p99Ns / 1000.0, itemsPerSecond / 1000000.0);
+    } else {
+        SDLTest_Log("Benchmark '%s': %d iterations, min %.3f us, median %.3f us, p99 %.3f us",
+                    name, iterations, minNs / 1000.0, medianNs / 1000.0, p99Ns / 1000.0);
+    }
+
+    SDLTest_WriteBenchmarkRecord(name, iterations, minNs, medianNs, p99Ns, meanNs, itemsPerSecond);
+    return 0;
+}
+
 /**
 * \brief Execute a test suite using the given run seed and execution key.
 *
@@ -695,4 +941,196 @@ int SDLTest_RunSuites(SDLTest_TestSuiteReference *testSuites[], const char *user
     return runResult;
 }
 
+/**
+* \brief Execute each test suite in a separate worker process.
+*
+* \param testSuites Suites to run.
+* \param userRunSeed Custom run seed provided by user, or NULL to autogenerate one.
+* \param numWorkers Maximum number of worker processes running at the same time.
+* \param workerArgv NULL-terminated command line used to start a worker.
+*
+* \returns Test run result; 0 when all suites passed, 1 if any suite failed, -1 if not supported.
+*/
+int SDLTest_RunSuitesParallel(SDLTest_TestSuiteReference *testSuites[], const char *userRunSeed, int numWorkers, char *workerArgv[])
+{
+#ifdef SDLTEST_HAVE_WORKER_PROCESSES
+    int suiteCounter;
+    int numSuites = 0;
+    int workerArgc = 0;
+    int runningWorkers = 0;
+    int passedSuites = 0;
+    int failedSuites = 0;
+    int skippedSuites = 0;
+    int runResult;
+    const char *runSeed;
+    char *generatedSeed = NULL;
+    char **argv;
+    pid_t *workers;
+    SDL_bool *failed;
+    float runStartSeconds;
+    float runtime;
+
+    if (workerArgv == NULL || workerArgv[0] == NULL) {
+        SDLTest_LogError("Worker command line can't be empty");
+        return -1;
+    }
+
+    if (numWorkers < 1) {
+        numWorkers = 1;
+    }
+
+    while (testSuites[numSuites]) {
+        numSuites++;
+    }
+    while (workerArgv[workerArgc]) {
+        workerArgc++;
+    }
+
+    if (numSuites == 0) {
+        SDLTest_LogError("No tests to run?");
+        return -1;
+    }
+
+    /* All workers share a run seed, so a failure can be reproduced in a single process */
+    if (userRunSeed == NULL || userRunSeed[0] == '\0') {
+        generatedSeed = SDLTest_GenerateRunSeed(16);
+        if (generatedSeed == NULL) {
+            SDLTest_LogError("Generating a random seed failed");
+            return 2;
+        }
+        runSeed = generatedSeed;
+    } else {
+        runSeed = userRunSeed;
+    }
+
+    argv = (char **)SDL_calloc(workerArgc + 5, sizeof(*argv));
+    workers = (pid_t *)SDL_calloc(numSuites, sizeof(*workers));
+    failed = (SDL_bool *)SDL_calloc(numSuites, sizeof(*failed));
+    if (argv == NULL || workers == NULL || failed == NULL) {
+        SDLTest_LogError("Unable to allocate worker state");
+        SDL_Error(SDL_ENOMEM);
+        SDL_free(argv);
+        SDL_free(workers);
+        SDL_free(failed);
+        SDL_free(generatedSeed);
+        return 2;
+    }
+    SDL_memcpy(argv, workerArgv, workerArgc * sizeof(*argv));
+    argv[workerArgc + 0] = (char *)"--seed";
+    argv[workerArgc + 1] = (char *)runSeed;
+    argv[workerArgc + 2] = (char *)"--filter";
+
+    /* Let the workers know they're not the process that owns the run */
+    SDL_setenv(SDLTEST_WORKER_ENV, "1", 1);
+
+    runStartSeconds = GetClock();
+    SDLTest_Log("::::: Parallel Test Run /w seed '%s' started, %d workers\n", runSeed, numWorkers);
+
+    suiteCounter = 0;
+    while (suiteCounter < numSuites || runningWorkers > 0) {
+        /* Start as many workers as we're allowed to */
+        while (suiteCounter < numSuites && runningWorkers < numWorkers) {
+            SDLTest_TestSuiteReference *testSuite = testSuites[suiteCounter];
+            pid_t pid;
+
+            suiteCounter++;
+            if (testSuite->name == NULL) {
+                SDLTest_LogError("===== Test Suite %i has no name and can't run in a worker, skipped\n", suiteCounter);
+                skippedSuites++;
+                continue;
+            }
+
+            argv[workerArgc + 3] = (char *)testSuite->name;
+            pid = fork();
+            if (pid == 0) {
+                execvp(argv[0], argv);
+                _exit(127);
+            }
+            if (pid < 0) {
+                SDLTest_LogError("===== Test Suite %i: '%s' couldn't start a worker: %s\n", suiteCounter, testSuite->name, strerror(errno));
+                failed[suiteCounter - 1] = SDL_TRUE;
+                failedSuites++;
+                continue;
+            }
+            workers[suiteCounter - 1] = pid;
+            runningWorkers++;
+            SDLTest_Log("===== Test Suite %i: '%s' started in worker %d\n", suiteCounter, testSuite->name, (int)pid);
+        }
+
+        /* Wait for any worker to finish */
+        if (runningWorkers > 0) {
+            int status = 0;
+            int exitCode;
+            int i;
+            pid_t pid = waitpid(-1, &status, 0);
+
+            if (pid < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                SDLTest_LogError("Waiting for workers failed: %s", strerror(errno));
+                break;
+            }
+
+            for (i = 0; i < numSuites; ++i) {
+                if (workers[i] == pid) {
+                    break;
+                }
+            }
+            if (i == numSuites) {
+                continue;
+            }
+            workers[i] = 0;
+            runningWorkers--;
+
+            exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+            if (exitCode == 0) {
+                passedSuites++;
+                SDLTest_Log(SDLTEST_FINAL_RESULT_FORMAT, "Suite", testSuites[i]->name, "Passed");
+            } else {
+                failed[i] = SDL_TRUE;
+                failedSuites++;
+                SDLTest_LogError("Worker for suite '%s' exited with %d", testSuites[i]->name, exitCode);
+                SDLTest_LogError(SDLTEST_FINAL_RESULT_FORMAT, "Suite", testSuites[i]->name, "Failed");
+            }
+        }
+    }
+
+    /* Take time - run end */
+    runtime = GetClock() - runStartSeconds;
+    if (runtime < 0.0f) runtime = 0.0f;
+    SDLTest_Log("Total Run runtime: %.1f sec", runtime);
+
+    /* Suites left over because waiting failed count as failures */
+    failedSuites += runningWorkers;
+    if (failedSuites == 0) {
+        runResult = 0;
+        SDLTest_Log(SDLTEST_LOG_SUMMARY_FORMAT, "Parallel Run", numSuites, passedSuites, failedSuites, skippedSuites);
+        SDLTest_Log(SDLTEST_FINAL_RESULT_FORMAT, "Run /w seed", runSeed, "Passed");
+    } else {
+        runResult = 1;
+        SDLTest_LogError(SDLTEST_LOG_SUMMARY_FORMAT, "Parallel Run", numSuites, passedSuites, failedSuites, skippedSuites);
+        SDLTest_LogError(SDLTEST_FINAL_RESULT_FORMAT, "Run /w seed", runSeed, "Failed");
+
+        SDLTest_Log("Harness input to repro failures:");
+        for (suiteCounter = 0; suiteCounter < numSuites; suiteCounter++) {
+            if (failed[suiteCounter] || workers[suiteCounter]) {
+                SDLTest_Log(" --seed %s --filter %s", runSeed, testSuites[suiteCounter]->name);
+            }
+        }
+    }
+
+    SDL_free(argv);
+    SDL_free(workers);
+    SDL_free(failed);
+    SDL_free(generatedSeed);
+
+    SDLTest_Log("Exit code: %d", runResult);
+    return runResult;
+#else
+    SDLTest_LogError("Running test suites in worker processes isn't supported on this platform");
+    return -1;
+#endif /* SDLTEST_HAVE_WORKER_PROCESSES */
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
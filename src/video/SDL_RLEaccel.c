@@ -85,6 +85,16 @@
  *
  *   The end of the sequence is marked by a zero <skip>,<run> pair at the
  *   beginning of an opaque line.
+ *
+ * Row index:
+ *
+ *   The segment stream is preceded by a table of 32-bit byte offsets into
+ *   the stream, so that clipped blits can start at any source line without
+ *   decoding the lines above it. Colorkeyed surfaces have one offset per
+ *   line, placed at the very beginning of the data. Surfaces with per-pixel
+ *   alpha have two offsets per line (the opaque and the translucent part),
+ *   placed right after the RLEDestFormat. Lines that were dropped as
+ *   trailing blank lines point at the end marker.
  */
 
 #include "SDL_video.h"
@@ -92,8 +102,74 @@
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 
+#if defined(__SSE2__)
+#  define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#if defined(__ARM_NEON)
+#  define HAVE_NEON_INTRINSICS 1
+#endif
+
+/*
+ * Copy a run of n pixels. Most runs are short, so for 16 and 32 bit pixels
+ * we move them inline, 16 bytes at a time where SIMD is available, rather
+ * than paying for a call to memcpy.
+ */
+static SDL_INLINE void
+RLECopyRun(Uint8 * dst, const Uint8 * src, unsigned n, int bpp)
+{
+    size_t len = (size_t)n * bpp;
+
+    if (bpp != 2 && bpp != 4) {
+        SDL_memcpy(dst, src, len);
+        return;
+    }
+
+#if defined(HAVE_SSE2_INTRINSICS)
+    if (len >= 16) {
+        /* the last, possibly overlapping, vector takes care of the tail */
+        Uint8 *dst_last = dst + len - 16;
+        const Uint8 *src_last = src + len - 16;
+        while (dst < dst_last) {
+            _mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+            dst += 16;
+            src += 16;
+        }
+        _mm_storeu_si128((__m128i *)dst_last, _mm_loadu_si128((const __m128i *)src_last));
+        return;
+    }
+#elif defined(HAVE_NEON_INTRINSICS)
+    if (len >= 16) {
+        /* the last, possibly overlapping, vector takes care of the tail */
+        Uint8 *dst_last = dst + len - 16;
+        const Uint8 *src_last = src + len - 16;
+        while (dst < dst_last) {
+            vst1q_u8(dst, vld1q_u8(src));
+            dst += 16;
+            src += 16;
+        }
+        vst1q_u8(dst_last, vld1q_u8(src_last));
+        return;
+    }
+#endif
+
+    if (bpp == 4) {
+        Uint32 *d = (Uint32 *)dst;
+        const Uint32 *s = (const Uint32 *)src;
+        while (n--) {
+            *d++ = *s++;
+        }
+    } else {
+        Uint16 *d = (Uint16 *)dst;
+        const Uint16 *s = (const Uint16 *)src;
+        while (n--) {
+            *d++ = *s++;
+        }
+    }
+}
+
 #define PIXEL_COPY(to, from, len, bpp)          \
-    SDL_memcpy(to, from, (size_t)(len) * (bpp))
+    RLECopyRun((Uint8 *)(to), (const Uint8 *)(from), (unsigned)(len), bpp)
 
 /*
  * Various colorkey blit methods, for opaque and per-surface alpha
@@ -382,57 +458,47 @@
 
 /*
  * This takes care of the case when the surface is clipped on the left and/or
- * right. Top clipping has already been taken care of.
+ * right. Each line is started from the row index, and decoding stops as soon
+ * as the right border is reached.
  */
 static void
-RLEClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
+RLEClipBlit(const Uint32 * rows, Uint8 * stream, SDL_Surface * surf_dst,
             Uint8 * dstbuf, SDL_Rect * srcrect, unsigned alpha)
 {
     SDL_PixelFormat *fmt = surf_dst->format;
 
 #define RLECLIPBLIT(bpp, Type, do_blit)                         \
     do {                                                        \
+        const Uint32 *row = rows + srcrect->y;                  \
         int linecount = srcrect->h;                             \
-        int ofs = 0;                                            \
         int left = srcrect->x;                                  \
         int right = left + srcrect->w;                          \
         dstbuf -= left * bpp;                                   \
-        for (;;) {                                              \
-            int run;                                            \
-            ofs += *(Type *)srcbuf;                             \
-            run = ((Type *)srcbuf)[1];                          \
-            srcbuf += 2 * sizeof(Type);                         \
-            if (run) {                                          \
-                /* clip to left and right borders */            \
-                if (ofs < right) {                              \
-                    int start = 0;                              \
-                    int len = run;                              \
-                    int startcol;                               \
-                    if (left - ofs > 0) {                       \
-                        start = left - ofs;                     \
-                        len -= start;                           \
-                        if (len <= 0)                           \
-                            goto nocopy ## bpp ## do_blit;      \
-                    }                                           \
-                    startcol = ofs + start;                     \
+        do {                                                    \
+            Uint8 *srcbuf = stream + *row++;                    \
+            int ofs = 0;                                        \
+            do {                                                \
+                int run;                                        \
+                ofs += *(Type *)srcbuf;                         \
+                run = ((Type *)srcbuf)[1];                      \
+                srcbuf += 2 * sizeof(Type);                     \
+                if (run) {                                      \
+                    /* clip to left and right borders */        \
+                    int start = ofs < left ? left - ofs : 0;    \
+                    int len = run - start;                      \
+                    int startcol = ofs + start;                 \
                     if (len > right - startcol)                 \
                         len = right - startcol;                 \
-                    do_blit(dstbuf + startcol * bpp, srcbuf + start * bpp, \
-                        len, bpp, alpha);                       \
-                }                                               \
-    nocopy ## bpp ## do_blit:                                   \
-                srcbuf += run * bpp;                            \
-                ofs += run;                                     \
-            } else if (!ofs)                                    \
-                break;                                          \
-                                                                \
-            if (ofs == w) {                                     \
-                ofs = 0;                                        \
-                dstbuf += surf_dst->pitch;                      \
-                if (!--linecount)                               \
-                    break;                                      \
-            }                                                   \
-        }                                                       \
+                    if (len > 0)                                \
+                        do_blit(dstbuf + startcol * bpp,        \
+                                srcbuf + start * bpp, len, bpp, alpha); \
+                    srcbuf += run * bpp;                        \
+                    ofs += run;                                 \
+                } else if (!ofs)                                \
+                    return;                                     \
+            } while (ofs < right);                              \
+            dstbuf += surf_dst->pitch;                          \
+        } while (--linecount);                                  \
     } while(0)
 
     CHOOSE_BLIT(RLECLIPBLIT, alpha, fmt);
@@ -449,6 +515,8 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
 {
     Uint8 *dstbuf;
     Uint8 *srcbuf;
+    const Uint32 *rows;
+    Uint8 *stream;
     int x, y;
     int w = surf_src->w;
     unsigned alpha;
@@ -465,56 +533,16 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     y = dstrect->y;
     dstbuf = (Uint8 *) surf_dst->pixels
         + y * surf_dst->pitch + x * surf_src->format->BytesPerPixel;
-    srcbuf = (Uint8 *) surf_src->map->data;
-
-    {
-        /* skip lines at the top if necessary */
-        int vskip = srcrect->y;
-        int ofs = 0;
-        if (vskip) {
-
-#define RLESKIP(bpp, Type)          \
-        for(;;) {           \
-            int run;            \
-            ofs += *(Type *)srcbuf; \
-            run = ((Type *)srcbuf)[1];  \
-            srcbuf += sizeof(Type) * 2; \
-            if(run) {           \
-            srcbuf += run * bpp;    \
-            ofs += run;     \
-            } else if(!ofs)     \
-            goto done;      \
-            if(ofs == w) {      \
-            ofs = 0;        \
-            if(!--vskip)        \
-                break;      \
-            }               \
-        }
-
-            switch (surf_src->format->BytesPerPixel) {
-            case 1:
-                RLESKIP(1, Uint8);
-                break;
-            case 2:
-                RLESKIP(2, Uint8);
-                break;
-            case 3:
-                RLESKIP(3, Uint8);
-                break;
-            case 4:
-                RLESKIP(4, Uint16);
-                break;
-            }
+    rows = (const Uint32 *) surf_src->map->data;
+    stream = (Uint8 *) (rows + surf_src->h);
 
-#undef RLESKIP
-
-        }
-    }
+    /* start at the first visible line */
+    srcbuf = stream + rows[srcrect->y];
 
     alpha = surf_src->map->info.a;
     /* if left or right edge clipping needed, call clip blit */
     if (srcrect->x || srcrect->w != surf_src->w) {
-        RLEClipBlit(w, srcbuf, surf_dst, dstbuf, srcrect, alpha);
+        RLEClipBlit(rows, stream, surf_dst, dstbuf, srcrect, alpha);
     } else {
         SDL_PixelFormat *fmt = surf_src->format;
 
@@ -547,7 +575,6 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
 #undef RLEBLIT
     }
 
-  done:
     /* Unlock the destination if necessary */
     if (SDL_MUSTLOCK(surf_dst)) {
         SDL_UnlockSurface(surf_dst);
@@ -630,7 +657,7 @@ typedef struct
 
 /* blit a pixel-alpha RLE surface clipped at the right and/or left edges */
 static void
-RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
+RLEAlphaClipBlit(const Uint32 * rows, Uint8 * stream, SDL_Surface * surf_dst,
                  Uint8 * dstbuf, SDL_Rect * srcrect)
 {
     SDL_PixelFormat *df = surf_dst->format;
@@ -641,11 +668,13 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
      */
 #define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend)              \
     do {                                  \
+    const Uint32 *row = rows + 2 * srcrect->y;            \
     int linecount = srcrect->h;                   \
     int left = srcrect->x;                        \
     int right = left + srcrect->w;                    \
     dstbuf -= left * sizeof(Ptype);                   \
     do {                                  \
+        Uint8 *srcbuf = stream + row[0];              \
         int ofs = 0;                          \
         /* blit opaque pixels on one line */              \
         do {                              \
@@ -671,11 +700,9 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
             ofs += run;                       \
         } else if(!ofs)                       \
             return;                       \
-        } while(ofs < w);                         \
-        /* skip padding if necessary */               \
-        if(sizeof(Ptype) == 2)                    \
-        srcbuf += (uintptr_t)srcbuf & 2;              \
+        } while(ofs < right);                         \
         /* blit translucent pixels on the same line */        \
+        srcbuf = stream + row[1];                 \
         ofs = 0;                              \
         do {                              \
         unsigned run;                         \
@@ -702,8 +729,9 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
             srcbuf += run * 4;                    \
             ofs += run;                       \
         }                             \
-        } while(ofs < w);                         \
+        } while(ofs < right);                         \
         dstbuf += surf_dst->pitch;                     \
+        row += 2;                             \
     } while(--linecount);                         \
     } while(0)
 
@@ -728,6 +756,8 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     int x, y;
     int w = surf_src->w;
     Uint8 *srcbuf, *dstbuf;
+    const Uint32 *rows;
+    Uint8 *stream;
     SDL_PixelFormat *df = surf_dst->format;
 
     /* Lock the destination if necessary */
@@ -740,67 +770,15 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     x = dstrect->x;
     y = dstrect->y;
     dstbuf = (Uint8 *) surf_dst->pixels + y * surf_dst->pitch + x * df->BytesPerPixel;
-    srcbuf = (Uint8 *) surf_src->map->data + sizeof(RLEDestFormat);
+    rows = (const Uint32 *) ((Uint8 *) surf_src->map->data + sizeof(RLEDestFormat));
+    stream = (Uint8 *) (rows + 2 * surf_src->h);
 
-    {
-        /* skip lines at the top if necessary */
-        int vskip = srcrect->y;
-        if (vskip) {
-            int ofs;
-            if (df->BytesPerPixel == 2) {
-                /* the 16/32 interleaved format */
-                do {
-                    /* skip opaque line */
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += srcbuf[0];
-                        run = srcbuf[1];
-                        srcbuf += 2;
-                        if (run) {
-                            srcbuf += 2 * run;
-                            ofs += run;
-                        } else if (!ofs)
-                            goto done;
-                    } while (ofs < w);
-
-                    /* skip padding */
-                    srcbuf += (uintptr_t) srcbuf & 2;
-
-                    /* skip translucent line */
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += ((Uint16 *) srcbuf)[0];
-                        run = ((Uint16 *) srcbuf)[1];
-                        srcbuf += 4 * (run + 1);
-                        ofs += run;
-                    } while (ofs < w);
-                } while (--vskip);
-            } else {
-                /* the 32/32 interleaved format */
-                vskip <<= 1;    /* opaque and translucent have same format */
-                do {
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += ((Uint16 *) srcbuf)[0];
-                        run = ((Uint16 *) srcbuf)[1];
-                        srcbuf += 4;
-                        if (run) {
-                            srcbuf += 4 * run;
-                            ofs += run;
-                        } else if (!ofs)
-                            goto done;
-                    } while (ofs < w);
-                } while (--vskip);
-            }
-        }
-    }
+    /* start at the first visible line */
+    srcbuf = stream + rows[2 * srcrect->y];
 
     /* if left or right edge clipping needed, call clip blit */
     if (srcrect->x || srcrect->w != surf_src->w) {
-        RLEAlphaClipBlit(w, srcbuf, surf_dst, dstbuf, srcrect);
+        RLEAlphaClipBlit(rows, stream, surf_dst, dstbuf, srcrect);
     } else {
 
         /*
@@ -1029,7 +1007,8 @@ RLEAlphaSurface(SDL_Surface * surface)
     int max_opaque_run;
     int max_transl_run = 65535;
     unsigned masksum;
-    Uint8 *rlebuf, *dst;
+    Uint8 *rlebuf, *dst, *stream;
+    Uint32 *rows;
     int (*copy_opaque) (void *, Uint32 *, int,
                         SDL_PixelFormat *, SDL_PixelFormat *);
     int (*copy_transl) (void *, Uint32 *, int,
@@ -1088,7 +1067,8 @@ RLEAlphaSurface(SDL_Surface * surface)
         return -1;              /* anything else unsupported right now */
     }
 
-    maxsize += sizeof(RLEDestFormat);
+    /* room for the saved format and the row index */
+    maxsize += sizeof(RLEDestFormat) + 2 * surface->h * sizeof(Uint32);
     rlebuf = (Uint8 *) SDL_malloc(maxsize);
     if (!rlebuf) {
         return SDL_OutOfMemory();
@@ -1110,7 +1090,9 @@ RLEAlphaSurface(SDL_Surface * surface)
         r->Bshift = df->Bshift;
         r->Ashift = df->Ashift;
     }
-    dst = rlebuf + sizeof(RLEDestFormat);
+    rows = (Uint32 *) (rlebuf + sizeof(RLEDestFormat));
+    stream = (Uint8 *) (rows + 2 * surface->h);
+    dst = stream;
 
     /* Do the actual encoding */
     {
@@ -1140,6 +1122,7 @@ RLEAlphaSurface(SDL_Surface * surface)
             int runstart, skipstart;
             int blankline = 0;
             /* First encode all opaque pixels of a scan line */
+            rows[2 * y] = (Uint32) (dst - stream);
             x = 0;
             do {
                 int run, skip, len;
@@ -1175,6 +1158,7 @@ RLEAlphaSurface(SDL_Surface * surface)
             dst += (uintptr_t) dst & 2;
 
             /* Next, encode all translucent pixels of the same scan line */
+            rows[2 * y + 1] = (Uint32) (dst - stream);
             x = 0;
             do {
                 int run, skip, len;
@@ -1211,6 +1195,13 @@ RLEAlphaSurface(SDL_Surface * surface)
         }
         dst = lastline;         /* back up past trailing blank lines */
         ADD_OPAQUE_COUNTS(0, 0);
+
+        /* the dropped lines all start at the end marker */
+        for (y = 0; y < 2 * h; y++) {
+            if (rows[y] > (Uint32) (lastline - stream)) {
+                rows[y] = (Uint32) (lastline - stream);
+            }
+        }
     }
 
 #undef ADD_OPAQUE_COUNTS
@@ -1275,7 +1266,8 @@ static const getpix_func getpixes[4] = {
 static int
 RLEColorkeySurface(SDL_Surface * surface)
 {
-    Uint8 *rlebuf, *dst;
+    Uint8 *rlebuf, *dst, *stream;
+    Uint32 *rows;
     int maxn;
     int y;
     Uint8 *srcbuf, *lastline;
@@ -1308,6 +1300,9 @@ RLEColorkeySurface(SDL_Surface * surface)
         return -1;
     }
 
+    /* room for the row index */
+    maxsize += surface->h * sizeof(Uint32);
+
     rlebuf = (Uint8 *) SDL_malloc(maxsize);
     if (rlebuf == NULL) {
         return SDL_OutOfMemory();
@@ -1316,7 +1311,9 @@ RLEColorkeySurface(SDL_Surface * surface)
     /* Set up the conversion */
     srcbuf = (Uint8 *) surface->pixels;
     maxn = bpp == 4 ? 65535 : 255;
-    dst = rlebuf;
+    rows = (Uint32 *) rlebuf;
+    stream = (Uint8 *) (rows + surface->h);
+    dst = stream;
     rgbmask = ~surface->format->Amask;
     ckey = surface->map->info.colorkey & rgbmask;
     lastline = dst;
@@ -1338,6 +1335,7 @@ RLEColorkeySurface(SDL_Surface * surface)
     for (y = 0; y < h; y++) {
         int x = 0;
         int blankline = 0;
+        rows[y] = (Uint32) (dst - stream);
         do {
             int run, skip, len;
             int runstart;
@@ -1382,6 +1380,13 @@ RLEColorkeySurface(SDL_Surface * surface)
     dst = lastline;             /* back up bast trailing blank lines */
     ADD_COUNTS(0, 0);
 
+    /* the dropped lines all start at the end marker */
+    for (y = 0; y < h; y++) {
+        if (rows[y] > (Uint32) (lastline - stream)) {
+            rows[y] = (Uint32) (lastline - stream);
+        }
+    }
+
 #undef ADD_COUNTS
 
     /* Now that we have it encoded, release the original pixels */
@@ -1505,7 +1510,7 @@ UnRLEAlpha(SDL_Surface * surface)
     SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
 
     dst = surface->pixels;
-    srcbuf = (Uint8 *) (df + 1);
+    srcbuf = (Uint8 *) (df + 1) + 2 * surface->h * sizeof(Uint32);
     for (;;) {
         /* copy opaque pixels */
         int ofs = 0;
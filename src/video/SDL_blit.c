@@ -21,6 +21,7 @@
 #include "../SDL_internal.h"
 
 #include "SDL_video.h"
+#include "SDL_hints.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_blit_auto.h"
@@ -28,6 +29,35 @@
 #include "SDL_blit_slow.h"
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
+#include "../SDL_parallel_c.h"
+
+/* Conversions smaller than this many pixels aren't worth waking threads for */
+#define SDL_CONVERT_PARALLEL_MIN_PIXELS (512 * 512)
+
+/* Bands handed out per thread, so threads that start late still get work */
+#define SDL_CONVERT_BANDS_PER_THREAD    4
+
+static void
+SDL_SetupBlitInfo(SDL_BlitInfo * info, SDL_Surface * src, SDL_Rect * srcrect,
+                  SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    info->src = (Uint8 *) src->pixels +
+        (Uint16) srcrect->y * src->pitch +
+        (Uint16) srcrect->x * info->src_fmt->BytesPerPixel;
+    info->src_w = srcrect->w;
+    info->src_h = srcrect->h;
+    info->src_pitch = src->pitch;
+    info->src_skip =
+        info->src_pitch - info->src_w * info->src_fmt->BytesPerPixel;
+    info->dst =
+        (Uint8 *) dst->pixels + (Uint16) dstrect->y * dst->pitch +
+        (Uint16) dstrect->x * info->dst_fmt->BytesPerPixel;
+    info->dst_w = dstrect->w;
+    info->dst_h = dstrect->h;
+    info->dst_pitch = dst->pitch;
+    info->dst_skip =
+        info->dst_pitch - info->dst_w * info->dst_fmt->BytesPerPixel;
+}
 
 /* The general purpose software blit routine */
 static int SDLCALL
@@ -66,22 +96,7 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
         SDL_BlitInfo *info = &src->map->info;
 
         /* Set up the blit information */
-        info->src = (Uint8 *) src->pixels +
-            (Uint16) srcrect->y * src->pitch +
-            (Uint16) srcrect->x * info->src_fmt->BytesPerPixel;
-        info->src_w = srcrect->w;
-        info->src_h = srcrect->h;
-        info->src_pitch = src->pitch;
-        info->src_skip =
-            info->src_pitch - info->src_w * info->src_fmt->BytesPerPixel;
-        info->dst =
-            (Uint8 *) dst->pixels + (Uint16) dstrect->y * dst->pitch +
-            (Uint16) dstrect->x * info->dst_fmt->BytesPerPixel;
-        info->dst_w = dstrect->w;
-        info->dst_h = dstrect->h;
-        info->dst_pitch = dst->pitch;
-        info->dst_skip =
-            info->dst_pitch - info->dst_w * info->dst_fmt->BytesPerPixel;
+        SDL_SetupBlitInfo(info, src, srcrect, dst, dstrect);
         RunBlit = (SDL_BlitFunc) src->map->data;
 
         /* Run the actual software blit */
@@ -99,6 +114,88 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
     return (okay ? 0 : -1);
 }
 
+/*
+ * Split a conversion of width x height pixels into bands of rows for
+ * SDL_ParallelFor(), as SDL_HINT_SURFACE_CONVERT_THREADS asks. Every band
+ * but the last is a multiple of 'align' rows high. Returns the number of
+ * bands, which is 1 when the conversion should run on the calling thread.
+ */
+int
+SDL_GetConvertBands(int width, int height, int align, int *threads, int *rows)
+{
+    int count;
+
+    *threads = 1;
+    *rows = height;
+    if ((Sint64) width * height < SDL_CONVERT_PARALLEL_MIN_PIXELS) {
+        return 1;
+    }
+    *threads = SDL_GetParallelThreadsHint(SDL_HINT_SURFACE_CONVERT_THREADS);
+    if (*threads <= 1) {
+        return 1;
+    }
+
+    count = *threads * SDL_CONVERT_BANDS_PER_THREAD;
+    *rows = (height + count - 1) / count;
+    *rows = ((*rows + align - 1) / align) * align;
+    return (height + *rows - 1) / *rows;
+}
+
+typedef struct
+{
+    SDL_BlitFunc RunBlit;
+    const SDL_BlitInfo *info;
+    int rows;
+} SDL_BlitBands;
+
+static void
+SDL_BlitBand(void *data, int index)
+{
+    const SDL_BlitBands *bands = (const SDL_BlitBands *) data;
+    SDL_BlitInfo info = *bands->info;
+    const int y = index * bands->rows;
+
+    info.src += y * info.src_pitch;
+    info.dst += y * info.dst_pitch;
+    info.src_h = SDL_min(bands->rows, info.src_h - y);
+    info.dst_h = info.src_h;
+    bands->RunBlit(&info);
+}
+
+/*
+ * Run an unscaled blit the way the blit map would, but with large blits
+ * split into bands of rows that are blitted on several threads. Each band
+ * gets its own copy of the blit information, since SDL_SoftBlit() keeps
+ * it in the map.
+ */
+int
+SDL_SoftBlitBands(SDL_Surface * src, SDL_Rect * srcrect,
+                  SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    SDL_BlitMap *map = src->map;
+    SDL_BlitBands bands;
+    SDL_BlitInfo info;
+    int threads, count;
+
+    if (map->blit != SDL_SoftBlit || map->serial ||
+        SDL_MUSTLOCK(src) || SDL_MUSTLOCK(dst) ||
+        srcrect->w != dstrect->w || srcrect->h != dstrect->h) {
+        return map->blit(src, srcrect, dst, dstrect);
+    }
+
+    count = SDL_GetConvertBands(srcrect->w, srcrect->h, 1, &threads, &bands.rows);
+    if (count <= 1) {
+        return map->blit(src, srcrect, dst, dstrect);
+    }
+
+    info = map->info;
+    SDL_SetupBlitInfo(&info, src, srcrect, dst, dstrect);
+    bands.RunBlit = (SDL_BlitFunc) map->data;
+    bands.info = &info;
+    SDL_ParallelFor(count, threads, SDL_BlitBand, &bands);
+    return 0;
+}
+
 #if SDL_HAVE_BLIT_AUTO
 
 #ifdef __MACOSX__
@@ -213,6 +310,7 @@ SDL_CalculateBlit(SDL_Surface * surface)
 #endif
 
     map->blit = SDL_SoftBlit;
+    map->serial = SDL_FALSE;
     map->info.src_fmt = surface->format;
     map->info.src_pitch = surface->pitch;
     map->info.dst_fmt = dst->format;
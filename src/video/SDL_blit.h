@@ -99,6 +99,10 @@ struct SDL_BlitMap
     void *data;
     SDL_BlitInfo info;
 
+    /* the blit carries state from one row to the next, so it can't be
+       split into bands of rows */
+    SDL_bool serial;
+
     /* the version count matches the destination; mismatch indicates
        an invalid mapping */
     Uint32 dst_palette_version;
@@ -107,6 +111,9 @@ struct SDL_BlitMap
 
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface * surface);
+extern int SDL_GetConvertBands(int width, int height, int align, int *threads, int *rows);
+extern int SDL_SoftBlitBands(SDL_Surface * src, SDL_Rect * srcrect,
+                             SDL_Surface * dst, SDL_Rect * dstrect);
 
 /* Functions found in SDL_blit_*.c */
 extern SDL_BlitFunc SDL_CalculateBlit0(SDL_Surface * surface);
@@ -114,6 +121,9 @@ extern SDL_BlitFunc SDL_CalculateBlit1(SDL_Surface * surface);
 extern SDL_BlitFunc SDL_CalculateBlitN(SDL_Surface * surface);
 extern SDL_BlitFunc SDL_CalculateBlitA(SDL_Surface * surface);
 
+/* Whether SDL_SoftStretchLinear() can scale this format directly */
+extern SDL_bool SDL_IsLinearStretchFormat(Uint32 format);
+
 /*
  * Useful macros for blitting routines
  */
@@ -126,6 +136,13 @@ extern SDL_BlitFunc SDL_CalculateBlitA(SDL_Surface * surface);
 #define DECLARE_ALIGNED(t,v,a)  t v
 #endif
 
+/* Blits from RGB formats to a palette look the destination pixel up in the
+   blit map's table, an inverse color map indexed by the top 5 bits of each
+   channel. Without a table, the destination has the 3-3-2 palette from
+   SDL_DitherColors() and is indexed directly. */
+#define RGB555_INDEX(r, g, b)   ((((r) >> 3) << 10) | (((g) >> 3) << 5) | ((b) >> 3))
+#define RGB332_INDEX(r, g, b)   ((((r) >> 5) << (3 + 2)) | (((g) >> 5) << 2) | ((b) >> 6))
+
 /* Load pixel of the specified format from a buffer and get its R-G-B values */
 #define RGB_FROM_PIXEL(Pixel, fmt, r, g, b)                             \
 {                                                                       \
@@ -60,9 +60,9 @@ BlitNto1SurfaceAlpha(SDL_BlitInfo * info)
         dB &= 0xff;
         /* Pack RGB into 8bit pixel */
         if ( palmap == NULL ) {
-            *dst =((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0));
+            *dst = RGB332_INDEX(dR, dG, dB);
         } else {
-            *dst = palmap[((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0))];
+            *dst = palmap[RGB555_INDEX(dR, dG, dB)];
         }
         dst++;
         src += srcbpp;
@@ -106,9 +106,9 @@ BlitNto1PixelAlpha(SDL_BlitInfo * info)
         dB &= 0xff;
         /* Pack RGB into 8bit pixel */
         if ( palmap == NULL ) {
-            *dst =((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0));
+            *dst = RGB332_INDEX(dR, dG, dB);
         } else {
-            *dst = palmap[((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0))];
+            *dst = palmap[RGB555_INDEX(dR, dG, dB)];
         }
         dst++;
         src += srcbpp;
@@ -155,9 +155,9 @@ BlitNto1SurfaceAlphaKey(SDL_BlitInfo * info)
             dB &= 0xff;
             /* Pack RGB into 8bit pixel */
             if ( palmap == NULL ) {
-                *dst =((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0));
+                *dst = RGB332_INDEX(dR, dG, dB);
             } else {
-                *dst = palmap[((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0))];
+                *dst = palmap[RGB555_INDEX(dR, dG, dB)];
             }
         }
         dst++;
@@ -25,6 +25,7 @@
 #include "SDL_video.h"
 #include "SDL_endian.h"
 #include "SDL_cpuinfo.h"
+#include "SDL_hints.h"
 #include "SDL_blit.h"
 
 
@@ -984,6 +985,12 @@ Blit_RGB444_RGB888ARMSIMD(SDL_BlitInfo * info)
                   (((src)&0x0000E000)>>11)| \
                   (((src)&0x000000C0)>>6)); \
 }
+/* RGB 8-8-8 --> inverse color map index, see RGB555_INDEX() */
+#define RGB888_INDEX(dst, src) { \
+    dst = (int)((((src)&0x00F80000)>>9)| \
+                (((src)&0x0000F800)>>6)| \
+                (((src)&0x000000F8)>>3)); \
+}
 static void
 Blit_RGB888_index8(SDL_BlitInfo * info)
 {
@@ -1046,7 +1053,7 @@ Blit_RGB888_index8(SDL_BlitInfo * info)
 #ifdef USE_DUFFS_LOOP
             /* *INDENT-OFF* */ /* clang-format off */
             DUFFS_LOOP(
-                RGB888_RGB332(Pixel, *src);
+                RGB888_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             , width);
@@ -1054,30 +1061,30 @@ Blit_RGB888_index8(SDL_BlitInfo * info)
 #else
             for (c = width / 4; c; --c) {
                 /* Pack RGB into 8bit pixel */
-                RGB888_RGB332(Pixel, *src);
+                RGB888_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
-                RGB888_RGB332(Pixel, *src);
+                RGB888_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
-                RGB888_RGB332(Pixel, *src);
+                RGB888_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
-                RGB888_RGB332(Pixel, *src);
+                RGB888_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             }
             switch (width & 3) {
             case 3:
-                RGB888_RGB332(Pixel, *src);
+                RGB888_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             case 2:
-                RGB888_RGB332(Pixel, *src);
+                RGB888_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             case 1:
-                RGB888_RGB332(Pixel, *src);
+                RGB888_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             }
@@ -1094,6 +1101,12 @@ Blit_RGB888_index8(SDL_BlitInfo * info)
                   (((src)&0x000E0000)>>15)| \
                   (((src)&0x00000300)>>8)); \
 }
+/* RGB 10-10-10 --> inverse color map index, see RGB555_INDEX() */
+#define RGB101010_INDEX(dst, src) { \
+    dst = (int)((((src)&0x3E000000)>>15)| \
+                (((src)&0x000F8000)>>10)| \
+                (((src)&0x000003E0)>>5)); \
+}
 static void
 Blit_RGB101010_index8(SDL_BlitInfo * info)
 {
@@ -1156,7 +1169,7 @@ Blit_RGB101010_index8(SDL_BlitInfo * info)
 #ifdef USE_DUFFS_LOOP
             /* *INDENT-OFF* */ /* clang-format off */
             DUFFS_LOOP(
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             , width);
@@ -1164,30 +1177,30 @@ Blit_RGB101010_index8(SDL_BlitInfo * info)
 #else
             for (c = width / 4; c; --c) {
                 /* Pack RGB into 8bit pixel */
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             }
             switch (width & 3) {
             case 3:
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             case 2:
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             case 1:
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             }
@@ -2170,9 +2183,7 @@ BlitNto1(SDL_BlitInfo * info)
                                 sR, sG, sB);
                 if ( 1 ) {
                     /* Pack RGB into 8bit pixel */
-                    *dst = map[((sR>>5)<<(3+2))|
-                           ((sG>>5)<<(2))  |
-                           ((sB>>6)<<(0))  ];
+                    *dst = map[RGB555_INDEX(sR, sG, sB)];
                 }
                 dst++;
                 src += srcbpp;
@@ -2183,8 +2194,7 @@ BlitNto1(SDL_BlitInfo * info)
                 DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel, sR, sG, sB);
                 if (1) {
                     /* Pack RGB into 8bit pixel */
-                    *dst = map[((sR >> 5) << (3 + 2)) |
-                               ((sG >> 5) << (2)) | ((sB >> 6) << (0))];
+                    *dst = map[RGB555_INDEX(sR, sG, sB)];
                 }
                 dst++;
                 src += srcbpp;
@@ -2196,6 +2206,85 @@ BlitNto1(SDL_BlitInfo * info)
     }
 }
 
+/* N->1 with Floyd-Steinberg error diffusion, see SDL_HINT_SURFACE_DITHER */
+static void
+BlitNto1Dither(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    const Uint8 *map = info->table;
+    SDL_PixelFormat *srcfmt = info->src_fmt;
+    const SDL_Color *colors = info->dst_fmt->palette->colors;
+    int srcbpp = srcfmt->BytesPerPixel;
+    /* Error carried into this row and the next, in 16ths, for each channel
+       of every pixel plus one pixel of padding on either side */
+    const size_t row_errors = 3 * (width + 2);
+    int *errors = (int *) SDL_AllocScratch(2 * row_errors * sizeof(int));
+    int *cur, *next, *tmp;
+    Uint32 Pixel;
+    int sR, sG, sB;
+    int x;
+
+    if (errors == NULL) {
+        BlitNto1(info);
+        return;
+    }
+    cur = errors;
+    next = errors + row_errors;
+    SDL_memset(cur, 0, row_errors * sizeof(int));
+
+    while (height--) {
+        SDL_memset(next, 0, row_errors * sizeof(int));
+        for (x = 0; x < width; ++x) {
+            int *e = &cur[3 * (x + 1)];
+            int *n = &next[3 * (x + 1)];
+            const SDL_Color *c;
+            int r, g, b;
+            Uint8 pixel;
+
+            DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel, sR, sG, sB);
+            r = SDL_clamp(sR + e[0] / 16, 0, 255);
+            g = SDL_clamp(sG + e[1] / 16, 0, 255);
+            b = SDL_clamp(sB + e[2] / 16, 0, 255);
+            if (map) {
+                pixel = map[RGB555_INDEX(r, g, b)];
+            } else {
+                pixel = (Uint8)RGB332_INDEX(r, g, b);
+            }
+            *dst++ = pixel;
+
+            /* 7/16 of the error goes right, 3/16, 5/16 and 1/16 to the row below */
+            c = &colors[pixel];
+            r -= c->r;
+            g -= c->g;
+            b -= c->b;
+            e[3] += r * 7;
+            e[4] += g * 7;
+            e[5] += b * 7;
+            n[-3] += r * 3;
+            n[-2] += g * 3;
+            n[-1] += b * 3;
+            n[0] += r * 5;
+            n[1] += g * 5;
+            n[2] += b * 5;
+            n[3] += r;
+            n[4] += g;
+            n[5] += b;
+            src += srcbpp;
+        }
+        tmp = cur;
+        cur = next;
+        next = tmp;
+        src += srcskip;
+        dst += dstskip;
+    }
+    SDL_FreeScratch(errors);
+}
+
 /* blits 32 bit RGB<->RGBA with both surfaces having the same R,G,B fields */
 static void
 Blit4to4MaskAlpha(SDL_BlitInfo * info)
@@ -2582,9 +2671,7 @@ BlitNto1Key(SDL_BlitInfo * info)
                                 sR, sG, sB);
                 if ( (Pixel & rgbmask) != ckey ) {
                     /* Pack RGB into 8bit pixel */
-                    *dst = (Uint8)palmap[((sR>>5)<<(3+2))|
-                                         ((sG>>5)<<(2))  |
-                                         ((sB>>6)<<(0))  ];
+                    *dst = palmap[RGB555_INDEX(sR, sG, sB)];
                 }
                 dst++;
                 src += srcbpp;
@@ -3248,6 +3335,422 @@ Blit_3or4_to_3or4__inversed_rgb(SDL_BlitInfo * info)
     }
 }
 
+/*
+ * Channel swizzles between 3 and 4 byte formats with 8-bit channels, done
+ * with byte shuffles: pshufb on x86, tbl on AArch64.
+ *
+ * Pixels are handled 16 at a time, so a block is exactly srcbpp vectors in
+ * and dstbpp vectors out. Each byte of an output vector comes from a fixed
+ * byte of the input block, or is a constant: the alpha for SET_ALPHA, or 0
+ * for the unused byte of a format without alpha, as BlitNtoN() writes.
+ */
+#if defined(HAVE_AVX2_INTRINSICS)
+#  define HAVE_SSSE3_BLIT_SHUFFLE 1
+#  define HAVE_AVX2_BLIT_SHUFFLE 1
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#  define HAVE_NEON_BLIT_SHUFFLE 1
+#endif
+
+typedef struct
+{
+    int srcbpp;
+    int dstbpp;
+    int index[4];           /* source byte of each destination byte, or -1 */
+    Uint8 value[4];         /* destination bytes that have no source byte */
+    Uint8 fill[4][16];      /* constant bytes of each output vector in a block */
+    Uint8 pshufb[4][4][16]; /* bytes of output vector j taken from input vector i */
+    Uint8 tbl[4][16];       /* bytes of output vector j taken from the whole block */
+} BlitShuffle;
+
+/* The input vectors that output vector j of a block can take bytes from */
+#define SHUFFLE_FIRST(j, srcbpp, dstbpp)  ((((16 * (j)) / (dstbpp)) * (srcbpp)) / 16)
+#define SHUFFLE_LAST(j, srcbpp, dstbpp)   (((((16 * (j) + 15) / (dstbpp)) + 1) * (srcbpp) - 1) / 16)
+
+/* Byte offset of an 8-bit channel within a pixel, or -1 if it isn't one */
+static int
+GetChannelByte(Uint32 mask, int bpp)
+{
+    int shift;
+
+    for (shift = 0; shift < bpp * 8; shift += 8) {
+        if (mask == ((Uint32)0xFF << shift)) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            return shift / 8;
+#else
+            return bpp - 1 - shift / 8;
+#endif
+        }
+    }
+    return -1;
+}
+
+static SDL_bool
+GetBlitShuffle(const SDL_PixelFormat *srcfmt, const SDL_PixelFormat *dstfmt, Uint8 alpha, BlitShuffle *shuffle)
+{
+    const Uint32 srcmasks[4] = { srcfmt->Rmask, srcfmt->Gmask, srcfmt->Bmask, srcfmt->Amask };
+    const Uint32 dstmasks[4] = { dstfmt->Rmask, dstfmt->Gmask, dstfmt->Bmask, dstfmt->Amask };
+    int srcbpp = srcfmt->BytesPerPixel;
+    int dstbpp = dstfmt->BytesPerPixel;
+    int c, i, j, k;
+
+    if ((srcbpp != 3 && srcbpp != 4) || (dstbpp != 3 && dstbpp != 4)) {
+        return SDL_FALSE;
+    }
+
+    shuffle->srcbpp = srcbpp;
+    shuffle->dstbpp = dstbpp;
+    for (k = 0; k < 4; ++k) {
+        shuffle->index[k] = -1;
+        shuffle->value[k] = 0;
+    }
+    for (c = 0; c < 4; ++c) {
+        int from, to;
+
+        if (dstmasks[c] == 0) {
+            if (c == 3) {
+                break;
+            }
+            return SDL_FALSE;
+        }
+        to = GetChannelByte(dstmasks[c], dstbpp);
+        if (to < 0) {
+            return SDL_FALSE;
+        }
+        if (srcmasks[c] == 0) {
+            /* SET_ALPHA */
+            shuffle->value[to] = alpha;
+            continue;
+        }
+        from = GetChannelByte(srcmasks[c], srcbpp);
+        if (from < 0) {
+            return SDL_FALSE;
+        }
+        shuffle->index[to] = from;
+    }
+
+    for (j = 0; j < dstbpp; ++j) {
+        for (k = 0; k < 16; ++k) {
+            const int d = 16 * j + k;
+            const int b = d % dstbpp;
+            const int s = (shuffle->index[b] < 0) ? -1 : (d / dstbpp) * srcbpp + shuffle->index[b];
+
+            shuffle->fill[j][k] = (s < 0) ? shuffle->value[b] : 0;
+            shuffle->tbl[j][k] = (s < 0) ? 0xFF : (Uint8)s;
+            for (i = 0; i < srcbpp; ++i) {
+                shuffle->pshufb[j][i][k] = (s >= 0 && s / 16 == i) ? (Uint8)(s % 16) : 0x80;
+            }
+        }
+    }
+    return SDL_TRUE;
+}
+
+static void
+BlitShuffleRow(const BlitShuffle *shuffle, const Uint8 *src, Uint8 *dst, int width)
+{
+    const int srcbpp = shuffle->srcbpp;
+    const int dstbpp = shuffle->dstbpp;
+    int k;
+
+    while (width--) {
+        for (k = 0; k < dstbpp; ++k) {
+            dst[k] = (shuffle->index[k] < 0) ? shuffle->value[k] : src[shuffle->index[k]];
+        }
+        src += srcbpp;
+        dst += dstbpp;
+    }
+}
+
+#if defined(HAVE_SSSE3_BLIT_SHUFFLE)
+static int
+hasSSSE3()
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
+    }
+    /* There's no SSSE3 check, but every CPU with SSE4.1 has it */
+    val = SDL_HasSSE41();
+    return val;
+}
+
+/* Called with constant srcbpp and dstbpp, so each pair gets its own loop */
+SDL_FORCE_INLINE void SDL_TARGETING("ssse3")
+BlitShuffleRows_SSSE3(SDL_BlitInfo *info, const BlitShuffle *shuffle, const int srcbpp, const int dstbpp)
+{
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    int height = info->dst_h;
+    __m128i mask[4][4];
+    __m128i fill[4];
+    int i, j;
+
+    for (j = 0; j < dstbpp; ++j) {
+        fill[j] = _mm_loadu_si128((const __m128i *)shuffle->fill[j]);
+        for (i = 0; i < srcbpp; ++i) {
+            mask[j][i] = _mm_loadu_si128((const __m128i *)shuffle->pshufb[j][i]);
+        }
+    }
+
+    while (height--) {
+        int width = info->dst_w;
+
+        for (; width >= 16; width -= 16) {
+            __m128i in[4];
+
+            for (i = 0; i < srcbpp; ++i) {
+                in[i] = _mm_loadu_si128((const __m128i *)(src + 16 * i));
+            }
+            for (j = 0; j < dstbpp; ++j) {
+                __m128i out = fill[j];
+                for (i = SHUFFLE_FIRST(j, srcbpp, dstbpp); i <= SHUFFLE_LAST(j, srcbpp, dstbpp); ++i) {
+                    out = _mm_or_si128(out, _mm_shuffle_epi8(in[i], mask[j][i]));
+                }
+                _mm_storeu_si128((__m128i *)(dst + 16 * j), out);
+            }
+            src += 16 * srcbpp;
+            dst += 16 * dstbpp;
+        }
+        BlitShuffleRow(shuffle, src, dst, width);
+        src += width * srcbpp + info->src_skip;
+        dst += width * dstbpp + info->dst_skip;
+    }
+}
+
+static void SDL_TARGETING("ssse3")
+BlitShuffle_SSSE3(SDL_BlitInfo *info, const BlitShuffle *shuffle)
+{
+    if (shuffle->srcbpp == 4) {
+        if (shuffle->dstbpp == 4) {
+            BlitShuffleRows_SSSE3(info, shuffle, 4, 4);
+        } else {
+            BlitShuffleRows_SSSE3(info, shuffle, 4, 3);
+        }
+    } else {
+        if (shuffle->dstbpp == 4) {
+            BlitShuffleRows_SSSE3(info, shuffle, 3, 4);
+        } else {
+            BlitShuffleRows_SSSE3(info, shuffle, 3, 3);
+        }
+    }
+}
+#endif /* HAVE_SSSE3_BLIT_SHUFFLE */
+
+#if defined(HAVE_AVX2_BLIT_SHUFFLE)
+static int
+hasAVX2()
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
+    }
+    val = SDL_HasAVX2();
+    return val;
+}
+
+/* Two blocks at a time, one in each 128-bit lane, since vpshufb doesn't
+   cross lanes */
+SDL_FORCE_INLINE void SDL_TARGETING("avx2")
+BlitShuffleRows_AVX2(SDL_BlitInfo *info, const BlitShuffle *shuffle, const int srcbpp, const int dstbpp)
+{
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    int height = info->dst_h;
+    __m256i mask[4][4];
+    __m256i fill[4];
+    int i, j;
+
+    for (j = 0; j < dstbpp; ++j) {
+        fill[j] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)shuffle->fill[j]));
+        for (i = 0; i < srcbpp; ++i) {
+            mask[j][i] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)shuffle->pshufb[j][i]));
+        }
+    }
+
+    while (height--) {
+        int width = info->dst_w;
+
+        for (; width >= 32; width -= 32) {
+            __m256i in[4];
+
+            if (srcbpp == 4 && dstbpp == 4) {
+                /* Every block uses the same masks, so lanes can be contiguous */
+                for (i = 0; i < 4; ++i) {
+                    in[i] = _mm256_loadu_si256((const __m256i *)(src + 32 * i));
+                    _mm256_storeu_si256((__m256i *)(dst + 32 * i),
+                                        _mm256_or_si256(fill[0], _mm256_shuffle_epi8(in[i], mask[0][0])));
+                }
+            } else {
+                for (i = 0; i < srcbpp; ++i) {
+                    in[i] = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(src + 16 * i))),
+                                                    _mm_loadu_si128((const __m128i *)(src + 16 * (srcbpp + i))), 1);
+                }
+                for (j = 0; j < dstbpp; ++j) {
+                    __m256i out = fill[j];
+                    for (i = SHUFFLE_FIRST(j, srcbpp, dstbpp); i <= SHUFFLE_LAST(j, srcbpp, dstbpp); ++i) {
+                        out = _mm256_or_si256(out, _mm256_shuffle_epi8(in[i], mask[j][i]));
+                    }
+                    _mm_storeu_si128((__m128i *)(dst + 16 * j), _mm256_castsi256_si128(out));
+                    _mm_storeu_si128((__m128i *)(dst + 16 * (dstbpp + j)), _mm256_extracti128_si256(out, 1));
+                }
+            }
+            src += 32 * srcbpp;
+            dst += 32 * dstbpp;
+        }
+        BlitShuffleRow(shuffle, src, dst, width);
+        src += width * srcbpp + info->src_skip;
+        dst += width * dstbpp + info->dst_skip;
+    }
+}
+
+static void SDL_TARGETING("avx2")
+BlitShuffle_AVX2(SDL_BlitInfo *info, const BlitShuffle *shuffle)
+{
+    if (shuffle->srcbpp == 4) {
+        if (shuffle->dstbpp == 4) {
+            BlitShuffleRows_AVX2(info, shuffle, 4, 4);
+        } else {
+            BlitShuffleRows_AVX2(info, shuffle, 4, 3);
+        }
+    } else {
+        if (shuffle->dstbpp == 4) {
+            BlitShuffleRows_AVX2(info, shuffle, 3, 4);
+        } else {
+            BlitShuffleRows_AVX2(info, shuffle, 3, 3);
+        }
+    }
+}
+#endif /* HAVE_AVX2_BLIT_SHUFFLE */
+
+#if defined(HAVE_NEON_BLIT_SHUFFLE)
+/* tbl looks up all srcbpp vectors of a block at once, and gives 0 for the
+   out of range indices used for constant bytes */
+SDL_FORCE_INLINE void
+BlitShuffleRows_NEON(SDL_BlitInfo *info, const BlitShuffle *shuffle, const int srcbpp, const int dstbpp)
+{
+    const Uint8 *src = info->src;
+    Uint8 *dst = info->dst;
+    int height = info->dst_h;
+    uint8x16_t mask[4];
+    uint8x16_t fill[4];
+    int j;
+
+    for (j = 0; j < dstbpp; ++j) {
+        fill[j] = vld1q_u8(shuffle->fill[j]);
+        mask[j] = vld1q_u8(shuffle->tbl[j]);
+    }
+
+    while (height--) {
+        int width = info->dst_w;
+
+        for (; width >= 16; width -= 16) {
+            if (srcbpp == 4) {
+                uint8x16x4_t in;
+                in.val[0] = vld1q_u8(src);
+                in.val[1] = vld1q_u8(src + 16);
+                in.val[2] = vld1q_u8(src + 32);
+                in.val[3] = vld1q_u8(src + 48);
+                for (j = 0; j < dstbpp; ++j) {
+                    vst1q_u8(dst + 16 * j, vorrq_u8(fill[j], vqtbl4q_u8(in, mask[j])));
+                }
+            } else {
+                uint8x16x3_t in;
+                in.val[0] = vld1q_u8(src);
+                in.val[1] = vld1q_u8(src + 16);
+                in.val[2] = vld1q_u8(src + 32);
+                for (j = 0; j < dstbpp; ++j) {
+                    vst1q_u8(dst + 16 * j, vorrq_u8(fill[j], vqtbl3q_u8(in, mask[j])));
+                }
+            }
+            src += 16 * srcbpp;
+            dst += 16 * dstbpp;
+        }
+        BlitShuffleRow(shuffle, src, dst, width);
+        src += width * srcbpp + info->src_skip;
+        dst += width * dstbpp + info->dst_skip;
+    }
+}
+
+static void
+BlitShuffle_NEON(SDL_BlitInfo *info, const BlitShuffle *shuffle)
+{
+    if (shuffle->srcbpp == 4) {
+        if (shuffle->dstbpp == 4) {
+            BlitShuffleRows_NEON(info, shuffle, 4, 4);
+        } else {
+            BlitShuffleRows_NEON(info, shuffle, 4, 3);
+        }
+    } else {
+        if (shuffle->dstbpp == 4) {
+            BlitShuffleRows_NEON(info, shuffle, 3, 4);
+        } else {
+            BlitShuffleRows_NEON(info, shuffle, 3, 3);
+        }
+    }
+}
+#endif /* HAVE_NEON_BLIT_SHUFFLE */
+
+/* Whether BlitNtoNShuffle() can be used, and has a SIMD kernel to use */
+static SDL_bool
+CanBlitShuffle(const SDL_PixelFormat *srcfmt, const SDL_PixelFormat *dstfmt)
+{
+    BlitShuffle shuffle;
+
+    if (!GetBlitShuffle(srcfmt, dstfmt, 0, &shuffle)) {
+        return SDL_FALSE;
+    }
+#if defined(HAVE_SSSE3_BLIT_SHUFFLE)
+    if (hasSSSE3()) {
+        return SDL_TRUE;
+    }
+#endif
+#if defined(HAVE_NEON_BLIT_SHUFFLE)
+    if (SDL_HasNEON()) {
+        return SDL_TRUE;
+    }
+#endif
+    return SDL_FALSE;
+}
+
+static void
+BlitNtoNShuffle(SDL_BlitInfo * info)
+{
+    BlitShuffle shuffle;
+
+    GetBlitShuffle(info->src_fmt, info->dst_fmt, info->a, &shuffle);
+
+#if defined(HAVE_AVX2_BLIT_SHUFFLE)
+    if (hasAVX2()) {
+        BlitShuffle_AVX2(info, &shuffle);
+        return;
+    }
+#endif
+#if defined(HAVE_SSSE3_BLIT_SHUFFLE)
+    if (hasSSSE3()) {
+        BlitShuffle_SSSE3(info, &shuffle);
+        return;
+    }
+#endif
+#if defined(HAVE_NEON_BLIT_SHUFFLE)
+    if (SDL_HasNEON()) {
+        BlitShuffle_NEON(info, &shuffle);
+        return;
+    }
+#endif
+    {
+        const Uint8 *src = info->src;
+        Uint8 *dst = info->dst;
+        int height = info->dst_h;
+
+        while (height--) {
+            BlitShuffleRow(&shuffle, src, dst, info->dst_w);
+            src += info->dst_w * shuffle.srcbpp + info->src_skip;
+            dst += info->dst_w * shuffle.dstbpp + info->dst_skip;
+        }
+    }
+}
+
 /* Normal N to N optimized blitters */
 #define NO_ALPHA   1
 #define SET_ALPHA  2
@@ -3410,7 +3913,10 @@ SDL_CalculateBlitN(SDL_Surface * surface)
     case 0:
         blitfun = NULL;
         if (dstfmt->BitsPerPixel == 8) {
-            if ((srcfmt->BytesPerPixel == 4) &&
+            if (dstfmt->palette && SDL_GetHintBoolean(SDL_HINT_SURFACE_DITHER, SDL_FALSE)) {
+                blitfun = BlitNto1Dither;
+                surface->map->serial = SDL_TRUE;
+            } else if ((srcfmt->BytesPerPixel == 4) &&
                 (srcfmt->Rmask == 0x00FF0000) &&
                 (srcfmt->Gmask == 0x0000FF00) &&
                 (srcfmt->Bmask == 0x000000FF)) {
@@ -3469,6 +3975,14 @@ SDL_CalculateBlitN(SDL_Surface * surface)
                     blitfun = BlitNtoNCopyAlpha;
                 }
             }
+
+            /* Byte swizzles between 24 and 32-bit formats */
+            if ((blitfun == BlitNtoN || blitfun == BlitNtoNCopyAlpha ||
+                 blitfun == Blit_3or4_to_3or4__same_rgb ||
+                 blitfun == Blit_3or4_to_3or4__inversed_rgb) &&
+                CanBlitShuffle(srcfmt, dstfmt)) {
+                blitfun = BlitNtoNShuffle;
+            }
         }
         return (blitfun);
 
@@ -35,10 +35,22 @@
 #include "SDL_hints.h"
 #include "SDL_video.h"
 #include "SDL_endian.h"
+#include "SDL_cpuinfo.h"
 #include "SDL_pixels_c.h"
 
+#if defined(__SSE2__)
+#  define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#if defined(__ARM_NEON)
+#  define HAVE_NEON_INTRINSICS 1
+#endif
+
 #define SAVE_32BIT_BMP
 
+/* SDL_SaveBMP_RW() converts and writes about this many bytes at a time */
+#define SAVE_BAND_SIZE  (128 * 1024)
+
 /* Compression encodings for BMP files */
 #ifndef BI_RGB
 #define BI_RGB      0
@@ -139,33 +151,148 @@ static SDL_bool readRlePixels(SDL_Surface * surface, SDL_RWops * src, int isRle8
     }
 }
 
+/* Swap (len) bytes between the rows at (a) and (b), which don't overlap */
+static void SwapRows(Uint8 *a, Uint8 *b, size_t len)
+{
+#if defined(HAVE_SSE2_INTRINSICS)
+    while (len >= 16) {
+        const __m128i rowa = _mm_loadu_si128((const __m128i *)a);
+        const __m128i rowb = _mm_loadu_si128((const __m128i *)b);
+        _mm_storeu_si128((__m128i *)a, rowb);
+        _mm_storeu_si128((__m128i *)b, rowa);
+        a += 16;
+        b += 16;
+        len -= 16;
+    }
+#elif defined(HAVE_NEON_INTRINSICS)
+    while (len >= 16) {
+        const uint8x16_t rowa = vld1q_u8(a);
+        const uint8x16_t rowb = vld1q_u8(b);
+        vst1q_u8(a, rowb);
+        vst1q_u8(b, rowa);
+        a += 16;
+        b += 16;
+        len -= 16;
+    }
+#endif
+    while (len--) {
+        const Uint8 tmp = *a;
+        *a++ = *b;
+        *b++ = tmp;
+    }
+}
+
+/* Turn a bottom-up image the right way up, in place */
+static void FlipRows(Uint8 *pixels, int pitch, int h)
+{
+    Uint8 *top = pixels;
+    Uint8 *bottom = pixels + (size_t)(h - 1) * pitch;
+
+    while (top < bottom) {
+        SwapRows(top, bottom, pitch);
+        top += pitch;
+        bottom -= pitch;
+    }
+}
+
+/*
+| Read the whole pixel array into the surface, which has the same row
+| layout.  Memory streams are copied straight into place; anything else
+| gets a single read and a flip if the image is upside down.
+*/
+static SDL_bool readPixelArray(SDL_Surface * surface, SDL_RWops * src, SDL_bool topDown)
+{
+    const size_t pitch = surface->pitch;
+    const size_t len = pitch * surface->h;
+    Uint8 *pixels = (Uint8 *)surface->pixels;
+
+    if ((src->type == SDL_RWOPS_MEMORY || src->type == SDL_RWOPS_MEMORY_RO) &&
+        (size_t)(src->hidden.mem.stop - src->hidden.mem.here) >= len) {
+        const Uint8 *data = src->hidden.mem.here;
+        if (topDown) {
+            SDL_memcpy(pixels, data, len);
+        } else {
+            Uint8 *bits = pixels + len;
+            while (bits > pixels) {
+                bits -= pitch;
+                SDL_memcpy(bits, data, pitch);
+                data += pitch;
+            }
+        }
+        return (SDL_RWseek(src, (Sint64)len, RW_SEEK_CUR) >= 0) ? SDL_TRUE : SDL_FALSE;
+    }
+
+    if (SDL_RWread(src, pixels, pitch, surface->h) != (size_t)surface->h) {
+        return SDL_FALSE;
+    }
+    if (!topDown) {
+        FlipRows(pixels, surface->pitch, surface->h);
+    }
+    return SDL_TRUE;
+}
+
 static void CorrectAlphaChannel(SDL_Surface *surface)
 {
+    /* 32-bit rows have no padding, so this is one run of pixels.
+       Pixels are in native byte order by now, alpha is the top byte. */
+    Uint32 *pixels = (Uint32 *)surface->pixels;
+    size_t count = (size_t)surface->h * surface->pitch / 4;
+    size_t i = 0;
+
     /* Check to see if there is any alpha channel data */
-    SDL_bool hasAlpha = SDL_FALSE;
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-    int alphaChannelOffset = 0;
-#else
-    int alphaChannelOffset = 3;
+#if defined(HAVE_SSE2_INTRINSICS)
+    {
+        const __m128i amask = _mm_set1_epi32((int)0xFF000000);
+        for (; i + 16 <= count; i += 16) {
+            const __m128i *p = (const __m128i *)(pixels + i);
+            __m128i any = _mm_or_si128(_mm_or_si128(_mm_loadu_si128(p), _mm_loadu_si128(p + 1)),
+                                       _mm_or_si128(_mm_loadu_si128(p + 2), _mm_loadu_si128(p + 3)));
+            any = _mm_cmpeq_epi32(_mm_and_si128(any, amask), _mm_setzero_si128());
+            if (_mm_movemask_epi8(any) != 0xFFFF) {
+                return;
+            }
+        }
+    }
+#elif defined(HAVE_NEON_INTRINSICS)
+    {
+        const uint32x4_t amask = vdupq_n_u32(0xFF000000);
+        for (; i + 16 <= count; i += 16) {
+            const Uint32 *p = pixels + i;
+            uint64x2_t any = vreinterpretq_u64_u32(vandq_u32(vorrq_u32(vorrq_u32(vld1q_u32(p), vld1q_u32(p + 4)),
+                                                                       vorrq_u32(vld1q_u32(p + 8), vld1q_u32(p + 12))), amask));
+            if (vgetq_lane_u64(any, 0) | vgetq_lane_u64(any, 1)) {
+                return;
+            }
+        }
+    }
 #endif
-    Uint8 *alpha = ((Uint8*)surface->pixels) + alphaChannelOffset;
-    Uint8 *end = alpha + surface->h * surface->pitch;
-
-    while (alpha < end) {
-        if (*alpha != 0) {
-            hasAlpha = SDL_TRUE;
-            break;
+    for (; i < count; ++i) {
+        if (pixels[i] & 0xFF000000) {
+            return;
         }
-        alpha += 4;
     }
 
-    if (!hasAlpha) {
-        alpha = ((Uint8*)surface->pixels) + alphaChannelOffset;
-        while (alpha < end) {
-            *alpha = SDL_ALPHA_OPAQUE;
-            alpha += 4;
+    /* No alpha channel data, make the image opaque */
+    i = 0;
+#if defined(HAVE_SSE2_INTRINSICS)
+    {
+        const __m128i amask = _mm_set1_epi32((int)0xFF000000);
+        for (; i + 4 <= count; i += 4) {
+            __m128i *p = (__m128i *)(pixels + i);
+            _mm_storeu_si128(p, _mm_or_si128(_mm_loadu_si128(p), amask));
+        }
+    }
+#elif defined(HAVE_NEON_INTRINSICS)
+    {
+        const uint32x4_t amask = vdupq_n_u32(0xFF000000);
+        for (; i + 4 <= count; i += 4) {
+            vst1q_u32(pixels + i, vorrq_u32(vld1q_u32(pixels + i), amask));
         }
     }
+#endif
+    for (; i < count; ++i) {
+        pixels[i] |= 0xFF000000;
+    }
 }
 
 SDL_Surface *
@@ -468,98 +595,85 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     }
     top = (Uint8 *)surface->pixels;
     end = (Uint8 *)surface->pixels+(surface->h*surface->pitch);
-    switch (ExpandBMP) {
-    case 1:
-        bmpPitch = (biWidth + 7) >> 3;
-        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
-        break;
-    case 4:
-        bmpPitch = (biWidth + 1) >> 1;
-        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
-        break;
-    default:
-        pad = ((surface->pitch % 4) ? (4 - (surface->pitch % 4)) : 0);
-        break;
-    }
-    if (topDown) {
-        bits = top;
-    } else {
-        bits = end - surface->pitch;
-    }
-    while (bits >= top && bits < end) {
-        switch (ExpandBMP) {
-        case 1:
-        case 4:{
-                Uint8 pixel = 0;
-                int shift = (8 - ExpandBMP);
+    if (!ExpandBMP) {
+        /* BMP rows are padded to 4 bytes, just like our surface pitch, so
+           the pixel array maps straight onto the surface pixels. */
+        if (!readPixelArray(surface, src, topDown)) {
+            SDL_Error(SDL_EFREAD);
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        if (biBitCount == 8 && palette && biClrUsed < (1u << biBitCount)) {
+            for (bits = top; bits < end; bits += surface->pitch) {
                 for (i = 0; i < surface->w; ++i) {
-                    if (i % (8 / ExpandBMP) == 0) {
-                        if (!SDL_RWread(src, &pixel, 1, 1)) {
-                            SDL_Error(SDL_EFREAD);
-                            was_error = SDL_TRUE;
-                            goto done;
-                        }
-                    }
-                    bits[i] = (pixel >> shift);
                     if (bits[i] >= biClrUsed) {
                         SDL_SetError("A BMP image contains a pixel with a color out of the palette");
                         was_error = SDL_TRUE;
                         goto done;
                     }
-                    pixel <<= ExpandBMP;
                 }
             }
-            break;
+        }
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+        /* Byte-swap the pixels if needed. Note that the 24bpp
+           case has already been taken care of above. */
+        switch (biBitCount) {
+        case 15:
+        case 16:{
+                Uint16 *pix = (Uint16 *) surface->pixels;
+                for (i = 0; i < surface->h * surface->pitch / 2; i++)
+                    pix[i] = SDL_Swap16(pix[i]);
+                break;
+            }
 
-        default:
-            if (SDL_RWread(src, bits, 1, surface->pitch) != surface->pitch) {
-                SDL_Error(SDL_EFREAD);
-                was_error = SDL_TRUE;
-                goto done;
+        case 32:{
+                Uint32 *pix = (Uint32 *) surface->pixels;
+                for (i = 0; i < surface->h * surface->pitch / 4; i++)
+                    pix[i] = SDL_Swap32(pix[i]);
+                break;
             }
-            if (biBitCount == 8 && palette && biClrUsed < (1u << biBitCount)) {
-                for (i = 0; i < surface->w; ++i) {
-                    if (bits[i] >= biClrUsed) {
-                        SDL_SetError("A BMP image contains a pixel with a color out of the palette");
+        }
+#endif
+    } else {
+        bmpPitch = (ExpandBMP == 1) ? ((biWidth + 7) >> 3) : ((biWidth + 1) >> 1);
+        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
+        if (topDown) {
+            bits = top;
+        } else {
+            bits = end - surface->pitch;
+        }
+        while (bits >= top && bits < end) {
+            Uint8 pixel = 0;
+            int shift = (8 - ExpandBMP);
+            for (i = 0; i < surface->w; ++i) {
+                if (i % (8 / ExpandBMP) == 0) {
+                    if (!SDL_RWread(src, &pixel, 1, 1)) {
+                        SDL_Error(SDL_EFREAD);
                         was_error = SDL_TRUE;
                         goto done;
                     }
                 }
-            }
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            /* Byte-swap the pixels if needed. Note that the 24bpp
-               case has already been taken care of above. */
-            switch (biBitCount) {
-            case 15:
-            case 16:{
-                    Uint16 *pix = (Uint16 *) bits;
-                    for (i = 0; i < surface->w; i++)
-                        pix[i] = SDL_Swap16(pix[i]);
-                    break;
+                bits[i] = (pixel >> shift);
+                if (bits[i] >= biClrUsed) {
+                    SDL_SetError("A BMP image contains a pixel with a color out of the palette");
+                    was_error = SDL_TRUE;
+                    goto done;
                 }
-
-            case 32:{
-                    Uint32 *pix = (Uint32 *) bits;
-                    for (i = 0; i < surface->w; i++)
-                        pix[i] = SDL_Swap32(pix[i]);
-                    break;
+                pixel <<= ExpandBMP;
+            }
+            /* Skip padding bytes, ugh */
+            if (pad) {
+                Uint8 padbyte;
+                for (i = 0; i < pad; ++i) {
+                    SDL_RWread(src, &padbyte, 1, 1);
                 }
             }
-#endif
-            break;
-        }
-        /* Skip padding bytes, ugh */
-        if (pad) {
-            Uint8 padbyte;
-            for (i = 0; i < pad; ++i) {
-                SDL_RWread(src, &padbyte, 1, 1);
+            if (topDown) {
+                bits += surface->pitch;
+            } else {
+                bits -= surface->pitch;
             }
         }
-        if (topDown) {
-            bits += surface->pitch;
-        } else {
-            bits -= surface->pitch;
-        }
     }
     if (correctAlpha) {
         CorrectAlphaChannel(surface);
@@ -580,13 +694,40 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     return (surface);
 }
 
+/*
+| Convert rows [y, y+h) of surface to format, just as SDL_ConvertSurface()
+| would convert them as part of the whole surface.  The surface is locked.
+*/
+static SDL_Surface *convertRows(SDL_Surface * surface, int y, int h, const SDL_PixelFormat * format)
+{
+    SDL_Surface *rows, *converted;
+
+    rows = SDL_CreateRGBSurfaceFrom((Uint8 *) surface->pixels + y * surface->pitch,
+                                    surface->w, h, surface->format->BitsPerPixel, surface->pitch,
+                                    surface->format->Rmask, surface->format->Gmask,
+                                    surface->format->Bmask, surface->format->Amask);
+    if (!rows) {
+        return NULL;
+    }
+    if (surface->format->palette) {
+        SDL_SetSurfacePalette(rows, surface->format->palette);
+    }
+    if (surface->map->info.flags & SDL_COPY_COLORKEY) {
+        SDL_SetColorKey(rows, SDL_TRUE, surface->map->info.colorkey);
+    }
+    converted = SDL_ConvertSurface(rows, format, 0);
+    SDL_FreeSurface(rows);
+    return converted;
+}
+
 int
 SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
 {
     Sint64 fp_offset;
-    int i, pad;
+    int i;
     SDL_Surface *surface;
-    Uint8 *bits;
+    SDL_PixelFormat format;
+    SDL_bool convert = SDL_FALSE;
     SDL_bool save32bit = SDL_FALSE;
     SDL_bool saveLegacyBMP = SDL_FALSE;
 
@@ -652,20 +793,16 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
             ) {
             surface = saveme;
         } else {
-            SDL_PixelFormat format;
-
             /* If the surface has a colorkey or alpha channel we'll save a
-               32-bit BMP with alpha channel, otherwise save a 24-bit BMP. */
+               32-bit BMP with alpha channel, otherwise save a 24-bit BMP.
+               The conversion happens a band of rows at a time as we write. */
             if (save32bit) {
                 SDL_InitFormat(&format, SDL_PIXELFORMAT_BGRA32);
             } else {
                 SDL_InitFormat(&format, SDL_PIXELFORMAT_BGR24);
             }
-            surface = SDL_ConvertSurface(saveme, &format, 0);
-            if (!surface) {
-                SDL_SetError("Couldn't convert image to %d bpp",
-                             format.BitsPerPixel);
-            }
+            surface = saveme;
+            convert = SDL_TRUE;
         }
     } else {
         /* Set no error here because it may overwrite a more useful message from
@@ -678,7 +815,26 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
     }
 
     if (surface && (SDL_LockSurface(surface) == 0)) {
-        const int bw = surface->w * surface->format->BytesPerPixel;
+        const SDL_PixelFormat *saveformat = convert ? &format : surface->format;
+        const int bw = surface->w * saveformat->BytesPerPixel;
+        const int bmpPitch = (bw + 3) & ~3;
+        const int bandRows = bmpPitch ? SDL_max(1, SDL_min(SAVE_BAND_SIZE / bmpPitch, surface->h)) : 1;
+        SDL_Surface *converted = NULL;
+        Uint8 *band = NULL;
+        size_t written;
+        int y, rows;
+
+        /* Convert the first band before writing anything, so a surface we
+           can't convert leaves dst untouched, like it always has. */
+        if (convert && bmpPitch && surface->h > 0) {
+            rows = SDL_min(bandRows, surface->h);
+            converted = convertRows(surface, surface->h - rows, rows, &format);
+            if (!converted) {
+                SDL_SetError("Couldn't convert image to %d bpp",
+                             format.BitsPerPixel);
+                goto unlock;
+            }
+        }
 
         /* Set the BMP file header values */
         bfSize = 0;             /* We'll write this when we're done */
@@ -700,13 +856,13 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
         biWidth = surface->w;
         biHeight = surface->h;
         biPlanes = 1;
-        biBitCount = surface->format->BitsPerPixel;
+        biBitCount = saveformat->BitsPerPixel;
         biCompression = BI_RGB;
-        biSizeImage = surface->h * surface->pitch;
+        biSizeImage = surface->h * bmpPitch;
         biXPelsPerMeter = 0;
         biYPelsPerMeter = 0;
-        if (surface->format->palette) {
-            biClrUsed = surface->format->palette->ncolors;
+        if (saveformat->palette) {
+            biClrUsed = saveformat->palette->ncolors;
         } else {
             biClrUsed = 0;
         }
@@ -756,12 +912,12 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
         }
 
         /* Write the palette (in BGR color order) */
-        if (surface->format->palette) {
+        if (saveformat->palette) {
             SDL_Color *colors;
             int ncolors;
 
-            colors = surface->format->palette->colors;
-            ncolors = surface->format->palette->ncolors;
+            colors = saveformat->palette->colors;
+            ncolors = saveformat->palette->ncolors;
             for (i = 0; i < ncolors; ++i) {
                 SDL_RWwrite(dst, &colors[i].b, 1, 1);
                 SDL_RWwrite(dst, &colors[i].g, 1, 1);
@@ -780,22 +936,46 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
             SDL_Error(SDL_EFSEEK);
         }
 
-        /* Write the bitmap image upside down */
-        bits = (Uint8 *) surface->pixels + (surface->h * surface->pitch);
-        pad = ((bw % 4) ? (4 - (bw % 4)) : 0);
-        while (bits > (Uint8 *) surface->pixels) {
-            bits -= surface->pitch;
-            if (SDL_RWwrite(dst, bits, 1, bw) != bw) {
-                SDL_Error(SDL_EFWRITE);
-                break;
+        /* Write the bitmap image upside down, a band of rows at a time,
+           so we never hold more than a band of converted pixels. */
+        if (!convert && bmpPitch) {
+            /* the padding bytes stay zero */
+            band = (Uint8 *) SDL_calloc(bandRows, bmpPitch);
+            if (!band) {
+                SDL_OutOfMemory();
             }
-            if (pad) {
-                const Uint8 padbyte = 0;
-                for (i = 0; i < pad; ++i) {
-                    SDL_RWwrite(dst, &padbyte, 1, 1);
+        }
+        for (y = surface->h; y > 0 && bmpPitch && (convert || band); y -= rows) {
+            rows = SDL_min(bandRows, y);
+            if (convert) {
+                if (!converted) {
+                    converted = convertRows(surface, y - rows, rows, &format);
+                }
+                if (!converted) {
+                    SDL_SetError("Couldn't convert image to %d bpp",
+                                 format.BitsPerPixel);
+                    break;
+                }
+                /* converted surfaces are zero-filled with the same padding we need */
+                SDL_assert(converted->pitch == bmpPitch);
+                FlipRows((Uint8 *) converted->pixels, converted->pitch, rows);
+                written = SDL_RWwrite(dst, converted->pixels, bmpPitch, rows);
+                SDL_FreeSurface(converted);
+                converted = NULL;
+            } else {
+                const Uint8 *bits = (const Uint8 *) surface->pixels + (y - 1) * surface->pitch;
+                for (i = 0; i < rows; ++i) {
+                    SDL_memcpy(band + i * bmpPitch, bits, bw);
+                    bits -= surface->pitch;
                 }
+                written = SDL_RWwrite(dst, band, bmpPitch, rows);
+            }
+            if (written != (size_t) rows) {
+                SDL_Error(SDL_EFWRITE);
+                break;
             }
         }
+        SDL_free(band);
 
         /* Write the BMP file size */
         bfSize = (Uint32)(SDL_RWtell(dst) - fp_offset);
@@ -808,10 +988,8 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
         }
 
         /* Close it up.. */
+      unlock:
         SDL_UnlockSurface(surface);
-        if (surface != saveme) {
-            SDL_FreeSurface(surface);
-        }
     }
 
     if (freedst && dst) {
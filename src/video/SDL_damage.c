@@ -0,0 +1,277 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#include "SDL_damage_c.h"
+
+#define DAMAGE_TILE_SIZE    64
+
+/* The xxHash64 primes and round function, which mix well enough that
+   any change to a tile is practically guaranteed to change its hash. */
+#define DAMAGE_PRIME1   0x9E3779B185EBCA87ULL
+#define DAMAGE_PRIME2   0xC2B2AE3D27D4EB4FULL
+#define DAMAGE_PRIME3   0x165667B19E3779F9ULL
+
+#define DAMAGE_ROTL(x, r)   (((x) << (r)) | ((x) >> (64 - (r))))
+
+struct SDL_DamageTracker
+{
+    /* The surface the hashes were taken from */
+    int w, h;
+    Uint32 format;
+
+    int tiles_x, tiles_y;
+    SDL_bool valid;         /* hashes hold the previous frame */
+    Uint64 *hashes;         /* one per tile, row by row */
+    Uint64 *row_hashes;     /* the tile row being scanned */
+    Uint8 *dirty;           /* the tile row being scanned */
+    int *open;              /* rects of the previous tile row, which may grow downwards */
+    int *next_open;
+    SDL_Rect *rects;
+};
+
+static SDL_INLINE Uint64
+SDL_DamageRound(Uint64 acc, Uint64 value)
+{
+    acc += value * DAMAGE_PRIME2;
+    acc = DAMAGE_ROTL(acc, 31);
+    return acc * DAMAGE_PRIME1;
+}
+
+static SDL_INLINE Uint64
+SDL_DamageLoad(const Uint8 *data)
+{
+    Uint64 value;
+    SDL_memcpy(&value, data, sizeof (value));
+    return value;
+}
+
+/* Hash a span of pixels, using four independent lanes to keep the
+   multiplier busy */
+static Uint64
+SDL_DamageHashSpan(const Uint8 *data, size_t len)
+{
+    Uint64 a = DAMAGE_PRIME1 + DAMAGE_PRIME2;
+    Uint64 b = DAMAGE_PRIME2;
+    Uint64 c = 0;
+    Uint64 d = 0 - DAMAGE_PRIME1;
+
+    while (len >= 32) {
+        a = SDL_DamageRound(a, SDL_DamageLoad(data));
+        b = SDL_DamageRound(b, SDL_DamageLoad(data + 8));
+        c = SDL_DamageRound(c, SDL_DamageLoad(data + 16));
+        d = SDL_DamageRound(d, SDL_DamageLoad(data + 24));
+        data += 32;
+        len -= 32;
+    }
+    while (len >= 8) {
+        a = SDL_DamageRound(a, SDL_DamageLoad(data));
+        data += 8;
+        len -= 8;
+    }
+    if (len > 0) {
+        Uint64 value = 0;
+        SDL_memcpy(&value, data, len);
+        b = SDL_DamageRound(b, value);
+    }
+    return DAMAGE_ROTL(a, 1) + DAMAGE_ROTL(b, 7) + DAMAGE_ROTL(c, 12) + DAMAGE_ROTL(d, 18);
+}
+
+SDL_DamageTracker *
+SDL_CreateDamageTracker(void)
+{
+    SDL_DamageTracker *tracker = (SDL_DamageTracker *) SDL_calloc(1, sizeof (*tracker));
+    if (!tracker) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    return tracker;
+}
+
+void
+SDL_DestroyDamageTracker(SDL_DamageTracker *tracker)
+{
+    if (tracker) {
+        SDL_free(tracker->hashes);
+        SDL_free(tracker);
+    }
+}
+
+void
+SDL_ResetDamageTracker(SDL_DamageTracker *tracker)
+{
+    if (tracker) {
+        tracker->valid = SDL_FALSE;
+    }
+}
+
+static int
+SDL_ResizeDamageTracker(SDL_DamageTracker *tracker, const SDL_Surface *surface)
+{
+    const int tiles_x = (surface->w + DAMAGE_TILE_SIZE - 1) / DAMAGE_TILE_SIZE;
+    const int tiles_y = (surface->h + DAMAGE_TILE_SIZE - 1) / DAMAGE_TILE_SIZE;
+    const size_t numtiles = (size_t) tiles_x * tiles_y;
+    /* Every other tile of a row being dirty gives the most rects */
+    const size_t maxruns = ((size_t) tiles_x + 1) / 2;
+    const size_t maxrects = maxruns * tiles_y;
+    Uint8 *mem;
+
+    SDL_free(tracker->hashes);
+    tracker->hashes = NULL;
+    tracker->valid = SDL_FALSE;
+    tracker->w = tracker->h = 0;
+    tracker->tiles_x = tracker->tiles_y = 0;
+
+    if (numtiles == 0) {
+        return 0;
+    }
+
+    /* One allocation, ordered by alignment */
+    mem = (Uint8 *) SDL_malloc(numtiles * sizeof (Uint64) +
+                               tiles_x * sizeof (Uint64) +
+                               maxrects * sizeof (SDL_Rect) +
+                               maxruns * 2 * sizeof (int) +
+                               tiles_x);
+    if (!mem) {
+        return SDL_OutOfMemory();
+    }
+    tracker->hashes = (Uint64 *) mem;
+    tracker->row_hashes = tracker->hashes + numtiles;
+    tracker->rects = (SDL_Rect *) (tracker->row_hashes + tiles_x);
+    tracker->open = (int *) (tracker->rects + maxrects);
+    tracker->next_open = tracker->open + maxruns;
+    tracker->dirty = (Uint8 *) (tracker->next_open + maxruns);
+
+    tracker->w = surface->w;
+    tracker->h = surface->h;
+    tracker->format = surface->format->format;
+    tracker->tiles_x = tiles_x;
+    tracker->tiles_y = tiles_y;
+    return 0;
+}
+
+int
+SDL_GetSurfaceDamage(SDL_DamageTracker *tracker, SDL_Surface *surface, const SDL_Rect **rects)
+{
+    int bpp, tx, ty, y;
+    int numrects = 0;
+    int numopen = 0;
+
+    if (!tracker) {
+        return SDL_InvalidParamError("tracker");
+    }
+    if (!surface) {
+        return SDL_InvalidParamError("surface");
+    }
+    if (!rects) {
+        return SDL_InvalidParamError("rects");
+    }
+    *rects = NULL;
+
+    if ((surface->w != tracker->w) || (surface->h != tracker->h) ||
+        (surface->format->format != tracker->format) || !tracker->hashes) {
+        if (SDL_ResizeDamageTracker(tracker, surface) < 0) {
+            return -1;
+        }
+        if (!tracker->hashes) {
+            return 0;  /* empty surface */
+        }
+    }
+
+    if (SDL_LockSurface(surface) < 0) {
+        return -1;
+    }
+
+    bpp = surface->format->BytesPerPixel;
+    for (ty = 0; ty < tracker->tiles_y; ++ty) {
+        const int y0 = ty * DAMAGE_TILE_SIZE;
+        const int y1 = SDL_min(y0 + DAMAGE_TILE_SIZE, surface->h);
+        Uint64 *hashes = &tracker->hashes[ty * tracker->tiles_x];
+        Uint64 *row_hashes = tracker->row_hashes;
+        Uint8 *dirty = tracker->dirty;
+        int *swap;
+        int numnext = 0;
+        int i = 0;
+
+        /* Hash the tiles of this row, scanning the surface a line at a time */
+        for (tx = 0; tx < tracker->tiles_x; ++tx) {
+            row_hashes[tx] = DAMAGE_PRIME3;
+        }
+        for (y = y0; y < y1; ++y) {
+            const Uint8 *line = (const Uint8 *) surface->pixels + y * surface->pitch;
+            for (tx = 0; tx < tracker->tiles_x; ++tx) {
+                const int x0 = tx * DAMAGE_TILE_SIZE;
+                const int x1 = SDL_min(x0 + DAMAGE_TILE_SIZE, surface->w);
+                const Uint64 hash = SDL_DamageHashSpan(line + x0 * bpp, (size_t) (x1 - x0) * bpp);
+                row_hashes[tx] = SDL_DamageRound(row_hashes[tx], hash);
+            }
+        }
+        for (tx = 0; tx < tracker->tiles_x; ++tx) {
+            dirty[tx] = (!tracker->valid || (hashes[tx] != row_hashes[tx]));
+            hashes[tx] = row_hashes[tx];
+        }
+
+        /* Turn runs of dirty tiles into rects, growing the rect above
+           instead if it covers exactly the same columns */
+        for (tx = 0; tx < tracker->tiles_x; ) {
+            int x, w, rect;
+
+            if (!dirty[tx]) {
+                ++tx;
+                continue;
+            }
+            x = tx * DAMAGE_TILE_SIZE;
+            while ((tx < tracker->tiles_x) && dirty[tx]) {
+                ++tx;
+            }
+            w = SDL_min(tx * DAMAGE_TILE_SIZE, surface->w) - x;
+
+            while ((i < numopen) && (tracker->rects[tracker->open[i]].x < x)) {
+                ++i;
+            }
+            if ((i < numopen) && (tracker->rects[tracker->open[i]].x == x) &&
+                (tracker->rects[tracker->open[i]].w == w)) {
+                rect = tracker->open[i];
+                tracker->rects[rect].h += (y1 - y0);
+            } else {
+                rect = numrects++;
+                tracker->rects[rect].x = x;
+                tracker->rects[rect].y = y0;
+                tracker->rects[rect].w = w;
+                tracker->rects[rect].h = (y1 - y0);
+            }
+            tracker->next_open[numnext++] = rect;
+        }
+
+        swap = tracker->open;
+        tracker->open = tracker->next_open;
+        tracker->next_open = swap;
+        numopen = numnext;
+    }
+
+    SDL_UnlockSurface(surface);
+
+    tracker->valid = SDL_TRUE;
+    *rects = tracker->rects;
+    return numrects;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,49 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_damage_c_h_
+#define SDL_damage_c_h_
+
+#include "../SDL_internal.h"
+
+#include "SDL_surface.h"
+
+/* Finds the parts of a window surface that changed since the last frame.
+
+   The surface is split into fixed-size tiles and each tile is hashed, so
+   only a hash per tile of the previous frame is kept around. Changed tiles
+   are merged into as few rectangles as possible. */
+typedef struct SDL_DamageTracker SDL_DamageTracker;
+
+extern SDL_DamageTracker *SDL_CreateDamageTracker(void);
+extern void SDL_DestroyDamageTracker(SDL_DamageTracker *tracker);
+
+/* Forget the previous frame, the next call to SDL_GetSurfaceDamage() reports
+   the whole surface. */
+extern void SDL_ResetDamageTracker(SDL_DamageTracker *tracker);
+
+/* Returns the number of changed rectangles and points `rects` at them, or -1
+   on error. The rectangles stay valid until the next call. */
+extern int SDL_GetSurfaceDamage(SDL_DamageTracker *tracker, SDL_Surface *surface, const SDL_Rect **rects);
+
+#endif /* SDL_damage_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -25,111 +25,155 @@
 #include "SDL_cpuinfo.h"
 
 
-#ifdef __SSE__
-/* *INDENT-OFF* */ /* clang-format off */
+/* Fills at least this many bytes per row go through the SIMD kernels;
+   narrower rows don't amortize the alignment head and tail. */
+#define SDL_FILLRECT_SIMD_MIN_ROW   64
+
+/* Fills bigger than this use non-temporal stores, which bypass the cache.
+   This is about the size of a typical last-level cache: anything larger
+   would evict everything else on the way through anyway, while smaller
+   fills are usually read back soon and should stay cached. */
+#define SDL_FILLRECT_STREAM_MIN     (8 * 1024 * 1024)
+
+#if defined(__SSE__) || defined(HAVE_AVX2_INTRINSICS)
+/* The SIMD kernels copy from a byte pattern of the fill color in memory
+   order. 8, 16 and 32-bit colors repeat every 4 bytes, and 24-bit colors
+   every 3 bytes, so three vectors (48 bytes for SSE, 96 for AVX) always
+   hold a whole number of pixels. Rows are aligned with a short scalar head
+   and the vectors are loaded from the pattern at the matching phase. */
+static int
+SDL_FillRectPattern(Uint8 *pattern, int size, Uint32 color, int bpp)
+{
+    Uint8 bytes[4];
+    int period, i;
 
-#if defined(_MSC_VER) && !defined(__clang__)
-#define SSE_BEGIN \
-    __m128 c128; \
-    c128.m128_u32[0] = color; \
-    c128.m128_u32[1] = color; \
-    c128.m128_u32[2] = color; \
-    c128.m128_u32[3] = color;
+    if (bpp == 3) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        bytes[0] = (Uint8) (color & 0xFF);
+        bytes[1] = (Uint8) ((color >> 8) & 0xFF);
+        bytes[2] = (Uint8) ((color >> 16) & 0xFF);
 #else
-#define SSE_BEGIN \
-    __m128 c128; \
-    DECLARE_ALIGNED(Uint32, cccc[4], 16); \
-    cccc[0] = color; \
-    cccc[1] = color; \
-    cccc[2] = color; \
-    cccc[3] = color; \
-    c128 = *(__m128 *)cccc;
+        bytes[0] = (Uint8) ((color >> 16) & 0xFF);
+        bytes[1] = (Uint8) ((color >> 8) & 0xFF);
+        bytes[2] = (Uint8) (color & 0xFF);
 #endif
-
-#define SSE_WORK \
-    for (i = n / 64; i--;) { \
-        _mm_stream_ps((float *)(p+0), c128); \
-        _mm_stream_ps((float *)(p+16), c128); \
-        _mm_stream_ps((float *)(p+32), c128); \
-        _mm_stream_ps((float *)(p+48), c128); \
-        p += 64; \
+        period = 3;
+    } else {
+        /* 'color' has already been replicated out to 32 bits */
+        SDL_memcpy(bytes, &color, 4);
+        period = 4;
+    }
+    for (i = 0; i < size; ++i) {
+        pattern[i] = bytes[i % period];
     }
+    return period;
+}
+#endif
 
-#define SSE_END
+#ifdef __SSE__
+/* *INDENT-OFF* */ /* clang-format off */
 
-#define DEFINE_SSE_FILLRECT(bpp, type) \
+#define DEFINE_SSE_FILLRECT(name, STORE, FENCE) \
 static void \
-SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+SDL_FillRect##name(Uint8 *pixels, int pitch, Uint32 color, int bpp, int w, int h) \
 { \
-    int i, n; \
-    Uint8 *p = NULL; \
- \
-    SSE_BEGIN; \
+    DECLARE_ALIGNED(Uint8, pattern[64], 16); \
+    const int period = SDL_FillRectPattern(pattern, sizeof (pattern), color, bpp); \
  \
     while (h--) { \
-        n = w * bpp; \
-        p = pixels; \
+        const Uint8 *phase = pattern; \
+        Uint8 *p = pixels; \
+        int n = w * bpp; \
+        int head = (int) (-(intptr_t) p & 15); \
+        __m128 c0, c1, c2; \
+        int i; \
  \
-        if (n > 63) { \
-            int adjust = 16 - ((uintptr_t)p & 15); \
-            if (adjust < 16) { \
-                n -= adjust; \
-                adjust /= bpp; \
-                while (adjust--) { \
-                    *((type *)p) = (type)color; \
-                    p += bpp; \
-                } \
-            } \
-            SSE_WORK; \
+        if (head) { \
+            SDL_memcpy(p, pattern, head); \
+            phase += head % period; \
+            p += head; \
+            n -= head; \
         } \
-        if (n & 63) { \
-            int remainder = (n & 63); \
-            remainder /= bpp; \
-            while (remainder--) { \
-                *((type *)p) = (type)color; \
-                p += bpp; \
-            } \
+        c0 = _mm_loadu_ps((const float *) (phase + 0)); \
+        c1 = _mm_loadu_ps((const float *) (phase + 16)); \
+        c2 = _mm_loadu_ps((const float *) (phase + 32)); \
+        for (i = n / 48; i--;) { \
+            STORE((float *) (p + 0), c0); \
+            STORE((float *) (p + 16), c1); \
+            STORE((float *) (p + 32), c2); \
+            p += 48; \
         } \
+        SDL_memcpy(p, phase, n % 48); \
         pixels += pitch; \
     } \
- \
-    SSE_END; \
+    if (FENCE) { \
+        _mm_sfence(); \
+    } \
 }
 
-static void
-SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
-{
-    int i, n;
+DEFINE_SSE_FILLRECT(SSE, _mm_store_ps, SDL_FALSE)
+DEFINE_SSE_FILLRECT(SSEStream, _mm_stream_ps, SDL_TRUE)
 
-    SSE_BEGIN;
-    while (h--) {
-        Uint8 *p = pixels;
-        n = w;
+/* *INDENT-ON* */ /* clang-format on */
+#endif /* __SSE__ */
 
-        if (n > 63) {
-            int adjust = 16 - ((uintptr_t)p & 15);
-            if (adjust) {
-                n -= adjust;
-                SDL_memset(p, color, adjust);
-                p += adjust;
-            }
-            SSE_WORK;
-        }
-        if (n & 63) {
-            int remainder = (n & 63);
-            SDL_memset(p, color, remainder);
-        }
-        pixels += pitch;
+#ifdef HAVE_AVX2_INTRINSICS
+/* *INDENT-OFF* */ /* clang-format off */
+
+static int
+hasAVX2()
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
     }
+    val = SDL_HasAVX2();
+    return val;
+}
 
-    SSE_END;
+#define DEFINE_AVX2_FILLRECT(name, STORE, FENCE) \
+static void SDL_TARGETING("avx2") \
+SDL_FillRect##name(Uint8 *pixels, int pitch, Uint32 color, int bpp, int w, int h) \
+{ \
+    DECLARE_ALIGNED(Uint8, pattern[128], 32); \
+    const int period = SDL_FillRectPattern(pattern, sizeof (pattern), color, bpp); \
+ \
+    while (h--) { \
+        const Uint8 *phase = pattern; \
+        Uint8 *p = pixels; \
+        int n = w * bpp; \
+        int head = (int) (-(intptr_t) p & 31); \
+        __m256i c0, c1, c2; \
+        int i; \
+ \
+        if (head) { \
+            SDL_memcpy(p, pattern, head); \
+            phase += head % period; \
+            p += head; \
+            n -= head; \
+        } \
+        c0 = _mm256_loadu_si256((const __m256i *) (phase + 0)); \
+        c1 = _mm256_loadu_si256((const __m256i *) (phase + 32)); \
+        c2 = _mm256_loadu_si256((const __m256i *) (phase + 64)); \
+        for (i = n / 96; i--;) { \
+            STORE((__m256i *) (p + 0), c0); \
+            STORE((__m256i *) (p + 32), c1); \
+            STORE((__m256i *) (p + 64), c2); \
+            p += 96; \
+        } \
+        SDL_memcpy(p, phase, n % 96); \
+        pixels += pitch; \
+    } \
+    if (FENCE) { \
+        _mm_sfence(); \
+    } \
 }
-/* DEFINE_SSE_FILLRECT(1, Uint8) */
-DEFINE_SSE_FILLRECT(2, Uint16)
-DEFINE_SSE_FILLRECT(4, Uint32)
+
+DEFINE_AVX2_FILLRECT(AVX2, _mm256_store_si256, SDL_FALSE)
+DEFINE_AVX2_FILLRECT(AVX2Stream, _mm256_stream_si256, SDL_TRUE)
 
 /* *INDENT-ON* */ /* clang-format on */
-#endif /* __SSE__ */
+#endif /* HAVE_AVX2_INTRINSICS */
 
 static void
 SDL_FillRect1(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
@@ -303,6 +347,9 @@ SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
     Uint8 *pixels;
     const SDL_Rect* rect;
     void (*fill_function)(Uint8 * pixels, int pitch, Uint32 color, int w, int h) = NULL;
+    void (*simd_function)(Uint8 * pixels, int pitch, Uint32 color, int bpp, int w, int h) = NULL;
+    void (*stream_function)(Uint8 * pixels, int pitch, Uint32 color, int bpp, int w, int h) = NULL;
+    int bpp;
     int i;
 
     if (!dst) {
@@ -371,18 +418,13 @@ SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
     }
 #endif
 
+    bpp = dst->format->BytesPerPixel;
     if (fill_function == NULL) {
-        switch (dst->format->BytesPerPixel) {
+        switch (bpp) {
         case 1:
             {
                 color |= (color << 8);
                 color |= (color << 16);
-#ifdef __SSE__
-                if (SDL_HasSSE()) {
-                    fill_function = SDL_FillRect1SSE;
-                    break;
-                }
-#endif
                 fill_function = SDL_FillRect1;
                 break;
             }
@@ -390,18 +432,11 @@ SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
         case 2:
             {
                 color |= (color << 16);
-#ifdef __SSE__
-                if (SDL_HasSSE()) {
-                    fill_function = SDL_FillRect2SSE;
-                    break;
-                }
-#endif
                 fill_function = SDL_FillRect2;
                 break;
             }
 
         case 3:
-            /* 24-bit RGB is a slow path, at least for now. */
             {
                 fill_function = SDL_FillRect3;
                 break;
@@ -409,12 +444,6 @@ SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
 
         case 4:
             {
-#ifdef __SSE__
-                if (SDL_HasSSE()) {
-                    fill_function = SDL_FillRect4SSE;
-                    break;
-                }
-#endif
                 fill_function = SDL_FillRect4;
                 break;
             }
@@ -422,6 +451,20 @@ SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
         default:
             return SDL_SetError("Unsupported pixel format");
         }
+
+        /* Wide enough rects use the SIMD kernels, which handle every depth */
+#ifdef HAVE_AVX2_INTRINSICS
+        if (hasAVX2()) {
+            simd_function = SDL_FillRectAVX2;
+            stream_function = SDL_FillRectAVX2Stream;
+        }
+#endif
+#ifdef __SSE__
+        if (simd_function == NULL && SDL_HasSSE()) {
+            simd_function = SDL_FillRectSSE;
+            stream_function = SDL_FillRectSSEStream;
+        }
+#endif
     }
 
     for (i = 0; i < count; ++i) {
@@ -433,9 +476,17 @@ SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
         rect = &clipped;
 
         pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch +
-                                         rect->x * dst->format->BytesPerPixel;
+                                         rect->x * bpp;
 
-        fill_function(pixels, dst->pitch, color, rect->w, rect->h);
+        if (simd_function && rect->w * bpp >= SDL_FILLRECT_SIMD_MIN_ROW) {
+            if ((size_t) rect->w * rect->h * bpp >= SDL_FILLRECT_STREAM_MIN) {
+                stream_function(pixels, dst->pitch, color, bpp, rect->w, rect->h);
+            } else {
+                simd_function(pixels, dst->pitch, color, bpp, rect->w, rect->h);
+            }
+        } else {
+            fill_function(pixels, dst->pitch, color, rect->w, rect->h);
+        }
     }
 
     /* We're done! */
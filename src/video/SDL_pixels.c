@@ -990,19 +990,103 @@ Map1toN(SDL_PixelFormat * src, Uint8 Rmod, Uint8 Gmod, Uint8 Bmod, Uint8 Amod,
     return (map);
 }
 
-/* Map from BitField to Dithered-Palette to Palette */
+/* Fill the 32x32x32 inverse color map of a palette, indexed with RGB555_INDEX().
+ *
+ * Each cell gets the color SDL_FindColor() would pick for it at full opacity,
+ * with the 5-bit channels expanded to 8 bits for the comparison. Candidates
+ * are visited in order of their distance in green, so the search stops as
+ * soon as green alone is farther away than the best match so far. Equal
+ * distances go to the lowest index, as they do in SDL_FindColor().
+ */
+static void
+SDL_BuildInverseColormap(const SDL_Palette * pal, Uint8 * map)
+{
+    const Uint8 *expand = SDL_expand_byte[3];
+    int order[256];
+    unsigned int alpha[256];
+    int ncolors = SDL_min(pal->ncolors, 256);
+    int start = 0;
+    int i, j, r, g, b;
+
+    /* Insertion sort by green; it's stable, so indices stay in order */
+    for (i = 0; i < ncolors; ++i) {
+        const int ad = pal->colors[i].a - SDL_ALPHA_OPAQUE;
+        alpha[i] = ad * ad;
+        for (j = i; j > 0 && pal->colors[order[j - 1]].g > pal->colors[i].g; --j) {
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+    }
+
+    for (g = 0; g < 32; ++g) {
+        const int G = expand[g];
+
+        /* The first candidate with green >= G */
+        while (start < ncolors && pal->colors[order[start]].g < G) {
+            ++start;
+        }
+        for (r = 0; r < 32; ++r) {
+            const int R = expand[r];
+            for (b = 0; b < 32; ++b) {
+                const int B = expand[b];
+                unsigned int smallest = ~0u;
+                int pixel = 0;
+
+                for (i = start; i < ncolors; ++i) {
+                    const SDL_Color *c = &pal->colors[order[i]];
+                    const int gd = c->g - G;
+                    unsigned int distance = gd * gd;
+                    if (distance > smallest) {
+                        break;
+                    }
+                    distance += (c->r - R) * (c->r - R) + (c->b - B) * (c->b - B) + alpha[order[i]];
+                    if (distance < smallest || (distance == smallest && order[i] < pixel)) {
+                        smallest = distance;
+                        pixel = order[i];
+                    }
+                }
+                for (i = start - 1; i >= 0; --i) {
+                    const SDL_Color *c = &pal->colors[order[i]];
+                    const int gd = c->g - G;
+                    unsigned int distance = gd * gd;
+                    if (distance > smallest) {
+                        break;
+                    }
+                    distance += (c->r - R) * (c->r - R) + (c->b - B) * (c->b - B) + alpha[order[i]];
+                    if (distance < smallest || (distance == smallest && order[i] < pixel)) {
+                        smallest = distance;
+                        pixel = order[i];
+                    }
+                }
+                map[RGB555_INDEX(R, G, B)] = (Uint8)pixel;
+            }
+        }
+    }
+}
+
+/* Map from BitField to Palette */
 static Uint8 *
 MapNto1(SDL_PixelFormat * src, SDL_PixelFormat * dst, int *identical)
 {
-    /* Generate a 256 color dither palette */
-    SDL_Palette dithered;
     SDL_Color colors[256];
     SDL_Palette *pal = dst->palette;
+    Uint8 *map;
 
-    dithered.ncolors = 256;
+    /* A 3-3-2 palette is indexed directly, without a map */
     SDL_DitherColors(colors, 8);
-    dithered.colors = colors;
-    return (Map1to1(&dithered, pal, identical));
+    if (pal->ncolors >= 256 && SDL_memcmp(colors, pal->colors, sizeof(colors)) == 0) {
+        *identical = 1;
+        return NULL;
+    }
+    *identical = 0;
+
+    map = (Uint8 *) SDL_malloc(RGB555_INDEX(0xFF, 0xFF, 0xFF) + 1);
+    if (map == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    SDL_BuildInverseColormap(pal, map);
+    return map;
 }
 
 SDL_BlitMap *
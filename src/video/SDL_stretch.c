@@ -42,6 +42,25 @@ SDL_SoftStretchLinear(SDL_Surface *src, const SDL_Rect *srcrect,
     return SDL_UpperSoftStretch(src, srcrect, dst, dstrect, SDL_ScaleModeLinear);
 }
 
+SDL_bool
+SDL_IsLinearStretchFormat(Uint32 format)
+{
+    if (SDL_ISPIXELFORMAT_FOURCC(format) || SDL_ISPIXELFORMAT_INDEXED(format)) {
+        return SDL_FALSE;
+    }
+    if (format == SDL_PIXELFORMAT_ARGB2101010) {
+        return SDL_FALSE;
+    }
+    switch (SDL_BYTESPERPIXEL(format)) {
+    case 2:
+    case 3:
+    case 4:
+        return SDL_TRUE;
+    default:
+        return SDL_FALSE;
+    }
+}
+
 static int
 SDL_UpperSoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
                 SDL_Surface * dst, const SDL_Rect * dstrect, SDL_ScaleMode scaleMode)
@@ -57,7 +76,7 @@ SDL_UpperSoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
     }
 
     if (scaleMode != SDL_ScaleModeNearest) {
-        if (src->format->BytesPerPixel != 4 || src->format->format == SDL_PIXELFORMAT_ARGB2101010) {
+        if (!SDL_IsLinearStretchFormat(src->format->format)) {
             return SDL_SetError("Wrong format");
         }
     }
@@ -544,6 +563,130 @@ scale_mat_SSE(const Uint32 *src, int src_w, int src_h, int src_pitch, Uint32 *ds
 }
 #endif
 
+#if defined(HAVE_AVX2_INTRINSICS) && defined(HAVE_SSE2_INTRINSICS)
+#define HAVE_AVX2_STRETCH 1
+
+static SDL_INLINE int
+hasAVX2()
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
+    }
+    val = SDL_HasAVX2();
+    return val;
+}
+
+/* Same arithmetic as scale_mat_SSE(), so the results are identical, but 8 pixels at a time */
+static int SDL_TARGETING("avx2")
+scale_mat_AVX2(const Uint32 *src, int src_w, int src_h, int src_pitch, Uint32 *dst, int dst_w, int dst_h, int dst_pitch)
+{
+    BILINEAR___START
+
+    for (i = 0; i < dst_h; i++) {
+        int nb_block8;
+        __m128i v_frac_h0;
+        __m128i v_frac_h1;
+        __m128i zero;
+        __m256i v256_frac_h0;
+        __m256i v256_frac_h1;
+        __m256i zero256;
+        const __m256i order = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+
+        BILINEAR___HEIGHT
+
+        nb_block8 = middle / 8;
+        middle -= nb_block8 * 8;
+
+        v_frac_h0 = _mm_set1_epi16((short)frac_h0);
+        v_frac_h1 = _mm_set1_epi16((short)frac_h1);
+        zero = _mm_setzero_si128();
+        v256_frac_h0 = _mm256_set1_epi16((short)frac_h0);
+        v256_frac_h1 = _mm256_set1_epi16((short)frac_h1);
+        zero256 = _mm256_setzero_si256();
+
+        while (left_pad_w--) {
+            INTERPOL_BILINEAR_SSE(src_h0, src_h1, FRAC_ZERO, v_frac_h0, v_frac_h1, dst, zero);
+            dst += 1;
+        }
+
+        while (nb_block8--) {
+            __m256i half[2];
+            int k;
+
+            for (k = 0; k < 2; k++) {
+                int index_w[4], frac_w[4], j;
+                __m256i x_0, x_1, k_lo, k_hi, p0, p1, w_lo, w_hi, d_lo, d_hi;
+
+                for (j = 0; j < 4; j++) {
+                    index_w[j] = 4 * SRC_INDEX(fp_sum_w);
+                    frac_w[j] = FRAC(fp_sum_w);
+                    fp_sum_w += fp_step_w;
+                }
+
+                /* Pixel pairs { x0, x1 } of destination pixels 0 and 1 in the low lane, 2 and 3 in the high lane */
+#define LOAD_PAIRS(row) \
+                _mm256_inserti128_si256(_mm256_castsi128_si256( \
+                    _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)((const Uint8 *)row + index_w[0])), \
+                                       _mm_loadl_epi64((const __m128i *)((const Uint8 *)row + index_w[1])))), \
+                    _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)((const Uint8 *)row + index_w[2])), \
+                                       _mm_loadl_epi64((const __m128i *)((const Uint8 *)row + index_w[3]))), 1)
+                x_0 = LOAD_PAIRS(src_h0);
+                x_1 = LOAD_PAIRS(src_h1);
+#undef LOAD_PAIRS
+
+                /* Interpolation vertical, k_lo has pixels 0 and 2, k_hi has 1 and 3 */
+                k_lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(x_0, zero256), v256_frac_h1),
+                                        _mm256_mullo_epi16(_mm256_unpacklo_epi8(x_1, zero256), v256_frac_h0));
+                k_hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(x_0, zero256), v256_frac_h1),
+                                        _mm256_mullo_epi16(_mm256_unpackhi_epi8(x_1, zero256), v256_frac_h0));
+
+                /* Interleave the x0 and x1 channels of each pixel */
+                p0 = _mm256_unpacklo_epi64(k_lo, k_hi);
+                p1 = _mm256_unpackhi_epi64(k_lo, k_hi);
+
+                /* Interpolation horizontal */
+#define FRAC_PAIR(f) (int)(((Uint32)(f) << 16) | (Uint32)(FRAC_ONE - (f)))
+                w_lo = _mm256_setr_epi32(FRAC_PAIR(frac_w[0]), FRAC_PAIR(frac_w[0]), FRAC_PAIR(frac_w[0]), FRAC_PAIR(frac_w[0]),
+                                         FRAC_PAIR(frac_w[2]), FRAC_PAIR(frac_w[2]), FRAC_PAIR(frac_w[2]), FRAC_PAIR(frac_w[2]));
+                w_hi = _mm256_setr_epi32(FRAC_PAIR(frac_w[1]), FRAC_PAIR(frac_w[1]), FRAC_PAIR(frac_w[1]), FRAC_PAIR(frac_w[1]),
+                                         FRAC_PAIR(frac_w[3]), FRAC_PAIR(frac_w[3]), FRAC_PAIR(frac_w[3]), FRAC_PAIR(frac_w[3]));
+#undef FRAC_PAIR
+                d_lo = _mm256_srli_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(p0, p1), w_lo), PRECISION * 2);
+                d_hi = _mm256_srli_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(p0, p1), w_hi), PRECISION * 2);
+
+                /* Pixels 0 and 1 in the low lane, 2 and 3 in the high lane */
+                half[k] = _mm256_packs_epi32(d_lo, d_hi);
+            }
+
+            /* Narrow, and put the pixels back in order */
+            _mm256_storeu_si256((__m256i *)dst, _mm256_permutevar8x32_epi32(_mm256_packus_epi16(half[0], half[1]), order));
+            dst += 8;
+        }
+
+        while (middle--) {
+            int index_w = 4 * SRC_INDEX(fp_sum_w);
+            int frac_w = FRAC(fp_sum_w);
+            const Uint32 *s_00_01 = (const Uint32 *)((const Uint8 *)src_h0 + index_w);
+            const Uint32 *s_10_11 = (const Uint32 *)((const Uint8 *)src_h1 + index_w);
+            fp_sum_w += fp_step_w;
+            INTERPOL_BILINEAR_SSE(s_00_01, s_10_11, frac_w, v_frac_h0, v_frac_h1, dst, zero);
+            dst += 1;
+        }
+
+        while (right_pad_w--) {
+            int index_w = 4 * (src_w - 2);
+            const Uint32 *s_00_01 = (const Uint32 *)((const Uint8 *)src_h0 + index_w);
+            const Uint32 *s_10_11 = (const Uint32 *)((const Uint8 *)src_h1 + index_w);
+            INTERPOL_BILINEAR_SSE(s_00_01, s_10_11, FRAC_ONE, v_frac_h0, v_frac_h1, dst, zero);
+            dst += 1;
+        }
+        dst = (Uint32 *)((Uint8 *)dst + dst_gap);
+    }
+    return 0;
+}
+#endif /* HAVE_AVX2_STRETCH */
+
 #if defined(HAVE_NEON_INTRINSICS)
 
 static SDL_INLINE int
@@ -813,6 +956,245 @@ scale_mat_NEON(const Uint32 *src, int src_w, int src_h, int src_pitch, Uint32 *d
 }
 #endif
 
+/* Separable scaling with precomputed coefficient tables.
+
+   This handles the 16 and 24-bit formats, and downscaling by 2x or more,
+   where bilinear filtering would only sample a few of the source pixels.
+   Along an axis shrinking that much, every destination pixel averages all
+   the source pixels it covers, weighted by how much of each it covers.
+   Along other axes it uses the same two taps as bilinear filtering.
+
+   Rows are filtered horizontally first, and the results are then blended
+   vertically. The horizontal results keep 8 fractional bits.
+ */
+#define AREA_PRECISION  12
+#define AREA_ONE        (1 << AREA_PRECISION)
+
+typedef struct scale_axis_t {
+    int taps;           /* source pixels per destination pixel */
+    int *start;         /* first source pixel, per destination pixel */
+    Uint16 *weights;    /* 'taps' weights per destination pixel, adding up to AREA_ONE */
+} scale_axis_t;
+
+static int
+init_scale_axis(scale_axis_t *axis, int src_nb, int dst_nb)
+{
+    SDL_bool area = (src_nb >= 2 * dst_nb) ? SDL_TRUE : SDL_FALSE;
+    int i, t;
+
+    if (area) {
+        axis->taps = (int)((((Sint64)src_nb << 16) / dst_nb) >> 16) + 2;
+    } else {
+        axis->taps = 2;
+    }
+    axis->taps = SDL_min(axis->taps, src_nb);
+
+    axis->start = (int *)SDL_AllocScratch(dst_nb * sizeof(int));
+    if (!axis->start) {
+        return -1;
+    }
+    axis->weights = (Uint16 *)SDL_AllocScratch((size_t)dst_nb * axis->taps * sizeof(Uint16));
+    if (!axis->weights) {
+        SDL_FreeScratch(axis->start);
+        return -1;
+    }
+    SDL_memset(axis->weights, 0, (size_t)dst_nb * axis->taps * sizeof(Uint16));
+
+    if (area) {
+        for (i = 0; i < dst_nb; i++) {
+            const Sint64 begin = ((Sint64)i * src_nb << 16) / dst_nb;
+            const Sint64 end = ((Sint64)(i + 1) * src_nb << 16) / dst_nb;
+            Uint16 *weights = axis->weights + i * axis->taps;
+            int first = (int)(begin >> 16);
+            int last = (int)((end - 1) >> 16);
+            int total = 0, largest = 0;
+
+            /* Keep all taps inside the source */
+            axis->start[i] = SDL_min(first, src_nb - axis->taps);
+            weights += first - axis->start[i];
+
+            for (t = 0; first + t <= last; t++) {
+                const Sint64 lo = SDL_max(begin, (Sint64)(first + t) << 16);
+                const Sint64 hi = SDL_min(end, (Sint64)(first + t + 1) << 16);
+                weights[t] = (Uint16)(((hi - lo) * AREA_ONE) / (end - begin));
+                total += weights[t];
+                if (weights[t] > weights[largest]) {
+                    largest = t;
+                }
+            }
+            /* Make the weights add up exactly, so flat areas stay flat */
+            weights[largest] += AREA_ONE - total;
+        }
+    } else {
+        int fp_sum, fp_step, left_pad, right_pad;
+
+        get_scaler_datas(src_nb, dst_nb, &fp_sum, &fp_step, &left_pad, &right_pad);
+
+        for (i = 0; i < dst_nb; i++) {
+            Uint16 *weights = axis->weights + i * axis->taps;
+            int index = SRC_INDEX(fp_sum);
+
+            if (axis->taps == 1) {
+                axis->start[i] = 0;
+                weights[0] = AREA_ONE;
+            } else if (fp_sum < 0) {
+                axis->start[i] = 0;
+                weights[0] = AREA_ONE;
+            } else if (index > src_nb - 2) {
+                axis->start[i] = src_nb - 2;
+                weights[1] = AREA_ONE;
+            } else {
+                const int frac = (fp_sum & 0xFFFF) >> (16 - AREA_PRECISION);
+                axis->start[i] = index;
+                weights[0] = AREA_ONE - frac;
+                weights[1] = frac;
+            }
+            fp_sum += fp_step;
+        }
+    }
+    return 0;
+}
+
+static void
+quit_scale_axis(scale_axis_t *axis)
+{
+    SDL_FreeScratch(axis->weights);
+    SDL_FreeScratch(axis->start);
+}
+
+static SDL_INLINE void
+scale_row_horizontal(const Uint8 *src, const int nch, const scale_axis_t *axis, int dst_w, Uint32 *dst)
+{
+    int x, t, c;
+
+    for (x = 0; x < dst_w; x++) {
+        const Uint8 *s = src + axis->start[x] * nch;
+        const Uint16 *w = axis->weights + x * axis->taps;
+        Uint32 sum[4] = { 0, 0, 0, 0 };
+
+        for (t = 0; t < axis->taps; t++) {
+            for (c = 0; c < nch; c++) {
+                sum[c] += s[c] * w[t];
+            }
+            s += nch;
+        }
+        for (c = 0; c < nch; c++) {
+            *dst++ = (sum[c] + (1 << 3)) >> (AREA_PRECISION - 8);
+        }
+    }
+}
+
+static int
+scale_mat_separable(SDL_Surface *s, const SDL_Rect *srcrect, SDL_Surface *d, const SDL_Rect *dstrect)
+{
+    const SDL_PixelFormat *fmt = s->format;
+    const int bpp = fmt->BytesPerPixel;
+    const int nch = (bpp == 2) ? 4 : bpp;   /* 16-bit pixels get unpacked into 4 channels */
+    const int src_w = srcrect->w;
+    const int dst_w = dstrect->w;
+    const int dst_h = dstrect->h;
+    const int row_size = dst_w * nch;
+    const Uint8 *src = (const Uint8 *)s->pixels + srcrect->x * bpp + srcrect->y * s->pitch;
+    Uint8 *dst = (Uint8 *)d->pixels + dstrect->x * bpp + dstrect->y * d->pitch;
+    scale_axis_t axis_w, axis_h;
+    Uint32 *rows, *acc;
+    Uint8 *unpacked = NULL;
+    int cached[2] = { -1, -1 };
+    int x, y, t, k;
+
+    if (init_scale_axis(&axis_w, src_w, dst_w) < 0) {
+        return SDL_OutOfMemory();
+    }
+    if (init_scale_axis(&axis_h, srcrect->h, dst_h) < 0) {
+        quit_scale_axis(&axis_w);
+        return SDL_OutOfMemory();
+    }
+
+    /* Two horizontally scaled rows, indexed by source row parity, and the vertical sums */
+    rows = (Uint32 *)SDL_AllocScratch(3 * (size_t)row_size * sizeof(Uint32));
+    if (rows && bpp == 2) {
+        unpacked = (Uint8 *)SDL_AllocScratch((size_t)src_w * 4);
+    }
+    if (!rows || (bpp == 2 && !unpacked)) {
+        SDL_FreeScratch(rows);
+        quit_scale_axis(&axis_h);
+        quit_scale_axis(&axis_w);
+        return SDL_OutOfMemory();
+    }
+    acc = rows + 2 * row_size;
+
+    for (y = 0; y < dst_h; y++) {
+        const Uint16 *weights = axis_h.weights + y * axis_h.taps;
+
+        SDL_memset(acc, 0, row_size * sizeof(Uint32));
+
+        for (t = 0; t < axis_h.taps; t++) {
+            const int index = axis_h.start[y] + t;
+            Uint32 *row = rows + (index & 1) * row_size;
+            const Uint32 w = weights[t];
+
+            if (w == 0) {
+                continue;
+            }
+
+            if (cached[index & 1] != index) {
+                const Uint8 *src_row = src + index * s->pitch;
+
+                if (bpp == 2) {
+                    const Uint16 *p = (const Uint16 *)src_row;
+                    Uint8 *u = unpacked;
+                    for (x = 0; x < src_w; x++) {
+                        const Uint32 pixel = p[x];
+                        *u++ = (Uint8)((pixel & fmt->Rmask) >> fmt->Rshift);
+                        *u++ = (Uint8)((pixel & fmt->Gmask) >> fmt->Gshift);
+                        *u++ = (Uint8)((pixel & fmt->Bmask) >> fmt->Bshift);
+                        *u++ = (Uint8)((pixel & fmt->Amask) >> fmt->Ashift);
+                    }
+                    src_row = unpacked;
+                }
+
+                /* Constant channel counts, so the inner loop gets unrolled */
+                if (nch == 4) {
+                    scale_row_horizontal(src_row, 4, &axis_w, dst_w, row);
+                } else {
+                    scale_row_horizontal(src_row, 3, &axis_w, dst_w, row);
+                }
+                cached[index & 1] = index;
+            }
+
+            for (k = 0; k < row_size; k++) {
+                acc[k] += row[k] * w;
+            }
+        }
+
+        /* Round back to 8 bits, or to the channel size for 16-bit formats */
+#define AREA_RESULT(v) (((v) + (1 << (AREA_PRECISION + 7))) >> (AREA_PRECISION + 8))
+        if (bpp == 2) {
+            Uint16 *p = (Uint16 *)dst;
+            const Uint32 *a = acc;
+            for (x = 0; x < dst_w; x++) {
+                p[x] = (Uint16)(((AREA_RESULT(a[0]) << fmt->Rshift) & fmt->Rmask) |
+                                ((AREA_RESULT(a[1]) << fmt->Gshift) & fmt->Gmask) |
+                                ((AREA_RESULT(a[2]) << fmt->Bshift) & fmt->Bmask) |
+                                ((AREA_RESULT(a[3]) << fmt->Ashift) & fmt->Amask));
+                a += 4;
+            }
+        } else {
+            for (k = 0; k < row_size; k++) {
+                dst[k] = (Uint8)AREA_RESULT(acc[k]);
+            }
+        }
+#undef AREA_RESULT
+        dst += d->pitch;
+    }
+
+    SDL_FreeScratch(unpacked);
+    SDL_FreeScratch(rows);
+    quit_scale_axis(&axis_h);
+    quit_scale_axis(&axis_w);
+    return 0;
+}
+
 int
 SDL_LowerSoftStretchLinear(SDL_Surface *s, const SDL_Rect *srcrect,
                 SDL_Surface *d, const SDL_Rect *dstrect)
@@ -827,12 +1209,22 @@ SDL_LowerSoftStretchLinear(SDL_Surface *s, const SDL_Rect *srcrect,
     Uint32 *src = (Uint32 *) ((Uint8 *)s->pixels + srcrect->x * 4 + srcrect->y * src_pitch);
     Uint32 *dst = (Uint32 *) ((Uint8 *)d->pixels + dstrect->x * 4 + dstrect->y * dst_pitch);
 
+    if (s->format->BytesPerPixel != 4 || src_w >= 2 * dst_w || src_h >= 2 * dst_h) {
+        return scale_mat_separable(s, srcrect, d, dstrect);
+    }
+
 #if defined(HAVE_NEON_INTRINSICS)
     if (ret == -1 && hasNEON()) {
         ret = scale_mat_NEON(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
     }
 #endif
 
+#if defined(HAVE_AVX2_STRETCH)
+    if (ret == -1 && hasAVX2()) {
+        ret = scale_mat_AVX2(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
+    }
+#endif
+
 #if defined(HAVE_SSE2_INTRINSICS)
     if (ret == -1 && hasSSE2()) {
         ret = scale_mat_SSE(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
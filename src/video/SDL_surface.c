@@ -677,20 +677,8 @@ SDL_GetClipRect(SDL_Surface * surface, SDL_Rect * rect)
     }
 }
 
-/*
- * Set up a blit between two surfaces -- split into three parts:
- * The upper part, SDL_UpperBlit(), performs clipping and rectangle
- * verification.  The lower part is a pointer to a low level
- * accelerated blitting function.
- *
- * These parts are separated out and each used internally by this
- * library in the optimimum places.  They are exported so that if
- * you know exactly what you are doing, you can optimize your code
- * by calling the one(s) you need.
- */
-int
-SDL_LowerBlit(SDL_Surface * src, SDL_Rect * srcrect,
-              SDL_Surface * dst, SDL_Rect * dstrect)
+static int
+SDL_ValidateMap(SDL_Surface * src, SDL_Surface * dst)
 {
     /* Check to make sure the blit mapping is valid */
     if ((src->map->dst != dst) ||
@@ -707,9 +695,44 @@ SDL_LowerBlit(SDL_Surface * src, SDL_Rect * srcrect,
 /*              src, dst->flags, src->map->info.flags, dst, dst->flags, */
 /*              dst->map->info.flags, src->map->blit); */
     }
+    return 0;
+}
+
+/*
+ * Set up a blit between two surfaces -- split into three parts:
+ * The upper part, SDL_UpperBlit(), performs clipping and rectangle
+ * verification.  The lower part is a pointer to a low level
+ * accelerated blitting function.
+ *
+ * These parts are separated out and each used internally by this
+ * library in the optimimum places.  They are exported so that if
+ * you know exactly what you are doing, you can optimize your code
+ * by calling the one(s) you need.
+ */
+int
+SDL_LowerBlit(SDL_Surface * src, SDL_Rect * srcrect,
+              SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    if (SDL_ValidateMap(src, dst) < 0) {
+        return (-1);
+    }
     return (src->map->blit(src, srcrect, dst, dstrect));
 }
 
+/*
+ * Like SDL_LowerBlit(), for the whole-surface blits that convert pixels.
+ * Large ones are split across threads if SDL_HINT_SURFACE_CONVERT_THREADS
+ * asks for it.
+ */
+static int
+SDL_LowerBlitConvert(SDL_Surface * src, SDL_Rect * rect, SDL_Surface * dst)
+{
+    if (SDL_ValidateMap(src, dst) < 0) {
+        return (-1);
+    }
+    return SDL_SoftBlitBands(src, rect, dst, rect);
+}
+
 
 int
 SDL_UpperBlit(SDL_Surface * src, const SDL_Rect * srcrect,
@@ -1019,9 +1042,7 @@ SDL_PrivateLowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
     } else {
         if ( !(src->map->info.flags & complex_copy_flags) &&
              src->format->format == dst->format->format &&
-             !SDL_ISPIXELFORMAT_INDEXED(src->format->format) &&
-             src->format->BytesPerPixel == 4 &&
-             src->format->format != SDL_PIXELFORMAT_ARGB2101010) {
+             SDL_IsLinearStretchFormat(src->format->format)) {
             /* fast path */
             return SDL_SoftStretchLinear(src, srcrect, dst, dstrect);
         } else {
@@ -1046,15 +1067,18 @@ SDL_PrivateLowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
             srcrect2.w = srcrect->w;
             srcrect2.h = srcrect->h;
 
-            /* Change source format if not appropriate for scaling */
-            if (src->format->BytesPerPixel != 4 || src->format->format == SDL_PIXELFORMAT_ARGB2101010) {
+            /* Change source format if not appropriate for scaling, or if going
+               to a 32-bit destination anyway, where scaling keeps more precision */
+            if (!SDL_IsLinearStretchFormat(src->format->format) ||
+                (src->format->BytesPerPixel != 4 &&
+                 dst->format->BytesPerPixel == 4 && SDL_IsLinearStretchFormat(dst->format->format))) {
                 SDL_Rect tmprect;
                 int fmt;
                 tmprect.x = 0;
                 tmprect.y = 0;
                 tmprect.w = src->w;
                 tmprect.h = src->h;
-                if (dst->format->BytesPerPixel == 4 && dst->format->format != SDL_PIXELFORMAT_ARGB2101010) {
+                if (dst->format->BytesPerPixel == 4 && SDL_IsLinearStretchFormat(dst->format->format)) {
                     fmt = dst->format->format;
                 } else {
                     fmt = SDL_PIXELFORMAT_ARGB8888;
@@ -1267,7 +1291,7 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
         }
     }
 
-    ret = SDL_LowerBlit(surface, &bounds, convert, &bounds);
+    ret = SDL_LowerBlitConvert(surface, &bounds, convert);
 
     /* Restore colorkey alpha value */
     if (palette_ck_transform) {
@@ -1510,7 +1534,7 @@ int SDL_ConvertPixels(int width, int height,
     rect.y = 0;
     rect.w = width;
     rect.h = height;
-    ret = SDL_LowerBlit(&src_surface, &rect, &dst_surface, &rect);
+    ret = SDL_LowerBlitConvert(&src_surface, &rect, &dst_surface);
 
     /* Free blitmap reference, after blitting between stack'ed surfaces */
     SDL_InvalidateMap(src_surface.map);
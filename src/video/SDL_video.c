@@ -28,6 +28,7 @@
 #include "SDL_blit.h"
 #include "SDL_pixels_c.h"
 #include "SDL_rect_c.h"
+#include "SDL_damage_c.h"
 #include "../events/SDL_events_c.h"
 #include "../timer/SDL_timer_c.h"
 
@@ -311,6 +312,17 @@ SDL_CreateWindowTexture(SDL_VideoDevice *_this, SDL_Window * window, Uint32 * fo
 static SDL_VideoDevice *_this = NULL;
 static SDL_atomic_t SDL_messagebox_count;
 
+static int
+SDL_PresentWindowTexture(SDL_WindowTextureData *data)
+{
+    if (SDL_RenderCopy(data->renderer, data->texture, NULL, NULL) < 0) {
+        return -1;
+    }
+
+    SDL_RenderPresent(data->renderer);
+    return 0;
+}
+
 static int
 SDL_UpdateWindowTexture(SDL_VideoDevice *unused, SDL_Window * window, const SDL_Rect * rects, int numrects)
 {
@@ -323,20 +335,43 @@ SDL_UpdateWindowTexture(SDL_VideoDevice *unused, SDL_Window * window, const SDL_
         return SDL_SetError("No window texture data");
     }
 
-    /* Update a single rect that contains subrects for best DMA performance */
+    /* Update a single rect that contains subrects for best DMA performance,
+       unless the subrects only cover a small part of it. */
     if (SDL_GetSpanEnclosingRect(window->w, window->h, numrects, rects, &rect)) {
-        src = (void *)((Uint8 *)data->pixels +
-                        rect.y * data->pitch +
-                        rect.x * data->bytes_per_pixel);
-        if (SDL_UpdateTexture(data->texture, &rect, src, data->pitch) < 0) {
-            return -1;
+        SDL_Rect bounds, clipped;
+        int i, area = 0;
+
+        bounds.x = 0;
+        bounds.y = 0;
+        bounds.w = window->w;
+        bounds.h = window->h;
+        for (i = 0; i < numrects; ++i) {
+            if (SDL_IntersectRect(&rects[i], &bounds, &clipped)) {
+                area += clipped.w * clipped.h;
+            }
         }
 
-        if (SDL_RenderCopy(data->renderer, data->texture, NULL, NULL) < 0) {
-            return -1;
+        if ((numrects > 1) && (area < ((rect.w * rect.h) / 2))) {
+            for (i = 0; i < numrects; ++i) {
+                if (SDL_IntersectRect(&rects[i], &bounds, &clipped)) {
+                    src = (void *)((Uint8 *)data->pixels +
+                                    clipped.y * data->pitch +
+                                    clipped.x * data->bytes_per_pixel);
+                    if (SDL_UpdateTexture(data->texture, &clipped, src, data->pitch) < 0) {
+                        return -1;
+                    }
+                }
+            }
+        } else {
+            src = (void *)((Uint8 *)data->pixels +
+                            rect.y * data->pitch +
+                            rect.x * data->bytes_per_pixel);
+            if (SDL_UpdateTexture(data->texture, &rect, src, data->pitch) < 0) {
+                return -1;
+            }
         }
 
-        SDL_RenderPresent(data->renderer);
+        return SDL_PresentWindowTexture(data);
     }
     return 0;
 }
@@ -2682,6 +2717,8 @@ SDL_GetWindowSurface(SDL_Window * window)
             window->surface_valid = SDL_TRUE;
             window->surface->flags |= SDL_DONTFREE;
         }
+        /* whatever was pushed before is gone with the old framebuffer */
+        SDL_ResetDamageTracker(window->surface_damage);
     }
     return window->surface;
 }
@@ -2693,6 +2730,32 @@ SDL_UpdateWindowSurface(SDL_Window * window)
 
     CHECK_WINDOW_MAGIC(window, -1);
 
+    /* See if we can get away with only pushing what changed */
+    if (window->surface_valid &&
+        SDL_GetHintBoolean(SDL_HINT_FRAMEBUFFER_DAMAGE_TRACKING, SDL_FALSE)) {
+        const SDL_Rect *rects;
+        int numrects = -1;
+
+        if (!window->surface_damage) {
+            window->surface_damage = SDL_CreateDamageTracker();
+        }
+        if (window->surface_damage) {
+            numrects = SDL_GetSurfaceDamage(window->surface_damage, window->surface, &rects);
+        }
+        if (numrects == 0 && _this->UpdateWindowFramebuffer == SDL_UpdateWindowTexture) {
+            /* Nothing changed, but apps may be pacing themselves on the present */
+            SDL_WindowTextureData *data = SDL_GetWindowData(window, SDL_WINDOWTEXTUREDATA);
+            if (!data || !data->texture) {
+                return SDL_SetError("No window texture data");
+            }
+            return SDL_PresentWindowTexture(data);
+        } else if (numrects >= 0) {
+            /* Native framebuffers present without any rects when nothing changed */
+            SDL_assert(_this->checked_texture_framebuffer);
+            return _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
+        }
+    }
+
     full_rect.x = 0;
     full_rect.y = 0;
     full_rect.w = window->w;
@@ -2712,6 +2775,9 @@ SDL_UpdateWindowSurfaceRects(SDL_Window * window, const SDL_Rect * rects,
 
     SDL_assert(_this->checked_texture_framebuffer); /* we should have done this before we had a valid surface. */
 
+    /* The tracked frame may no longer be what's on screen */
+    SDL_ResetDamageTracker(window->surface_damage);
+
     return _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
 }
 
@@ -3083,6 +3149,13 @@ SDL_OnWindowMoved(SDL_Window * window)
     }
 }
 
+void
+SDL_OnWindowExposed(SDL_Window * window)
+{
+    /* The window contents need to be pushed again in full */
+    SDL_ResetDamageTracker(window->surface_damage);
+}
+
 void
 SDL_OnWindowMinimized(SDL_Window * window)
 {
@@ -3272,6 +3345,7 @@ SDL_DestroyWindow(SDL_Window * window)
     SDL_free(window->title);
     SDL_FreeSurface(window->icon);
     SDL_free(window->gamma);
+    SDL_DestroyDamageTracker(window->surface_damage);
     while (window->data) {
         SDL_WindowUserData *data = window->data;
 
@@ -24,6 +24,8 @@
 #include "SDL_video.h"
 #include "SDL_pixels_c.h"
 #include "SDL_yuv_c.h"
+#include "SDL_blit.h"
+#include "../SDL_parallel_c.h"
 
 #include "yuv2rgb/yuv_rgb.h"
 
@@ -435,6 +437,60 @@ static SDL_bool yuv_rgb_std(
     return SDL_FALSE;
 }
 
+static SDL_bool yuv_rgb(
+    Uint32 src_format, Uint32 dst_format,
+    Uint32 width, Uint32 height,
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride,
+    Uint8 *rgb, Uint32 rgb_stride,
+    YCbCrType yuv_type)
+{
+    return (yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type) ||
+            yuv_rgb_lsx(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type) ||
+            yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type));
+}
+
+/* A YUV to RGB conversion split into bands of rows. Bands start on even
+   rows, so 4:2:0 formats never share a chroma row between two bands. */
+typedef struct
+{
+    Uint32 src_format;
+    Uint32 dst_format;
+    Uint32 width;
+    Uint32 height;
+    const Uint8 *y;
+    const Uint8 *u;
+    const Uint8 *v;
+    Uint32 y_stride;
+    Uint32 uv_stride;
+    Uint8 *rgb;
+    Uint32 rgb_stride;
+    YCbCrType yuv_type;
+    Uint32 rows;
+    SDL_bool converted;
+} YUVToRGBBands;
+
+static void yuv_rgb_band(void *data, int index)
+{
+    YUVToRGBBands *bands = (YUVToRGBBands *)data;
+    const Uint32 row = index * bands->rows;
+    const Uint32 uv_row = IsPlanar2x2Format(bands->src_format) ? row / 2 : row;
+    SDL_bool converted;
+
+    converted = yuv_rgb(bands->src_format, bands->dst_format,
+                        bands->width, SDL_min(bands->rows, bands->height - row),
+                        bands->y + row * bands->y_stride,
+                        bands->u + uv_row * bands->uv_stride,
+                        bands->v + uv_row * bands->uv_stride,
+                        bands->y_stride, bands->uv_stride,
+                        bands->rgb + row * bands->rgb_stride, bands->rgb_stride,
+                        bands->yuv_type);
+
+    /* Every band has a fast path or none does */
+    if (index == 0) {
+        bands->converted = converted;
+    }
+}
+
 int
 SDL_ConvertPixels_YUV_to_RGB(int width, int height,
          Uint32 src_format, const void *src, int src_pitch,
@@ -446,6 +502,7 @@ SDL_ConvertPixels_YUV_to_RGB(int width, int height,
     Uint32 y_stride = 0;
     Uint32 uv_stride = 0;
     YCbCrType yuv_type = YCBCR_601;
+    int bands, threads, rows;
 
     if (GetYUVPlanes(width, height, src_format, src, src_pitch, &y, &u, &v, &y_stride, &uv_stride) < 0) {
         return -1;
@@ -455,15 +512,36 @@ SDL_ConvertPixels_YUV_to_RGB(int width, int height,
         return -1;
     }
 
-    if (yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8*)dst, dst_pitch, yuv_type)) {
-        return 0;
-    }
-
-    if (yuv_rgb_lsx(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8*)dst, dst_pitch, yuv_type)) {
-        return 0;
+    /* The SSE code converts the last row of packed 4:2:2 images with the C
+       code, which rounds differently, so splitting them would change the
+       result depending on the number of threads. */
+    if (IsPacked4Format(src_format)) {
+        bands = 1;
+    } else {
+        bands = SDL_GetConvertBands(width, height, 2, &threads, &rows);
     }
-
-    if (yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8*)dst, dst_pitch, yuv_type)) {
+    if (bands > 1) {
+        YUVToRGBBands job;
+
+        job.src_format = src_format;
+        job.dst_format = dst_format;
+        job.width = width;
+        job.height = height;
+        job.y = y;
+        job.u = u;
+        job.v = v;
+        job.y_stride = y_stride;
+        job.uv_stride = uv_stride;
+        job.rgb = (Uint8 *)dst;
+        job.rgb_stride = dst_pitch;
+        job.yuv_type = yuv_type;
+        job.rows = rows;
+        job.converted = SDL_FALSE;
+        SDL_ParallelFor(bands, threads, yuv_rgb_band, &job);
+        if (job.converted) {
+            return 0;
+        }
+    } else if (yuv_rgb(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8*)dst, dst_pitch, yuv_type)) {
         return 0;
     }
 
@@ -473,7 +551,7 @@ SDL_ConvertPixels_YUV_to_RGB(int width, int height,
         void *tmp;
         int tmp_pitch = (width * sizeof(Uint32));
 
-        tmp = SDL_malloc(tmp_pitch * height);
+        tmp = SDL_AllocScratch(tmp_pitch * height);
         if (tmp == NULL) {
             return SDL_OutOfMemory();
         }
@@ -481,13 +559,13 @@ SDL_ConvertPixels_YUV_to_RGB(int width, int height,
         /* convert src/src_format to tmp/ARGB8888 */
         ret = SDL_ConvertPixels_YUV_to_RGB(width, height, src_format, src, src_pitch, SDL_PIXELFORMAT_ARGB8888, tmp, tmp_pitch);
         if (ret < 0) {
-            SDL_free(tmp);
+            SDL_FreeScratch(tmp);
             return ret;
         }
 
         /* convert tmp/ARGB8888 to dst/RGB */
         ret = SDL_ConvertPixels(width, height, SDL_PIXELFORMAT_ARGB8888, tmp, tmp_pitch, dst_format, dst, dst_pitch);
-        SDL_free(tmp);
+        SDL_FreeScratch(tmp);
         return ret;
     }
 
@@ -502,12 +580,14 @@ struct RGB2YUVFactors
     float v[3]; /* Rfactor, Gfactor, Bfactor */
 };
 
-static int
-SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch)
+/* Convert rows [row, row + rows) of a width x height image. row is even, so
+   the rows map to whole rows of the 4:2:0 chroma planes. */
+static void
+SDL_ConvertPixels_ARGB8888_to_YUV_Rows(int width, int height, int row, int rows, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch)
 {
     const int src_pitch_x_2    = src_pitch * 2;
-    const int height_half      = height / 2;
-    const int height_remainder = (height & 0x1);
+    const int height_half      = rows / 2;
+    const int height_remainder = (rows & 0x1);
     const int width_half       = width / 2;
     const int width_remainder  = (width & 0x1);
     int i, j;
@@ -604,13 +684,16 @@ SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int sr
             GetYUVPlanes(width, height, dst_format, dst, dst_pitch,
                          (const Uint8 **)&plane_y, (const Uint8 **)&plane_u, (const Uint8 **)&plane_v,
                          &y_stride, &uv_stride);
-            plane_interleaved_uv = (plane_y + height * y_stride);
+            plane_interleaved_uv = (plane_y + height * y_stride) + (row / 2) * uv_stride;
+            plane_y += row * y_stride;
+            plane_u += (row / 2) * uv_stride;
+            plane_v += (row / 2) * uv_stride;
             y_skip = (y_stride - width);
 
-            curr_row = (const Uint8*)src;
+            curr_row = (const Uint8*)src + row * src_pitch;
 
             /* Write Y plane */
-            for (j = 0; j < height; j++) {
+            for (j = 0; j < rows; j++) {
                 for (i = 0; i < width; i++) {
                     const Uint32 p1 = ((const Uint32 *)curr_row)[i];
                     const Uint32 r = (p1 & 0x00ff0000) >> 16;
@@ -622,9 +705,8 @@ SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int sr
                 curr_row += src_pitch;
             }
 
-            curr_row = (const Uint8*)src;
-            next_row = (const Uint8*)src;
-            next_row += src_pitch;
+            curr_row = (const Uint8*)src + row * src_pitch;
+            next_row = curr_row + src_pitch;
 
             if (dst_format == SDL_PIXELFORMAT_YV12 || dst_format == SDL_PIXELFORMAT_IYUV)
             {
@@ -730,20 +812,15 @@ SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int sr
     case SDL_PIXELFORMAT_UYVY:
     case SDL_PIXELFORMAT_YVYU:
         {
-            const Uint8 *curr_row = (const Uint8*) src;
-            Uint8 *plane           = (Uint8*) dst;
+            const Uint8 *curr_row = (const Uint8*) src + row * src_pitch;
+            Uint8 *plane           = (Uint8*) dst + row * dst_pitch;
             const int row_size = (4 * ((width + 1) / 2));
-            int plane_skip;
-
-            if (dst_pitch < row_size) {
-                return SDL_SetError("Destination pitch is too small, expected at least %d\n", row_size);
-            }
-            plane_skip = (dst_pitch - row_size);
+            const int plane_skip = (dst_pitch - row_size);
 
             /* Write YUV plane, packed */
             if (dst_format == SDL_PIXELFORMAT_YUY2) 
             {
-                for (j = 0; j < height; j++) {
+                for (j = 0; j < rows; j++) {
                     for (i = 0; i < width_half; i++) {
                         READ_TWO_RGB_PIXELS;
                         /* Y U Y1 V */
@@ -766,7 +843,7 @@ SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int sr
             } 
             else if (dst_format == SDL_PIXELFORMAT_UYVY)
             {
-                for (j = 0; j < height; j++) {
+                for (j = 0; j < rows; j++) {
                     for (i = 0; i < width_half; i++) {
                         READ_TWO_RGB_PIXELS;
                         /* U Y V Y1 */
@@ -789,7 +866,7 @@ SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int sr
             }
             else if (dst_format == SDL_PIXELFORMAT_YVYU)
             {
-                for (j = 0; j < height; j++) {
+                for (j = 0; j < rows; j++) {
                     for (i = 0; i < width_half; i++) {
                         READ_TWO_RGB_PIXELS;
                         /* Y V Y1 U */
@@ -814,7 +891,7 @@ SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int sr
         break;
 
     default:
-        return SDL_SetError("Unsupported YUV destination format: %s", SDL_GetPixelFormatName(dst_format));
+        break;
     }
 #undef MAKE_Y
 #undef MAKE_U
@@ -825,6 +902,74 @@ SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int sr
 #undef READ_1x1_PIXEL
 #undef READ_TWO_RGB_PIXELS
 #undef READ_ONE_RGB_PIXEL
+}
+
+typedef struct
+{
+    int width;
+    int height;
+    const void *src;
+    int src_pitch;
+    Uint32 dst_format;
+    void *dst;
+    int dst_pitch;
+    int rows;
+} ARGB8888ToYUVBands;
+
+static void
+SDL_ConvertPixels_ARGB8888_to_YUV_Band(void *data, int index)
+{
+    const ARGB8888ToYUVBands *bands = (const ARGB8888ToYUVBands *)data;
+    const int row = index * bands->rows;
+
+    SDL_ConvertPixels_ARGB8888_to_YUV_Rows(bands->width, bands->height, row, SDL_min(bands->rows, bands->height - row),
+                                           bands->src, bands->src_pitch, bands->dst_format, bands->dst, bands->dst_pitch);
+}
+
+static int
+SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch)
+{
+    int bands, threads, rows;
+
+    switch (dst_format)
+    {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        break;
+
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+        {
+            const int row_size = (4 * ((width + 1) / 2));
+            if (dst_pitch < row_size) {
+                return SDL_SetError("Destination pitch is too small, expected at least %d\n", row_size);
+            }
+        }
+        break;
+
+    default:
+        return SDL_SetError("Unsupported YUV destination format: %s", SDL_GetPixelFormatName(dst_format));
+    }
+
+    bands = SDL_GetConvertBands(width, height, 2, &threads, &rows);
+    if (bands > 1) {
+        ARGB8888ToYUVBands job;
+
+        job.width = width;
+        job.height = height;
+        job.src = src;
+        job.src_pitch = src_pitch;
+        job.dst_format = dst_format;
+        job.dst = dst;
+        job.dst_pitch = dst_pitch;
+        job.rows = rows;
+        SDL_ParallelFor(bands, threads, SDL_ConvertPixels_ARGB8888_to_YUV_Band, &job);
+    } else {
+        SDL_ConvertPixels_ARGB8888_to_YUV_Rows(width, height, 0, height, src, src_pitch, dst_format, dst, dst_pitch);
+    }
     return 0;
 }
 
@@ -867,7 +1012,7 @@ SDL_ConvertPixels_RGB_to_YUV(int width, int height,
         void *tmp;
         int tmp_pitch = (width * sizeof(Uint32));
 
-        tmp = SDL_malloc(tmp_pitch * height);
+        tmp = SDL_AllocScratch(tmp_pitch * height);
         if (tmp == NULL) {
             return SDL_OutOfMemory();
         }
@@ -875,13 +1020,13 @@ SDL_ConvertPixels_RGB_to_YUV(int width, int height,
         /* convert src/src_format to tmp/ARGB8888 */
         ret = SDL_ConvertPixels(width, height, src_format, src, src_pitch, SDL_PIXELFORMAT_ARGB8888, tmp, tmp_pitch);
         if (ret == -1) {
-            SDL_free(tmp);
+            SDL_FreeScratch(tmp);
             return ret;
         }
 
         /* convert tmp/ARGB8888 to dst/FOURCC */
         ret = SDL_ConvertPixels_ARGB8888_to_YUV(width, height, tmp, tmp_pitch, dst_format, dst, dst_pitch);
-        SDL_free(tmp);
+        SDL_FreeScratch(tmp);
         return ret;
     }
 }
@@ -958,7 +1103,7 @@ SDL_ConvertPixels_SwapUVPlanes(int width, int height, const void *src, int src_p
         Uint8 *row2 = (Uint8 *)dst + UVheight * UVpitch;
 
         /* Allocate a temporary row for the swap */
-        tmp = (Uint8 *)SDL_malloc(UVwidth);
+        tmp = (Uint8 *)SDL_AllocScratch(UVwidth);
         if (!tmp) {
             return SDL_OutOfMemory();
         }
@@ -969,7 +1114,7 @@ SDL_ConvertPixels_SwapUVPlanes(int width, int height, const void *src, int src_p
             row1 += UVpitch;
             row2 += UVpitch;
         }
-        SDL_free(tmp);
+        SDL_FreeScratch(tmp);
     } else {
         const Uint8 *srcUV;
         Uint8 *dstUV;
@@ -1019,7 +1164,7 @@ SDL_ConvertPixels_PackUVPlanes_to_NV(int width, int height, const void *src, int
 
     if (src == dst) {
         /* Need to make a copy of the buffer so we don't clobber it while converting */
-        tmp = (Uint8 *)SDL_malloc(2*UVheight*srcUVPitch);
+        tmp = (Uint8 *)SDL_AllocScratch(2*UVheight*srcUVPitch);
         if (!tmp) {
             return SDL_OutOfMemory();
         }
@@ -1065,7 +1210,7 @@ SDL_ConvertPixels_PackUVPlanes_to_NV(int width, int height, const void *src, int
     }
 
     if (tmp) {
-        SDL_free(tmp);
+        SDL_FreeScratch(tmp);
     }
     return 0;
 }
@@ -1093,7 +1238,7 @@ SDL_ConvertPixels_SplitNV_to_UVPlanes(int width, int height, const void *src, in
 
     if (src == dst) {
         /* Need to make a copy of the buffer so we don't clobber it while converting */
-        tmp = (Uint8 *)SDL_malloc(UVheight*srcUVPitch);
+        tmp = (Uint8 *)SDL_AllocScratch(UVheight*srcUVPitch);
         if (!tmp) {
             return SDL_OutOfMemory();
         }
@@ -1144,7 +1289,7 @@ SDL_ConvertPixels_SplitNV_to_UVPlanes(int width, int height, const void *src, in
     }
 
     if (tmp) {
-        SDL_free(tmp);
+        SDL_FreeScratch(tmp);
     }
     return 0;
 }
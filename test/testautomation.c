@@ -37,6 +37,14 @@ main(int argc, char *argv[])
     Uint64 userExecKey = 0;
     char *userRunSeed = NULL;
     char *filter = NULL;
+    int benchmark = 0;
+    int benchWarmup = -1;
+    int benchRuns = -1;
+    char *benchOutput = NULL;
+    int benchFormat = SDLTEST_BENCHMARK_OUTPUT_CSV;
+    int parallel = 0;
+    char **workerArgv = NULL;
+    int workerArgc = 0;
     int i, done;
     SDL_Event event;
 
@@ -46,9 +54,18 @@ main(int argc, char *argv[])
         return 1;
     }
 
+    /* Worker processes get the same command line, minus the options the harness passes itself */
+    workerArgv = (char **)SDL_calloc(argc + 1, sizeof(*workerArgv));
+    if (!workerArgv) {
+        SDL_OutOfMemory();
+        quit(1);
+    }
+    workerArgv[workerArgc++] = argv[0];
+
     /* Parse commandline */
     for (i = 1; i < argc;) {
         int consumed;
+        SDL_bool forWorkers = SDL_TRUE;
 
         consumed = SDLTest_CommonArg(state, i);
         if (consumed == 0) {
@@ -69,25 +86,93 @@ main(int argc, char *argv[])
             else if (SDL_strcasecmp(argv[i], "--seed") == 0) {
                 if (argv[i + 1]) {
                     userRunSeed = SDL_strdup(argv[i + 1]);
+                    forWorkers = SDL_FALSE;
                     consumed = 2;
                 }
             }
             else if (SDL_strcasecmp(argv[i], "--filter") == 0) {
                 if (argv[i + 1]) {
                     filter = SDL_strdup(argv[i + 1]);
+                    forWorkers = SDL_FALSE;
+                    consumed = 2;
+                }
+            }
+            else if (SDL_strcasecmp(argv[i], "--benchmark") == 0) {
+                benchmark = 1;
+                consumed = 1;
+            }
+            else if (SDL_strcasecmp(argv[i], "--bench-warmup") == 0) {
+                if (argv[i + 1]) {
+                    benchWarmup = SDL_atoi(argv[i + 1]);
+                    consumed = 2;
+                }
+            }
+            else if (SDL_strcasecmp(argv[i], "--bench-runs") == 0) {
+                if (argv[i + 1]) {
+                    benchRuns = SDL_atoi(argv[i + 1]);
+                    consumed = 2;
+                }
+            }
+            else if (SDL_strcasecmp(argv[i], "--bench-output") == 0) {
+                if (argv[i + 1]) {
+                    benchOutput = argv[i + 1];
+                    consumed = 2;
+                }
+            }
+            else if (SDL_strcasecmp(argv[i], "--bench-format") == 0) {
+                if (argv[i + 1]) {
+                    if (SDL_strcasecmp(argv[i + 1], "csv") == 0) {
+                        benchFormat = SDLTEST_BENCHMARK_OUTPUT_CSV;
+                        consumed = 2;
+                    } else if (SDL_strcasecmp(argv[i + 1], "json") == 0) {
+                        benchFormat = SDLTEST_BENCHMARK_OUTPUT_JSON;
+                        consumed = 2;
+                    }
+                }
+            }
+            else if (SDL_strcasecmp(argv[i], "--parallel") == 0) {
+                if (argv[i + 1]) {
+                    parallel = SDL_atoi(argv[i + 1]);
+                    forWorkers = SDL_FALSE;
                     consumed = 2;
                 }
             }
         }
         if (consumed < 0) {
-            static const char *options[] = { "[--iterations #]", "[--execKey #]", "[--seed string]", "[--filter suite_name|test_name]", NULL };
+            static const char *options[] = {
+                "[--iterations #]", "[--execKey #]", "[--seed string]", "[--filter suite_name|test_name]",
+                "[--benchmark]", "[--bench-warmup #]", "[--bench-runs #]", "[--bench-output file]", "[--bench-format csv|json]",
+                "[--parallel #]", NULL };
             SDLTest_CommonLogUsage(state, argv[0], options);
             quit(1);
         }
 
+        if (forWorkers) {
+            int j;
+            for (j = 0; j < consumed; ++j) {
+                workerArgv[workerArgc++] = argv[i + j];
+            }
+        }
         i += consumed;
     }
 
+    SDLTest_SetBenchmarkOptions(benchmark, benchWarmup, benchRuns);
+    if (benchOutput && SDLTest_SetBenchmarkOutput(benchOutput, benchFormat) < 0) {
+        quit(1);
+    }
+
+    /* Run every suite in its own process, the workers set up their own windows and renderers */
+    if (parallel > 1 && !filter) {
+        result = SDLTest_RunSuitesParallel(testSuites, userRunSeed, parallel, workerArgv);
+        if (result >= 0) {
+            SDL_free(workerArgv);
+            SDL_free(userRunSeed);
+            quit(result);
+        }
+        SDLTest_Log("Falling back to running suites serially");
+    }
+    SDL_free(workerArgv);
+
     /* Initialize common state */
     if (!SDLTest_CommonInit(state)) {
         quit(2);
@@ -12,6 +12,10 @@
 #include "SDL.h"
 #include "SDL_test.h"
 
+/* The channel converters SDL_BuildAudioCVT picks when it doesn't mix through a matrix */
+#define LOG_DEBUG_CONVERT(from, to)
+#include "../src/audio/SDL_audio_channel_converters.h"
+
 /* ================= Test Case Implementation ================== */
 
 /* Fixture */
@@ -969,6 +973,452 @@ int audio_openCloseAudioDeviceConnected()
 
 
 
+/* Writes a little-endian value of the given size */
+static void
+_audio_writeLE(Uint8 *p, Uint32 value, int bytes)
+{
+    int i;
+    for (i = 0; i < bytes; i++) {
+        p[i] = (Uint8)(value >> (i * 8));
+    }
+}
+
+/* Creates a stereo WAVE file with random data. ADPCM blocks get valid headers. */
+static Uint8 *
+_audio_createWAV(Uint16 formattag, Uint16 blockalign, Uint16 bitspersample, Uint16 samplesperblock, Uint32 datalength, Uint32 *filelength)
+{
+    /* MS ADPCM has the 7 preset coefficient pairs after wSamplesPerBlock */
+    const Sint16 coeffs[14] = { 256, 0, 512, -256, 0, 0, 192, 64, 240, 0, 460, -208, 392, -232 };
+    const Uint32 fmtlength = (formattag == 0x0002) ? 50 : 20;
+    Uint8 *wav, *data;
+    Uint32 i;
+
+    *filelength = 28 + fmtlength + datalength;
+    wav = (Uint8 *)SDL_malloc(*filelength);
+    SDLTest_AssertCheck(wav != NULL, "Verify WAVE buffer is not NULL");
+    if (wav == NULL) {
+        return NULL;
+    }
+
+    SDL_memcpy(wav, "RIFF", 4);
+    _audio_writeLE(wav + 4, *filelength - 8, 4);
+    SDL_memcpy(wav + 8, "WAVEfmt ", 8);
+    _audio_writeLE(wav + 16, fmtlength, 4);
+    _audio_writeLE(wav + 20, formattag, 2);
+    _audio_writeLE(wav + 22, 2, 2);                 /* channels */
+    _audio_writeLE(wav + 24, 22050, 4);             /* frequency */
+    _audio_writeLE(wav + 28, 22050 * blockalign, 4);
+    _audio_writeLE(wav + 32, blockalign, 2);
+    _audio_writeLE(wav + 34, bitspersample, 2);
+    _audio_writeLE(wav + 36, fmtlength - 18, 2);    /* extension size */
+    _audio_writeLE(wav + 38, samplesperblock, 2);
+    if (formattag == 0x0002) {
+        _audio_writeLE(wav + 40, 7, 2);
+        for (i = 0; i < 14; i++) {
+            _audio_writeLE(wav + 42 + i * 2, (Uint16)coeffs[i], 2);
+        }
+    }
+    SDL_memcpy(wav + 20 + fmtlength, "data", 4);
+    _audio_writeLE(wav + 24 + fmtlength, datalength, 4);
+    data = wav + 28 + fmtlength;
+    for (i = 0; i < datalength; i++) {
+        data[i] = SDLTest_RandomUint8();
+    }
+    if (formattag == 0x0002) {
+        for (i = 0; i + 14 <= datalength; i += blockalign) {
+            /* Valid coefficient indices in each block header. */
+            data[i] = (Uint8)SDLTest_RandomIntegerInRange(0, 6);
+            data[i + 1] = (Uint8)SDLTest_RandomIntegerInRange(0, 6);
+        }
+    } else if (formattag == 0x0011) {
+        for (i = 0; i + 8 <= datalength; i += blockalign) {
+            /* Valid step indices and reserved bytes in each block header. */
+            data[i + 2] = (Uint8)SDLTest_RandomIntegerInRange(0, 88);
+            data[i + 3] = 0;
+            data[i + 6] = (Uint8)SDLTest_RandomIntegerInRange(0, 88);
+            data[i + 7] = 0;
+        }
+    }
+
+    return wav;
+}
+
+/**
+ * \brief Loads MS ADPCM and IMA ADPCM WAVE files with one and with several decoding threads
+ *
+ * \sa https://wiki.libsdl.org/SDL_LoadWAV_RW
+ */
+int audio_loadWAVParallel()
+{
+    /* 300 full blocks plus a truncated one, so both the parallel and the serial decoder run */
+    const char *threads[] = { "1", "4", "0" };
+    const Uint16 formattags[] = { 0x0002, 0x0011 };
+    const Uint16 samplesperblocks[] = { 244, 249 };
+    Uint8 *wav;
+    Uint32 filelength;
+    Uint8 *buffers[SDL_arraysize(threads)];
+    Uint32 lengths[SDL_arraysize(threads)];
+    SDL_AudioSpec spec;
+    Uint32 i, j;
+
+    for (j = 0; j < SDL_arraysize(formattags); j++) {
+        wav = _audio_createWAV(formattags[j], 256, 4, samplesperblocks[j], 300 * 256 + 100, &filelength);
+        if (wav == NULL) {
+            return TEST_ABORTED;
+        }
+
+        for (i = 0; i < SDL_arraysize(threads); i++) {
+            SDL_SetHint(SDL_HINT_WAVE_DECODE_THREADS, threads[i]);
+            buffers[i] = NULL;
+            lengths[i] = 0;
+            SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, filelength), 1, &spec, &buffers[i], &lengths[i]);
+            SDLTest_AssertPass("Call to SDL_LoadWAV_RW() with format 0x%04x and %s decoding threads", (unsigned int)formattags[j], threads[i]);
+            SDLTest_AssertCheck(buffers[i] != NULL, "Verify audio buffer is not NULL");
+            SDLTest_AssertCheck(lengths[i] == lengths[0], "Verify audio length; expected: %u, got: %u", (unsigned int)lengths[0], (unsigned int)lengths[i]);
+            if (buffers[i] != NULL && buffers[0] != NULL && lengths[i] == lengths[0]) {
+                SDLTest_AssertCheck(SDL_memcmp(buffers[i], buffers[0], lengths[0]) == 0, "Verify decoded samples match the serial decoder");
+            }
+        }
+        SDLTest_AssertCheck(lengths[0] >= 300 * samplesperblocks[j] * 4u, "Verify audio length; expected: >= %u, got: %u", 300 * samplesperblocks[j] * 4u, (unsigned int)lengths[0]);
+
+        for (i = 0; i < SDL_arraysize(threads); i++) {
+            SDL_FreeWAV(buffers[i]);
+        }
+        SDL_free(wav);
+    }
+    SDL_ResetHint(SDL_HINT_WAVE_DECODE_THREADS);
+
+    return TEST_COMPLETED;
+}
+
+
+/**
+ * \brief Decodes WAVE files with SDL_WAVStream and compares them to SDL_LoadWAV_RW()
+ *
+ * \sa https://wiki.libsdl.org/SDL_OpenWAVStream_RW
+ * \sa https://wiki.libsdl.org/SDL_WAVStreamRead
+ * \sa https://wiki.libsdl.org/SDL_WAVStreamSeek
+ * \sa https://wiki.libsdl.org/SDL_WAVStreamPut
+ */
+int audio_streamWAV()
+{
+    /* 16-bit PCM, A-law, and IMA ADPCM with a truncated last block */
+    const Uint16 formattags[] = { 0x0001, 0x0006, 0x0011 };
+    const Uint16 blockaligns[] = { 4, 2, 256 };
+    const Uint16 bitspersamples[] = { 16, 8, 4 };
+    const Uint16 samplesperblocks[] = { 0, 0, 249 };
+    const Uint32 datalengths[] = { 80000, 40002, 80 * 256 + 100 };
+    Uint32 i;
+
+    for (i = 0; i < SDL_arraysize(formattags); i++) {
+        Uint8 *wav, *audio_buf = NULL, *buf;
+        Uint32 filelength, audio_len = 0, framesize, pos;
+        SDL_AudioSpec spec, streamspec;
+        SDL_WAVStream *stream;
+        SDL_AudioStream *audiostream;
+        Sint64 length, frame;
+        int ret, frames;
+
+        wav = _audio_createWAV(formattags[i], blockaligns[i], bitspersamples[i], samplesperblocks[i], datalengths[i], &filelength);
+        if (wav == NULL) {
+            return TEST_ABORTED;
+        }
+        SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, filelength), 1, &spec, &audio_buf, &audio_len);
+        SDLTest_AssertCheck(audio_buf != NULL, "Verify SDL_LoadWAV_RW() loaded format 0x%04x", (unsigned int)formattags[i]);
+
+        stream = SDL_OpenWAVStream_RW(SDL_RWFromConstMem(wav, filelength), 1, &streamspec);
+        SDLTest_AssertPass("Call to SDL_OpenWAVStream_RW()");
+        SDLTest_AssertCheck(stream != NULL, "Verify stream is not NULL");
+        if (stream == NULL || audio_buf == NULL) {
+            SDL_CloseWAVStream(stream);
+            SDL_FreeWAV(audio_buf);
+            SDL_free(wav);
+            return TEST_ABORTED;
+        }
+        SDLTest_AssertCheck(streamspec.format == spec.format && streamspec.channels == spec.channels && streamspec.freq == spec.freq, "Verify stream has the format of SDL_LoadWAV_RW()");
+
+        framesize = SDL_AUDIO_BITSIZE(spec.format) / 8 * spec.channels;
+        length = SDL_WAVStreamLength(stream);
+        SDLTest_AssertCheck(length * framesize == audio_len, "Verify stream length; expected: %u, got: %u", (unsigned int)(audio_len / framesize), (unsigned int)length);
+
+        /* Read everything in pieces that don't line up with the blocks. */
+        buf = (Uint8 *)SDL_malloc(audio_len);
+        pos = 0;
+        while ((frames = SDL_WAVStreamRead(stream, buf + pos, 1000)) > 0) {
+            pos += frames * framesize;
+        }
+        SDLTest_AssertCheck(frames == 0, "Verify SDL_WAVStreamRead() reached the end; got: %d", frames);
+        SDLTest_AssertCheck(pos == audio_len && SDL_memcmp(buf, audio_buf, audio_len) == 0, "Verify decoded samples match SDL_LoadWAV_RW()");
+        SDLTest_AssertCheck(SDL_WAVStreamTell(stream) == length, "Verify position is at the end");
+
+        /* Seek somewhere into the middle. */
+        frame = SDLTest_RandomIntegerInRange(0, (Sint32)length - 300);
+        ret = SDL_WAVStreamSeek(stream, frame);
+        SDLTest_AssertCheck(ret == 0, "Verify SDL_WAVStreamSeek() to frame %d returns 0, got: %d", (int)frame, ret);
+        frames = SDL_WAVStreamRead(stream, buf, 300);
+        SDLTest_AssertCheck(frames == 300 && SDL_memcmp(buf, audio_buf + frame * framesize, 300 * framesize) == 0, "Verify decoded samples after seeking");
+        ret = SDL_WAVStreamSeek(stream, length + 1);
+        SDLTest_AssertCheck(ret == -1, "Verify SDL_WAVStreamSeek() past the end returns -1, got: %d", ret);
+
+        /* Feed an audio stream that doesn't convert anything. */
+        SDL_WAVStreamSeek(stream, 0);
+        audiostream = SDL_NewAudioStream(spec.format, spec.channels, spec.freq, spec.format, spec.channels, spec.freq);
+        SDLTest_AssertCheck(audiostream != NULL, "Verify audio stream is not NULL");
+        if (audiostream != NULL) {
+            frames = SDL_WAVStreamPut(stream, audiostream, 5000);
+            SDLTest_AssertCheck(frames == 5000, "Verify SDL_WAVStreamPut() added 5000 frames, got: %d", frames);
+            SDL_AudioStreamFlush(audiostream);
+            ret = SDL_AudioStreamGet(audiostream, buf, 5000 * framesize);
+            SDLTest_AssertCheck(ret == (int)(5000 * framesize) && SDL_memcmp(buf, audio_buf, 5000 * framesize) == 0, "Verify samples from the audio stream");
+            SDL_FreeAudioStream(audiostream);
+        }
+
+        SDL_free(buf);
+        SDL_CloseWAVStream(stream);
+        SDL_FreeWAV(audio_buf);
+        SDL_free(wav);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Mixes channels through custom matrices in audio streams
+ *
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamSetChannelMatrix
+ */
+int audio_channelMatrix()
+{
+    /* Odd frame counts so the vector mixers also run their tails */
+    const Uint8 srcchans[] = { 8, 2, 2, 6, 3 };
+    const Uint8 dstchans[] = { 2, 6, 2, 1, 4 };
+    const int frames = 37;
+    float matrix[8 * 8];
+    float src[37 * 8], dst[37 * 8], expected[37 * 8];
+    SDL_AudioStream *stream;
+    int i, j, k, ret, mismatches;
+
+    for (i = 0; i < (int)SDL_arraysize(srcchans); i++) {
+        const int s = srcchans[i], d = dstchans[i];
+
+        for (j = 0; j < s * d; j++) {
+            matrix[j] = (j % 3) ? ((float) j / (s * d)) : 0.0f;  /* leave some weights out */
+        }
+        for (j = 0; j < frames * s; j++) {
+            src[j] = SDLTest_RandomUnitFloat() * 2.0f - 1.0f;
+        }
+        for (j = 0; j < frames; j++) {
+            for (k = 0; k < d; k++) {
+                int c;
+                expected[(j * d) + k] = 0.0f;
+                for (c = 0; c < s; c++) {
+                    expected[(j * d) + k] += matrix[(k * s) + c] * src[(j * s) + c];
+                }
+            }
+        }
+
+        stream = SDL_NewAudioStream(AUDIO_F32SYS, s, 48000, AUDIO_F32SYS, d, 48000);
+        SDLTest_AssertCheck(stream != NULL, "Verify audio stream is not NULL");
+        if (stream == NULL) {
+            continue;
+        }
+        ret = SDL_AudioStreamSetChannelMatrix(stream, matrix);
+        SDLTest_AssertCheck(ret == 0, "Validate result from SDL_AudioStreamSetChannelMatrix, expected: 0, got: %i", ret);
+        SDL_AudioStreamPut(stream, src, frames * s * sizeof (float));
+        SDL_AudioStreamFlush(stream);
+        ret = SDL_AudioStreamGet(stream, dst, frames * d * sizeof (float));
+        SDLTest_AssertCheck(ret == (int) (frames * d * sizeof (float)), "Verify %d to %d channels returned %d bytes, got: %d", s, d, (int) (frames * d * sizeof (float)), ret);
+        mismatches = 0;
+        for (j = 0; j < frames * d; j++) {
+            if (SDL_fabs(dst[j] - expected[j]) > 0.00001) {
+                mismatches++;
+            }
+        }
+        SDLTest_AssertCheck(mismatches == 0, "Verify %d to %d channels through the matrix, %d samples differ", s, d, mismatches);
+        SDL_FreeAudioStream(stream);
+    }
+
+    /* Going back to the default mapping matches a stream that never had a matrix */
+    {
+        float defaults[37 * 2];
+        SDL_AudioStream *reference = SDL_NewAudioStream(AUDIO_F32SYS, 8, 44100, AUDIO_F32SYS, 2, 48000);
+        stream = SDL_NewAudioStream(AUDIO_F32SYS, 8, 44100, AUDIO_F32SYS, 2, 48000);
+        SDLTest_AssertCheck(stream != NULL && reference != NULL, "Verify audio streams are not NULL");
+        if (stream != NULL && reference != NULL) {
+            int len;
+            ret = SDL_AudioStreamSetChannelMatrix(stream, matrix);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDL_AudioStreamSetChannelMatrix, expected: 0, got: %i", ret);
+            ret = SDL_AudioStreamSetChannelMatrix(stream, NULL);
+            SDLTest_AssertCheck(ret == 0, "Validate result from SDL_AudioStreamSetChannelMatrix(NULL), expected: 0, got: %i", ret);
+            SDL_AudioStreamPut(stream, src, 32 * 8 * sizeof (float));
+            SDL_AudioStreamPut(reference, src, 32 * 8 * sizeof (float));
+            SDL_AudioStreamFlush(stream);
+            SDL_AudioStreamFlush(reference);
+            len = SDL_AudioStreamGet(reference, defaults, sizeof (defaults));
+            ret = SDL_AudioStreamGet(stream, dst, sizeof (defaults));
+            SDLTest_AssertCheck(len > 0 && ret == len && SDL_memcmp(dst, defaults, len) == 0, "Verify the default mapping is restored, got %d and %d bytes", ret, len);
+        }
+        SDL_FreeAudioStream(stream);
+        SDL_FreeAudioStream(reference);
+    }
+
+    ret = SDL_AudioStreamSetChannelMatrix(NULL, matrix);
+    SDLTest_AssertCheck(ret == -1, "Validate result from SDL_AudioStreamSetChannelMatrix(NULL, ...), expected: -1, got: %i", ret);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Converts standard layouts with the default channel mixing, checking it matches the channel converters it stands in for
+ *
+ * \sa https://wiki.libsdl.org/SDL_BuildAudioCVT
+ */
+int audio_defaultChannelMatrix()
+{
+    /* Mono, stereo, quad, 5.1 and 7.1 going up and down; odd frame counts run the vector tails too */
+    const Uint8 srcchans[] = { 2, 6, 8, 6, 4, 2, 3, 5 };
+    const Uint8 dstchans[] = { 6, 2, 6, 8, 2, 4, 1, 6 };
+    const int frames = 37;
+    float src[37 * 8], expected[37 * 8];
+    SDL_AudioCVT cvt, ref;
+    int i, j, ret, mismatches;
+
+    for (i = 0; i < (int)SDL_arraysize(srcchans); i++) {
+        const int s = srcchans[i], d = dstchans[i];
+
+        for (j = 0; j < frames * s; j++) {
+            src[j] = SDLTest_RandomUnitFloat() * 2.0f - 1.0f;
+        }
+
+        SDL_zero(ref);
+        ref.buf = (Uint8 *) expected;
+        ref.len_cvt = frames * s * sizeof (float);
+        ref.filters[0] = channel_converters[s - 1][d - 1];
+        SDL_memcpy(expected, src, ref.len_cvt);
+        ref.filters[0](&ref, AUDIO_F32SYS);
+
+        ret = SDL_BuildAudioCVT(&cvt, AUDIO_F32SYS, s, 48000, AUDIO_F32SYS, d, 48000);
+        SDLTest_AssertCheck(ret == 1, "Validate result from SDL_BuildAudioCVT, expected: 1, got: %i", ret);
+        if (ret != 1) {
+            continue;
+        }
+        cvt.len = frames * s * sizeof (float);
+        cvt.buf = (Uint8 *) SDL_malloc(cvt.len * cvt.len_mult);
+        SDLTest_AssertCheck(cvt.buf != NULL, "Verify buffer is not NULL");
+        if (cvt.buf == NULL) {
+            continue;
+        }
+        SDL_memcpy(cvt.buf, src, cvt.len);
+        ret = SDL_ConvertAudio(&cvt);
+        SDLTest_AssertCheck(ret == 0, "Validate result from SDL_ConvertAudio, expected: 0, got: %i", ret);
+        SDLTest_AssertCheck(cvt.len_cvt == ref.len_cvt, "Verify %d to %d channels converted length, expected: %i, got: %i", s, d, ref.len_cvt, cvt.len_cvt);
+
+        mismatches = 0;
+        for (j = 0; cvt.len_cvt == ref.len_cvt && j < frames * d; j++) {
+            if (SDL_fabs(((float *) cvt.buf)[j] - expected[j]) > 0.00001) {
+                mismatches++;
+            }
+        }
+        SDLTest_AssertCheck(mismatches == 0, "Verify %d to %d channels matches the channel converter, %d samples differ", s, d, mismatches);
+        SDL_free(cvt.buf);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Converts buffers big enough to be converted in chunks, checking they match small conversions,
+ * or running the filters one after the other over the whole buffer when resampling
+ *
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudio
+ */
+int audio_convertLargeBuffer()
+{
+    /* One layout that grows through the filters and one that shrinks, at the same rate and resampled */
+    const SDL_AudioFormat srcformats[] = { AUDIO_S16MSB, AUDIO_F32MSB, AUDIO_S16MSB, AUDIO_F32MSB };
+    const Uint8 srcchans[] = { 2, 8, 2, 8 };
+    const int srcrates[] = { 48000, 48000, 44100, 48000 };
+    const SDL_AudioFormat dstformats[] = { AUDIO_S32LSB, AUDIO_U8, AUDIO_S32LSB, AUDIO_U8 };
+    const Uint8 dstchans[] = { 6, 2, 6, 2 };
+    const int dstrates[] = { 48000, 48000, 48000, 22050 };
+    const int frames = 20011;
+    const int pieceframes = 64;
+    SDL_AudioCVT cvt, piece;
+    Uint8 *src, *expected;
+    int i, j, ret, srcframesize, dstframesize, len;
+
+    for (i = 0; i < (int)SDL_arraysize(srcformats); i++) {
+        ret = SDL_BuildAudioCVT(&cvt, srcformats[i], srcchans[i], srcrates[i], dstformats[i], dstchans[i], dstrates[i]);
+        SDLTest_AssertCheck(ret == 1, "Validate result from SDL_BuildAudioCVT, expected: 1, got: %i", ret);
+        if (ret != 1) {
+            continue;
+        }
+        srcframesize = (SDL_AUDIO_BITSIZE(srcformats[i]) / 8) * srcchans[i];
+        dstframesize = (SDL_AUDIO_BITSIZE(dstformats[i]) / 8) * dstchans[i];
+        cvt.len = frames * srcframesize;
+        cvt.buf = (Uint8 *) SDL_malloc(cvt.len * cvt.len_mult);
+        src = (Uint8 *) SDL_malloc(cvt.len);
+        expected = (Uint8 *) SDL_malloc(cvt.len * cvt.len_mult);
+        SDLTest_AssertCheck(cvt.buf != NULL && src != NULL && expected != NULL, "Verify buffers are not NULL");
+        if (cvt.buf == NULL || src == NULL || expected == NULL) {
+            SDL_free(cvt.buf);
+            SDL_free(src);
+            SDL_free(expected);
+            continue;
+        }
+
+        for (j = 0; j < frames * srcchans[i]; j++) {
+            const float sample = SDLTest_RandomUnitFloat() * 2.0f - 1.0f;
+            if (SDL_AUDIO_ISFLOAT(srcformats[i])) {
+                ((float *) src)[j] = SDL_SwapFloatBE(sample);
+            } else {
+                ((Uint16 *) src)[j] = SDL_SwapBE16((Uint16) (Sint16) (sample * 32767.0f));
+            }
+        }
+
+        SDL_memcpy(&piece, &cvt, sizeof (piece));
+        len = 0;
+        if (srcrates[i] == dstrates[i]) {
+            /* Pieces too small to be split up give the reference output */
+            piece.buf = (Uint8 *) SDL_malloc(pieceframes * srcframesize * cvt.len_mult);
+            for (j = 0; piece.buf != NULL && j < frames; j += pieceframes) {
+                piece.len = SDL_min(pieceframes, frames - j) * srcframesize;
+                SDL_memcpy(piece.buf, src + (j * srcframesize), piece.len);
+                ret = SDL_ConvertAudio(&piece);
+                SDLTest_AssertCheck(ret == 0, "Validate result from SDL_ConvertAudio on a piece, expected: 0, got: %i", ret);
+                SDL_memcpy(expected + len, piece.buf, piece.len_cvt);
+                len += piece.len_cvt;
+            }
+            SDL_free(piece.buf);
+        } else {
+            /* The resampler needs the whole buffer, so run every filter over all of it in turn */
+            piece.buf = expected;
+            piece.len_cvt = piece.len;
+            piece.filter_index = 0;
+            SDL_memcpy(piece.buf, src, piece.len);
+            piece.filters[0](&piece, piece.src_format);
+            len = piece.len_cvt;
+        }
+
+        SDL_memcpy(cvt.buf, src, cvt.len);
+        ret = SDL_ConvertAudio(&cvt);
+        SDLTest_AssertCheck(ret == 0, "Validate result from SDL_ConvertAudio, expected: 0, got: %i", ret);
+        if (srcrates[i] == dstrates[i]) {
+            SDLTest_AssertCheck(cvt.len_cvt == frames * dstframesize, "Verify converted length, expected: %i, got: %i", frames * dstframesize, cvt.len_cvt);
+        }
+        SDLTest_AssertCheck(len == cvt.len_cvt && SDL_memcmp(cvt.buf, expected, len) == 0,
+                            "Verify %d to %d channels at %d to %d Hz matches the reference conversion, expected %d bytes, got %d",
+                            srcchans[i], dstchans[i], srcrates[i], dstrates[i], len, cvt.len_cvt);
+
+        SDL_free(cvt.buf);
+        SDL_free(src);
+        SDL_free(expected);
+    }
+
+    return TEST_COMPLETED;
+}
+
+
 /* ================= Test Case References ================== */
 
 /* Audio test cases */
@@ -1022,11 +1472,26 @@ static const SDLTest_TestCaseReference audioTest14 =
 static const SDLTest_TestCaseReference audioTest15 =
         { (SDLTest_TestCaseFp)audio_pauseUnpauseAudio, "audio_pauseUnpauseAudio", "Pause and Unpause audio for various audio specs while testing callback.", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference audioTest16 =
+        { (SDLTest_TestCaseFp)audio_loadWAVParallel, "audio_loadWAVParallel", "Loads ADPCM WAVE data with several decoding threads.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest17 =
+        { (SDLTest_TestCaseFp)audio_streamWAV, "audio_streamWAV", "Decodes WAVE data a few sample frames at a time.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest18 =
+        { (SDLTest_TestCaseFp)audio_channelMatrix, "audio_channelMatrix", "Mixes channels through custom matrices in audio streams.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest19 =
+        { (SDLTest_TestCaseFp)audio_convertLargeBuffer, "audio_convertLargeBuffer", "Converts large buffers in chunks and compares them to small conversions.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest20 =
+        { (SDLTest_TestCaseFp)audio_defaultChannelMatrix, "audio_defaultChannelMatrix", "Compares the default channel mixing to the channel converters.", TEST_ENABLED };
+
 /* Sequence of Audio test cases */
 static const SDLTest_TestCaseReference *audioTests[] =  {
     &audioTest1, &audioTest2, &audioTest3, &audioTest4, &audioTest5, &audioTest6,
     &audioTest7, &audioTest8, &audioTest9, &audioTest10, &audioTest11,
-    &audioTest12, &audioTest13, &audioTest14, &audioTest15, NULL
+    &audioTest12, &audioTest13, &audioTest14, &audioTest15, &audioTest16, &audioTest17, &audioTest18, &audioTest19, &audioTest20, NULL
 };
 
 /* Audio test suite (global) */
@@ -494,6 +494,1252 @@ render_testBlitColor (void *arg)
 }
 
 
+/**
+ * @brief Tests blitting a texture allocated from a texture atlas.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_CreateTextureAtlas
+ * http://wiki.libsdl.org/SDL_CreateAtlasTexture
+ * http://wiki.libsdl.org/SDL_DefragmentTextureAtlas
+ * http://wiki.libsdl.org/SDL_DestroyTextureAtlas
+ */
+int
+render_testBlitAtlas (void *arg)
+{
+   int ret;
+   SDL_Rect rect;
+   SDL_TextureAtlas *atlas;
+   SDL_Texture *filler;
+   SDL_Texture *tface;
+   SDL_Surface *face;
+   SDL_Surface *referenceSurface;
+   SDL_BlendMode blendMode;
+   int pass;
+   int i, j, ni, nj;
+   int checkFailCount1;
+   int checkFailCount2;
+
+   face = SDLTest_ImageFace();
+   SDLTest_AssertCheck(face != NULL, "Verify SDLTest_ImageFace() result");
+   if (face == NULL) {
+       return TEST_ABORTED;
+   }
+   SDL_GetSurfaceBlendMode(face, &blendMode);
+
+   atlas = SDL_CreateTextureAtlas(renderer, SDL_PIXELFORMAT_ARGB8888, 128, 128);
+   SDLTest_AssertCheck(atlas != NULL, "Verify SDL_CreateTextureAtlas() result");
+   if (atlas == NULL) {
+       SDL_FreeSurface(face);
+       return TEST_ABORTED;
+   }
+
+   /* Take the corner of the page so the face isn't at the origin. */
+   filler = SDL_CreateAtlasTexture(atlas, 50, 20);
+   SDLTest_AssertCheck(filler != NULL, "Verify SDL_CreateAtlasTexture() result");
+   tface = SDL_CreateAtlasTexture(atlas, face->w, face->h);
+   SDLTest_AssertCheck(tface != NULL, "Verify SDL_CreateAtlasTexture() result");
+   if (tface == NULL) {
+       SDL_DestroyTextureAtlas(atlas);
+       SDL_FreeSurface(face);
+       return TEST_ABORTED;
+   }
+   {
+      SDL_Surface *converted = SDL_ConvertSurfaceFormat(face, SDL_PIXELFORMAT_ARGB8888, 0);
+      SDLTest_AssertCheck(converted != NULL, "Verify SDL_ConvertSurfaceFormat() result");
+      if (converted != NULL) {
+         ret = SDL_UpdateTexture(tface, NULL, converted->pixels, converted->pitch);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+         SDL_FreeSurface(converted);
+      }
+   }
+   ret = SDL_SetTextureBlendMode(tface, blendMode);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetTextureBlendMode, expected: 0, got: %i", ret);
+
+   rect.w = face->w;
+   rect.h = face->h;
+   ni     = TESTRENDER_SCREEN_W - face->w;
+   nj     = TESTRENDER_SCREEN_H - face->h;
+
+   referenceSurface = SDLTest_ImageBlitColor();
+
+   /* Blit with color mod, then again after the atlas has been repacked. */
+   for (pass = 0; pass < 2; pass++) {
+      if (pass == 1) {
+         if (!SDL_RenderTargetSupported(renderer)) {
+            break;
+         }
+         SDL_DestroyTexture(filler);
+         ret = SDL_DefragmentTextureAtlas(atlas);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_DefragmentTextureAtlas, expected: 0, got: %i", ret);
+         ret = SDL_GetAtlasTextureRegion(tface, NULL, &rect, NULL);
+         SDLTest_AssertCheck(ret == 0 && rect.x == 0 && rect.y == 0, "Validate texture moved to the page origin, got: %i,%i", rect.x, rect.y);
+         rect.w = face->w;
+         rect.h = face->h;
+      }
+
+      _clearScreen();
+
+      checkFailCount1 = 0;
+      checkFailCount2 = 0;
+      for (j=0; j <= nj; j+=4) {
+         for (i=0; i <= ni; i+=4) {
+            ret = SDL_SetTextureColorMod( tface, (255/nj)*j, (255/ni)*i, (255/nj)*j );
+            if (ret != 0) checkFailCount1++;
+
+            rect.x = i;
+            rect.y = j;
+            ret = SDL_RenderCopy(renderer, tface, NULL, &rect );
+            if (ret != 0) checkFailCount2++;
+         }
+      }
+      SDLTest_AssertCheck(checkFailCount1 == 0, "Validate results from calls to SDL_SetTextureColorMod, expected: 0, got: %i", checkFailCount1);
+      SDLTest_AssertCheck(checkFailCount2 == 0, "Validate results from calls to SDL_RenderCopy, expected: 0, got: %i", checkFailCount2);
+
+      /* See if it's the same. */
+      _compare(referenceSurface, ALLOWABLE_ERROR_OPAQUE );
+
+      SDL_RenderPresent(renderer);
+   }
+
+   /* Clean up, destroying the atlas frees the textures left in it. */
+   SDL_DestroyTextureAtlas(atlas);
+   SDL_FreeSurface(referenceSurface);
+   SDL_FreeSurface(face);
+
+   return TEST_COMPLETED;
+}
+
+#define GUTTER_TEXTURE_W  8
+#define GUTTER_TEXTURE_H  6
+
+/* Checks the one texel gutter around an atlas texture holds copies of its edge texels */
+static int
+_checkAtlasGutter(SDL_Texture *texture, const Uint32 *texels)
+{
+   SDL_Texture *page;
+   SDL_Rect rect;
+   Uint32 *pixels;
+   int w, h;
+   int x, y, tx, ty;
+   int failed = 0;
+   int ret;
+
+   ret = SDL_GetAtlasTextureRegion(texture, &page, &rect, NULL);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_GetAtlasTextureRegion, expected: 0, got: %i", ret);
+   ret = SDL_QueryTexture(page, NULL, NULL, &w, &h);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_QueryTexture, expected: 0, got: %i", ret);
+   pixels = (Uint32 *) SDL_malloc(w * h * sizeof(Uint32));
+   if (pixels == NULL) {
+      return -1;
+   }
+
+   /* Draw the page as is and read it back */
+   _clearScreen();
+   rect.w = w;
+   rect.h = h;
+   rect.x = 0;
+   rect.y = 0;
+   SDL_SetTextureBlendMode(page, SDL_BLENDMODE_NONE);
+   ret = SDL_RenderCopy(renderer, page, NULL, &rect);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopy, expected: 0, got: %i", ret);
+   ret = SDL_RenderReadPixels(renderer, &rect, SDL_PIXELFORMAT_ARGB8888, pixels, w * sizeof(Uint32));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+   SDL_GetAtlasTextureRegion(texture, NULL, &rect, NULL);
+
+   for (y = rect.y - 1; y <= rect.y + rect.h; y++) {
+      for (x = rect.x - 1; x <= rect.x + rect.w; x++) {
+         if (x < 0 || y < 0 || x >= w || y >= h) {
+            continue;
+         }
+         tx = SDL_clamp(x - rect.x, 0, rect.w - 1);
+         ty = SDL_clamp(y - rect.y, 0, rect.h - 1);
+         if (pixels[y * w + x] != texels[ty * GUTTER_TEXTURE_W + tx]) {
+            failed++;
+         }
+      }
+   }
+   SDL_free(pixels);
+   return failed;
+}
+
+/**
+ * @brief Tests the padding around atlas textures repeats their edges, so linear filtering doesn't bleed in their neighbours.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_CreateAtlasTexture
+ * http://wiki.libsdl.org/SDL_GetAtlasTextureRegion
+ * http://wiki.libsdl.org/SDL_UpdateTexture
+ */
+int
+render_testAtlasGutter (void *arg)
+{
+   Uint32 texels[GUTTER_TEXTURE_W * GUTTER_TEXTURE_H];
+   SDL_TextureAtlas *atlas;
+   SDL_Texture *filler;
+   SDL_Texture *texture;
+   SDL_Rect rect;
+   int i, ret, failed;
+
+   atlas = SDL_CreateTextureAtlas(renderer, SDL_PIXELFORMAT_ARGB8888, 64, 64);
+   SDLTest_AssertCheck(atlas != NULL, "Verify SDL_CreateTextureAtlas() result");
+   if (atlas == NULL) {
+      return TEST_ABORTED;
+   }
+
+   /* Put another texture in the way so the gutter is all on the page. */
+   filler = SDL_CreateAtlasTexture(atlas, 20, 10);
+   SDLTest_AssertCheck(filler != NULL, "Verify SDL_CreateAtlasTexture() result");
+   texture = SDL_CreateAtlasTexture(atlas, GUTTER_TEXTURE_W, GUTTER_TEXTURE_H);
+   SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateAtlasTexture() result");
+   if (filler == NULL || texture == NULL) {
+      SDL_DestroyTextureAtlas(atlas);
+      return TEST_ABORTED;
+   }
+
+   for (i = 0; i < (int)SDL_arraysize(texels); i++) {
+      texels[i] = 0xFF000000 | (Uint32)((i * 0x3F1D27) & 0xFFFFFF);
+   }
+   ret = SDL_UpdateTexture(texture, NULL, texels, GUTTER_TEXTURE_W * sizeof(Uint32));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+   failed = _checkAtlasGutter(texture, texels);
+   SDLTest_AssertCheck(failed == 0, "Validate gutter after a full update, expected: 0 mismatches, got: %i", failed);
+
+   /* Update only the bottom right corner, which has to refresh its part of the gutter. */
+   for (i = 0; i < (int)SDL_arraysize(texels); i++) {
+      if (i % GUTTER_TEXTURE_W >= 3 && i / GUTTER_TEXTURE_W >= 2) {
+         texels[i] ^= 0x00FFFFFF;
+      }
+   }
+   rect.x = 3;
+   rect.y = 2;
+   rect.w = GUTTER_TEXTURE_W - 3;
+   rect.h = GUTTER_TEXTURE_H - 2;
+   ret = SDL_UpdateTexture(texture, &rect, &texels[2 * GUTTER_TEXTURE_W + 3], GUTTER_TEXTURE_W * sizeof(Uint32));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+   failed = _checkAtlasGutter(texture, texels);
+   SDLTest_AssertCheck(failed == 0, "Validate gutter after a partial update, expected: 0 mismatches, got: %i", failed);
+
+   /* Moving the texture has to bring its gutter along. */
+   if (SDL_RenderTargetSupported(renderer)) {
+      SDL_DestroyTexture(filler);
+      filler = SDL_CreateAtlasTexture(atlas, 3, 3);
+      SDLTest_AssertCheck(filler != NULL, "Verify SDL_CreateAtlasTexture() result");
+      ret = SDL_DefragmentTextureAtlas(atlas);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_DefragmentTextureAtlas, expected: 0, got: %i", ret);
+      failed = _checkAtlasGutter(texture, texels);
+      SDLTest_AssertCheck(failed == 0, "Validate gutter after defragmenting, expected: 0 mismatches, got: %i", failed);
+   }
+
+   SDL_DestroyTextureAtlas(atlas);
+
+   return TEST_COMPLETED;
+}
+
+/* Blends one color channel of a fill the way the blend mode is specified to */
+static Uint8
+_blendFillChannel(SDL_BlendMode mode, unsigned d, unsigned c, unsigned a)
+{
+   unsigned v;
+   switch (mode) {
+   case SDL_BLENDMODE_BLEND:
+      v = (d * (255 - a)) / 255 + c;
+      break;
+   case SDL_BLENDMODE_ADD:
+      v = d + c;
+      break;
+   case SDL_BLENDMODE_MOD:
+      v = (d * c) / 255;
+      break;
+   default:
+      v = (d * c) / 255 + (d * (255 - a)) / 255;
+      break;
+   }
+   return (Uint8)SDL_min(v, 255);
+}
+
+/**
+ * @brief Tests filling rects with every blend mode in the software renderer,
+ *        against the blend equations applied pixel by pixel.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_CreateSoftwareRenderer
+ * http://wiki.libsdl.org/SDL_RenderFillRects
+ */
+int
+render_testBlendFillRects (void *arg)
+{
+   const Uint32 formats[] = { SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_ARGB8888 };
+   const SDL_BlendMode modes[] = { SDL_BLENDMODE_BLEND, SDL_BLENDMODE_ADD, SDL_BLENDMODE_MOD, SDL_BLENDMODE_MUL };
+   /* Odd widths so that every kernel also runs its tail */
+   const SDL_Rect rects[] = { { 1, 1, 37, 5 }, { 3, 9, 1, 4 }, { 0, 14, 53, 3 } };
+   const Uint8 cr = 0xC8, cg = 0x5A, cb = 0x13, ca = 0x9E;
+   const int w = 53, h = 17;
+   int f, m, i, x, y;
+
+   for (f = 0; f < (int)SDL_arraysize(formats); f++) {
+      for (m = 0; m < (int)SDL_arraysize(modes); m++) {
+         SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, formats[f]);
+         SDL_Surface *original = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, formats[f]);
+         SDL_Renderer *software;
+         int mismatches = 0;
+
+         SDLTest_AssertCheck(surface != NULL && original != NULL, "Verify %s surfaces are not NULL", SDL_GetPixelFormatName(formats[f]));
+         if (surface == NULL || original == NULL) {
+            SDL_FreeSurface(surface);
+            SDL_FreeSurface(original);
+            continue;
+         }
+         for (y = 0; y < h; y++) {
+            for (x = 0; x < w; x++) {
+               SDL_Rect pixel;
+               pixel.x = x;
+               pixel.y = y;
+               pixel.w = pixel.h = 1;
+               SDL_FillRect(surface, &pixel, SDL_MapRGBA(surface->format, (Uint8)(x * 5), (Uint8)(y * 15), (Uint8)(x * y), (Uint8)(255 - x * 3)));
+            }
+         }
+         SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+         SDL_BlitSurface(surface, NULL, original, NULL);
+
+         software = SDL_CreateSoftwareRenderer(surface);
+         SDLTest_AssertCheck(software != NULL, "Verify SDL_CreateSoftwareRenderer() result");
+         if (software != NULL) {
+            SDL_SetRenderDrawBlendMode(software, modes[m]);
+            SDL_SetRenderDrawColor(software, cr, cg, cb, ca);
+            SDL_RenderFillRects(software, rects, SDL_arraysize(rects));
+            SDL_RenderFlush(software);
+            SDL_DestroyRenderer(software);
+         }
+
+         for (y = 0; y < h; y++) {
+            for (x = 0; x < w; x++) {
+               const SDL_Point point = { x, y };
+               const int bpp = surface->format->BytesPerPixel;
+               Uint32 expected = 0, actual = 0;
+               SDL_memcpy(&expected, (Uint8 *)original->pixels + y * original->pitch + x * bpp, bpp);
+               SDL_memcpy(&actual, (Uint8 *)surface->pixels + y * surface->pitch + x * bpp, bpp);
+               for (i = 0; i < (int)SDL_arraysize(rects); i++) {
+                  if (SDL_PointInRect(&point, &rects[i])) {
+                     const SDL_bool premultiply = (modes[m] == SDL_BLENDMODE_BLEND || modes[m] == SDL_BLENDMODE_ADD);
+                     const unsigned sr = premultiply ? cr * ca / 255 : cr;
+                     const unsigned sg = premultiply ? cg * ca / 255 : cg;
+                     const unsigned sb = premultiply ? cb * ca / 255 : cb;
+                     Uint8 r, g, b, a;
+                     SDL_GetRGBA(expected, original->format, &r, &g, &b, &a);
+                     r = _blendFillChannel(modes[m], r, sr, ca);
+                     g = _blendFillChannel(modes[m], g, sg, ca);
+                     b = _blendFillChannel(modes[m], b, sb, ca);
+                     if (modes[m] == SDL_BLENDMODE_BLEND || modes[m] == SDL_BLENDMODE_MUL) {
+                        a = _blendFillChannel(modes[m], a, ca, ca);
+                     }
+                     expected = SDL_MapRGBA(original->format, r, g, b, a);
+                     break;
+                  }
+               }
+               if (actual != expected) {
+                  mismatches++;
+               }
+            }
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify %s fill with blend mode %d, %d pixels differ", SDL_GetPixelFormatName(formats[f]), modes[m], mismatches);
+
+         SDL_FreeSurface(surface);
+         SDL_FreeSurface(original);
+      }
+   }
+
+   return TEST_COMPLETED;
+}
+
+/* Draws the geometry at each offset, retained or through SDL_RenderGeometryRaw() */
+static int
+_renderGeometryTo(SDL_Surface *surface, SDL_Surface *face, SDL_bool retained,
+                  const float *xy, const SDL_Color *color, const float *uv, int num_vertices,
+                  const Uint16 *indices, int num_indices, const SDL_FPoint *offsets, int num_offsets)
+{
+   SDL_Renderer *software;
+   SDL_Texture *texture = NULL;
+   SDL_Geometry *geometry = NULL;
+   float moved[2 * 8];
+   int i, o, failed = 0;
+
+   SDL_FillRect(surface, NULL, 0);
+   software = SDL_CreateSoftwareRenderer(surface);
+   if (software == NULL) {
+      return -1;
+   }
+   if (face != NULL) {
+      texture = SDL_CreateTextureFromSurface(software, face);
+      if (texture == NULL) {
+         SDL_DestroyRenderer(software);
+         return -1;
+      }
+   }
+   if (retained) {
+      geometry = SDL_CreateGeometry(software, xy, 2 * sizeof(float), color, sizeof(SDL_Color),
+                                    uv, uv ? 2 * sizeof(float) : 0, num_vertices, indices, num_indices, sizeof(Uint16));
+      if (geometry == NULL) {
+         SDL_DestroyRenderer(software);
+         return -1;
+      }
+   }
+   for (o = 0; o < num_offsets; o++) {
+      if (retained) {
+         if (SDL_RenderRetainedGeometry(software, texture, geometry, &offsets[o]) != 0) {
+            failed++;
+         }
+      } else {
+         for (i = 0; i < num_vertices; i++) {
+            moved[2 * i] = xy[2 * i] + offsets[o].x;
+            moved[2 * i + 1] = xy[2 * i + 1] + offsets[o].y;
+         }
+         if (SDL_RenderGeometryRaw(software, texture, moved, 2 * sizeof(float), color, sizeof(SDL_Color),
+                                   uv, uv ? 2 * sizeof(float) : 0, num_vertices, indices, num_indices, sizeof(Uint16)) != 0) {
+            failed++;
+         }
+      }
+   }
+   SDL_RenderFlush(software);
+   /* Destroying the geometry while it's queued must flush it first. */
+   if (retained) {
+      SDL_RenderRetainedGeometry(software, texture, geometry, NULL);
+      SDL_DestroyGeometry(geometry);
+   } else {
+      SDL_RenderGeometryRaw(software, texture, xy, 2 * sizeof(float), color, sizeof(SDL_Color),
+                            uv, uv ? 2 * sizeof(float) : 0, num_vertices, indices, num_indices, sizeof(Uint16));
+   }
+   SDL_RenderFlush(software);
+   SDL_DestroyRenderer(software);
+   return failed ? -1 : 0;
+}
+
+/**
+ * @brief Tests drawing a retained geometry in the software renderer,
+ *        against the same vertices passed to SDL_RenderGeometryRaw().
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_CreateGeometry
+ * http://wiki.libsdl.org/SDL_RenderRetainedGeometry
+ * http://wiki.libsdl.org/SDL_DestroyGeometry
+ */
+int
+render_testRetainedGeometry (void *arg)
+{
+   const float xy[] = { 2.0f, 3.0f, 40.0f, 5.0f, 35.0f, 30.0f, 4.0f, 28.0f };
+   /* Fractional and negative positions, which round differently once offset */
+   const float xy_frac[] = { -3.4f, 2.6f, 40.7f, -5.5f, 35.3f, 30.9f, 4.6f, 28.5f };
+   const float uv[] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f };
+   const SDL_Color color[] = { { 255, 0, 0, 255 }, { 0, 255, 0, 255 }, { 0, 0, 255, 255 }, { 255, 255, 255, 255 } };
+   const Uint16 indices[] = { 0, 1, 2, 0, 2, 3 };
+   /* Several draws of the same geometry in one batch, fractional and negative too */
+   const SDL_FPoint offsets[] = { { 10.0f, 20.0f }, { 45.5f, 8.25f }, { 60.7f, 40.4f }, { -2.5f, 70.6f } };
+   SDL_Surface *face;
+   int pass;
+
+   face = SDLTest_ImageFace();
+   SDLTest_AssertCheck(face != NULL, "Verify SDLTest_ImageFace() result");
+   if (face == NULL) {
+       return TEST_ABORTED;
+   }
+
+   for (pass = 0; pass < 6; pass++) {
+      SDL_Surface *expected = SDL_CreateRGBSurfaceWithFormat(0, TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, 0, SDL_PIXELFORMAT_ARGB8888);
+      SDL_Surface *actual = SDL_CreateRGBSurfaceWithFormat(0, TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, 0, SDL_PIXELFORMAT_ARGB8888);
+      SDL_Surface *texture = (pass % 3 == 0) ? NULL : face;
+      const float *positions = (pass < 3) ? xy : xy_frac;
+      const float *coords = (pass % 3 == 0) ? NULL : uv;
+      const Uint16 *index = (pass % 3 == 2) ? indices : NULL;
+      const int num_vertices = (pass % 3 == 2) ? 4 : 3;
+      const int num_indices = (pass % 3 == 2) ? SDL_arraysize(indices) : 0;
+      int ret;
+
+      SDLTest_AssertCheck(expected != NULL && actual != NULL, "Verify surfaces are not NULL");
+      if (expected == NULL || actual == NULL) {
+         SDL_FreeSurface(expected);
+         SDL_FreeSurface(actual);
+         continue;
+      }
+
+      ret = _renderGeometryTo(expected, texture, SDL_FALSE, positions, color, coords, num_vertices, index, num_indices, offsets, SDL_arraysize(offsets));
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGeometryRaw, expected: 0, got: %i", ret);
+      ret = _renderGeometryTo(actual, texture, SDL_TRUE, positions, color, coords, num_vertices, index, num_indices, offsets, SDL_arraysize(offsets));
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderRetainedGeometry, expected: 0, got: %i", ret);
+
+      ret = SDLTest_CompareSurfaces(actual, expected, 0);
+      SDLTest_AssertCheck(ret == 0, "Validate retained geometry pass %d matches SDL_RenderGeometryRaw, got: %i", pass, ret);
+
+      SDL_FreeSurface(expected);
+      SDL_FreeSurface(actual);
+   }
+
+   SDL_FreeSurface(face);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests many small flushes through the OpenGL renderer's vertex
+ *        buffer ring, checking the results along the way.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_RenderFlush
+ * http://wiki.libsdl.org/SDL_HINT_RENDER_OPENGL_VERTEX_BUFFERS
+ */
+int
+render_testGLVertexFlushes (void *arg)
+{
+   const int w = 64, h = 64;
+   SDL_Window *glwindow = NULL;
+   SDL_Renderer *gl = NULL;
+   SDL_RendererInfo info;
+   Uint32 *pixels;
+   int driver = -1, i, n;
+
+   for (i = 0; i < SDL_GetNumRenderDrivers(); i++) {
+      if (SDL_GetRenderDriverInfo(i, &info) == 0 && SDL_strcmp(info.name, "opengl") == 0) {
+         driver = i;
+      }
+   }
+   if (driver >= 0) {
+      glwindow = SDL_CreateWindow("render_testGLVertexFlushes", 0, 0, w, h, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+      gl = glwindow ? SDL_CreateRenderer(glwindow, driver, 0) : NULL;
+   }
+   if (gl == NULL) {
+      SDLTest_Log("OpenGL renderer not available, skipping test");
+      if (glwindow != NULL) {
+         SDL_DestroyWindow(glwindow);
+      }
+      return TEST_SKIPPED;
+   }
+
+   pixels = (Uint32 *)SDL_malloc(w * h * sizeof(Uint32));
+   SDLTest_AssertCheck(pixels != NULL, "Verify pixel buffer is not NULL");
+
+   /* A few KB per flush goes around the ring many times */
+   for (n = 0; pixels != NULL && n < 2000; n++) {
+      for (i = 0; i < 256; i++) {
+         const SDL_Rect cell = { (i % 16) * 4, (i / 16) * 4, 4, 4 };
+         SDL_SetRenderDrawColor(gl, (Uint8)(n + i), (Uint8)i, (Uint8)n, 255);
+         SDL_RenderFillRect(gl, &cell);
+      }
+      SDL_RenderFlush(gl);
+
+      if ((n % 250) == 249) {
+         int ret = SDL_RenderReadPixels(gl, NULL, SDL_PIXELFORMAT_ARGB8888, pixels, w * sizeof(Uint32));
+         int mismatches = 0;
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+         for (i = 0; ret == 0 && i < 256; i++) {
+            const Uint32 expected = 0xFF000000 | ((Uint32)(Uint8)(n + i) << 16) | ((Uint32)(Uint8)i << 8) | (Uint8)n;
+            if (pixels[((i / 16) * 4 + 2) * w + (i % 16) * 4 + 2] != expected) {
+               mismatches++;
+            }
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify flush %d drew every cell, %d cells differ", n, mismatches);
+      }
+   }
+
+   SDL_free(pixels);
+   SDL_DestroyRenderer(gl);
+   SDL_DestroyWindow(glwindow);
+
+   return TEST_COMPLETED;
+}
+
+#define UPLOAD_TARGET_W     128
+#define UPLOAD_TARGET_H     32
+#define UPLOAD_RGB_W        37
+#define UPLOAD_RGB_H        29
+#define UPLOAD_YUV_W        38
+#define UPLOAD_YUV_H        30
+#define UPLOAD_YUV_PITCH    48
+#define UPLOAD_YUV_ERROR    12  /* shaders and the CPU round the YUV conversion differently */
+
+/* A texel of lock round n, different for every round */
+static Uint32
+_uploadTexel(int n, int x, int y)
+{
+   Uint32 v = (Uint32)(x * 73 + y * 151 + n * 199) * 2654435761u;
+   return 0xFF000000 | (v >> 8);
+}
+
+/* A byte of plane p of update n at x,y of the buffers the YUV textures are
+   updated from, kept in gamut so the conversions don't clip differently */
+static Uint8
+_uploadPlaneByte(int p, int n, int x, int y)
+{
+   const Uint32 v = ((Uint32)(x * 37 + y * 101 + (p + n * 4) * 59) * 2654435761u) >> 24;
+   return (Uint8)(p ? (96 + v % 64) : (16 + v % 220));
+}
+
+/* Streams an ARGB8888 texture through partial locks and updates, and YUV and
+   NV12 textures through updates of odd sized areas, on the given renderer.
+   Reads back the result, returns -1 if anything failed. */
+static int
+_renderStreamingUploads(SDL_Renderer *r, Uint32 *pixels)
+{
+   static Uint8 planes[4][UPLOAD_YUV_PITCH * UPLOAD_YUV_H];
+   const SDL_Rect yuvrect = { 4, 6, 13, 9 };
+   SDL_Texture *rgb = NULL, *yuv = NULL, *nv = NULL;
+   SDL_Rect rect, dst;
+   Uint32 texels[8 * 10];
+   void *locked;
+   int pitch, n, x, y, p;
+   int ret = -1;
+
+   rgb = SDL_CreateTexture(r, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, UPLOAD_RGB_W, UPLOAD_RGB_H);
+   yuv = SDL_CreateTexture(r, SDL_PIXELFORMAT_IYUV, SDL_TEXTUREACCESS_STREAMING, UPLOAD_YUV_W, UPLOAD_YUV_H);
+   nv = SDL_CreateTexture(r, SDL_PIXELFORMAT_NV12, SDL_TEXTUREACCESS_STREAMING, UPLOAD_YUV_W, UPLOAD_YUV_H);
+   SDLTest_AssertCheck(rgb != NULL && yuv != NULL && nv != NULL, "Verify SDL_CreateTexture() results");
+   if (rgb == NULL || yuv == NULL || nv == NULL) {
+      goto done;
+   }
+   SDL_SetTextureBlendMode(rgb, SDL_BLENDMODE_NONE);
+   SDL_SetTextureBlendMode(yuv, SDL_BLENDMODE_NONE);
+   SDL_SetTextureBlendMode(nv, SDL_BLENDMODE_NONE);
+
+   SDL_SetRenderDrawColor(r, 0, 0, 0, 255);
+   SDL_RenderClear(r);
+
+   /* The whole texture, then partial rects, drawing in between, so the ring of buffers wraps */
+   dst.x = 0;
+   dst.y = 0;
+   dst.w = UPLOAD_RGB_W;
+   dst.h = UPLOAD_RGB_H;
+   for (n = 0; n < 9; n++) {
+      rect.x = (n * 5) % 20;
+      rect.y = (n * 3) % 14;
+      rect.w = 4 + n;
+      rect.h = 3 + n;
+      if (SDL_LockTexture(rgb, n ? &rect : NULL, &locked, &pitch) < 0) {
+         goto done;
+      }
+      if (n == 0) {
+         rect.x = 0;
+         rect.y = 0;
+         rect.w = UPLOAD_RGB_W;
+         rect.h = UPLOAD_RGB_H;
+      }
+      for (y = 0; y < rect.h; y++) {
+         Uint32 *row = (Uint32 *)((Uint8 *)locked + y * pitch);
+         for (x = 0; x < rect.w; x++) {
+            row[x] = _uploadTexel(n, rect.x + x, rect.y + y);
+         }
+      }
+      SDL_UnlockTexture(rgb);
+      if (SDL_RenderCopy(r, rgb, NULL, &dst) < 0) {
+         goto done;
+      }
+   }
+   rect.x = UPLOAD_RGB_W - 8;
+   rect.y = UPLOAD_RGB_H - 10;
+   rect.w = 8;
+   rect.h = 10;
+   for (y = 0; y < rect.h; y++) {
+      for (x = 0; x < rect.w; x++) {
+         texels[y * rect.w + x] = _uploadTexel(9, rect.x + x, rect.y + y);
+      }
+   }
+   if (SDL_UpdateTexture(rgb, &rect, texels, rect.w * sizeof(Uint32)) < 0 ||
+       SDL_RenderCopy(r, rgb, NULL, &dst) < 0) {
+      goto done;
+   }
+
+   /* The whole YUV textures, then an odd sized area in the middle with its own data */
+   for (n = 0; n < 2; n++) {
+      for (p = 0; p < 4; p++) {
+         for (y = 0; y < UPLOAD_YUV_H; y++) {
+            for (x = 0; x < UPLOAD_YUV_PITCH; x++) {
+               planes[p][y * UPLOAD_YUV_PITCH + x] = _uploadPlaneByte(p, n, x, y);
+            }
+         }
+      }
+      if (SDL_UpdateYUVTexture(yuv, n ? &yuvrect : NULL,
+                               planes[0], UPLOAD_YUV_PITCH,
+                               planes[1], UPLOAD_YUV_PITCH / 2,
+                               planes[2], UPLOAD_YUV_PITCH / 2) < 0) {
+         goto done;
+      }
+      if (SDL_UpdateNVTexture(nv, n ? &yuvrect : NULL,
+                              planes[0], UPLOAD_YUV_PITCH,
+                              planes[3], UPLOAD_YUV_PITCH) < 0) {
+         goto done;
+      }
+   }
+   dst.w = UPLOAD_YUV_W;
+   dst.h = UPLOAD_YUV_H;
+   dst.x = 40;
+   if (SDL_RenderCopy(r, yuv, NULL, &dst) < 0) {
+      goto done;
+   }
+   dst.x = 80;
+   if (SDL_RenderCopy(r, nv, NULL, &dst) < 0) {
+      goto done;
+   }
+
+   ret = SDL_RenderReadPixels(r, NULL, SDL_PIXELFORMAT_ARGB8888, pixels, UPLOAD_TARGET_W * sizeof(Uint32));
+
+done:
+   if (nv != NULL) {
+      SDL_DestroyTexture(nv);
+   }
+   if (yuv != NULL) {
+      SDL_DestroyTexture(yuv);
+   }
+   if (rgb != NULL) {
+      SDL_DestroyTexture(rgb);
+   }
+   return ret;
+}
+
+/**
+ * @brief Streams textures through the OpenGL and OpenGL ES 2 renderers with
+ *        partial locks and YUV and NV12 updates, and compares the result to
+ *        the software renderer.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_LockTexture
+ * http://wiki.libsdl.org/SDL_UpdateYUVTexture
+ * http://wiki.libsdl.org/SDL_UpdateNVTexture
+ */
+int
+render_testGLStreamingUploads (void *arg)
+{
+   const char *drivers[] = { "opengl", "opengles2" };
+   SDL_Surface *target;
+   SDL_Renderer *sw;
+   SDL_RendererInfo info;
+   Uint32 *expected, *pixels;
+   int tested = 0, d, i, x, y, c, ret;
+
+   target = SDL_CreateRGBSurfaceWithFormat(0, UPLOAD_TARGET_W, UPLOAD_TARGET_H, 32, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(target != NULL, "Verify SDL_CreateRGBSurfaceWithFormat() result");
+   expected = (Uint32 *)SDL_malloc(2 * UPLOAD_TARGET_W * UPLOAD_TARGET_H * sizeof(Uint32));
+   SDLTest_AssertCheck(expected != NULL, "Verify pixel buffer is not NULL");
+   if (target == NULL || expected == NULL) {
+      SDL_FreeSurface(target);
+      SDL_free(expected);
+      return TEST_ABORTED;
+   }
+   pixels = expected + UPLOAD_TARGET_W * UPLOAD_TARGET_H;
+
+   sw = SDL_CreateSoftwareRenderer(target);
+   SDLTest_AssertCheck(sw != NULL, "Verify SDL_CreateSoftwareRenderer() result");
+   ret = sw ? _renderStreamingUploads(sw, expected) : -1;
+   SDLTest_AssertCheck(ret == 0, "Validate streaming uploads on the software renderer, expected: 0, got: %i", ret);
+   if (sw != NULL) {
+      SDL_DestroyRenderer(sw);
+   }
+
+   for (d = 0; ret == 0 && d < (int)SDL_arraysize(drivers); d++) {
+      SDL_Window *glwindow = NULL;
+      SDL_Renderer *gl = NULL;
+      int driver = -1, mismatches = 0;
+
+      for (i = 0; i < SDL_GetNumRenderDrivers(); i++) {
+         if (SDL_GetRenderDriverInfo(i, &info) == 0 && SDL_strcmp(info.name, drivers[d]) == 0) {
+            driver = i;
+         }
+      }
+      if (driver >= 0) {
+         glwindow = SDL_CreateWindow("render_testGLStreamingUploads", 0, 0, UPLOAD_TARGET_W, UPLOAD_TARGET_H, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+         gl = glwindow ? SDL_CreateRenderer(glwindow, driver, 0) : NULL;
+      }
+      if (gl == NULL) {
+         SDLTest_Log("%s renderer not available", drivers[d]);
+         if (glwindow != NULL) {
+            SDL_DestroyWindow(glwindow);
+         }
+         continue;
+      }
+      tested++;
+
+      i = _renderStreamingUploads(gl, pixels);
+      SDLTest_AssertCheck(i == 0, "Validate streaming uploads on the %s renderer, expected: 0, got: %i", drivers[d], i);
+      for (y = 0; i == 0 && y < UPLOAD_TARGET_H; y++) {
+         for (x = 0; x < UPLOAD_TARGET_W; x++) {
+            const Uint32 a = expected[y * UPLOAD_TARGET_W + x];
+            const Uint32 b = pixels[y * UPLOAD_TARGET_W + x];
+            const int allowed = (x < 40) ? 0 : UPLOAD_YUV_ERROR;
+            for (c = 0; c < 24; c += 8) {
+               if (SDL_abs((int)((a >> c) & 0xFF) - (int)((b >> c) & 0xFF)) > allowed) {
+                  mismatches++;
+                  break;
+               }
+            }
+         }
+      }
+      SDLTest_AssertCheck(mismatches == 0, "Verify the %s renderer matches the software renderer, %d pixels differ", drivers[d], mismatches);
+
+      SDL_DestroyRenderer(gl);
+      SDL_DestroyWindow(glwindow);
+   }
+
+   SDL_free(expected);
+   SDL_FreeSurface(target);
+
+   if (tested == 0) {
+      SDLTest_Log("OpenGL renderers not available, skipping test");
+      return TEST_SKIPPED;
+   }
+   return TEST_COMPLETED;
+}
+
+/* A draw for render_testSortCommands, texture 0 or 1, or -1 to fill */
+typedef struct
+{
+   int texture;
+   SDL_Rect rect;
+} _sortDraw;
+
+#define SORT_TARGET_SIZE 64
+
+/* Queues the draws in one batch on a software renderer, sorting its commands
+   or not, and reads back the result and the sort counters. Returns -1 if the
+   renderer couldn't be created. */
+static int
+_renderSortDraws(const _sortDraw *draws, int count, SDL_bool sort, Uint32 *pixels, Uint64 *reordered, Uint64 *saved)
+{
+   SDL_Window *sortwindow;
+   SDL_Renderer *sortrenderer = NULL;
+   SDL_Texture *textures[2] = { NULL, NULL };
+   SDL_RendererInfo info;
+   Uint32 texels[8 * 8];
+   int driver = -1, ret = -1, i, t;
+
+   for (i = 0; i < SDL_GetNumRenderDrivers(); i++) {
+      if (SDL_GetRenderDriverInfo(i, &info) == 0 && SDL_strcmp(info.name, "software") == 0) {
+         driver = i;
+      }
+   }
+   sortwindow = SDL_CreateWindow("render_testSortCommands", 0, 0, SORT_TARGET_SIZE, SORT_TARGET_SIZE, SDL_WINDOW_HIDDEN);
+   if (sortwindow != NULL && driver >= 0) {
+      /* Picking a driver turns batching off unless asked for */
+      SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+      SDL_SetHint(SDL_HINT_RENDER_SORT_COMMANDS, sort ? "1" : "0");
+      sortrenderer = SDL_CreateRenderer(sortwindow, driver, 0);
+      SDL_ResetHint(SDL_HINT_RENDER_BATCHING);
+      SDL_ResetHint(SDL_HINT_RENDER_SORT_COMMANDS);
+   }
+   if (sortrenderer == NULL) {
+      if (sortwindow != NULL) {
+         SDL_DestroyWindow(sortwindow);
+      }
+      return -1;
+   }
+
+   /* Translucent textures, blended and added, so the order of overlapping draws shows */
+   for (t = 0; t < 2; t++) {
+      textures[t] = SDL_CreateTexture(sortrenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 8, 8);
+      SDLTest_AssertCheck(textures[t] != NULL, "Verify SDL_CreateTexture() result");
+      if (textures[t] == NULL) {
+         goto done;
+      }
+      for (i = 0; i < 8 * 8; i++) {
+         texels[i] = t ? (0x60000000 | ((Uint32)(i * 4) << 8) | 0x40) : (0xA0000000 | ((Uint32)(255 - i * 3) << 16) | (Uint32)(i * 2));
+      }
+      SDL_UpdateTexture(textures[t], NULL, texels, 8 * sizeof(Uint32));
+      SDL_SetTextureBlendMode(textures[t], t ? SDL_BLENDMODE_ADD : SDL_BLENDMODE_BLEND);
+   }
+
+   SDL_SetRenderDrawColor(sortrenderer, 0, 0, 0, 255);
+   SDL_RenderClear(sortrenderer);
+   SDL_SetRenderDrawColor(sortrenderer, 255, 255, 255, 255);
+   SDL_SetRenderDrawBlendMode(sortrenderer, SDL_BLENDMODE_NONE);
+   for (i = 0; i < count; i++) {
+      if (draws[i].texture < 0) {
+         SDL_RenderFillRect(sortrenderer, &draws[i].rect);
+      } else {
+         SDL_RenderCopy(sortrenderer, textures[draws[i].texture], NULL, &draws[i].rect);
+      }
+   }
+
+   ret = SDL_RenderReadPixels(sortrenderer, NULL, SDL_PIXELFORMAT_ARGB8888, pixels, SORT_TARGET_SIZE * sizeof(Uint32));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+   SDL_RenderGetSortStats(sortrenderer, reordered, saved);
+
+done:
+   for (t = 0; t < 2; t++) {
+      if (textures[t] != NULL) {
+         SDL_DestroyTexture(textures[t]);
+      }
+   }
+   SDL_DestroyRenderer(sortrenderer);
+   SDL_DestroyWindow(sortwindow);
+   return ret;
+}
+
+/**
+ * @brief Queues interleaved overlapping and separate draws with command
+ *        sorting on and off, checking they render the same and the sorting
+ *        counters add up.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_HINT_RENDER_SORT_COMMANDS
+ * http://wiki.libsdl.org/SDL_RenderGetSortStats
+ */
+int
+render_testSortCommands (void *arg)
+{
+   /* Separate draws, the second copy of texture 0 moves back past texture 1 */
+   static const _sortDraw separate[] = {
+      { 0, { 0, 0, 8, 8 } }, { 1, { 16, 0, 8, 8 } }, { 0, { 32, 0, 8, 8 } }
+   };
+   /* The same, but texture 1 overlaps both so nothing can move */
+   static const _sortDraw overlapping[] = {
+      { 0, { 0, 0, 8, 8 } }, { 1, { 4, 0, 32, 8 } }, { 0, { 32, 0, 8, 8 } }
+   };
+   _sortDraw draws[150];
+   Uint32 *sorted, *unsorted;
+   Uint64 reordered, saved;
+   int i, mismatches;
+
+   sorted = (Uint32 *)SDL_malloc(SORT_TARGET_SIZE * SORT_TARGET_SIZE * sizeof(Uint32));
+   unsorted = (Uint32 *)SDL_malloc(SORT_TARGET_SIZE * SORT_TARGET_SIZE * sizeof(Uint32));
+   SDLTest_AssertCheck(sorted != NULL && unsorted != NULL, "Verify pixel buffers are not NULL");
+   if (sorted == NULL || unsorted == NULL) {
+      SDL_free(sorted);
+      SDL_free(unsorted);
+      return TEST_ABORTED;
+   }
+
+   if (_renderSortDraws(separate, SDL_arraysize(separate), SDL_TRUE, sorted, &reordered, &saved) < 0) {
+      SDLTest_Log("Software renderer not available for a window, skipping test");
+      SDL_free(sorted);
+      SDL_free(unsorted);
+      return TEST_SKIPPED;
+   }
+   SDLTest_AssertCheck(reordered == 1 && saved == 1, "Verify separate draws are grouped, expected 1 reordered and 1 saved, got %d and %d", (int)reordered, (int)saved);
+   _renderSortDraws(separate, SDL_arraysize(separate), SDL_FALSE, unsorted, &reordered, &saved);
+   SDLTest_AssertCheck(reordered == 0 && saved == 0, "Verify nothing is reordered without the hint, got %d and %d", (int)reordered, (int)saved);
+   SDLTest_AssertCheck(SDL_memcmp(sorted, unsorted, SORT_TARGET_SIZE * SORT_TARGET_SIZE * sizeof(Uint32)) == 0, "Verify separate draws render the same sorted");
+
+   _renderSortDraws(overlapping, SDL_arraysize(overlapping), SDL_TRUE, sorted, &reordered, &saved);
+   SDLTest_AssertCheck(reordered == 0 && saved == 0, "Verify overlapping draws stay in order, got %d reordered and %d saved", (int)reordered, (int)saved);
+
+   /* Interleave fills and both textures, some overlapping and some not */
+   for (i = 0; i < (int)SDL_arraysize(draws); i++) {
+      draws[i].texture = SDLTest_RandomIntegerInRange(-1, 1);
+      draws[i].rect.x = SDLTest_RandomIntegerInRange(-4, SORT_TARGET_SIZE - 4);
+      draws[i].rect.y = SDLTest_RandomIntegerInRange(-4, SORT_TARGET_SIZE - 4);
+      draws[i].rect.w = SDLTest_RandomIntegerInRange(2, 12);
+      draws[i].rect.h = SDLTest_RandomIntegerInRange(2, 12);
+   }
+   _renderSortDraws(draws, SDL_arraysize(draws), SDL_TRUE, sorted, &reordered, &saved);
+   SDLTest_AssertCheck(reordered > 0 && saved > 0, "Verify mixed draws are grouped, got %d reordered and %d saved", (int)reordered, (int)saved);
+   _renderSortDraws(draws, SDL_arraysize(draws), SDL_FALSE, unsorted, &reordered, &saved);
+   mismatches = 0;
+   for (i = 0; i < SORT_TARGET_SIZE * SORT_TARGET_SIZE; i++) {
+      if (sorted[i] != unsorted[i]) {
+         mismatches++;
+      }
+   }
+   SDLTest_AssertCheck(mismatches == 0, "Verify mixed draws render the same sorted, %d pixels differ", mismatches);
+
+   SDL_free(sorted);
+   SDL_free(unsorted);
+   return TEST_COMPLETED;
+}
+
+/* Edge function of the software triangle rasterizer, on points with one fractional bit */
+static int
+_triangleEdge(const SDL_Point *a, const SDL_Point *b, int x, int y)
+{
+   return (b->x - a->x) * (y - a->y) - (b->y - a->y) * (x - a->x);
+}
+
+/* Whether the pixels exactly on the edge from a to b are inside (top-left rule) */
+static int
+_triangleTopLeft(const SDL_Point *a, const SDL_Point *b, int clockwise)
+{
+   if (clockwise) {
+      return (a->y == b->y && a->x < b->x) || b->y < a->y;
+   }
+   return (a->y == b->y && b->x < a->x) || a->y < b->y;
+}
+
+/* Interpolates a vertex attribute with the edge weights of a pixel */
+static Uint32
+_triangleLerp(const int *w, int v0, int v1, int v2, int area)
+{
+   return (Uint32)(((Sint64)w[0] * v0 + (Sint64)w[1] * v1 + (Sint64)w[2] * v2) / area);
+}
+
+/* Draws a triangle into an ARGB8888 surface one pixel at a time, the way the
+   software renderer's rasterizer is specified to. Textures are ARGB8888
+   surfaces, and only SDL_BLENDMODE_NONE and SDL_BLENDMODE_BLEND are handled. */
+static void
+_drawTriangleReference(SDL_Surface *dst, SDL_Surface *tex, const SDL_Vertex *v, SDL_BlendMode blend)
+{
+   const SDL_Color *c0 = &v[0].color, *c1 = &v[1].color, *c2 = &v[2].color;
+   SDL_Surface *target = dst;
+   SDL_Point d[3], s[3];
+   SDL_Rect bounds, rect;
+   int area, clockwise, uniform, modulate_color = 0, modulate_alpha = 0;
+   int bias[3], min, max, i, x, y;
+
+   for (i = 0; i < 3; i++) {
+      d[i].x = (int)v[i].position.x * 2;
+      d[i].y = (int)v[i].position.y * 2;
+      if (tex != NULL) {
+         s[i].x = (int)(v[i].tex_coord.x * tex->w);
+         s[i].y = (int)(v[i].tex_coord.y * tex->h);
+      }
+      if (v[i].color.r != 255 || v[i].color.g != 255 || v[i].color.b != 255) {
+         modulate_color = 1;
+      }
+      if (v[i].color.a != 255) {
+         modulate_alpha = 1;
+      }
+   }
+   uniform = SDL_memcmp(c0, c1, sizeof(*c0)) == 0 && SDL_memcmp(c1, c2, sizeof(*c1)) == 0;
+
+   area = _triangleEdge(&d[0], &d[1], d[2].x, d[2].y);
+   if (area == 0) {
+      return;
+   }
+   clockwise = area > 0;
+   area = SDL_abs(area);
+   bias[0] = _triangleTopLeft(&d[1], &d[2], clockwise) ? 0 : -1;
+   bias[1] = _triangleTopLeft(&d[2], &d[0], clockwise) ? 0 : -1;
+   bias[2] = _triangleTopLeft(&d[0], &d[1], clockwise) ? 0 : -1;
+
+   min = SDL_min(d[0].x, SDL_min(d[1].x, d[2].x));
+   max = SDL_max(d[0].x, SDL_max(d[1].x, d[2].x));
+   bounds.x = min >> 1;
+   bounds.w = (max - min) >> 1;
+   min = SDL_min(d[0].y, SDL_min(d[1].y, d[2].y));
+   max = SDL_max(d[0].y, SDL_max(d[1].y, d[2].y));
+   bounds.y = min >> 1;
+   bounds.h = (max - min) >> 1;
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = dst->w;
+   rect.h = dst->h;
+   SDL_IntersectRect(&bounds, &rect, &bounds);
+
+   if (tex != NULL) {
+      /* The last texel is at the highest texture coordinate, not past it */
+      min = SDL_min(s[0].x, SDL_min(s[1].x, s[2].x));
+      max = SDL_max(s[0].x, SDL_max(s[1].x, s[2].x));
+      for (i = 0; max > min && i < 3; i++) {
+         s[i].x -= (s[i].x == max);
+      }
+      min = SDL_min(s[0].y, SDL_min(s[1].y, s[2].y));
+      max = SDL_max(s[0].y, SDL_max(s[1].y, s[2].y));
+      for (i = 0; max > min && i < 3; i++) {
+         s[i].y -= (s[i].y == max);
+      }
+   } else if (blend != SDL_BLENDMODE_NONE) {
+      /* Blended fills are drawn to a transparent surface, then blitted */
+      target = SDL_CreateRGBSurfaceWithFormat(0, bounds.w, bounds.h, 0, SDL_PIXELFORMAT_ARGB8888);
+      if (target == NULL) {
+         return;
+      }
+      SDL_SetSurfaceBlendMode(target, blend);
+   }
+
+   for (y = bounds.y; y < bounds.y + bounds.h; y++) {
+      for (x = bounds.x; x < bounds.x + bounds.w; x++) {
+         Uint32 *pixel;
+         Uint32 r, g, b, a;
+         int w[3];
+
+         w[0] = _triangleEdge(&d[1], &d[2], 2 * x + 1, 2 * y + 1);
+         w[1] = _triangleEdge(&d[2], &d[0], 2 * x + 1, 2 * y + 1);
+         w[2] = _triangleEdge(&d[0], &d[1], 2 * x + 1, 2 * y + 1);
+         if (!clockwise) {
+            w[0] = -w[0];
+            w[1] = -w[1];
+            w[2] = -w[2];
+         }
+         if (w[0] + bias[0] < 0 || w[1] + bias[1] < 0 || w[2] + bias[2] < 0) {
+            continue;
+         }
+
+         if (uniform) {
+            r = c0->r;
+            g = c0->g;
+            b = c0->b;
+            a = c0->a;
+         } else {
+            r = _triangleLerp(w, c0->r, c1->r, c2->r, area);
+            g = _triangleLerp(w, c0->g, c1->g, c2->g, area);
+            b = _triangleLerp(w, c0->b, c1->b, c2->b, area);
+            a = _triangleLerp(w, c0->a, c1->a, c2->a, area);
+         }
+
+         if (target != dst) {
+            pixel = (Uint32 *)((Uint8 *)target->pixels + (y - bounds.y) * target->pitch) + (x - bounds.x);
+         } else {
+            pixel = (Uint32 *)((Uint8 *)dst->pixels + y * dst->pitch) + x;
+         }
+
+         if (tex != NULL) {
+            const Uint32 sx = _triangleLerp(w, s[0].x, s[1].x, s[2].x, area);
+            const Uint32 sy = _triangleLerp(w, s[0].y, s[1].y, s[2].y, area);
+            const Uint32 texel = ((const Uint32 *)((const Uint8 *)tex->pixels + sy * tex->pitch))[sx];
+            Uint32 sr = (texel >> 16) & 0xFF, sg = (texel >> 8) & 0xFF, sb = texel & 0xFF, sa = texel >> 24;
+            Uint32 dr = (*pixel >> 16) & 0xFF, dg = (*pixel >> 8) & 0xFF, db = *pixel & 0xFF, da = *pixel >> 24;
+
+            if (modulate_color) {
+               sr = (sr * r) / 255;
+               sg = (sg * g) / 255;
+               sb = (sb * b) / 255;
+            }
+            if (modulate_alpha) {
+               sa = (sa * a) / 255;
+            }
+            if (blend == SDL_BLENDMODE_BLEND) {
+               if (sa < 255) {
+                  sr = (sr * sa) / 255;
+                  sg = (sg * sa) / 255;
+                  sb = (sb * sa) / 255;
+               }
+               dr = sr + ((255 - sa) * dr) / 255;
+               dg = sg + ((255 - sa) * dg) / 255;
+               db = sb + ((255 - sa) * db) / 255;
+               da = sa + ((255 - sa) * da) / 255;
+            } else {
+               dr = sr;
+               dg = sg;
+               db = sb;
+               da = sa;
+            }
+            *pixel = (da << 24) | (dr << 16) | (dg << 8) | db;
+         } else {
+            *pixel = (a << 24) | (r << 16) | (g << 8) | b;
+         }
+      }
+   }
+
+   if (target != dst) {
+      SDL_BlitSurface(target, NULL, dst, &bounds);
+      SDL_FreeSurface(target);
+   }
+}
+
+/* Fills an ARGB8888 surface with a pattern that varies in every channel */
+static void
+_fillPattern(SDL_Surface *surface, int seed)
+{
+   int x, y;
+
+   for (y = 0; y < surface->h; y++) {
+      Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+      for (x = 0; x < surface->w; x++) {
+         row[x] = ((Uint32)(0x80 | ((x * y + seed) & 0x7F)) << 24) |
+                  ((Uint32)((x * 37 + seed) & 0xFF) << 16) |
+                  ((Uint32)((y * 53 + seed) & 0xFF) << 8) |
+                  (Uint32)((x * 11 + y * 29) & 0xFF);
+      }
+   }
+}
+
+/**
+ * @brief Tests SDL_RenderGeometry() in the software renderer against a
+ *        per-pixel reference, for colored, textured and blended triangles,
+ *        including clipped ones and ones much larger than the target.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_RenderGeometry
+ */
+int
+render_testSoftwareGeometry (void *arg)
+{
+   /* Odd sizes everywhere, so triangles end in the middle of pixel blocks */
+   const float positions[][6] = {
+      { 3.0f, 2.0f, 20.0f, 9.0f, 7.0f, 17.0f },
+      { 40.0f, 5.0f, 30.0f, 30.0f, 61.0f, 25.0f },
+      { 10.7f, 30.2f, 33.5f, 41.9f, 2.3f, 44.6f },
+      { 0.0f, 0.0f, 66.0f, 1.0f, 66.0f, 3.0f },
+      { -10.0f, -8.0f, 50.0f, 3.0f, 10.0f, 60.0f },
+      { -2000.0f, -1500.0f, 2100.0f, 30.0f, 40.0f, 1900.0f }
+   };
+   const float uv[6] = { 0.0f, 0.0f, 1.0f, 0.3f, 0.4f, 1.0f };
+   const SDL_Color colors[][3] = {
+      { { 255, 255, 255, 255 }, { 255, 255, 255, 255 }, { 255, 255, 255, 255 } },
+      { { 200, 100, 50, 255 }, { 200, 100, 50, 255 }, { 200, 100, 50, 255 } },
+      { { 255, 0, 0, 255 }, { 0, 255, 0, 128 }, { 0, 0, 255, 255 } },
+      { { 255, 0, 0, 200 }, { 0, 255, 0, 64 }, { 30, 60, 255, 128 } }
+   };
+   /* Texture (or none), blend mode and vertex colors of each pass */
+   const struct {
+      SDL_bool textured;
+      SDL_BlendMode blend;
+      int colors;
+   } passes[] = {
+      { SDL_FALSE, SDL_BLENDMODE_NONE, 1 },
+      { SDL_FALSE, SDL_BLENDMODE_NONE, 2 },
+      { SDL_FALSE, SDL_BLENDMODE_BLEND, 1 },
+      { SDL_FALSE, SDL_BLENDMODE_BLEND, 3 },
+      { SDL_TRUE, SDL_BLENDMODE_NONE, 0 },
+      { SDL_TRUE, SDL_BLENDMODE_NONE, 2 },
+      { SDL_TRUE, SDL_BLENDMODE_BLEND, 0 },
+      { SDL_TRUE, SDL_BLENDMODE_BLEND, 3 }
+   };
+   SDL_Surface *expected, *actual, *face;
+   SDL_Renderer *software = NULL;
+   SDL_Texture *texture = NULL;
+   int pass, t, i, ret;
+
+   expected = SDL_CreateRGBSurfaceWithFormat(0, 67, 45, 0, SDL_PIXELFORMAT_ARGB8888);
+   actual = SDL_CreateRGBSurfaceWithFormat(0, 67, 45, 0, SDL_PIXELFORMAT_ARGB8888);
+   face = SDL_CreateRGBSurfaceWithFormat(0, 13, 7, 0, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(expected != NULL && actual != NULL && face != NULL, "Verify surfaces are not NULL");
+   if (expected != NULL && actual != NULL && face != NULL) {
+      software = SDL_CreateSoftwareRenderer(actual);
+      SDLTest_AssertCheck(software != NULL, "Verify SDL_CreateSoftwareRenderer() result");
+   }
+   if (software != NULL) {
+      _fillPattern(face, 91);
+      texture = SDL_CreateTexture(software, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, face->w, face->h);
+      SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture() result");
+   }
+   if (texture != NULL) {
+      ret = SDL_UpdateTexture(texture, NULL, face->pixels, face->pitch);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+   }
+
+   for (pass = 0; texture != NULL && pass < (int)SDL_arraysize(passes); pass++) {
+      for (t = 0; t < (int)SDL_arraysize(positions); t++) {
+         SDL_Vertex verts[3];
+
+         for (i = 0; i < 3; i++) {
+            verts[i].position.x = positions[t][2 * i];
+            verts[i].position.y = positions[t][2 * i + 1];
+            verts[i].color = colors[passes[pass].colors][i];
+            verts[i].tex_coord.x = uv[2 * i];
+            verts[i].tex_coord.y = uv[2 * i + 1];
+         }
+
+         _fillPattern(expected, pass + t);
+         _fillPattern(actual, pass + t);
+         _drawTriangleReference(expected, passes[pass].textured ? face : NULL, verts, passes[pass].blend);
+
+         SDL_SetRenderDrawBlendMode(software, passes[pass].blend);
+         SDL_SetTextureBlendMode(texture, passes[pass].blend);
+         ret = SDL_RenderGeometry(software, passes[pass].textured ? texture : NULL, verts, 3, NULL, 0);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGeometry, expected: 0, got: %i", ret);
+         SDL_RenderFlush(software);
+
+         ret = SDLTest_CompareSurfaces(actual, expected, 0);
+         SDLTest_AssertCheck(ret == 0, "Validate pass %d, triangle %d matches the reference, got: %i", pass, t, ret);
+      }
+   }
+
+   if (texture != NULL) {
+      SDL_DestroyTexture(texture);
+   }
+   if (software != NULL) {
+      SDL_DestroyRenderer(software);
+   }
+   SDL_FreeSurface(face);
+   SDL_FreeSurface(actual);
+   SDL_FreeSurface(expected);
+
+   return TEST_COMPLETED;
+}
+
 /**
  * @brief Tests blitting with alpha.
  *
@@ -1090,9 +2336,33 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        { (SDLTest_TestCaseFp)render_testBlitAtlas, "render_testBlitAtlas", "Tests blitting from a texture atlas", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest9 =
+        { (SDLTest_TestCaseFp)render_testBlendFillRects, "render_testBlendFillRects", "Tests filling rects with blending in the software renderer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest10 =
+        { (SDLTest_TestCaseFp)render_testRetainedGeometry, "render_testRetainedGeometry", "Tests drawing retained geometry in the software renderer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest11 =
+        { (SDLTest_TestCaseFp)render_testGLVertexFlushes, "render_testGLVertexFlushes", "Tests many small flushes through the OpenGL renderer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest12 =
+        { (SDLTest_TestCaseFp)render_testSoftwareGeometry, "render_testSoftwareGeometry", "Tests software renderer geometry against a per-pixel reference", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest13 =
+        { (SDLTest_TestCaseFp)render_testSortCommands, "render_testSortCommands", "Tests sorted render commands draw the same as unsorted ones", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest14 =
+        { (SDLTest_TestCaseFp)render_testAtlasGutter, "render_testAtlasGutter", "Tests atlas textures are padded with copies of their edges", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest15 =
+        { (SDLTest_TestCaseFp)render_testGLStreamingUploads, "render_testGLStreamingUploads", "Tests streaming texture uploads in the OpenGL renderers against the software renderer", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, &renderTest9, &renderTest10, &renderTest11, &renderTest12, &renderTest13, &renderTest14, &renderTest15, NULL
 };
 
 /* Render test suite (global) */
@@ -58,6 +58,39 @@ sdltest_generateRunSeed(void *arg)
   return TEST_COMPLETED;
 }
 
+static void
+sdltest_benchmarkCounter(void *arg)
+{
+  int *counter = (int *)arg;
+  (*counter)++;
+}
+
+/**
+ * @brief Checks the harness function SDLTest_Benchmark
+ */
+int
+sdltest_benchmark(void *arg)
+{
+  int counter = 0;
+  int result;
+
+  result = SDLTest_Benchmark("sdltest_benchmarkCounter", sdltest_benchmarkCounter, &counter, 1);
+  SDLTest_AssertPass("Call to SDLTest_Benchmark()");
+  SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0, got: %d", result);
+  SDLTest_AssertCheck(counter > 0, "Verify benchmark function was called; got: %d calls", counter);
+
+  /* Negative cases */
+  result = SDLTest_Benchmark(NULL, sdltest_benchmarkCounter, &counter, 1);
+  SDLTest_AssertPass("Call to SDLTest_Benchmark(NULL, ...)");
+  SDLTest_AssertCheck(result == -1, "Verify result value; expected: -1, got: %d", result);
+
+  result = SDLTest_Benchmark("sdltest_benchmarkCounter", NULL, &counter, 1);
+  SDLTest_AssertPass("Call to SDLTest_Benchmark(..., NULL, ...)");
+  SDLTest_AssertCheck(result == -1, "Verify result value; expected: -1, got: %d", result);
+
+  return TEST_COMPLETED;
+}
+
 /**
  * @brief Calls to SDLTest_GetFuzzerInvocationCount()
  */
@@ -1302,11 +1335,14 @@ static const SDLTest_TestCaseReference sdltestTest14 =
 static const SDLTest_TestCaseReference sdltestTest15 =
         { (SDLTest_TestCaseFp)sdltest_generateRunSeed, "sdltest_generateRunSeed", "Checks internal harness function SDLTest_GenerateRunSeed", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference sdltestTest16 =
+        { (SDLTest_TestCaseFp)sdltest_benchmark, "sdltest_benchmark", "Checks harness function SDLTest_Benchmark", TEST_ENABLED };
+
 /* Sequence of SDL_test test cases */
 static const SDLTest_TestCaseReference *sdltestTests[] =  {
     &sdltestTest1, &sdltestTest2, &sdltestTest3, &sdltestTest4, &sdltestTest5, &sdltestTest6,
     &sdltestTest7, &sdltestTest8, &sdltestTest9, &sdltestTest10, &sdltestTest11, &sdltestTest12,
-    &sdltestTest13, &sdltestTest14, &sdltestTest15, NULL
+    &sdltestTest13, &sdltestTest14, &sdltestTest15, &sdltestTest16, NULL
 };
 
 /* SDL_test test suite (global) */
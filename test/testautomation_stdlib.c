@@ -492,6 +492,223 @@ stdlib_overflow(void *arg)
   return TEST_COMPLETED;
 }
 
+typedef struct
+{
+    Uint8 *src;
+    Uint8 *dst;
+    size_t len;
+} memcpy_benchmark_data;
+
+static void
+stdlib_memcpyBenchmarkFunc(void *arg)
+{
+    memcpy_benchmark_data *data = (memcpy_benchmark_data *)arg;
+    SDL_memcpy(data->dst, data->src, data->len);
+}
+
+static void
+stdlib_memsetBenchmarkFunc(void *arg)
+{
+    memcpy_benchmark_data *data = (memcpy_benchmark_data *)arg;
+    SDL_memset(data->dst, 0xA5, data->len);
+}
+
+/**
+ * @brief Benchmark of SDL_memcpy and SDL_memset over a large buffer
+ */
+static int
+stdlib_benchmarkMemcpy(void *arg)
+{
+    memcpy_benchmark_data data;
+    int result;
+
+    data.len = 4 * 1024 * 1024;
+    data.src = (Uint8 *)SDL_malloc(data.len);
+    data.dst = (Uint8 *)SDL_malloc(data.len);
+    SDLTest_AssertCheck(data.src != NULL && data.dst != NULL, "Check buffer allocation");
+    if (data.src == NULL || data.dst == NULL) {
+        SDL_free(data.src);
+        SDL_free(data.dst);
+        return TEST_ABORTED;
+    }
+    SDL_memset(data.src, 0x5A, data.len);
+
+    result = SDLTest_Benchmark("SDL_memcpy 4MB", stdlib_memcpyBenchmarkFunc, &data, data.len);
+    SDLTest_AssertCheck(result == 0, "Call to SDLTest_Benchmark(SDL_memcpy), expected 0, got %d", result);
+    result = SDLTest_Benchmark("SDL_memset 4MB", stdlib_memsetBenchmarkFunc, &data, data.len);
+    SDLTest_AssertCheck(result == 0, "Call to SDLTest_Benchmark(SDL_memset), expected 0, got %d", result);
+
+    SDL_free(data.src);
+    SDL_free(data.dst);
+    return TEST_COMPLETED;
+}
+
+static const char *iconv_encodings[] = {
+    "UTF-8", "UTF-16LE", "UTF-16BE", "UTF-32LE", "UTF-32BE"
+};
+
+/* Encodes code points the way the named encoding should, to check SDL_iconv against */
+static size_t
+stdlib_iconvEncode(const Uint32 *chars, int count, const char *encoding, Uint8 *dst)
+{
+    Uint8 *start = dst;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        Uint32 ch = chars[i];
+
+        if (SDL_strcmp(encoding, "UTF-8") == 0) {
+            if (ch < 0x80) {
+                *dst++ = (Uint8)ch;
+            } else if (ch < 0x800) {
+                *dst++ = (Uint8)(0xC0 | (ch >> 6));
+                *dst++ = (Uint8)(0x80 | (ch & 0x3F));
+            } else if (ch < 0x10000) {
+                *dst++ = (Uint8)(0xE0 | (ch >> 12));
+                *dst++ = (Uint8)(0x80 | ((ch >> 6) & 0x3F));
+                *dst++ = (Uint8)(0x80 | (ch & 0x3F));
+            } else {
+                *dst++ = (Uint8)(0xF0 | (ch >> 18));
+                *dst++ = (Uint8)(0x80 | ((ch >> 12) & 0x3F));
+                *dst++ = (Uint8)(0x80 | ((ch >> 6) & 0x3F));
+                *dst++ = (Uint8)(0x80 | (ch & 0x3F));
+            }
+        } else if (SDL_strncmp(encoding, "UTF-16", 6) == 0) {
+            const SDL_bool be = (encoding[6] == 'B');
+            Uint16 units[2];
+            int n = 1, j;
+
+            if (ch < 0x10000) {
+                units[0] = (Uint16)ch;
+            } else {
+                units[0] = (Uint16)(0xD800 | ((ch - 0x10000) >> 10));
+                units[1] = (Uint16)(0xDC00 | ((ch - 0x10000) & 0x3FF));
+                n = 2;
+            }
+            for (j = 0; j < n; ++j) {
+                *dst++ = (Uint8)(be ? (units[j] >> 8) : units[j]);
+                *dst++ = (Uint8)(be ? units[j] : (units[j] >> 8));
+            }
+        } else {
+            const SDL_bool be = (encoding[6] == 'B');
+            int j;
+
+            for (j = 0; j < 4; ++j) {
+                *dst++ = (Uint8)(ch >> (be ? (24 - 8 * j) : (8 * j)));
+            }
+        }
+    }
+    return (size_t)(dst - start);
+}
+
+/* Converts with SDL_iconv into a small buffer, so the output fills up part way through runs */
+static size_t
+stdlib_iconvChunked(const char *tocode, const char *fromcode, const Uint8 *src, size_t srclen, Uint8 *dst)
+{
+    SDL_iconv_t cd;
+    const char *inbuf = (const char *)src;
+    size_t inbytesleft = srclen;
+    size_t total = 0;
+
+    cd = SDL_iconv_open(tocode, fromcode);
+    SDLTest_AssertCheck(cd != (SDL_iconv_t)-1, "Check SDL_iconv_open(\"%s\", \"%s\")", tocode, fromcode);
+    if (cd == (SDL_iconv_t)-1) {
+        return 0;
+    }
+    while (inbytesleft > 0) {
+        char chunk[7];
+        char *outbuf = chunk;
+        size_t outbytesleft = sizeof(chunk);
+        const size_t retCode = SDL_iconv(cd, &inbuf, &inbytesleft, &outbuf, &outbytesleft);
+
+        SDL_memcpy(dst + total, chunk, outbuf - chunk);
+        total += outbuf - chunk;
+        if (retCode == SDL_ICONV_E2BIG && outbuf != chunk) {
+            continue;
+        }
+        SDLTest_AssertCheck(retCode != SDL_ICONV_ERROR && retCode != SDL_ICONV_E2BIG &&
+                            retCode != SDL_ICONV_EILSEQ && retCode != SDL_ICONV_EINVAL,
+                            "Check SDL_iconv(\"%s\", \"%s\") result, got %d", tocode, fromcode, (int)retCode);
+        if (retCode == SDL_ICONV_ERROR || retCode == SDL_ICONV_E2BIG ||
+            retCode == SDL_ICONV_EILSEQ || retCode == SDL_ICONV_EINVAL) {
+            break;
+        }
+    }
+    SDL_iconv_close(cd);
+    return total;
+}
+
+/**
+ * @brief Call to SDL_iconv_string and SDL_iconv with ASCII runs split by other characters
+ */
+static int
+stdlib_iconv(void *arg)
+{
+    /* Run lengths around the 16 character blocks of the ASCII fast path */
+    static const int lengths[] = { 1, 15, 16, 17, 31, 32, 33, 50 };
+    /* Characters taking 2, 3 and 4 bytes in UTF-8, the last a surrogate pair in UTF-16 */
+    static const Uint32 others[] = { 0xE9, 0x20AC, 0x1F600 };
+    const char *invalid = "ab\xC3" "cd";
+    Uint32 chars[64];
+    Uint8 src[256], expected[256], chunked[256];
+    int i, j, k, place, from, to;
+    char *result;
+
+    for (i = 0; i < (int)SDL_arraysize(lengths); ++i) {
+        const int length = lengths[i];
+
+        /* Try no other character, then each at the ends of the run and either side of each block edge */
+        for (place = -1; place < length; ++place) {
+            if (place >= 0 && place != 0 && place != length - 1 && (place % 16) != 0 && (place % 16) != 15) {
+                continue;
+            }
+            for (k = 0; k < (int)SDL_arraysize(others); ++k) {
+                for (j = 0; j < length; ++j) {
+                    chars[j] = (Uint32)('a' + (j % 26));
+                }
+                if (place >= 0) {
+                    chars[place] = others[k];
+                    /* Mix in a second character after the next block edge */
+                    if (place + 17 < length) {
+                        chars[place + 17] = others[(k + 1) % SDL_arraysize(others)];
+                    }
+                } else if (k > 0) {
+                    continue;
+                }
+
+                for (from = 0; from < (int)SDL_arraysize(iconv_encodings); ++from) {
+                    const size_t srclen = stdlib_iconvEncode(chars, length, iconv_encodings[from], src);
+
+                    for (to = 0; to < (int)SDL_arraysize(iconv_encodings); ++to) {
+                        const size_t len = stdlib_iconvEncode(chars, length, iconv_encodings[to], expected);
+                        size_t chunkedlen;
+
+                        result = SDL_iconv_string(iconv_encodings[to], iconv_encodings[from], (const char *)src, srclen);
+                        SDLTest_AssertCheck(result != NULL && SDL_memcmp(result, expected, len) == 0,
+                                            "Check SDL_iconv_string(\"%s\", \"%s\") of %d characters, other at %d",
+                                            iconv_encodings[to], iconv_encodings[from], length, place);
+                        SDL_free(result);
+
+                        chunkedlen = stdlib_iconvChunked(iconv_encodings[to], iconv_encodings[from], src, srclen, chunked);
+                        SDLTest_AssertCheck(chunkedlen == len && SDL_memcmp(chunked, expected, len) == 0,
+                                            "Check SDL_iconv(\"%s\", \"%s\") of %d characters, other at %d, expected %d bytes, got %d",
+                                            iconv_encodings[to], iconv_encodings[from], length, place, (int)len, (int)chunkedlen);
+                    }
+                }
+            }
+        }
+    }
+
+    /* A sequence cut short by ASCII is illegal, it mustn't stop the conversion */
+    result = SDL_iconv_string("UTF-8", "UTF-8", invalid, SDL_strlen(invalid));
+    SDLTest_AssertCheck(result != NULL && SDL_strncmp(result, "ab", 2) == 0 &&
+                        SDL_strlen(result) >= 4 && SDL_strcmp(result + SDL_strlen(result) - 2, "cd") == 0,
+                        "Check SDL_iconv_string(\"UTF-8\", \"UTF-8\") skips an illegal sequence, got \"%s\"", result ? result : "(null)");
+    SDL_free(result);
+
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Standard C routine test cases */
@@ -510,6 +727,12 @@ static const SDLTest_TestCaseReference stdlibTest4 =
 static const SDLTest_TestCaseReference stdlibTestOverflow =
         { stdlib_overflow, "stdlib_overflow", "Overflow detection", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference stdlibTestIconv =
+        { stdlib_iconv, "stdlib_iconv", "Call to SDL_iconv_string and SDL_iconv", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference stdlibBenchmarkMemcpy =
+        { stdlib_benchmarkMemcpy, "stdlib_benchmarkMemcpy", "Benchmark of SDL_memcpy and SDL_memset", TEST_BENCHMARK };
+
 /* Sequence of Standard C routine test cases */
 static const SDLTest_TestCaseReference *stdlibTests[] =  {
     &stdlibTest1,
@@ -517,6 +740,8 @@ static const SDLTest_TestCaseReference *stdlibTests[] =  {
     &stdlibTest3,
     &stdlibTest4,
     &stdlibTestOverflow,
+    &stdlibTestIconv,
+    &stdlibBenchmarkMemcpy,
     NULL
 };
 
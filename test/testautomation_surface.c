@@ -764,6 +764,755 @@ surface_testOverflow(void *arg)
     return TEST_COMPLETED;
 }
 
+/**
+ * @brief Tests linear scaling with SDL_SoftStretchLinear() in all the formats it supports.
+ */
+int
+surface_testStretchLinear(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGB888,
+        SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_BGR24,
+        SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB555, SDL_PIXELFORMAT_ARGB4444, SDL_PIXELFORMAT_ARGB1555
+    };
+    /* Upscaling, bilinear downscaling and area averaging downscales */
+    const SDL_Point sizes[] = { { 80, 50 }, { 30, 20 }, { 9, 5 }, { 1, 1 } };
+    const int src_w = 37, src_h = 23;
+    int f, i, x, y;
+
+    for (f = 0; f < SDL_arraysize(formats); f++) {
+        SDL_Surface *src = SDL_CreateRGBSurfaceWithFormat(0, src_w, src_h, 0, formats[f]);
+        const char *name = SDL_GetPixelFormatName(formats[f]);
+        Uint32 color;
+
+        SDLTest_AssertCheck(src != NULL, "Verify source surface in %s is not NULL", name);
+        if (src == NULL) {
+            continue;
+        }
+        color = SDL_MapRGBA(src->format, 0x40, 0x80, 0xC0, 0xFF);
+
+        for (i = 0; i < SDL_arraysize(sizes); i++) {
+            SDL_Surface *dst = SDL_CreateRGBSurfaceWithFormat(0, sizes[i].x, sizes[i].y, 0, formats[f]);
+            int ret, mismatches = 0, reversals = 0;
+
+            SDLTest_AssertCheck(dst != NULL, "Verify destination surface in %s is not NULL", name);
+            if (dst == NULL) {
+                continue;
+            }
+
+            /* A flat color has to stay exactly the same */
+            SDL_FillRect(src, NULL, color);
+            ret = SDL_SoftStretchLinear(src, NULL, dst, NULL);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SoftStretchLinear(%s, %dx%d), expected: 0, got: %i", name, dst->w, dst->h, ret);
+            for (y = 0; y < dst->h; y++) {
+                for (x = 0; x < dst->w; x++) {
+                    Uint32 pixel = 0;
+                    SDL_memcpy(&pixel, (Uint8 *)dst->pixels + y * dst->pitch + x * dst->format->BytesPerPixel, dst->format->BytesPerPixel);
+                    if (SDL_BYTEORDER == SDL_BIG_ENDIAN) {
+                        pixel >>= (32 - 8 * dst->format->BytesPerPixel);
+                    }
+                    if (pixel != color) {
+                        mismatches++;
+                    }
+                }
+            }
+            SDLTest_AssertCheck(mismatches == 0, "Verify flat color stays flat in %s %dx%d, %d pixels differ", name, dst->w, dst->h, mismatches);
+
+            /* A horizontal gradient has to stay a gradient */
+            for (x = 0; x < src_w; x++) {
+                SDL_Rect column;
+                const Uint8 level = (Uint8)(x * 255 / (src_w - 1));
+                column.x = x;
+                column.y = 0;
+                column.w = 1;
+                column.h = src_h;
+                SDL_FillRect(src, &column, SDL_MapRGBA(src->format, level, level, level, 0xFF));
+            }
+            SDL_SoftStretchLinear(src, NULL, dst, NULL);
+            for (y = 0; y < dst->h; y++) {
+                Uint8 last = 0;
+                for (x = 0; x < dst->w; x++) {
+                    Uint32 pixel = 0;
+                    Uint8 r, g, b;
+                    SDL_memcpy(&pixel, (Uint8 *)dst->pixels + y * dst->pitch + x * dst->format->BytesPerPixel, dst->format->BytesPerPixel);
+                    if (SDL_BYTEORDER == SDL_BIG_ENDIAN) {
+                        pixel >>= (32 - 8 * dst->format->BytesPerPixel);
+                    }
+                    SDL_GetRGB(pixel, dst->format, &r, &g, &b);
+                    if (r < last) {
+                        reversals++;
+                    }
+                    last = r;
+                }
+            }
+            SDLTest_AssertCheck(reversals == 0, "Verify gradient stays ordered in %s %dx%d, %d reversals", name, dst->w, dst->h, reversals);
+
+            SDL_FreeSurface(dst);
+        }
+        SDL_FreeSurface(src);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests blitting sub-rectangles of RLE encoded surfaces.
+ */
+int
+surface_testBlitClippedRLE(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_RGB332, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_RGB888,
+        SDL_PIXELFORMAT_ARGB8888
+    };
+    /* Full surface, left and right clipped, narrow columns, and below the last visible line */
+    const SDL_Rect rects[] = {
+        { 0, 0, 61, 47 }, { 5, 3, 40, 30 }, { 0, 10, 7, 20 }, { 33, 0, 1, 47 }, { 60, 46, 1, 1 }, { 12, 40, 30, 7 }
+    };
+    const int w = 61, h = 47;
+    int f, i, x, y;
+
+    for (f = 0; f < SDL_arraysize(formats); f++) {
+        const char *name = SDL_GetPixelFormatName(formats[f]);
+        const SDL_bool alpha = SDL_ISPIXELFORMAT_ALPHA(formats[f]);
+        SDL_Surface *rle = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, formats[f]);
+        SDL_Surface *plain = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, formats[f]);
+        SDL_Surface *expected = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, SDL_PIXELFORMAT_RGB888);
+        SDL_Surface *actual = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, SDL_PIXELFORMAT_RGB888);
+
+        SDLTest_AssertCheck(rle && plain && expected && actual, "Verify surfaces in %s are not NULL", name);
+        if (!rle || !plain || !expected || !actual) {
+            continue;
+        }
+
+        /* Diagonal stripes of opaque pixels; the last lines are left blank */
+        SDL_FillRect(rle, NULL, 0);
+        for (y = 0; y < h - 4; y++) {
+            for (x = 0; x < w; x++) {
+                SDL_Rect pixel;
+                if (((x + y) / 3) % 3 == 0) {
+                    continue;
+                }
+                pixel.x = x;
+                pixel.y = y;
+                pixel.w = pixel.h = 1;
+                SDL_FillRect(rle, &pixel, SDL_MapRGBA(rle->format, (Uint8)(x * 4), (Uint8)(y * 5), 0x80, 0xFF));
+            }
+        }
+        SDL_BlitSurface(rle, NULL, plain, NULL);
+        if (alpha) {
+            SDL_SetSurfaceBlendMode(rle, SDL_BLENDMODE_BLEND);
+            SDL_SetSurfaceBlendMode(plain, SDL_BLENDMODE_BLEND);
+        } else {
+            SDL_SetColorKey(rle, SDL_TRUE, 0);
+            SDL_SetColorKey(plain, SDL_TRUE, 0);
+        }
+        SDL_SetSurfaceRLE(rle, 1);
+
+        for (i = 0; i < SDL_arraysize(rects); i++) {
+            SDL_Rect srcrect = rects[i];
+            SDL_Rect dstrect = rects[i];
+            int ret, mismatches = 0;
+
+            SDL_FillRect(expected, NULL, SDL_MapRGB(expected->format, 0x10, 0x20, 0x30));
+            SDL_FillRect(actual, NULL, SDL_MapRGB(actual->format, 0x10, 0x20, 0x30));
+            SDL_BlitSurface(plain, &srcrect, expected, &dstrect);
+            dstrect = rects[i];
+            ret = SDL_BlitSurface(rle, &srcrect, actual, &dstrect);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface(%s, %d,%d %dx%d), expected: 0, got: %i", name, srcrect.x, srcrect.y, srcrect.w, srcrect.h, ret);
+            SDLTest_AssertCheck(SDL_HasSurfaceRLE(rle), "Verify %s surface is RLE encoded", name);
+            for (y = 0; y < h; y++) {
+                if (SDL_memcmp((Uint8 *)expected->pixels + y * expected->pitch, (Uint8 *)actual->pixels + y * actual->pitch, w * 4) != 0) {
+                    mismatches++;
+                }
+            }
+            SDLTest_AssertCheck(mismatches == 0, "Verify RLE blit of %s %d,%d %dx%d matches, %d lines differ", name, srcrect.x, srcrect.y, srcrect.w, srcrect.h, mismatches);
+        }
+
+        SDL_FreeSurface(rle);
+        SDL_FreeSurface(plain);
+        SDL_FreeSurface(expected);
+        SDL_FreeSurface(actual);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that wide, narrow and very large fills produce the same pixels in every depth.
+ */
+int
+surface_testFillRects(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_RGB332, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_RGB888
+    };
+    /* Narrow and wide rects at every alignment, plus clipped ones */
+    const SDL_Rect rects[] = {
+        { 0, 0, 1, 1 }, { 1, 1, 5, 3 }, { 3, 2, 21, 4 }, { 7, 5, 64, 2 }, { 2, 8, 130, 3 },
+        { 0, 12, 173, 9 }, { 13, 22, 97, 5 }, { 160, 30, 40, 4 }, { -5, 36, 50, 3 }
+    };
+    const int w = 173, h = 40;
+    int f, i, x, y;
+
+    for (f = 0; f < SDL_arraysize(formats); f++) {
+        const char *name = SDL_GetPixelFormatName(formats[f]);
+        SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, formats[f]);
+        SDL_Surface *big;
+        int bpp, mismatches = 0;
+        Uint8 pixel[4];
+        Uint32 color;
+
+        SDLTest_AssertCheck(surface != NULL, "Verify %s surface is not NULL", name);
+        if (!surface) {
+            continue;
+        }
+        bpp = surface->format->BytesPerPixel;
+        color = SDL_MapRGB(surface->format, 0x8A, 0x45, 0xC3);
+
+        /* A single pixel fill gives the expected bytes */
+        SDL_FillRect(surface, NULL, 0);
+        SDL_FillRect(surface, &rects[0], color);
+        SDL_memcpy(pixel, surface->pixels, bpp);
+
+        for (i = 1; i < SDL_arraysize(rects); i++) {
+            SDL_Rect clipped;
+            int ret;
+
+            SDL_FillRect(surface, NULL, 0);
+            ret = SDL_FillRects(surface, &rects[i], 1, color);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRects(%s), expected: 0, got: %i", name, ret);
+            SDL_IntersectRect(&rects[i], &surface->clip_rect, &clipped);
+            for (y = 0; y < h; y++) {
+                for (x = 0; x < w; x++) {
+                    const Uint8 *p = (Uint8 *)surface->pixels + y * surface->pitch + x * bpp;
+                    const SDL_Point point = { x, y };
+                    if (SDL_PointInRect(&point, &clipped)) {
+                        mismatches += SDL_memcmp(p, pixel, bpp) != 0;
+                    } else {
+                        mismatches += p[0] != 0 || p[bpp - 1] != 0;
+                    }
+                }
+            }
+        }
+        SDLTest_AssertCheck(mismatches == 0, "Verify %s fills match, %d pixels differ", name, mismatches);
+        SDL_FreeSurface(surface);
+
+        /* Large enough to bypass the cache */
+        big = SDL_CreateRGBSurfaceWithFormat(0, 1531, (9 * 1024 * 1024) / (1531 * bpp), 0, formats[f]);
+        SDLTest_AssertCheck(big != NULL, "Verify large %s surface is not NULL", name);
+        if (!big) {
+            continue;
+        }
+        mismatches = 0;
+        SDL_FillRect(big, NULL, color);
+        for (y = 0; y < big->h; y++) {
+            for (x = 0; x < big->w; x++) {
+                mismatches += SDL_memcmp((Uint8 *)big->pixels + y * big->pitch + x * bpp, pixel, bpp) != 0;
+            }
+        }
+        SDLTest_AssertCheck(mismatches == 0, "Verify large %s fill matches, %d pixels differ", name, mismatches);
+        SDL_FreeSurface(big);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests blitting RGB surfaces to palettized surfaces, with and without dithering.
+ */
+int
+surface_testBlitToPalette(void *arg)
+{
+    const Uint32 formats[] = { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_BGR24 };
+    SDL_Color colors[256];
+    int f, i, x, y;
+
+    for (i = 0; i < SDL_arraysize(colors); i++) {
+        colors[i].r = SDLTest_RandomUint8();
+        colors[i].g = SDLTest_RandomUint8();
+        colors[i].b = SDLTest_RandomUint8();
+        colors[i].a = SDL_ALPHA_OPAQUE;
+    }
+
+    for (f = 0; f < SDL_arraysize(formats); f++) {
+        const char *name = SDL_GetPixelFormatName(formats[f]);
+        const int ncolors = SDLTest_RandomIntegerInRange(2, 256);
+        SDL_Surface *src = SDL_CreateRGBSurfaceWithFormat(0, 32 * 32, 32, 0, formats[f]);
+        SDL_Surface *dst = SDL_CreateRGBSurfaceWithFormat(0, 32 * 32, 32, 0, SDL_PIXELFORMAT_INDEX8);
+        int ret, mismatches = 0;
+
+        SDLTest_AssertCheck(src != NULL && dst != NULL, "Verify %s and INDEX8 surfaces are not NULL", name);
+        if (!src || !dst) {
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(dst);
+            continue;
+        }
+        SDL_SetPaletteColors(dst->format->palette, colors, 0, ncolors);
+
+        /* One pixel for each 5-bit cell of the color cube */
+        for (y = 0; y < src->h; y++) {
+            for (x = 0; x < src->w; x++) {
+                SDL_Rect rect;
+                rect.x = x;
+                rect.y = y;
+                rect.w = rect.h = 1;
+                SDL_FillRect(src, &rect, SDL_MapRGB(src->format, (x >> 5) * 255 / 31, (x & 31) * 255 / 31, y * 255 / 31));
+            }
+        }
+        ret = SDL_BlitSurface(src, NULL, dst, NULL);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface(%s), expected: 0, got: %i", name, ret);
+        for (y = 0; y < src->h; y++) {
+            for (x = 0; x < src->w; x++) {
+                const Uint32 expected = SDL_MapRGB(dst->format, (x >> 5) * 255 / 31, (x & 31) * 255 / 31, y * 255 / 31);
+                mismatches += ((Uint8 *)dst->pixels)[y * dst->pitch + x] != expected;
+            }
+        }
+        SDLTest_AssertCheck(mismatches == 0, "Verify %s blit to a %d color palette matches SDL_MapRGB, %d pixels differ", name, ncolors, mismatches);
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(dst);
+    }
+
+    /* Dithering to black and white keeps the average brightness */
+    {
+        const SDL_Color bw[2] = { { 0, 0, 0, SDL_ALPHA_OPAQUE }, { 255, 255, 255, SDL_ALPHA_OPAQUE } };
+        SDL_Surface *src = SDL_CreateRGBSurfaceWithFormat(0, 256, 64, 0, SDL_PIXELFORMAT_RGB888);
+        SDL_Surface *dst = SDL_CreateRGBSurfaceWithFormat(0, 256, 64, 0, SDL_PIXELFORMAT_INDEX8);
+        int white = 0;
+
+        SDLTest_AssertCheck(src != NULL && dst != NULL, "Verify dither surfaces are not NULL");
+        if (src && dst) {
+            SDL_SetHint(SDL_HINT_SURFACE_DITHER, "1");
+            SDL_SetPaletteColors(dst->format->palette, bw, 0, SDL_arraysize(bw));
+            SDL_FillRect(src, NULL, SDL_MapRGB(src->format, 64, 64, 64));
+            SDL_BlitSurface(src, NULL, dst, NULL);
+            for (y = 0; y < dst->h; y++) {
+                for (x = 0; x < dst->w; x++) {
+                    white += ((Uint8 *)dst->pixels)[y * dst->pitch + x];
+                }
+            }
+            /* 64/255 of the pixels should be white */
+            SDLTest_AssertCheck(SDL_abs(white * 255 - 64 * dst->w * dst->h) <= 255 * dst->w,
+                                "Verify dithered blit has %d white pixels, got %d", 64 * dst->w * dst->h / 255, white);
+            SDL_ResetHint(SDL_HINT_SURFACE_DITHER);
+        }
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(dst);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that blits between 24 and 32-bit formats keep every channel.
+ */
+int
+surface_testBlitSwizzle(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_BGR24, SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_BGR888,
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_BGRA8888
+    };
+    /* Wide enough for whole SIMD blocks and a partial one */
+    const int w = 77, h = 3;
+    int s, d, x, y;
+
+    for (s = 0; s < SDL_arraysize(formats); s++) {
+        SDL_Surface *src = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, formats[s]);
+
+        SDLTest_AssertCheck(src != NULL, "Verify %s surface is not NULL", SDL_GetPixelFormatName(formats[s]));
+        if (!src) {
+            continue;
+        }
+        for (y = 0; y < h; y++) {
+            for (x = 0; x < src->pitch; x++) {
+                ((Uint8 *)src->pixels)[y * src->pitch + x] = SDLTest_RandomUint8();
+            }
+        }
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+
+        for (d = 0; d < SDL_arraysize(formats); d++) {
+            SDL_Surface *dst = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, formats[d]);
+            int ret, mismatches = 0;
+
+            SDLTest_AssertCheck(dst != NULL, "Verify %s surface is not NULL", SDL_GetPixelFormatName(formats[d]));
+            if (!dst) {
+                continue;
+            }
+            ret = SDL_BlitSurface(src, NULL, dst, NULL);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+            for (y = 0; y < h; y++) {
+                for (x = 0; x < w; x++) {
+                    Uint32 sp = 0, dp = 0;
+                    Uint8 sr, sg, sb, sa, dr, dg, db, da;
+
+                    SDL_memcpy(&sp, (Uint8 *)src->pixels + y * src->pitch + x * src->format->BytesPerPixel, src->format->BytesPerPixel);
+                    SDL_memcpy(&dp, (Uint8 *)dst->pixels + y * dst->pitch + x * dst->format->BytesPerPixel, dst->format->BytesPerPixel);
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+                    sp >>= 8 * (4 - src->format->BytesPerPixel);
+                    dp >>= 8 * (4 - dst->format->BytesPerPixel);
+#endif
+                    SDL_GetRGBA(sp, src->format, &sr, &sg, &sb, &sa);
+                    SDL_GetRGBA(dp, dst->format, &dr, &dg, &db, &da);
+                    if (!dst->format->Amask) {
+                        sa = da;
+                    }
+                    mismatches += (sr != dr || sg != dg || sb != db || sa != da);
+                }
+            }
+            SDLTest_AssertCheck(mismatches == 0, "Verify %s to %s blit keeps every channel, %d pixels differ",
+                                SDL_GetPixelFormatName(formats[s]), SDL_GetPixelFormatName(formats[d]), mismatches);
+            SDL_FreeSurface(dst);
+        }
+        SDL_FreeSurface(src);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that large conversions split across threads match the serial ones.
+ */
+int
+surface_testConvertThreads(void *arg)
+{
+    const struct {
+        Uint32 src_format;
+        Uint32 dst_format;
+    } conversions[] = {
+        { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565 },
+        { SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_ABGR8888 },
+        { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_IYUV },
+        { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_NV21 },
+        { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_UYVY },
+        { SDL_PIXELFORMAT_YV12, SDL_PIXELFORMAT_RGB24 },
+        { SDL_PIXELFORMAT_NV12, SDL_PIXELFORMAT_ARGB8888 }
+    };
+    /* Over the threshold for splitting, with an odd number of rows */
+    const int w = 700, h = 401;
+    const int pitch = w * 4;
+    const int size = pitch * h;
+    Uint8 *src = (Uint8 *)SDL_malloc(size);
+    Uint8 *serial = (Uint8 *)SDL_malloc(size);
+    Uint8 *threaded = (Uint8 *)SDL_malloc(size);
+    int i, c;
+
+    SDLTest_AssertCheck(src && serial && threaded, "Verify buffers are not NULL");
+    if (src && serial && threaded) {
+        for (i = 0; i < size; i++) {
+            src[i] = SDLTest_RandomUint8();
+        }
+
+        for (c = 0; c < SDL_arraysize(conversions); c++) {
+            const Uint32 src_format = conversions[c].src_format;
+            const Uint32 dst_format = conversions[c].dst_format;
+            const int src_pitch = SDL_ISPIXELFORMAT_FOURCC(src_format) ? w : pitch;
+            const int dst_pitch = SDL_ISPIXELFORMAT_FOURCC(dst_format) ? (dst_format == SDL_PIXELFORMAT_UYVY ? w * 2 : w) : pitch;
+            int ret;
+
+            SDL_memset(serial, 0, size);
+            SDL_memset(threaded, 0, size);
+            SDL_SetHint(SDL_HINT_SURFACE_CONVERT_THREADS, "1");
+            ret = SDL_ConvertPixels(w, h, src_format, src, src_pitch, dst_format, serial, dst_pitch);
+            SDLTest_AssertCheck(ret == 0, "Verify result from serial SDL_ConvertPixels, expected: 0, got: %i", ret);
+            SDL_SetHint(SDL_HINT_SURFACE_CONVERT_THREADS, "4");
+            ret = SDL_ConvertPixels(w, h, src_format, src, src_pitch, dst_format, threaded, dst_pitch);
+            SDLTest_AssertCheck(ret == 0, "Verify result from threaded SDL_ConvertPixels, expected: 0, got: %i", ret);
+            SDLTest_AssertCheck(SDL_memcmp(serial, threaded, size) == 0, "Verify %s to %s conversion is the same on 4 threads",
+                                SDL_GetPixelFormatName(src_format), SDL_GetPixelFormatName(dst_format));
+        }
+        SDL_ResetHint(SDL_HINT_SURFACE_CONVERT_THREADS);
+    }
+    SDL_free(src);
+    SDL_free(serial);
+    SDL_free(threaded);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests saving and loading bitmaps that are converted and read in bands
+ */
+int
+surface_testSaveLoadBitmapBands(void *arg)
+{
+    const char *sampleFilename = "testSaveLoadBitmapBands.bmp";
+    const Uint32 formats[] = { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888 };
+    /* Big enough to be saved in several bands, with an odd number of rows */
+    const int w = 700, h = 401;
+    const int size = w * h * 4 + 1024;
+    Uint8 *mem = (Uint8 *)SDL_malloc(size);
+    int f, i, y;
+
+    SDLTest_AssertCheck(mem != NULL, "Verify buffer is not NULL");
+    for (f = 0; mem != NULL && f < SDL_arraysize(formats); f++) {
+        SDL_Surface *face = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, formats[f]);
+        SDL_Surface *expected, *loaded[2];
+        SDL_RWops *rw;
+        Sint64 len;
+        int ret;
+
+        SDLTest_AssertCheck(face != NULL, "Verify surface is not NULL");
+        if (face == NULL) {
+            continue;
+        }
+        for (i = 0; i < face->h * face->pitch; i++) {
+            ((Uint8 *)face->pixels)[i] = SDLTest_RandomUint8();
+        }
+        if (!face->format->Amask) {
+            /* Saved as 32-bit with the colorkey in the alpha channel */
+            SDL_SetColorKey(face, SDL_TRUE, *(Uint32 *)face->pixels);
+        }
+        expected = SDL_ConvertSurfaceFormat(face, SDL_PIXELFORMAT_BGRA32, 0);
+
+        rw = SDL_RWFromMem(mem, size);
+        ret = SDL_SaveBMP_RW(face, rw, 0);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SaveBMP_RW, expected: 0, got: %i", ret);
+        len = SDL_RWtell(rw);
+        SDL_RWclose(rw);
+
+        /* A memory stream gets copied straight into place, a file gets read in one go and flipped */
+        loaded[0] = SDL_LoadBMP_RW(SDL_RWFromConstMem(mem, (int)len), 1);
+        unlink(sampleFilename);
+        rw = SDL_RWFromFile(sampleFilename, "wb");
+        if (rw != NULL) {
+            SDL_RWwrite(rw, mem, 1, (size_t)len);
+            SDL_RWclose(rw);
+        }
+        loaded[1] = SDL_LoadBMP(sampleFilename);
+        unlink(sampleFilename);
+
+        for (i = 0; i < SDL_arraysize(loaded); i++) {
+            SDL_Surface *actual = loaded[i] ? SDL_ConvertSurfaceFormat(loaded[i], SDL_PIXELFORMAT_BGRA32, 0) : NULL;
+            int mismatches = 0;
+
+            SDLTest_AssertCheck(actual != NULL && expected != NULL, "Verify %s bitmap %i loaded", SDL_GetPixelFormatName(formats[f]), i);
+            if (actual != NULL && expected != NULL) {
+                SDLTest_AssertCheck(actual->w == w && actual->h == h, "Verify size of loaded surface, expected: %ix%i, got: %ix%i", w, h, actual->w, actual->h);
+                for (y = 0; y < h && actual->w == w && actual->h == h; y++) {
+                    if (SDL_memcmp((Uint8 *)actual->pixels + y * actual->pitch, (Uint8 *)expected->pixels + y * expected->pitch, w * 4) != 0) {
+                        mismatches++;
+                    }
+                }
+                SDLTest_AssertCheck(mismatches == 0, "Verify %s bitmap %i round trip, %i rows differ", SDL_GetPixelFormatName(formats[f]), i, mismatches);
+            }
+            SDL_FreeSurface(actual);
+            SDL_FreeSurface(loaded[i]);
+        }
+        SDL_FreeSurface(expected);
+        SDL_FreeSurface(face);
+    }
+
+    /* Empty rows still make a valid save */
+    for (f = 0; mem != NULL && f < SDL_arraysize(formats); f++) {
+        SDL_Surface *face = SDL_CreateRGBSurfaceWithFormat(0, 0, 4, 32, formats[f]);
+        SDL_RWops *rw = SDL_RWFromMem(mem, size);
+        int ret;
+
+        SDLTest_AssertCheck(face != NULL, "Verify 0x4 surface is not NULL");
+        if (face != NULL) {
+            ret = SDL_SaveBMP_RW(face, rw, 0);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SaveBMP_RW on a 0x4 %s surface, expected: 0, got: %i", SDL_GetPixelFormatName(formats[f]), ret);
+        }
+        SDL_RWclose(rw);
+        SDL_FreeSurface(face);
+    }
+    SDL_free(mem);
+
+    return TEST_COMPLETED;
+}
+
+/* Widths to halve: one that fits a single chunk of scratch memory, one that
+   spills into a second chunk, and one that needs an oversize chunk */
+static const int _scratchWidths[] = { 30, 2800, 6000 };
+
+/* Halves RGB24 surfaces with SDL_SoftStretchLinear(), whose area filter nests
+   six scratch allocations, and checks every channel against the exact
+   average of its 2x2 block. Returns how many of the surfaces were wrong. */
+static int
+_halveSurfaces(int rounds, Uint32 seed)
+{
+    const int count = (int)SDL_arraysize(_scratchWidths);
+    int failures = 0, r, i, x, y, c;
+
+    for (r = 0; r < rounds; r++) {
+        for (i = 0; i < count; i++) {
+            /* A different order every round, so chunks get reused for other sizes */
+            const int w = _scratchWidths[(i + r) % count];
+            SDL_Surface *src = SDL_CreateRGBSurfaceWithFormat(0, w, 4, 24, SDL_PIXELFORMAT_RGB24);
+            SDL_Surface *dst = SDL_CreateRGBSurfaceWithFormat(0, w / 2, 2, 24, SDL_PIXELFORMAT_RGB24);
+            int mismatches = 0;
+
+            if (src == NULL || dst == NULL) {
+                mismatches++;
+            } else {
+                for (y = 0; y < src->h; y++) {
+                    Uint8 *p = (Uint8 *)src->pixels + y * src->pitch;
+                    for (x = 0; x < w * 3; x++) {
+                        seed = seed * 1103515245 + 12345;
+                        p[x] = (Uint8)(seed >> 16);
+                    }
+                }
+                if (SDL_SoftStretchLinear(src, NULL, dst, NULL) < 0) {
+                    mismatches++;
+                }
+                for (y = 0; mismatches == 0 && y < dst->h; y++) {
+                    for (x = 0; x < dst->w; x++) {
+                        for (c = 0; c < 3; c++) {
+                            const Uint8 *s = (const Uint8 *)src->pixels + 2 * y * src->pitch + 2 * x * 3 + c;
+                            const int average = (s[0] + s[3] + s[src->pitch] + s[src->pitch + 3] + 2) / 4;
+                            mismatches += (((const Uint8 *)dst->pixels)[y * dst->pitch + x * 3 + c] != average);
+                        }
+                    }
+                }
+            }
+            failures += (mismatches != 0);
+            SDL_FreeSurface(dst);
+            SDL_FreeSurface(src);
+        }
+    }
+    return failures;
+}
+
+static int SDLCALL
+_halveSurfacesThread(void *arg)
+{
+    return _halveSurfaces(4, *(const Uint32 *)arg);
+}
+
+/**
+ * @brief Tests scratch memory with nested, oversize and concurrent allocations,
+ *        through area downscaling in SDL_SoftStretchLinear().
+ */
+int
+surface_testScratchStretch(void *arg)
+{
+    Uint32 seeds[] = { 1, 2, 3, 4 };
+    SDL_Thread *threads[SDL_arraysize(seeds)];
+    int failures, status, i;
+
+    failures = _halveSurfaces(3, 0);
+    SDLTest_AssertCheck(failures == 0, "Verify halved surfaces on one thread, %d were wrong", failures);
+
+    /* Every thread has its own scratch memory, freed when it exits */
+    for (i = 0; i < (int)SDL_arraysize(seeds); i++) {
+        threads[i] = SDL_CreateThread(_halveSurfacesThread, "testScratchStretch", &seeds[i]);
+        SDLTest_AssertCheck(threads[i] != NULL, "Verify SDL_CreateThread() result");
+    }
+    failures = _halveSurfaces(3, 5);
+    SDLTest_AssertCheck(failures == 0, "Verify halved surfaces alongside other threads, %d were wrong", failures);
+    for (i = 0; i < (int)SDL_arraysize(seeds); i++) {
+        if (threads[i] != NULL) {
+            SDL_WaitThread(threads[i], &status);
+            SDLTest_AssertCheck(status == 0, "Verify halved surfaces on thread %d, %d were wrong", i, status);
+        }
+    }
+
+    return TEST_COMPLETED;
+}
+
+/* Memory functions that pass everything through to the ones SDL had, and
+   keep track of blocks big enough to be chunks of scratch memory */
+#define SCRATCH_BLOCKS 8
+
+static SDL_malloc_func _realMalloc;
+static SDL_calloc_func _realCalloc;
+static SDL_realloc_func _realRealloc;
+static SDL_free_func _realFree;
+static void *_scratchBlocks[SCRATCH_BLOCKS];
+static SDL_atomic_t _scratchAllocs;
+static SDL_atomic_t _scratchFrees;
+
+static void * SDLCALL
+_trackingMalloc(size_t size)
+{
+    void *mem = _realMalloc(size);
+    if (mem != NULL && size >= 64 * 1024) {
+        const int i = SDL_AtomicAdd(&_scratchAllocs, 1);
+        if (i < SCRATCH_BLOCKS) {
+            _scratchBlocks[i] = mem;
+        }
+    }
+    return mem;
+}
+
+static void * SDLCALL
+_trackingCalloc(size_t nmemb, size_t size)
+{
+    return _realCalloc(nmemb, size);
+}
+
+static void * SDLCALL
+_trackingRealloc(void *mem, size_t size)
+{
+    return _realRealloc(mem, size);
+}
+
+static void SDLCALL
+_trackingFree(void *mem)
+{
+    const int count = SDL_min(SDL_AtomicGet(&_scratchAllocs), SCRATCH_BLOCKS);
+    int i;
+
+    for (i = 0; mem != NULL && i < count; i++) {
+        if (_scratchBlocks[i] == mem) {
+            SDL_AtomicAdd(&_scratchFrees, 1);
+        }
+    }
+    _realFree(mem);
+}
+
+/* Halves a surface small enough that only scratch memory needs a big block */
+static int SDLCALL
+_halveSmallSurfaceThread(void *arg)
+{
+    SDL_Surface *src = SDL_CreateRGBSurfaceWithFormat(0, 30, 4, 24, SDL_PIXELFORMAT_RGB24);
+    SDL_Surface *dst = SDL_CreateRGBSurfaceWithFormat(0, 15, 2, 24, SDL_PIXELFORMAT_RGB24);
+    int result = -1;
+
+    if (src != NULL && dst != NULL) {
+        result = SDL_SoftStretchLinear(src, NULL, dst, NULL);
+    }
+    SDL_FreeSurface(dst);
+    SDL_FreeSurface(src);
+    return result;
+}
+
+/**
+ * @brief Tests scratch memory comes from the memory functions set by the app,
+ *        and goes back to them when the thread exits.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_SetMemoryFunctions
+ */
+int
+surface_testScratchMemoryFunctions(void *arg)
+{
+    SDL_Thread *thread;
+    int ret, status = -1;
+
+    SDL_GetMemoryFunctions(&_realMalloc, &_realCalloc, &_realRealloc, &_realFree);
+    SDL_AtomicSet(&_scratchAllocs, 0);
+    SDL_AtomicSet(&_scratchFrees, 0);
+    ret = SDL_SetMemoryFunctions(_trackingMalloc, _trackingCalloc, _trackingRealloc, _trackingFree);
+    SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetMemoryFunctions, expected: 0, got: %i", ret);
+
+    /* A new thread, so its scratch memory is set up with our functions */
+    thread = SDL_CreateThread(_halveSmallSurfaceThread, "testScratchMemory", NULL);
+    SDLTest_AssertCheck(thread != NULL, "Verify SDL_CreateThread() result");
+    if (thread != NULL) {
+        SDL_WaitThread(thread, &status);
+    }
+    SDLTest_AssertCheck(status == 0, "Verify SDL_SoftStretchLinear() on the thread, expected: 0, got: %i", status);
+
+    SDL_SetMemoryFunctions(_realMalloc, _realCalloc, _realRealloc, _realFree);
+
+    SDLTest_AssertCheck(SDL_AtomicGet(&_scratchAllocs) > 0, "Verify scratch memory came from the app's malloc, got %d blocks", SDL_AtomicGet(&_scratchAllocs));
+    SDLTest_AssertCheck(SDL_AtomicGet(&_scratchFrees) == SDL_AtomicGet(&_scratchAllocs), "Verify scratch memory went back to the app's free, expected: %d blocks, got: %d", SDL_AtomicGet(&_scratchAllocs), SDL_AtomicGet(&_scratchFrees));
+
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Surface test cases */
@@ -809,11 +1558,40 @@ static const SDLTest_TestCaseReference surfaceTest12 =
 static const SDLTest_TestCaseReference surfaceTestOverflow =
         { surface_testOverflow, "surface_testOverflow", "Test overflow detection.", TEST_ENABLED};
 
+static const SDLTest_TestCaseReference surfaceTestStretchLinear =
+        { surface_testStretchLinear, "surface_testStretchLinear", "Tests linear scaling in 16, 24 and 32-bit formats.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTestBlitClippedRLE =
+        { surface_testBlitClippedRLE, "surface_testBlitClippedRLE", "Tests blitting sub-rectangles of RLE encoded surfaces.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTestFillRects =
+        { surface_testFillRects, "surface_testFillRects", "Tests filling rects of every width in 8, 16, 24 and 32-bit formats.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTestBlitToPalette =
+        { surface_testBlitToPalette, "surface_testBlitToPalette", "Tests blitting RGB surfaces to palettized surfaces, with and without dithering.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTestBlitSwizzle =
+        { surface_testBlitSwizzle, "surface_testBlitSwizzle", "Tests that blits between 24 and 32-bit formats keep every channel.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTestConvertThreads =
+        { surface_testConvertThreads, "surface_testConvertThreads", "Tests that large conversions split across threads match the serial ones.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTestSaveLoadBitmapBands =
+        { surface_testSaveLoadBitmapBands, "surface_testSaveLoadBitmapBands", "Tests saving and loading large bitmaps through memory and files.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTestScratchStretch =
+        { surface_testScratchStretch, "surface_testScratchStretch", "Tests scratch memory through nested, oversize and concurrent area downscales.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTestScratchMemoryFunctions =
+        { surface_testScratchMemoryFunctions, "surface_testScratchMemoryFunctions", "Tests scratch memory uses the app's memory functions.", TEST_ENABLED};
+
 /* Sequence of Surface test cases */
 static const SDLTest_TestCaseReference *surfaceTests[] =  {
     &surfaceTest1, &surfaceTest2, &surfaceTest3, &surfaceTest4, &surfaceTest5,
     &surfaceTest6, &surfaceTest7, &surfaceTest8, &surfaceTest9, &surfaceTest10,
-    &surfaceTest11, &surfaceTest12, &surfaceTestOverflow, NULL
+    &surfaceTest11, &surfaceTest12, &surfaceTestOverflow, &surfaceTestStretchLinear, &surfaceTestBlitClippedRLE,
+    &surfaceTestFillRects, &surfaceTestBlitToPalette,
+    &surfaceTestBlitSwizzle, &surfaceTestConvertThreads, &surfaceTestSaveLoadBitmapBands, &surfaceTestScratchStretch, &surfaceTestScratchMemoryFunctions, NULL
 };
 
 /* Surface test suite (global) */
@@ -1973,6 +1973,86 @@ video_setWindowCenteredOnDisplay(void *arg)
     return TEST_COMPLETED;
 }
 
+/**
+ * @brief Tests SDL_UpdateWindowSurface with SDL_HINT_FRAMEBUFFER_DAMAGE_TRACKING
+ *
+ * @sa http://wiki.libsdl.org/SDL_UpdateWindowSurface
+ */
+int
+video_updateWindowSurfaceDamage(void *arg)
+{
+  const char* title = "video_updateWindowSurfaceDamage Test Window";
+  SDL_Window* window;
+  SDL_Surface* surface;
+  SDL_Rect rect;
+  int result;
+  int frame;
+
+  SDL_SetHint(SDL_HINT_FRAMEBUFFER_DAMAGE_TRACKING, "1");
+  SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_FRAMEBUFFER_DAMAGE_TRACKING, \"1\")");
+
+  window = _createVideoSuiteTestWindow(title);
+  if (window == NULL) {
+    SDL_ResetHint(SDL_HINT_FRAMEBUFFER_DAMAGE_TRACKING);
+    return TEST_ABORTED;
+  }
+
+  surface = SDL_GetWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_GetWindowSurface()");
+  if (surface == NULL) {
+    SDLTest_Log("Window surface not supported by this video driver, skipping");
+    _destroyVideoSuiteTestWindow(window);
+    SDL_ResetHint(SDL_HINT_FRAMEBUFFER_DAMAGE_TRACKING);
+    return TEST_SKIPPED;
+  }
+
+  /* The first frame, an unchanged frame and frames with small changes */
+  for (frame = 0; frame < 8; frame++) {
+    if (frame >= 2) {
+      rect.x = SDLTest_RandomIntegerInRange(0, surface->w - 1);
+      rect.y = SDLTest_RandomIntegerInRange(0, surface->h - 1);
+      rect.w = SDLTest_RandomIntegerInRange(1, 100);
+      rect.h = SDLTest_RandomIntegerInRange(1, 100);
+      SDL_FillRect(surface, &rect, SDL_MapRGB(surface->format, (Uint8)(frame * 31), 0, 0));
+    }
+    result = SDL_UpdateWindowSurface(window);
+    SDLTest_AssertPass("Call to SDL_UpdateWindowSurface(), frame %d", frame);
+    SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+  }
+
+  /* Explicit rects and tracked frames mixed */
+  rect.x = 0;
+  rect.y = 0;
+  rect.w = surface->w / 2;
+  rect.h = surface->h / 2;
+  SDL_FillRect(surface, &rect, SDL_MapRGB(surface->format, 0, 255, 0));
+  result = SDL_UpdateWindowSurfaceRects(window, &rect, 1);
+  SDLTest_AssertPass("Call to SDL_UpdateWindowSurfaceRects()");
+  SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+  result = SDL_UpdateWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_UpdateWindowSurface()");
+  SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+
+  /* A new surface after resizing */
+  SDL_SetWindowSize(window, surface->w / 2 + 1, surface->h / 2 + 3);
+  SDLTest_AssertPass("Call to SDL_SetWindowSize()");
+  surface = SDL_GetWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_GetWindowSurface()");
+  SDLTest_AssertCheck(surface != NULL, "Validate that the window surface is not NULL");
+  if (surface != NULL) {
+    SDL_FillRect(surface, NULL, SDL_MapRGB(surface->format, 0, 0, 255));
+    result = SDL_UpdateWindowSurface(window);
+    SDLTest_AssertPass("Call to SDL_UpdateWindowSurface()");
+    SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+  }
+
+  /* Clean up */
+  _destroyVideoSuiteTestWindow(window);
+  SDL_ResetHint(SDL_HINT_FRAMEBUFFER_DAMAGE_TRACKING);
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Video test cases */
@@ -2048,13 +2128,16 @@ static const SDLTest_TestCaseReference videoTest23 =
 static const SDLTest_TestCaseReference videoTest24 =
         { (SDLTest_TestCaseFp) video_setWindowCenteredOnDisplay, "video_setWindowCenteredOnDisplay", "Checks using SDL_WINDOWPOS_CENTERED_DISPLAY centers the window on a display", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference videoTest25 =
+        { (SDLTest_TestCaseFp) video_updateWindowSurfaceDamage, "video_updateWindowSurfaceDamage", "Checks SDL_UpdateWindowSurface with damage tracking enabled", TEST_ENABLED };
+
 /* Sequence of Video test cases */
 static const SDLTest_TestCaseReference *videoTests[] =  {
     &videoTest1, &videoTest2, &videoTest3, &videoTest4, &videoTest5, &videoTest6,
     &videoTest7, &videoTest8, &videoTest9, &videoTest10, &videoTest11, &videoTest12,
     &videoTest13, &videoTest14, &videoTest15, &videoTest16, &videoTest17,
     &videoTest18, &videoTest19, &videoTest20, &videoTest21, &videoTest22,
-    &videoTest23, &videoTest24, NULL
+    &videoTest23, &videoTest24, &videoTest25, NULL
 };
 
 /* Video test suite (global) */
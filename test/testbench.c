@@ -0,0 +1,609 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Micro-benchmarks for the software pixel pipeline: blits, scaling,
+   fills, pixel format conversion and alpha premultiplication.
+
+   Every case is reported in Mpixels/s, tagged with the CPU feature path
+   it ran on. Use --cpu to force a path, for example run it once with
+   --cpu scalar and once with --cpu native and compare the results.
+ */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define MAX_SIZES   8
+
+typedef void (*BenchFunc)(void *data);
+
+typedef struct
+{
+    const char *name;
+    const char *mask;
+} CPUPath;
+
+/* Each path only enables features the CPU actually has, missing ones are ignored */
+static const CPUPath cpu_paths[] = {
+    { "native", NULL },
+    { "scalar", "-all" },
+    { "mmx", "-all,+mmx" },
+    { "sse", "-all,+mmx,+sse" },
+    { "sse2", "-all,+mmx,+sse,+sse2" },
+    { "sse41", "-all,+mmx,+sse,+sse2,+sse3,+sse41" },
+    { "avx", "-all,+mmx,+sse,+sse2,+sse3,+sse41,+sse42,+avx" },
+    { "avx2", "-all,+mmx,+sse,+sse2,+sse3,+sse41,+sse42,+avx,+avx2" },
+    { "armsimd", "-all,+armsimd" },
+    { "neon", "-all,+armsimd,+neon" },
+    { "altivec", "-all,+altivec" },
+    { "lsx", "-all,+lsx" },
+    { "lasx", "-all,+lsx,+lasx" },
+};
+
+static const Uint32 rgb_formats[] = {
+    SDL_PIXELFORMAT_ARGB8888,
+    SDL_PIXELFORMAT_ABGR8888,
+    SDL_PIXELFORMAT_RGBA8888,
+    SDL_PIXELFORMAT_RGB888,
+    SDL_PIXELFORMAT_BGR888,
+    SDL_PIXELFORMAT_ARGB2101010,
+    SDL_PIXELFORMAT_RGB565,
+    SDL_PIXELFORMAT_RGB555,
+    SDL_PIXELFORMAT_ARGB4444,
+    SDL_PIXELFORMAT_RGB24,
+    SDL_PIXELFORMAT_BGR24,
+};
+
+/* The formats we commonly render into */
+static const Uint32 dst_formats[] = {
+    SDL_PIXELFORMAT_ARGB8888,
+    SDL_PIXELFORMAT_ABGR8888,
+    SDL_PIXELFORMAT_RGB888,
+    SDL_PIXELFORMAT_RGB565,
+    SDL_PIXELFORMAT_RGB24,
+};
+
+static const Uint32 yuv_formats[] = {
+    SDL_PIXELFORMAT_YV12,
+    SDL_PIXELFORMAT_IYUV,
+    SDL_PIXELFORMAT_NV12,
+    SDL_PIXELFORMAT_NV21,
+    SDL_PIXELFORMAT_YUY2,
+    SDL_PIXELFORMAT_UYVY,
+    SDL_PIXELFORMAT_YVYU,
+};
+
+static const struct
+{
+    const char *name;
+    SDL_BlendMode mode;
+} blend_modes[] = {
+    { "none", SDL_BLENDMODE_NONE },
+    { "blend", SDL_BLENDMODE_BLEND },
+    { "add", SDL_BLENDMODE_ADD },
+    { "mod", SDL_BLENDMODE_MOD },
+    { "mul", SDL_BLENDMODE_MUL },
+};
+
+static const struct
+{
+    const char *name;
+    SDL_bool color;
+    SDL_bool alpha;
+} mods[] = {
+    { "", SDL_FALSE, SDL_FALSE },
+    { "+colormod", SDL_TRUE, SDL_FALSE },
+    { "+alphamod", SDL_FALSE, SDL_TRUE },
+};
+
+static const char *cpu_path = "native";
+static const char *filter = NULL;
+static double time_budget = 0.05;
+static int min_iterations = 3;
+static SDL_RWops *csv = NULL;
+static SDL_Point sizes[MAX_SIZES];
+static int num_sizes = 0;
+
+static const char *
+FormatName(Uint32 format)
+{
+    const char *name = SDL_GetPixelFormatName(format);
+    /* Skip the common prefix, it just makes the table wider */
+    if (SDL_strncmp(name, "SDL_PIXELFORMAT_", 16) == 0) {
+        name += 16;
+    }
+    return name;
+}
+
+static SDL_bool
+ShouldRun(const char *op, const char *src, const char *dst, const char *mode)
+{
+    char name[256];
+
+    if (!filter) {
+        return SDL_TRUE;
+    }
+    SDL_snprintf(name, sizeof(name), "%s %s %s %s", op, src, dst, mode);
+    return SDL_strstr(name, filter) ? SDL_TRUE : SDL_FALSE;
+}
+
+/* Runs func until the time budget is used up and returns the throughput in Mpixels/s */
+static double
+Measure(BenchFunc func, void *data, Uint64 pixels)
+{
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 budget = (Uint64)(time_budget * frequency);
+    Uint64 start, elapsed;
+    int iterations = 0;
+
+    /* Warm up caches and any lazily built blit maps */
+    func(data);
+
+    start = SDL_GetPerformanceCounter();
+    do {
+        func(data);
+        ++iterations;
+        elapsed = SDL_GetPerformanceCounter() - start;
+    } while (iterations < min_iterations || elapsed < budget);
+
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    return ((double)pixels * iterations) / ((double)elapsed / frequency) / 1000000.0;
+}
+
+static void
+Report(const char *op, const char *src, const char *dst, const char *mode, int w, int h, double mpixels)
+{
+    SDL_Log("%-8s %-12s %-14s %-14s %-18s %5dx%-5d %10.1f Mpixels/s\n", cpu_path, op, src, dst, mode, w, h, mpixels);
+
+    if (csv) {
+        char line[256];
+        SDL_snprintf(line, sizeof(line), "%s,%s,%s,%s,%s,%d,%d,%.2f\n", cpu_path, op, src, dst, mode, w, h, mpixels);
+        SDL_RWwrite(csv, line, 1, SDL_strlen(line));
+    }
+}
+
+/* Fills a buffer with noise, so blending and colorkey paths see varied alpha */
+static void
+FillNoise(void *pixels, size_t len)
+{
+    Uint8 *p = (Uint8 *)pixels;
+    Uint32 seed = 0x12345678;
+    size_t i;
+
+    for (i = 0; i < len; ++i) {
+        seed = seed * 1103515245 + 12345;
+        p[i] = (Uint8)(seed >> 16);
+    }
+}
+
+static SDL_Surface *
+CreateNoiseSurface(int w, int h, Uint32 format)
+{
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, format);
+    if (surface) {
+        FillNoise(surface->pixels, (size_t)surface->pitch * surface->h);
+    }
+    return surface;
+}
+
+typedef struct
+{
+    SDL_Surface *src;
+    SDL_Surface *dst;
+} BlitData;
+
+static void
+BenchBlit(void *data)
+{
+    BlitData *blit = (BlitData *)data;
+    SDL_BlitSurface(blit->src, NULL, blit->dst, NULL);
+}
+
+static void
+BenchBlitScaled(void *data)
+{
+    BlitData *blit = (BlitData *)data;
+    SDL_BlitScaled(blit->src, NULL, blit->dst, NULL);
+}
+
+static void
+BenchStretchLinear(void *data)
+{
+    BlitData *blit = (BlitData *)data;
+    SDL_SoftStretchLinear(blit->src, NULL, blit->dst, NULL);
+}
+
+static void
+RunBlits(int w, int h)
+{
+    size_t s, d, b, m;
+
+    for (s = 0; s < SDL_arraysize(rgb_formats); ++s) {
+        for (d = 0; d < SDL_arraysize(dst_formats); ++d) {
+            BlitData data;
+
+            data.src = CreateNoiseSurface(w, h, rgb_formats[s]);
+            data.dst = CreateNoiseSurface(w, h, dst_formats[d]);
+            if (!data.src || !data.dst) {
+                SDL_Log("Couldn't create surfaces: %s\n", SDL_GetError());
+                SDL_FreeSurface(data.src);
+                SDL_FreeSurface(data.dst);
+                continue;
+            }
+
+            for (b = 0; b < SDL_arraysize(blend_modes); ++b) {
+                for (m = 0; m < SDL_arraysize(mods); ++m) {
+                    char mode[64];
+
+                    SDL_snprintf(mode, sizeof(mode), "%s%s", blend_modes[b].name, mods[m].name);
+                    if (!ShouldRun("blit", FormatName(rgb_formats[s]), FormatName(dst_formats[d]), mode)) {
+                        continue;
+                    }
+                    SDL_SetSurfaceBlendMode(data.src, blend_modes[b].mode);
+                    SDL_SetSurfaceColorMod(data.src, 255, mods[m].color ? 128 : 255, mods[m].color ? 64 : 255);
+                    SDL_SetSurfaceAlphaMod(data.src, mods[m].alpha ? 128 : 255);
+                    Report("blit", FormatName(rgb_formats[s]), FormatName(dst_formats[d]), mode, w, h,
+                           Measure(BenchBlit, &data, (Uint64)w * h));
+                }
+            }
+            SDL_FreeSurface(data.src);
+            SDL_FreeSurface(data.dst);
+        }
+    }
+}
+
+static void
+RunScaledBlits(int w, int h)
+{
+    static const struct
+    {
+        const char *name;
+        int num, den;
+    } scales[] = {
+        { "up2x", 2, 1 },
+        { "down2x", 1, 2 },
+        { "down3x", 1, 3 },
+    };
+    size_t s, d, i, b;
+
+    for (s = 0; s < SDL_arraysize(rgb_formats); ++s) {
+        for (d = 0; d < SDL_arraysize(dst_formats); ++d) {
+            for (i = 0; i < SDL_arraysize(scales); ++i) {
+                const int dw = SDL_max(1, w * scales[i].num / scales[i].den);
+                const int dh = SDL_max(1, h * scales[i].num / scales[i].den);
+                BlitData data;
+
+                data.src = CreateNoiseSurface(w, h, rgb_formats[s]);
+                data.dst = CreateNoiseSurface(dw, dh, dst_formats[d]);
+                if (!data.src || !data.dst) {
+                    SDL_FreeSurface(data.src);
+                    SDL_FreeSurface(data.dst);
+                    continue;
+                }
+
+                for (b = 0; b < 2; ++b) {
+                    char mode[64];
+
+                    SDL_snprintf(mode, sizeof(mode), "%s,%s", scales[i].name, blend_modes[b].name);
+                    if (ShouldRun("blitscaled", FormatName(rgb_formats[s]), FormatName(dst_formats[d]), mode)) {
+                        SDL_SetSurfaceBlendMode(data.src, blend_modes[b].mode);
+                        Report("blitscaled", FormatName(rgb_formats[s]), FormatName(dst_formats[d]), mode, dw, dh,
+                               Measure(BenchBlitScaled, &data, (Uint64)dw * dh));
+                    }
+                }
+
+                /* SDL_SoftStretchLinear() needs matching formats */
+                if (rgb_formats[s] == dst_formats[d] &&
+                    ShouldRun("stretchlinear", FormatName(rgb_formats[s]), FormatName(dst_formats[d]), scales[i].name)) {
+                    if (SDL_SoftStretchLinear(data.src, NULL, data.dst, NULL) == 0) {
+                        Report("stretchlinear", FormatName(rgb_formats[s]), FormatName(dst_formats[d]), scales[i].name, dw, dh,
+                               Measure(BenchStretchLinear, &data, (Uint64)dw * dh));
+                    }
+                }
+                SDL_FreeSurface(data.src);
+                SDL_FreeSurface(data.dst);
+            }
+        }
+    }
+}
+
+typedef struct
+{
+    SDL_Surface *dst;
+    SDL_Rect *rects;
+    int count;
+} FillData;
+
+static void
+BenchFill(void *data)
+{
+    FillData *fill = (FillData *)data;
+    SDL_FillRects(fill->dst, fill->rects, fill->count, 0x80402010);
+}
+
+static void
+RunFills(int w, int h)
+{
+    size_t d;
+
+    for (d = 0; d < SDL_arraysize(rgb_formats); ++d) {
+        FillData data;
+        SDL_Rect rects[64];
+        Uint64 pixels = 0;
+        int i;
+
+        data.dst = CreateNoiseSurface(w, h, rgb_formats[d]);
+        if (!data.dst) {
+            continue;
+        }
+
+        if (ShouldRun("fillrects", "-", FormatName(rgb_formats[d]), "full")) {
+            rects[0].x = rects[0].y = 0;
+            rects[0].w = w;
+            rects[0].h = h;
+            data.rects = rects;
+            data.count = 1;
+            Report("fillrects", "-", FormatName(rgb_formats[d]), "full", w, h,
+                   Measure(BenchFill, &data, (Uint64)w * h));
+        }
+
+        /* An 8x8 grid of small, odd sized rects, to hit the unaligned edges */
+        if (ShouldRun("fillrects", "-", FormatName(rgb_formats[d]), "grid64")) {
+            for (i = 0; i < 64; ++i) {
+                rects[i].x = (i % 8) * w / 8 + 1;
+                rects[i].y = (i / 8) * h / 8 + 1;
+                rects[i].w = SDL_max(1, w / 8 - 3);
+                rects[i].h = SDL_max(1, h / 8 - 3);
+                pixels += (Uint64)rects[i].w * rects[i].h;
+            }
+            data.rects = rects;
+            data.count = 64;
+            Report("fillrects", "-", FormatName(rgb_formats[d]), "grid64", w, h,
+                   Measure(BenchFill, &data, pixels));
+        }
+        SDL_FreeSurface(data.dst);
+    }
+}
+
+typedef struct
+{
+    int w, h;
+    Uint32 src_format;
+    void *src;
+    int src_pitch;
+    Uint32 dst_format;
+    void *dst;
+    int dst_pitch;
+} ConvertData;
+
+static void
+BenchConvert(void *data)
+{
+    ConvertData *cvt = (ConvertData *)data;
+    SDL_ConvertPixels(cvt->w, cvt->h, cvt->src_format, cvt->src, cvt->src_pitch, cvt->dst_format, cvt->dst, cvt->dst_pitch);
+}
+
+static void
+BenchPremultiply(void *data)
+{
+    ConvertData *cvt = (ConvertData *)data;
+    SDL_PremultiplyAlpha(cvt->w, cvt->h, cvt->src_format, cvt->src, cvt->src_pitch, cvt->dst_format, cvt->dst, cvt->dst_pitch);
+}
+
+/* Returns the pitch of the first plane, and the size of the whole image in *size */
+static int
+GetImagePitch(Uint32 format, int w, int h, size_t *size)
+{
+    int pitch;
+
+    if (SDL_ISPIXELFORMAT_FOURCC(format)) {
+        if (format == SDL_PIXELFORMAT_YUY2 || format == SDL_PIXELFORMAT_UYVY || format == SDL_PIXELFORMAT_YVYU) {
+            pitch = ((w + 1) / 2) * 4;
+            *size = (size_t)pitch * h;
+        } else {
+            pitch = w;
+            *size = (size_t)pitch * h + 2 * (size_t)((w + 1) / 2) * ((h + 1) / 2);
+        }
+    } else {
+        pitch = (w * SDL_BYTESPERPIXEL(format) + 3) & ~3;
+        *size = (size_t)pitch * h;
+    }
+    return pitch;
+}
+
+static void
+RunConversion(const char *op, BenchFunc func, Uint32 src_format, Uint32 dst_format, int w, int h)
+{
+    ConvertData data;
+    size_t src_size, dst_size;
+
+    if (!ShouldRun(op, FormatName(src_format), FormatName(dst_format), "-")) {
+        return;
+    }
+
+    data.w = w;
+    data.h = h;
+    data.src_format = src_format;
+    data.dst_format = dst_format;
+    data.src_pitch = GetImagePitch(src_format, w, h, &src_size);
+    data.dst_pitch = GetImagePitch(dst_format, w, h, &dst_size);
+    data.src = SDL_malloc(src_size);
+    data.dst = SDL_malloc(dst_size);
+    if (data.src && data.dst) {
+        FillNoise(data.src, src_size);
+        /* Skip conversions SDL doesn't support instead of timing the error path */
+        SDL_ClearError();
+        func(&data);
+        if (*SDL_GetError()) {
+            SDL_Log("Skipping %s %s -> %s: %s\n", op, FormatName(src_format), FormatName(dst_format), SDL_GetError());
+        } else {
+            Report(op, FormatName(src_format), FormatName(dst_format), "-", w, h,
+                   Measure(func, &data, (Uint64)w * h));
+        }
+    }
+    SDL_free(data.src);
+    SDL_free(data.dst);
+}
+
+static void
+RunConversions(int w, int h)
+{
+    size_t s, d;
+
+    for (s = 0; s < SDL_arraysize(rgb_formats); ++s) {
+        for (d = 0; d < SDL_arraysize(rgb_formats); ++d) {
+            if (s != d) {
+                RunConversion("convert", BenchConvert, rgb_formats[s], rgb_formats[d], w, h);
+            }
+        }
+    }
+
+    /* YUV conversions need even sizes for the chroma planes */
+    w &= ~1;
+    h &= ~1;
+    if (w && h) {
+        for (s = 0; s < SDL_arraysize(yuv_formats); ++s) {
+            for (d = 0; d < SDL_arraysize(dst_formats); ++d) {
+                RunConversion("convert", BenchConvert, yuv_formats[s], dst_formats[d], w, h);
+                RunConversion("convert", BenchConvert, dst_formats[d], yuv_formats[s], w, h);
+            }
+            for (d = 0; d < SDL_arraysize(yuv_formats); ++d) {
+                if (s != d) {
+                    RunConversion("convert", BenchConvert, yuv_formats[s], yuv_formats[d], w, h);
+                }
+            }
+        }
+    }
+
+    RunConversion("premultiply", BenchPremultiply, SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, w, h);
+}
+
+static void
+LogCPUFeatures(void)
+{
+    SDL_Log("CPU path '%s':%s%s%s%s%s%s%s%s%s%s%s\n", cpu_path,
+            SDL_HasMMX() ? " MMX" : "",
+            SDL_HasSSE() ? " SSE" : "",
+            SDL_HasSSE2() ? " SSE2" : "",
+            SDL_HasSSE3() ? " SSE3" : "",
+            SDL_HasSSE41() ? " SSE4.1" : "",
+            SDL_HasSSE42() ? " SSE4.2" : "",
+            SDL_HasAVX() ? " AVX" : "",
+            SDL_HasAVX2() ? " AVX2" : "",
+            SDL_HasAVX512F() ? " AVX-512F" : "",
+            SDL_HasARMSIMD() ? " ARMSIMD" : "",
+            SDL_HasNEON() ? " NEON" : "");
+}
+
+static void
+Usage(const char *argv0)
+{
+    size_t i;
+
+    SDL_Log("Usage: %s [--cpu path] [--size WxH]... [--filter text] [--time seconds] [--csv file]\n", argv0);
+    SDL_Log("  --cpu     limits SDL to the CPU features of a path, one of:\n");
+    for (i = 0; i < SDL_arraysize(cpu_paths); ++i) {
+        SDL_Log("              %s\n", cpu_paths[i].name);
+    }
+    SDL_Log("  --size    image size, may be given up to %d times (default 64x64 and 1920x1080)\n", MAX_SIZES);
+    SDL_Log("  --filter  only run cases whose \"op src dst mode\" contains the text, e.g. \"blit ARGB8888\"\n");
+    SDL_Log("  --time    minimum time spent on each case (default 0.05)\n");
+    SDL_Log("  --csv     also write the results to a CSV file\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *csv_file = NULL;
+    int i;
+
+    for (i = 1; i < argc; ++i) {
+        if (SDL_strcmp(argv[i], "--cpu") == 0 && argv[i + 1]) {
+            size_t p;
+            cpu_path = argv[++i];
+            for (p = 0; p < SDL_arraysize(cpu_paths); ++p) {
+                if (SDL_strcasecmp(cpu_path, cpu_paths[p].name) == 0) {
+                    break;
+                }
+            }
+            if (p == SDL_arraysize(cpu_paths)) {
+                Usage(argv[0]);
+                return 1;
+            }
+            /* This has to happen before anything queries the CPU features */
+            if (cpu_paths[p].mask) {
+                SDL_SetHint(SDL_HINT_CPU_FEATURE_MASK, cpu_paths[p].mask);
+            }
+        } else if (SDL_strcmp(argv[i], "--size") == 0 && argv[i + 1] && num_sizes < MAX_SIZES) {
+            if (SDL_sscanf(argv[++i], "%dx%d", &sizes[num_sizes].x, &sizes[num_sizes].y) != 2 ||
+                sizes[num_sizes].x <= 0 || sizes[num_sizes].y <= 0) {
+                Usage(argv[0]);
+                return 1;
+            }
+            ++num_sizes;
+        } else if (SDL_strcmp(argv[i], "--filter") == 0 && argv[i + 1]) {
+            filter = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--time") == 0 && argv[i + 1]) {
+            time_budget = SDL_atof(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--csv") == 0 && argv[i + 1]) {
+            csv_file = argv[++i];
+        } else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    if (num_sizes == 0) {
+        sizes[0].x = sizes[0].y = 64;
+        sizes[1].x = 1920;
+        sizes[1].y = 1080;
+        num_sizes = 2;
+    }
+
+    if (csv_file) {
+        static const char header[] = "path,op,src,dst,mode,width,height,mpixels_per_sec\n";
+        csv = SDL_RWFromFile(csv_file, "wb");
+        if (!csv) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create %s: %s\n", csv_file, SDL_GetError());
+            SDL_Quit();
+            return 1;
+        }
+        SDL_RWwrite(csv, header, 1, sizeof(header) - 1);
+    }
+
+    LogCPUFeatures();
+
+    for (i = 0; i < num_sizes; ++i) {
+        RunBlits(sizes[i].x, sizes[i].y);
+        RunScaledBlits(sizes[i].x, sizes[i].y);
+        RunFills(sizes[i].x, sizes[i].y);
+        RunConversions(sizes[i].x, sizes[i].y);
+    }
+
+    if (csv) {
+        SDL_RWclose(csv);
+    }
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */